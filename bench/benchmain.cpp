@@ -0,0 +1,156 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "benchreport.h"
+#include "mediagenerator.h"
+#include "scanbench.h"
+#include "gridbench.h"
+#include "statsbench.h"
+#include "statsmanager.h"
+#include "toolbar.h"
+
+namespace {
+
+QList<int> parseInts(const QString &value)
+{
+    QList<int> out;
+    for (const QString &part : value.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int n = part.trimmed().toInt(&ok);
+        if (ok && n > 0) out.append(n);
+    }
+    return out;
+}
+
+QJsonArray toJson(const QList<int> &values)
+{
+    QJsonArray out;
+    for (int value : values) out.append(value);
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // As in goobert --headless: the platform is fixed when QApplication is built
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
+    QApplication app(argc, argv);
+    app.setApplicationName("Goobert");
+    app.setApplicationVersion(GOOBERT_VERSION);
+    app.setOrganizationName("drzo1dberg");
+
+    // Config, stats and index databases go to Qt's test-mode locations, never the user's
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Goobert benchmark harness; results are written as JSON");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption suitesOption("suites", "Comma-separated suites to run: scan, stats, grid", "list", "scan,stats,grid");
+    const QCommandLineOption outOption("out", "Result file, or - for stdout", "file",
+        QString("goobert-bench-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+    const QCommandLineOption labelOption("label", "Free text stored with the results, e.g. a commit", "text");
+    const QCommandLineOption workDirOption("work-dir", "Where generated media is kept between runs", "dir",
+        QDir::tempPath() + "/goobert-bench");
+    const QCommandLineOption runsOption("runs", "Measured repetitions of every case", "n", "3");
+    const QCommandLineOption scanSizesOption("scan-sizes", "Files per scan tree", "list", "10000,100000,1000000");
+    const QCommandLineOption gridsOption("grids", "Grid sizes n for n x n grids", "list", "2,4,6,8,10");
+    const QCommandLineOption switchesOption("switches", "nextAll() rounds per grid run", "n", "5");
+    const QCommandLineOption codecOption("codec", "Clip codec: h264, hevc, vp9 or av1", "codec", "h264");
+    const QCommandLineOption resolutionOption("resolution", "Clip size", "WxH", "1920x1080");
+    const QCommandLineOption clipsOption("clips", "Number of generated clips", "n", "100");
+    const QCommandLineOption clipSecondsOption("clip-seconds", "Clip length; longer than a grid start plus a switch round", "s", "20");
+    const QCommandLineOption ffmpegOption("ffmpeg", "ffmpeg binary for the clip generator", "path", "ffmpeg");
+    const QCommandLineOption eventsOption("stats-events", "Stats events per run", "n", "200000");
+    const QCommandLineOption statsCellsOption("stats-cells", "Cells producing stats events", "n", "100");
+    const QCommandLineOption headlessOption("headless", "Grid suite without a display: offscreen platform, vo=null");
+    parser.addOptions({suitesOption, outOption, labelOption, workDirOption, runsOption, scanSizesOption,
+                       gridsOption, switchesOption, codecOption, resolutionOption, clipsOption,
+                       clipSecondsOption, ffmpegOption, eventsOption, statsCellsOption, headlessOption});
+    parser.process(app);
+
+    const QStringList suites = parser.value(suitesOption).split(',', Qt::SkipEmptyParts);
+    const QString workDir = parser.value(workDirOption);
+    const int runs = std::max(1, parser.value(runsOption).toInt());
+    if (!QDir().mkpath(workDir)) {
+        std::cerr << "Cannot create " << workDir.toStdString() << std::endl;
+        return 2;
+    }
+
+    ScanBench::Options scanOptions;
+    scanOptions.sizes = parseInts(parser.value(scanSizesOption));
+    scanOptions.runs = runs;
+
+    GridBench::Options gridOptions;
+    gridOptions.sizes = parseInts(parser.value(gridsOption));
+    gridOptions.sizes.removeIf([](int n) { return n > ToolBarConstants::kMaxGridSize; });
+    gridOptions.runs = runs;
+    gridOptions.switches = std::max(0, parser.value(switchesOption).toInt());
+    gridOptions.headless = parser.isSet(headlessOption);
+
+    MediaGenerator::ClipSpec clipSpec;
+    clipSpec.codec = parser.value(codecOption);
+    clipSpec.count = std::max(1, parser.value(clipsOption).toInt());
+    clipSpec.seconds = std::max(1, parser.value(clipSecondsOption).toInt());
+    const QStringList resolution = parser.value(resolutionOption).split('x');
+    if (resolution.size() == 2) {
+        clipSpec.size = QSize(resolution.at(0).toInt(), resolution.at(1).toInt());
+    }
+
+    StatsBench::Options statsOptions;
+    statsOptions.events = std::max(1, parser.value(eventsOption).toInt());
+    statsOptions.cells = std::max(1, parser.value(statsCellsOption).toInt());
+    statsOptions.runs = runs;
+
+    QJsonObject options;
+    options["suites"] = QJsonArray::fromStringList(suites);
+    options["runs"] = runs;
+    options["scan_sizes"] = toJson(scanOptions.sizes);
+    options["grids"] = toJson(gridOptions.sizes);
+    options["switches"] = gridOptions.switches;
+    options["headless"] = gridOptions.headless;
+    options["clips"] = clipSpec.key();
+    options["stats_events"] = statsOptions.events;
+    options["stats_cells"] = statsOptions.cells;
+    BenchReport report(parser.value(labelOption), options);
+
+    bool ok = true;
+    if (suites.contains("scan")) {
+        ok = ScanBench::run(report, workDir, scanOptions) && ok;
+    }
+    // Before the grid, whose window shuts the stats database down on close
+    if (suites.contains("stats")) {
+        ok = StatsBench::run(report, statsOptions) && ok;
+    }
+    if (suites.contains("grid")) {
+        QString error;
+        const QString clipDir = MediaGenerator::ensureClips(workDir, clipSpec, parser.value(ffmpegOption), &error);
+        if (clipDir.isEmpty()) {
+            qWarning() << "goobert_bench: no clips:" << error;
+            ok = false;
+        } else {
+            ok = GridBench::run(report, clipDir, gridOptions) && ok;
+        }
+    }
+    StatsManager::instance().shutdown();
+
+    if (!report.write(parser.value(outOption))) {
+        return 2;
+    }
+    return ok ? 0 : 1;
+}
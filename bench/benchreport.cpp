@@ -0,0 +1,102 @@
+#include "benchreport.h"
+#include <QDateTime>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QThread>
+#include <QDebug>
+#include <mpv/client.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+BenchReport::BenchReport(const QString &label, const QJsonObject &options)
+{
+    m_header["schema"] = BenchConstants::kSchemaVersion;
+    m_header["goobert_version"] = GOOBERT_VERSION;
+    m_header["started_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    m_header["label"] = label;
+    m_header["environment"] = environment();
+    m_header["options"] = options;
+}
+
+void BenchReport::add(const QString &suite, const QString &name, const QJsonObject &params, const QJsonObject &metrics)
+{
+    QJsonObject result;
+    result["suite"] = suite;
+    result["name"] = name;
+    result["params"] = params;
+    result["metrics"] = metrics;
+    m_results.append(result);
+
+    qDebug().noquote() << "bench:" << suite << name
+                       << QJsonDocument(params).toJson(QJsonDocument::Compact)
+                       << QJsonDocument(metrics).toJson(QJsonDocument::Compact);
+}
+
+bool BenchReport::write(const QString &path) const
+{
+    QJsonObject document = m_header;
+    document["finished_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    document["results"] = m_results;
+    const QByteArray json = QJsonDocument(document).toJson(QJsonDocument::Indented);
+
+    if (path == "-") {
+        return std::fwrite(json.constData(), 1, json.size(), stdout) == static_cast<size_t>(json.size());
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qWarning() << "BenchReport: cannot write" << path << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QJsonObject BenchReport::summarize(QVector<double> samples, const QString &prefix)
+{
+    QJsonObject out;
+    out[prefix + "count"] = samples.size();
+    if (samples.isEmpty()) {
+        return out;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    // Nearest rank, so every reported value is one that was measured
+    const auto rank = [&samples](double fraction) {
+        const qsizetype index = static_cast<qsizetype>(std::ceil(fraction * samples.size())) - 1;
+        return samples.at(std::clamp<qsizetype>(index, 0, samples.size() - 1));
+    };
+    double sum = 0.0;
+    for (double sample : std::as_const(samples)) {
+        sum += sample;
+    }
+
+    out[prefix + "min"] = samples.first();
+    out[prefix + "median"] = rank(0.5);
+    out[prefix + "p95"] = rank(0.95);
+    out[prefix + "max"] = samples.last();
+    out[prefix + "mean"] = sum / samples.size();
+    return out;
+}
+
+QJsonObject BenchReport::environment()
+{
+    QJsonObject env;
+    env["host"] = QSysInfo::machineHostName();
+    env["os"] = QSysInfo::prettyProductName();
+    env["kernel"] = QSysInfo::kernelVersion();
+    env["cpu_arch"] = QSysInfo::currentCpuArchitecture();
+    env["cpu_threads"] = QThread::idealThreadCount();
+    env["qt"] = qVersion();
+
+    const unsigned long mpvApi = mpv_client_api_version();
+    env["mpv_client_api"] = QString("%1.%2").arg(mpvApi >> 16).arg(mpvApi & 0xffff);
+
+#ifdef GOOBERT_HAVE_AVFORMAT
+    env["avformat"] = true;
+#else
+    env["avformat"] = false;
+#endif
+    return env;
+}
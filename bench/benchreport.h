@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+namespace BenchConstants {
+    inline constexpr int kSchemaVersion = 1;   // Bump when a metric changes meaning
+}
+
+// Results of one goobert_bench run. Written as a single JSON document:
+//
+//   { "schema": 1, "goobert_version": ..., "started_at": ..., "label": ...,
+//     "environment": {...}, "options": {...},
+//     "results": [ { "suite": ..., "name": ..., "params": {...}, "metrics": {...} } ] }
+//
+// Every metric name carries its unit (_ms, _per_sec, ...), and a result's
+// params identify it across runs, so two files can be diffed entry by entry.
+class BenchReport
+{
+public:
+    BenchReport(const QString &label, const QJsonObject &options);
+
+    void add(const QString &suite, const QString &name, const QJsonObject &params, const QJsonObject &metrics);
+    [[nodiscard]] bool isEmpty() const noexcept { return m_results.isEmpty(); }
+
+    // "-" writes to stdout
+    bool write(const QString &path) const;
+
+    // count, min, median, p95, max and mean of samples, each key prefixed
+    [[nodiscard]] static QJsonObject summarize(QVector<double> samples, const QString &prefix);
+    [[nodiscard]] static QJsonObject environment();
+
+private:
+    QJsonObject m_header;
+    QJsonArray m_results;
+};
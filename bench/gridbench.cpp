@@ -0,0 +1,179 @@
+#include "gridbench.h"
+#include "benchreport.h"
+#include "mainwindow.h"
+#include "mediaindex.h"
+#include "config.h"
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonObject>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+struct Phase {
+    bool ok = false;
+    double launchMs = -1.0;    // startGrid() to gridLaunched(); only for grid starts
+    QVector<double> cellMs;    // Trigger to each cell's next first frame
+};
+
+// Runs the event loop until every cell of the grid has rendered the first
+// frame of a new file after trigger(). With waitForLaunch the cells are
+// taken from the grid that trigger() builds.
+Phase measure(MainWindow &window, bool waitForLaunch, const std::function<void()> &trigger)
+{
+    Phase phase;
+    QEventLoop loop;
+    QElapsedTimer clock;
+    QVector<qint64> firstAt;
+    qsizetype remaining = -1;
+    QObject context;   // Owns this phase's connections; goes first
+
+    const auto attach = [&]() {
+        const QVector<GridCell*> &cells = window.cells();
+        firstAt.fill(-1, cells.size());
+        remaining = cells.size();
+        for (qsizetype i = 0; i < cells.size(); ++i) {
+            QObject::connect(cells.at(i), &GridCell::firstFrame, &context, [&, i]() {
+                if (firstAt.at(i) >= 0) return;
+                firstAt[i] = clock.nsecsElapsed();
+                if (--remaining == 0) loop.quit();
+            });
+        }
+    };
+
+    if (waitForLaunch) {
+        QObject::connect(&window, &MainWindow::gridLaunched, &context, [&]() {
+            phase.launchMs = clock.nsecsElapsed() / 1.0e6;
+            attach();
+        });
+    } else {
+        attach();
+    }
+
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    QObject::connect(&timeout, &QTimer::timeout, &loop, [&loop]() { loop.exit(1); });
+
+    clock.start();
+    trigger();
+    timeout.start(GridBenchConstants::kTimeoutMs);
+    phase.ok = remaining == 0 || loop.exec() == 0;
+
+    for (qint64 at : std::as_const(firstAt)) {
+        if (at >= 0) phase.cellMs.append(at / 1.0e6);
+    }
+    return phase;
+}
+
+void merge(QJsonObject &into, const QJsonObject &from)
+{
+    for (auto it = from.begin(); it != from.end(); ++it) {
+        into[it.key()] = it.value();
+    }
+}
+
+void settle(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+bool waitForIndex(const QString &root)
+{
+    MediaIndex &index = MediaIndex::instance();
+    index.ensureIndexed(root);
+    if (index.isReady(root)) return true;
+
+    QEventLoop loop;
+    QObject::connect(&index, &MediaIndex::indexReady, &loop, [&](const QString &readyRoot) {
+        if (readyRoot == root) loop.quit();
+    });
+    QTimer::singleShot(GridBenchConstants::kTimeoutMs, &loop, [&loop]() { loop.exit(1); });
+    return loop.exec() == 0;
+}
+
+} // namespace
+
+bool GridBench::run(BenchReport &report, const QString &clipDir, const Options &options)
+{
+    const QString root = MediaIndex::normalizedRoot(clipDir);
+    MainWindow window(root);
+    if (options.headless) {
+        window.setHeadless(true);
+    } else {
+        window.show();
+    }
+
+    // Startup is measured against a warm index, as on any start but the first
+    if (!waitForIndex(root)) {
+        qWarning() << "GridBench: indexing" << root << "timed out";
+        return false;
+    }
+    settle(GridBenchConstants::kSettleMs);
+
+    const Config &cfg = Config::instance();
+    bool ok = true;
+    for (int n : options.sizes) {
+        QVector<double> launchMs;
+        QVector<double> firstCellMs;
+        QVector<double> allCellsMs;
+        QVector<double> gapMs;       // Every cell of every switch
+        QVector<double> switchMs;    // Slowest cell per switch
+        int failures = 0;
+
+        for (int run = 0; run < options.runs; ++run) {
+            const Phase start = measure(window, true, [&]() { window.startGrid(n, n); });
+            if (!start.ok || start.cellMs.isEmpty()) {
+                qWarning() << "GridBench:" << n << "x" << n << "start timed out with"
+                           << start.cellMs.size() << "cells playing";
+                ++failures;
+                window.stopGrid();
+                continue;
+            }
+            launchMs.append(start.launchMs);
+            firstCellMs.append(*std::min_element(start.cellMs.cbegin(), start.cellMs.cend()));
+            allCellsMs.append(*std::max_element(start.cellMs.cbegin(), start.cellMs.cend()));
+
+            for (int round = 0; round < options.switches; ++round) {
+                settle(GridBenchConstants::kSettleMs);
+                const Phase next = measure(window, false, [&]() { window.nextAll(); });
+                if (!next.ok) {
+                    ++failures;
+                    continue;
+                }
+                gapMs += next.cellMs;
+                switchMs.append(*std::max_element(next.cellMs.cbegin(), next.cellMs.cend()));
+            }
+
+            window.stopGrid();
+            settle(GridBenchConstants::kSettleMs);
+        }
+
+        QJsonObject params;
+        params["rows"] = n;
+        params["cols"] = n;
+        params["hwdec_budget"] = cfg.hwdecBudget();
+        params["wall_renderer"] = !options.headless && cfg.wallRendererEnabled();
+        params["headless"] = options.headless;
+        params["skipper"] = cfg.skipperEnabled();
+
+        QJsonObject start = BenchReport::summarize(allCellsMs, "all_playing_ms_");
+        merge(start, BenchReport::summarize(firstCellMs, "first_frame_ms_"));
+        merge(start, BenchReport::summarize(launchMs, "launch_ms_"));
+        start["failures"] = failures;
+        report.add("grid", "start", params, start);
+
+        QJsonObject gaps = BenchReport::summarize(gapMs, "gap_ms_");
+        merge(gaps, BenchReport::summarize(switchMs, "switch_ms_"));
+        report.add("grid", "next_gap", params, gaps);
+
+        ok = ok && failures == 0;
+    }
+
+    window.close();
+    return ok;
+}
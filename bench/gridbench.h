@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+class BenchReport;
+
+namespace GridBenchConstants {
+    inline constexpr int kTimeoutMs = 60000;   // Per grid start or switch; a cell that never plays fails the run
+    inline constexpr int kSettleMs = 1000;     // Between phases, so the scheduler's rebalance is done
+}
+
+// Drives a real MainWindow over generated clips: time from startGrid() to
+// the first frame of every cell, then the gap between nextAll() and each
+// cell's first frame of its next file. Needs a GL capable display unless
+// headless, where playback-restart under vo=null stands in for the frame.
+class GridBench
+{
+public:
+    struct Options {
+        QList<int> sizes{2, 4, 6, 8, 10};   // n for an n x n grid
+        int runs = 3;
+        int switches = 5;                   // nextAll() rounds per run
+        bool headless = false;              // See MainWindow::setHeadless()
+    };
+
+    static bool run(BenchReport &report, const QString &clipDir, const Options &options);
+};
@@ -0,0 +1,148 @@
+#include "mediagenerator.h"
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <QDebug>
+
+namespace {
+
+bool isStamped(const QString &dir, const QString &key)
+{
+    QFile stamp(dir + "/.complete");
+    return stamp.open(QIODevice::ReadOnly) && stamp.readAll().trimmed() == key.toUtf8();
+}
+
+void writeStamp(const QString &dir, const QString &key)
+{
+    QFile stamp(dir + "/.complete");
+    if (stamp.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        stamp.write(key.toUtf8() + '\n');
+    }
+}
+
+void setError(QString *error, const QString &message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+} // namespace
+
+QString MediaGenerator::ClipSpec::key() const
+{
+    return QString("clips-%1-%2x%3-%4s-%5fps-%6")
+        .arg(codec).arg(size.width()).arg(size.height()).arg(seconds).arg(fps).arg(count);
+}
+
+QStringList MediaGenerator::encoderArgs(const QString &codec)
+{
+    // Fastest presets; the bench measures playback, not the encoder
+    if (codec == "h264") return {"-c:v", "libx264", "-preset", "veryfast"};
+    if (codec == "hevc") return {"-c:v", "libx265", "-preset", "ultrafast"};
+    if (codec == "vp9") return {"-c:v", "libvpx-vp9", "-deadline", "realtime", "-cpu-used", "8", "-b:v", "0", "-crf", "35"};
+    if (codec == "av1") return {"-c:v", "libsvtav1", "-preset", "12"};
+    return {};
+}
+
+QString MediaGenerator::ensureClips(const QString &workDir, const ClipSpec &spec,
+                                    const QString &ffmpeg, QString *error)
+{
+    const QString key = spec.key();
+    const QString dir = workDir + "/" + key;
+    if (isStamped(dir, key)) {
+        return dir;
+    }
+
+    const QStringList encoder = encoderArgs(spec.codec);
+    if (encoder.isEmpty()) {
+        setError(error, "Unknown codec: " + spec.codec);
+        return QString();
+    }
+    if (!QDir().mkpath(dir)) {
+        setError(error, "Cannot create " + dir);
+        return QString();
+    }
+
+    // Different patterns and hues, so cells are told apart on screen
+    static const QStringList sources = {"testsrc2", "smptehdbars", "testsrc", "rgbtestsrc"};
+    const QString size = QString("%1x%2").arg(spec.size.width()).arg(spec.size.height());
+
+    qDebug() << "MediaGenerator: encoding" << spec.count << "clips into" << dir;
+    for (int i = 0; i < spec.count; ++i) {
+        const QString name = QString("clip_%1.mkv").arg(i, 4, 10, QChar('0'));
+        if (QFile::exists(dir + "/" + name)) {
+            continue;   // Left over from an interrupted run
+        }
+
+        QStringList args = {"-hide_banner", "-loglevel", "error", "-y",
+            "-f", "lavfi", "-i", QString("%1=size=%2:rate=%3:duration=%4")
+                .arg(sources.at(i % sources.size()), size).arg(spec.fps).arg(spec.seconds),
+            "-f", "lavfi", "-i", QString("sine=frequency=%1:duration=%2").arg(220 + 20 * (i % 32)).arg(spec.seconds),
+            "-vf", QString("hue=h=%1,format=yuv420p").arg((i * 37) % 360),
+            "-g", QString::number(spec.fps * 2)};
+        args += encoder;
+        args += {"-c:a", "aac", "-shortest", "-f", "matroska", dir + "/" + name + ".part"};
+
+        QProcess process;
+        process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        process.start(ffmpeg, args);
+        if (!process.waitForFinished(GeneratorConstants::kEncodeTimeoutMs)
+            || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+            process.kill();
+            QFile::remove(dir + "/" + name + ".part");
+            setError(error, QString("%1 failed on %2: %3").arg(ffmpeg, name,
+                process.error() == QProcess::FailedToStart ? QString("not found") : "exit code " + QString::number(process.exitCode())));
+            return QString();
+        }
+        QFile::rename(dir + "/" + name + ".part", dir + "/" + name);
+    }
+
+    writeStamp(dir, key);
+    return dir;
+}
+
+const QStringList& MediaGenerator::nameWords()
+{
+    static const QStringList words = {
+        "alpha", "beach", "city", "delta", "evening", "forest", "garden", "harbor",
+        "island", "journey", "kitchen", "lake", "mountain", "night", "ocean", "party"
+    };
+    return words;
+}
+
+QString MediaGenerator::ensureFileTree(const QString &workDir, int count, QString *error)
+{
+    const QString key = QString("tree-%1").arg(count);
+    const QString root = workDir + "/" + key;
+    if (isStamped(root, key)) {
+        return root;
+    }
+
+    // One image in eight, as in a typical mixed library
+    static const QStringList extensions = {"mkv", "mp4", "webm", "mov", "mkv", "mp4", "avi", "jpg"};
+    const QStringList &words = nameWords();
+
+    qDebug() << "MediaGenerator: creating" << count << "files under" << root;
+    QDir().mkpath(root);
+    for (int i = 0; i < count; ++i) {
+        const QString dir = QString("%1/d%2").arg(root).arg(i / GeneratorConstants::kFilesPerDirectory, 4, 10, QChar('0'));
+        if (i % GeneratorConstants::kFilesPerDirectory == 0 && !QDir().mkpath(dir)) {
+            setError(error, "Cannot create " + dir);
+            return QString();
+        }
+
+        const QString name = QString("%1 %2 %3.%4")
+            .arg(words.at(i % words.size()), words.at((i / words.size()) % words.size()))
+            .arg(i, 7, 10, QChar('0'))
+            .arg(extensions.at(i % extensions.size()));
+        QFile file(dir + "/" + name);
+        if (!file.open(QIODevice::WriteOnly)) {
+            setError(error, "Cannot create " + file.fileName() + ": " + file.errorString());
+            return QString();
+        }
+    }
+
+    writeStamp(root, key);
+    return root;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+namespace GeneratorConstants {
+    inline constexpr int kFilesPerDirectory = 1000;    // Scan trees; about what a real library has per folder
+    inline constexpr int kEncodeTimeoutMs = 300000;    // Per clip; software AV1 at 4K is slow
+}
+
+// Synthetic inputs for goobert_bench, generated once under the work directory
+// and reused while their spec is unchanged (a ".complete" stamp records it).
+class MediaGenerator
+{
+public:
+    struct ClipSpec {
+        int count = 100;               // Enough for a 10x10 grid without repeats
+        QString codec = "h264";        // h264, hevc, vp9 or av1
+        QSize size{1920, 1080};
+        int seconds = 10;
+        int fps = 30;
+
+        [[nodiscard]] QString key() const;   // Directory name, e.g. "clips-h264-1920x1080-10s-30fps-100"
+    };
+
+    // Short clips from ffmpeg's lavfi test sources, with a sine audio track and
+    // a keyframe every two seconds. Returns the clip directory, or empty on error.
+    [[nodiscard]] static QString ensureClips(const QString &workDir, const ClipSpec &spec,
+                                             const QString &ffmpeg, QString *error);
+
+    // count empty files with media names (videos and some images),
+    // kFilesPerDirectory per subdirectory. Returns the tree's root.
+    [[nodiscard]] static QString ensureFileTree(const QString &workDir, int count, QString *error);
+
+    // Words the scan tree's file names are made of, for filter queries
+    [[nodiscard]] static const QStringList& nameWords();
+
+    [[nodiscard]] static QStringList encoderArgs(const QString &codec);   // Empty for unknown codecs
+};
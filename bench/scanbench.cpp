@@ -0,0 +1,96 @@
+#include "scanbench.h"
+#include "benchreport.h"
+#include "mediagenerator.h"
+#include "filescanner.h"
+#include "filterengine.h"
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QDebug>
+
+namespace {
+
+double perSecond(qint64 items, double ms)
+{
+    return ms > 0.0 ? items * 1000.0 / ms : 0.0;
+}
+
+} // namespace
+
+bool ScanBench::run(BenchReport &report, const QString &workDir, const Options &options)
+{
+    const QStringList &words = MediaGenerator::nameWords();
+    // One common term, an AND with a negation, and a phrase
+    const QStringList queries = {
+        words.at(1),
+        words.at(2) + " " + words.at(3) + " -" + words.at(4),
+        "\"" + words.at(5) + " " + words.at(6) + "\""
+    };
+
+    for (int size : options.sizes) {
+        QString error;
+        const QString root = MediaGenerator::ensureFileTree(workDir, size, &error);
+        if (root.isEmpty()) {
+            qWarning() << "ScanBench:" << error;
+            return false;
+        }
+
+        QVector<double> scanMs;
+        QVector<double> buildMs;
+        QVector<QVector<double>> filterMs(queries.size());
+        qint64 found = 0;
+        QVector<int> matches(queries.size(), 0);
+
+        // The first pass only warms the page cache and is not reported
+        for (int pass = 0; pass <= options.runs; ++pass) {
+            QStringList paths;
+            paths.reserve(size);
+
+            QElapsedTimer timer;
+            timer.start();
+            FileScanner().scanParallel({root}, [&paths](const FileScanner::ScanBatch &batch) {
+                for (const FileScanner::Entry &entry : batch.files) {
+                    paths.append(entry.path);
+                }
+            });
+            const qint64 scanNs = timer.nsecsElapsed();
+
+            timer.restart();
+            const FilterEngine engine(paths);
+            const qint64 buildNs = timer.nsecsElapsed();
+
+            if (pass == 0) continue;
+            found = paths.size();
+            scanMs.append(scanNs / 1.0e6);
+            buildMs.append(buildNs / 1.0e6);
+
+            for (qsizetype q = 0; q < queries.size(); ++q) {
+                timer.restart();
+                const QVector<int> hits = engine.match(FilterEngine::parse(queries.at(q)));
+                filterMs[q].append(timer.nsecsElapsed() / 1.0e6);
+                matches[q] = hits.size();
+            }
+        }
+
+        QJsonObject params;
+        params["files"] = size;
+
+        QJsonObject scan = BenchReport::summarize(scanMs, "ms_");
+        scan["files_found"] = found;
+        scan["files_per_sec"] = perSecond(found, scan["ms_median"].toDouble());
+        report.add("scan", "scan_parallel", params, scan);
+
+        QJsonObject build = BenchReport::summarize(buildMs, "ms_");
+        build["files_per_sec"] = perSecond(found, build["ms_median"].toDouble());
+        report.add("scan", "filter_build", params, build);
+
+        for (qsizetype q = 0; q < queries.size(); ++q) {
+            QJsonObject queryParams = params;
+            queryParams["query"] = queries.at(q);
+            QJsonObject filter = BenchReport::summarize(filterMs.at(q), "ms_");
+            filter["matches"] = matches.at(q);
+            filter["files_per_sec"] = perSecond(found, filter["ms_median"].toDouble());
+            report.add("scan", "filter_match", queryParams, filter);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+class BenchReport;
+
+// FileScanner and FilterEngine throughput over synthetic trees of empty
+// files. The trees are created once and the page cache is warm after the
+// first pass, so results measure the scanner, not the disk.
+class ScanBench
+{
+public:
+    struct Options {
+        QList<int> sizes{10000, 100000, 1000000};
+        int runs = 3;
+    };
+
+    static bool run(BenchReport &report, const QString &workDir, const Options &options);
+};
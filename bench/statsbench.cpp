@@ -0,0 +1,100 @@
+#include "statsbench.h"
+#include "benchreport.h"
+#include "statsmanager.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QJsonObject>
+#include <QStringList>
+#include <QDebug>
+#include <algorithm>
+
+bool StatsBench::run(BenchReport &report, const Options &options)
+{
+    StatsManager &stats = StatsManager::instance();
+
+    // Every bench run starts from an empty database; only ever under Qt's test-mode paths
+    if (QStandardPaths::isTestModeEnabled() && !stats.isInitialized()) {
+        for (const char *suffix : {"", "-wal", "-shm"}) {
+            QFile::remove(StatsManager::databasePath() + suffix);
+        }
+    }
+    if (!stats.initialize()) {
+        qWarning() << "StatsBench: cannot open the stats database";
+        return false;
+    }
+
+    const int cells = std::max(1, options.cells);
+    QStringList paths;
+    for (int i = 0; i < cells * StatsBenchConstants::kFilesPerCell; ++i) {
+        paths.append(QString("/bench/stats/d%1/file_%2.mkv").arg(i % 64).arg(i, 6, 10, QChar('0')));
+    }
+
+    QVector<double> queueMs;
+    QVector<double> totalMs;
+    QVector<double> dropped;
+    QVector<double> peakPending;
+
+    for (int run = 0; run < options.runs; ++run) {
+        const quint64 droppedBefore = stats.droppedWrites();
+        int pendingMax = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < options.events; ++i) {
+            const int cell = i % cells;
+            const int row = cell / 10;
+            const int col = cell % 10;
+            const int step = i / cells;
+            const QString &path = paths.at(cell * StatsBenchConstants::kFilesPerCell
+                                           + (step / StatsBenchConstants::kEventsPerSession) % StatsBenchConstants::kFilesPerCell);
+            const double position = (step % StatsBenchConstants::kEventsPerSession) * 2.0;
+
+            if (step % StatsBenchConstants::kEventsPerSession == 0) {
+                stats.startWatching(row, col, path, 120.0, false);
+            }
+            switch (i % 4) {
+            case 0:
+                stats.logPositionSample(path, position / 120.0);
+                break;
+            case 1:
+                stats.updatePosition(row, col, position);
+                stats.logPositionSample(path, position / 120.0);
+                break;
+            case 2:
+                stats.logSkipEvent(path, position, position + 30.0, "next");
+                break;
+            default:
+                stats.logPauseEvent(path, position, step % 2 == 0);
+                break;
+            }
+
+            if (i % 1024 == 0) {
+                pendingMax = std::max(pendingMax, stats.pendingWrites());
+            }
+        }
+        stats.stopAll();
+        queueMs.append(timer.nsecsElapsed() / 1.0e6);
+
+        stats.flushWrites();
+        totalMs.append(timer.nsecsElapsed() / 1.0e6);
+        dropped.append(static_cast<double>(stats.droppedWrites() - droppedBefore));
+        peakPending.append(pendingMax);
+    }
+
+    QJsonObject params;
+    params["events"] = options.events;
+    params["cells"] = cells;
+
+    QJsonObject metrics = BenchReport::summarize(totalMs, "ms_");
+    const double queueMedian = BenchReport::summarize(queueMs, "q_")["q_median"].toDouble();
+    const double totalMedian = metrics["ms_median"].toDouble();
+    const double droppedMax = dropped.isEmpty() ? 0.0 : *std::max_element(dropped.cbegin(), dropped.cend());
+    metrics["queue_ms_median"] = queueMedian;
+    metrics["queued_per_sec"] = queueMedian > 0.0 ? options.events * 1000.0 / queueMedian : 0.0;
+    metrics["committed_per_sec"] = totalMedian > 0.0 ? (options.events - droppedMax) * 1000.0 / totalMedian : 0.0;
+    metrics["dropped_max"] = droppedMax;
+    metrics["pending_peak"] = peakPending.isEmpty() ? 0.0 : *std::max_element(peakPending.cbegin(), peakPending.cend());
+    report.add("stats", "event_throughput", params, metrics);
+    return true;
+}
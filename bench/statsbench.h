@@ -0,0 +1,24 @@
+#pragma once
+
+class BenchReport;
+
+namespace StatsBenchConstants {
+    inline constexpr int kFilesPerCell = 20;       // Distinct paths, so file rows and rollups see real cardinality
+    inline constexpr int kEventsPerSession = 50;   // A cell moves to its next file this often
+}
+
+// StatsManager under a wall's worth of load: skip, pause and position events
+// with session churn from many cells, as fast as the GUI thread can queue them.
+// Reports the queueing rate, the committed rate through flushWrites(), and
+// what the bounded writer queue dropped.
+class StatsBench
+{
+public:
+    struct Options {
+        int events = 200000;
+        int cells = 100;
+        int runs = 3;
+    };
+
+    static bool run(BenchReport &report, const Options &options);
+};
@@ -8,10 +8,16 @@ comprehensive statistics with modern visualizations.
 
 import sqlite3
 import os
+import hashlib
+import struct
 import subprocess
+import threading
+import atexit
+import queue
+from contextlib import closing
 from datetime import datetime, timedelta
 from pathlib import Path
-from flask import Flask, render_template, jsonify, request
+from flask import Flask, render_template, jsonify, request, send_from_directory, abort, g
 from flask_cors import CORS
 
 app = Flask(__name__)
@@ -20,14 +26,93 @@ CORS(app)
 # Database path
 DB_PATH = os.path.expanduser("~/.config/goobert/goobert.db")
 
+# rollup_histograms layout, see StatsRollups in statsrollups.h
+HISTOGRAM_BUCKETS = 100
+HISTOGRAM_ALL_FILES = 0
+HISTOGRAM_POSITION = 0
+HISTOGRAM_SKIP = 1
+
+# Thumbnail store written by Goobert's ThumbnailCache
+THUMBNAIL_DIR = os.path.join(os.environ.get("XDG_CACHE_HOME", os.path.expanduser("~/.cache")),
+                             "goobert", "thumbnails")
+
+
+# Prepared statements kept per reader connection
+STATEMENT_CACHE_SIZE = 256
+# Long-lived read-only connections shared by all request threads
+READER_POOL_SIZE = 4
+
+_reader_pool = queue.LifoQueue()
+_readers = []
+_readers_lock = threading.Lock()
+
+
+def _open_reader():
+    conn = sqlite3.connect(Path(DB_PATH).as_uri() + '?mode=ro', uri=True,
+                           cached_statements=STATEMENT_CACHE_SIZE, check_same_thread=False)
+    conn.row_factory = sqlite3.Row
+    conn.execute("PRAGMA query_only=1")
+    return conn
+
 
 def get_db():
-    """Get database connection"""
+    """Get a read-only connection for the current request
+
+    Connections come from a small pool that outlives requests, so endpoints
+    reuse their prepared statements even though the dev server runs every
+    request on a new thread. At most READER_POOL_SIZE are ever opened; the
+    request holds its connection until teardown returns it. Each query
+    reads the latest WAL snapshot without blocking Goobert.
+    """
+    conn = g.get('reader')
+    if conn is not None:
+        return conn
+
+    try:
+        conn = _reader_pool.get_nowait()
+    except queue.Empty:
+        with _readers_lock:
+            if len(_readers) < READER_POOL_SIZE:
+                conn = _open_reader()
+                _readers.append(conn)
+        if conn is None:
+            conn = _reader_pool.get()
+    g.reader = conn
+    return conn
+
+
+@app.teardown_appcontext
+def release_db(exception):
+    conn = g.pop('reader', None)
+    if conn is not None:
+        conn.rollback()   # No read transaction may outlive its request
+        _reader_pool.put(conn)
+
+
+@atexit.register
+def close_readers():
+    with _readers_lock:
+        for conn in _readers:
+            conn.close()
+        _readers.clear()
+
+
+def get_write_db():
+    """Get a short-lived writable connection; the caller commits and closes it (use closing())"""
     conn = sqlite3.connect(DB_PATH)
     conn.row_factory = sqlite3.Row
     return conn
 
 
+def read_histogram(cur, kind, file_id=HISTOGRAM_ALL_FILES):
+    """Decode one rollup_histograms row into HISTOGRAM_BUCKETS counts"""
+    cur.execute("SELECT buckets FROM rollup_histograms WHERE file_id = ? AND kind = ?", (file_id, kind))
+    row = cur.fetchone()
+    if not row or len(row[0]) != HISTOGRAM_BUCKETS * 4:
+        return [0] * HISTOGRAM_BUCKETS
+    return list(struct.unpack(f'<{HISTOGRAM_BUCKETS}I', row[0]))
+
+
 def format_duration(ms):
     """Format milliseconds to human readable string"""
     if ms is None:
@@ -55,63 +140,51 @@ def api_summary():
     conn = get_db()
     cur = conn.cursor()
 
-    # Total accumulated watch time (what we were showing before)
-    cur.execute("SELECT COALESCE(SUM(total_watch_ms), 0) FROM file_stats")
+    # Goobert keeps rollup_* tables current, so none of this scans the raw history
+    cur.execute("SELECT COALESCE(SUM(watch_ms), 0) FROM rollup_file_types")
     accumulated_watch_ms = cur.fetchone()[0]
 
     # Real elapsed time - based on actual session time spans
     # This accounts for parallel playback correctly
     cur.execute("""
         SELECT
-            MIN(started_at) as first_start,
-            MAX(ended_at) as last_end
-        FROM watch_sessions
-        WHERE started_at > 0
+            MIN(first_start) as first_start,
+            MAX(last_end) as last_end,
+            COALESCE(SUM(session_count), 0) as sessions,
+            COALESCE(SUM(watch_ms), 0) as session_ms,
+            COALESCE(SUM(skip_count), 0) as skips,
+            COALESCE(SUM(screenshot_count), 0) as screenshots
+        FROM rollup_daily
     """)
     row = cur.fetchone()
     if row and row['first_start'] and row['last_end']:
         real_elapsed_ms = row['last_end'] - row['first_start']
     else:
         real_elapsed_ms = 0
+    total_sessions = row['sessions']
+    avg_session = row['session_ms'] / total_sessions if total_sessions > 0 else 0
+    total_skips = row['skips']
+    total_screenshots = row['screenshots']
 
-    # Today's real time (unique time ranges)
-    today_start = int(datetime.now().replace(hour=0, minute=0, second=0).timestamp() * 1000)
+    # Today's real time (unique time ranges) and sessions
     cur.execute("""
-        SELECT
-            MIN(started_at) as first_start,
-            MAX(ended_at) as last_end
-        FROM watch_sessions
-        WHERE started_at >= ?
-    """, (today_start,))
+        SELECT first_start, last_end, watch_ms, session_count
+        FROM rollup_daily
+        WHERE day = date('now', 'localtime')
+    """)
     row = cur.fetchone()
     today_real_ms = (row['last_end'] - row['first_start']) if row and row['first_start'] and row['last_end'] else 0
-
-    # Session-based stats for today
-    cur.execute("""
-        SELECT COALESCE(SUM(duration_ms), 0), COUNT(*)
-        FROM watch_sessions
-        WHERE started_at >= ?
-    """, (today_start,))
-    row = cur.fetchone()
-    today_accumulated_ms = row[0]
-    today_sessions = row[1]
+    today_accumulated_ms = row['watch_ms'] if row else 0
+    today_sessions = row['session_count'] if row else 0
 
     # Files tracked
-    cur.execute("SELECT COUNT(*) FROM file_stats WHERE total_watch_ms > 0")
+    cur.execute("SELECT COALESCE(SUM(file_count), 0) FROM rollup_directories")
     files_tracked = cur.fetchone()[0]
 
-    # Total sessions
-    cur.execute("SELECT COUNT(*) FROM watch_sessions")
-    total_sessions = cur.fetchone()[0]
-
-    # Average session length
-    cur.execute("SELECT AVG(duration_ms) FROM watch_sessions WHERE duration_ms > 0")
-    avg_session = cur.fetchone()[0] or 0
-
     # Peak hour
     cur.execute("""
-        SELECT hour_of_day, SUM(duration_ms) as total
-        FROM watch_sessions
+        SELECT hour_of_day, SUM(watch_ms) as total
+        FROM rollup_hourly
         GROUP BY hour_of_day
         ORDER BY total DESC
         LIMIT 1
@@ -121,8 +194,8 @@ def api_summary():
 
     # Peak day
     cur.execute("""
-        SELECT day_of_week, SUM(duration_ms) as total
-        FROM watch_sessions
+        SELECT day_of_week, SUM(watch_ms) as total
+        FROM rollup_hourly
         GROUP BY day_of_week
         ORDER BY total DESC
         LIMIT 1
@@ -132,18 +205,9 @@ def api_summary():
     days = ['', 'Mon', 'Tue', 'Wed', 'Thu', 'Fri', 'Sat', 'Sun']
     peak_day_name = days[peak_day] if 1 <= peak_day <= 7 else 'N/A'
 
-    # Total skips and screenshots
-    cur.execute("SELECT COUNT(*) FROM skip_events")
-    total_skips = cur.fetchone()[0]
-
-    cur.execute("SELECT COUNT(*) FROM screenshot_events")
-    total_screenshots = cur.fetchone()[0]
-
     # Parallelism factor (how much parallel playback on average)
     parallelism = accumulated_watch_ms / real_elapsed_ms if real_elapsed_ms > 0 else 1
 
-    conn.close()
-
     return jsonify({
         'accumulated_watch_time': format_duration(accumulated_watch_ms),
         'accumulated_watch_ms': accumulated_watch_ms,
@@ -170,8 +234,8 @@ def api_hourly():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT hour_of_day, SUM(duration_ms) as total, COUNT(*) as sessions
-        FROM watch_sessions
+        SELECT hour_of_day, SUM(watch_ms) as total, SUM(session_count) as sessions
+        FROM rollup_hourly
         GROUP BY hour_of_day
         ORDER BY hour_of_day
     """)
@@ -185,8 +249,6 @@ def api_hourly():
             'sessions': row['sessions']
         }
 
-    conn.close()
-
     return jsonify({
         'labels': [f"{h:02d}:00" for h in range(24)],
         'watch_time': [hourly[h]['total_ms'] / 1000 / 60 for h in range(24)],  # minutes
@@ -201,8 +263,8 @@ def api_daily():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT day_of_week, SUM(duration_ms) as total, COUNT(*) as sessions
-        FROM watch_sessions
+        SELECT day_of_week, SUM(watch_ms) as total, SUM(session_count) as sessions
+        FROM rollup_hourly
         GROUP BY day_of_week
         ORDER BY day_of_week
     """)
@@ -216,8 +278,6 @@ def api_daily():
             'sessions': row['sessions']
         }
 
-    conn.close()
-
     return jsonify({
         'labels': days,
         'watch_time': [daily[d]['total_ms'] / 1000 / 60 for d in range(1, 8)],  # minutes
@@ -236,16 +296,15 @@ def api_timeline():
 
     cur.execute("""
         SELECT
-            date(started_at / 1000, 'unixepoch', 'localtime') as day,
-            SUM(duration_ms) as total_ms,
-            COUNT(*) as sessions,
-            MIN(started_at) as first_session,
-            MAX(ended_at) as last_session
-        FROM watch_sessions
-        WHERE started_at >= ?
-        GROUP BY day
+            day,
+            watch_ms as total_ms,
+            session_count as sessions,
+            first_start as first_session,
+            last_end as last_session
+        FROM rollup_daily
+        WHERE day >= ? AND session_count > 0
         ORDER BY day
-    """, (int((datetime.now() - timedelta(days=days)).timestamp() * 1000),))
+    """, ((datetime.now() - timedelta(days=days)).strftime('%Y-%m-%d'),))
 
     data = []
     for row in cur.fetchall():
@@ -257,8 +316,6 @@ def api_timeline():
             'sessions': row['sessions']
         })
 
-    conn.close()
-
     return jsonify(data)
 
 
@@ -280,11 +337,9 @@ def api_top_files():
             fs.duration_ms,
             fs.is_image,
             fs.last_position_ms,
-            COALESCE(skip_cnt.cnt, 0) as skip_count,
-            COALESCE(loop_cnt.cnt, 0) as loop_count
+            fs.skip_count,
+            (SELECT COUNT(*) FROM loop_events le WHERE le.file_id = fs.id) as loop_count
         FROM file_stats fs
-        LEFT JOIN (SELECT file_id, COUNT(*) as cnt FROM skip_events GROUP BY file_id) skip_cnt ON fs.id = skip_cnt.file_id
-        LEFT JOIN (SELECT file_id, COUNT(*) as cnt FROM loop_events GROUP BY file_id) loop_cnt ON fs.id = loop_cnt.file_id
         WHERE fs.total_watch_ms > 0
         ORDER BY fs.total_watch_ms DESC
         LIMIT ?
@@ -310,7 +365,6 @@ def api_top_files():
             'is_image': bool(row['is_image'])
         })
 
-    conn.close()
     return jsonify(files)
 
 
@@ -349,7 +403,6 @@ def api_recent_sessions():
             'hour': row['hour_of_day']
         })
 
-    conn.close()
     return jsonify(sessions)
 
 
@@ -360,36 +413,24 @@ def api_directories():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT
-            file_path,
-            total_watch_ms,
-            play_count
-        FROM file_stats
-        WHERE total_watch_ms > 0
+        SELECT d.path, r.watch_ms, r.play_count, r.file_count
+        FROM rollup_directories r
+        JOIN directories d ON d.id = r.directory_id
+        WHERE r.watch_ms > 0
+        ORDER BY r.watch_ms DESC
+        LIMIT 20
     """)
 
-    dir_stats = {}
-    for row in cur.fetchall():
-        dir_path = os.path.dirname(row['file_path'])
-        if dir_path not in dir_stats:
-            dir_stats[dir_path] = {'watch_ms': 0, 'play_count': 0, 'file_count': 0}
-        dir_stats[dir_path]['watch_ms'] += row['total_watch_ms']
-        dir_stats[dir_path]['play_count'] += row['play_count']
-        dir_stats[dir_path]['file_count'] += 1
-
-    # Sort by watch time
-    sorted_dirs = sorted(dir_stats.items(), key=lambda x: x[1]['watch_ms'], reverse=True)[:20]
-
-    conn.close()
+    rows = cur.fetchall()
 
     return jsonify([{
-        'directory': d[0],
-        'short_name': os.path.basename(d[0]) or d[0],
-        'watch_time': format_duration(d[1]['watch_ms']),
-        'watch_ms': d[1]['watch_ms'],
-        'play_count': d[1]['play_count'],
-        'file_count': d[1]['file_count']
-    } for d in sorted_dirs])
+        'directory': row['path'],
+        'short_name': os.path.basename(row['path']) or row['path'],
+        'watch_time': format_duration(row['watch_ms']),
+        'watch_ms': row['watch_ms'],
+        'play_count': row['play_count'],
+        'file_count': row['file_count']
+    } for row in rows])
 
 
 @app.route('/api/events')
@@ -457,7 +498,6 @@ def api_events():
     # Sort all events by timestamp
     events.sort(key=lambda x: x['timestamp'], reverse=True)
 
-    conn.close()
     return jsonify(events[:limit])
 
 
@@ -484,7 +524,6 @@ def api_grid_sessions():
             'filter': row['filter'] or '-'
         })
 
-    conn.close()
     return jsonify(sessions)
 
 
@@ -494,39 +533,22 @@ def api_completion_stats():
     conn = get_db()
     cur = conn.cursor()
 
-    # Files watched >90%
-    cur.execute("""
-        SELECT COUNT(*) FROM file_stats
-        WHERE duration_ms > 0
-        AND (last_position_ms * 100.0 / duration_ms) >= 90
-    """)
-    full_watch = cur.fetchone()[0]
-
-    # Files watched 10-90%
-    cur.execute("""
-        SELECT COUNT(*) FROM file_stats
-        WHERE duration_ms > 0
-        AND (last_position_ms * 100.0 / duration_ms) >= 10
-        AND (last_position_ms * 100.0 / duration_ms) < 90
-    """)
-    partial_watch = cur.fetchone()[0]
-
-    # Files watched <10%
+    # One pass over idx_file_stats_completion: full >= 90%, partial 10-90%, skipped < 10%
     cur.execute("""
-        SELECT COUNT(*) FROM file_stats
+        SELECT
+            COALESCE(SUM(CASE WHEN last_position_ms * 100.0 / duration_ms >= 90 THEN 1 ELSE 0 END), 0) as full_watch,
+            COALESCE(SUM(CASE WHEN last_position_ms * 100.0 / duration_ms >= 10
+                               AND last_position_ms * 100.0 / duration_ms < 90 THEN 1 ELSE 0 END), 0) as partial_watch,
+            COALESCE(SUM(CASE WHEN last_position_ms * 100.0 / duration_ms < 10 THEN 1 ELSE 0 END), 0) as skipped,
+            AVG(last_position_ms * 100.0 / duration_ms) as avg_completion
+        FROM file_stats
         WHERE duration_ms > 0
-        AND (last_position_ms * 100.0 / duration_ms) < 10
     """)
-    skipped = cur.fetchone()[0]
-
-    # Average completion rate
-    cur.execute("""
-        SELECT AVG(CASE WHEN duration_ms > 0 THEN (last_position_ms * 100.0 / duration_ms) ELSE 0 END)
-        FROM file_stats WHERE duration_ms > 0
-    """)
-    avg_completion = cur.fetchone()[0] or 0
-
-    conn.close()
+    row = cur.fetchone()
+    full_watch = row['full_watch']
+    partial_watch = row['partial_watch']
+    skipped = row['skipped']
+    avg_completion = row['avg_completion'] or 0
 
     return jsonify({
         'full_watch_count': full_watch,
@@ -542,25 +564,10 @@ def api_skip_heatmap():
     conn = get_db()
     cur = conn.cursor()
 
-    # Get skip positions as percentage of file duration
-    cur.execute("""
-        SELECT
-            CAST(se.from_position_ms * 100.0 / fs.duration_ms AS INTEGER) / 10 * 10 as bucket,
-            COUNT(*) as cnt
-        FROM skip_events se
-        JOIN file_stats fs ON se.file_id = fs.id
-        WHERE fs.duration_ms > 0
-        GROUP BY bucket
-        ORDER BY bucket
-    """)
-
-    # Initialize all buckets
+    # Wall-wide skip histogram in 1% buckets, folded into 10% steps
     heatmap = {i: 0 for i in range(0, 110, 10)}
-    for row in cur.fetchall():
-        bucket = min(100, max(0, row['bucket']))
-        heatmap[bucket] = row['cnt']
-
-    conn.close()
+    for pct, count in enumerate(read_histogram(cur, HISTOGRAM_SKIP)):
+        heatmap[pct // 10 * 10] += count
 
     return jsonify({
         'labels': [f"{i}%" for i in range(0, 110, 10)],
@@ -574,24 +581,10 @@ def api_position_heatmap():
     conn = get_db()
     cur = conn.cursor()
 
-    # Check if position_samples table exists
-    cur.execute("SELECT name FROM sqlite_master WHERE type='table' AND name='position_samples'")
-    if not cur.fetchone():
-        conn.close()
-        return jsonify({'labels': [], 'values': []})
-
-    cur.execute("""
-        SELECT position_pct, COUNT(*) as cnt
-        FROM position_samples
-        GROUP BY position_pct
-        ORDER BY position_pct
-    """)
-
+    # Wall-wide position histogram in 1% buckets, folded into 5% steps
     heatmap = {i: 0 for i in range(0, 105, 5)}
-    for row in cur.fetchall():
-        heatmap[row['position_pct']] = row['cnt']
-
-    conn.close()
+    for pct, count in enumerate(read_histogram(cur, HISTOGRAM_POSITION)):
+        heatmap[pct // 5 * 5] += count
 
     return jsonify({
         'labels': [f"{i}%" for i in range(0, 105, 5)],
@@ -605,40 +598,15 @@ def api_session_distribution():
     conn = get_db()
     cur = conn.cursor()
 
-    cur.execute("SELECT duration_ms FROM watch_sessions WHERE duration_ms > 0")
-
-    # Buckets: <30s, 30s-1m, 1-2m, 2-5m, 5-10m, 10-30m, 30m-1h, >1h
-    buckets = {
-        '<30s': 0,
-        '30s-1m': 0,
-        '1-2m': 0,
-        '2-5m': 0,
-        '5-10m': 0,
-        '10-30m': 0,
-        '30m-1h': 0,
-        '>1h': 0
-    }
+    # Buckets match RollupConstants::kSessionLengthBuckets (lower bound in seconds)
+    labels = {0: '<30s', 30: '30s-1m', 60: '1-2m', 120: '2-5m', 300: '5-10m',
+              600: '10-30m', 1800: '30m-1h', 3600: '>1h'}
+    buckets = {label: 0 for label in labels.values()}
 
+    cur.execute("SELECT bucket_sec, session_count FROM rollup_session_lengths")
     for row in cur.fetchall():
-        duration_sec = row['duration_ms'] / 1000
-        if duration_sec < 30:
-            buckets['<30s'] += 1
-        elif duration_sec < 60:
-            buckets['30s-1m'] += 1
-        elif duration_sec < 120:
-            buckets['1-2m'] += 1
-        elif duration_sec < 300:
-            buckets['2-5m'] += 1
-        elif duration_sec < 600:
-            buckets['5-10m'] += 1
-        elif duration_sec < 1800:
-            buckets['10-30m'] += 1
-        elif duration_sec < 3600:
-            buckets['30m-1h'] += 1
-        else:
-            buckets['>1h'] += 1
-
-    conn.close()
+        if row['bucket_sec'] in labels:
+            buckets[labels[row['bucket_sec']]] = row['session_count']
 
     return jsonify({
         'labels': list(buckets.keys()),
@@ -653,9 +621,8 @@ def api_file_type_breakdown():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT is_image, SUM(total_watch_ms) as total, COUNT(*) as count
-        FROM file_stats
-        GROUP BY is_image
+        SELECT is_image, watch_ms as total, file_count as count
+        FROM rollup_file_types
     """)
 
     video_ms = 0
@@ -671,8 +638,6 @@ def api_file_type_breakdown():
             video_ms = row['total'] or 0
             video_count = row['count']
 
-    conn.close()
-
     return jsonify({
         'video_time': format_duration(video_ms),
         'video_ms': video_ms,
@@ -690,9 +655,8 @@ def api_skip_types():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT skip_type, COUNT(*) as cnt
-        FROM skip_events
-        GROUP BY skip_type
+        SELECT skip_type, skip_count as cnt
+        FROM rollup_skip_types
         ORDER BY cnt DESC
     """)
 
@@ -700,8 +664,6 @@ def api_skip_types():
     for row in cur.fetchall():
         types[row['skip_type'] or 'unknown'] = row['cnt']
 
-    conn.close()
-
     return jsonify(types)
 
 
@@ -714,10 +676,9 @@ def api_concurrent_stats():
     # Average concurrent cells (estimated from parallelism factor)
     cur.execute("""
         SELECT
-            COALESCE(SUM(duration_ms), 0) as total,
-            (MAX(ended_at) - MIN(started_at)) as elapsed
-        FROM watch_sessions
-        WHERE started_at > 0
+            COALESCE(SUM(watch_ms), 0) as total,
+            (MAX(last_end) - MIN(first_start)) as elapsed
+        FROM rollup_daily
     """)
     row = cur.fetchone()
     avg_concurrent = (row['total'] / row['elapsed']) if row and row['elapsed'] else 1.0
@@ -738,8 +699,6 @@ def api_concurrent_stats():
             'watch_time': format_duration(row['total_ms'])
         })
 
-    conn.close()
-
     return jsonify({
         'average_concurrent': round(avg_concurrent, 2),
         'cell_usage': cells[:16]  # Top 16 cells
@@ -754,14 +713,12 @@ def api_weekly_trend():
     cur = conn.cursor()
 
     cur.execute("""
-        SELECT
-            strftime('%Y-W%W', started_at / 1000, 'unixepoch', 'localtime') as week,
-            SUM(duration_ms) as total
-        FROM watch_sessions
-        WHERE started_at >= ?
+        SELECT strftime('%Y-W%W', day) as week, SUM(watch_ms) as total
+        FROM rollup_daily
+        WHERE day >= ?
         GROUP BY week
         ORDER BY week
-    """, (int((datetime.now() - timedelta(weeks=weeks)).timestamp() * 1000),))
+    """, ((datetime.now() - timedelta(weeks=weeks)).strftime('%Y-%m-%d'),))
 
     data = []
     for row in cur.fetchall():
@@ -770,7 +727,6 @@ def api_weekly_trend():
             'minutes': row['total'] / 1000 / 60
         })
 
-    conn.close()
     return jsonify(data)
 
 
@@ -785,14 +741,12 @@ def api_monthly_trend():
     start_date = datetime.now() - timedelta(days=months * 30)
 
     cur.execute("""
-        SELECT
-            strftime('%Y-%m', started_at / 1000, 'unixepoch', 'localtime') as month,
-            SUM(duration_ms) as total
-        FROM watch_sessions
-        WHERE started_at >= ?
+        SELECT substr(day, 1, 7) as month, SUM(watch_ms) as total
+        FROM rollup_daily
+        WHERE day >= ?
         GROUP BY month
         ORDER BY month
-    """, (int(start_date.timestamp() * 1000),))
+    """, (start_date.strftime('%Y-%m-%d'),))
 
     data = []
     for row in cur.fetchall():
@@ -801,7 +755,6 @@ def api_monthly_trend():
             'minutes': row['total'] / 1000 / 60
         })
 
-    conn.close()
     return jsonify(data)
 
 
@@ -814,7 +767,6 @@ def api_favorites():
     # Check if favorites table exists
     cur.execute("SELECT name FROM sqlite_master WHERE type='table' AND name='favorites'")
     if not cur.fetchone():
-        conn.close()
         return jsonify([])
 
     cur.execute("""
@@ -837,7 +789,6 @@ def api_favorites():
             'added_at': datetime.fromtimestamp(row['added_at'] / 1000).strftime('%Y-%m-%d %H:%M') if row['added_at'] else 'Unknown'
         })
 
-    conn.close()
     return jsonify(favorites)
 
 
@@ -850,7 +801,11 @@ def api_toggle_favorite():
     if not file_path:
         return jsonify({'error': 'No path provided'}), 400
 
-    conn = get_db()
+    with closing(get_write_db()) as conn:
+        return toggle_favorite(conn, file_path)
+
+
+def toggle_favorite(conn, file_path):
     cur = conn.cursor()
 
     # Check if favorites table exists, create if not
@@ -867,7 +822,6 @@ def api_toggle_favorite():
     cur.execute("SELECT id FROM file_stats WHERE file_path = ?", (file_path,))
     row = cur.fetchone()
     if not row:
-        conn.close()
         return jsonify({'error': 'File not found'}), 404
 
     file_id = row['id']
@@ -884,8 +838,6 @@ def api_toggle_favorite():
         is_favorite = True
 
     conn.commit()
-    conn.close()
-
     return jsonify({'is_favorite': is_favorite})
 
 
@@ -895,55 +847,27 @@ def api_directory_analysis():
     conn = get_db()
     cur = conn.cursor()
 
-    # Get all files grouped by directory
     cur.execute("""
-        SELECT file_path, total_watch_ms, play_count
-        FROM file_stats
-        WHERE total_watch_ms > 0
+        SELECT d.path, r.watch_ms, r.play_count, r.file_count, r.session_count
+        FROM rollup_directories r
+        JOIN directories d ON d.id = r.directory_id
+        WHERE r.watch_ms > 0
+        ORDER BY r.watch_ms DESC
+        LIMIT 20
     """)
 
-    dir_stats = {}
-    for row in cur.fetchall():
-        dir_path = os.path.dirname(row['file_path'])
-        if dir_path not in dir_stats:
-            dir_stats[dir_path] = {
-                'watch_ms': 0,
-                'play_count': 0,
-                'file_count': 0,
-                'session_count': 0
-            }
-        dir_stats[dir_path]['watch_ms'] += row['total_watch_ms']
-        dir_stats[dir_path]['play_count'] += row['play_count']
-        dir_stats[dir_path]['file_count'] += 1
-
-    # Get session counts per directory
-    cur.execute("""
-        SELECT fs.file_path, COUNT(*) as sessions
-        FROM watch_sessions ws
-        JOIN file_stats fs ON ws.file_id = fs.id
-        GROUP BY fs.file_path
-    """)
-
-    for row in cur.fetchall():
-        dir_path = os.path.dirname(row['file_path'])
-        if dir_path in dir_stats:
-            dir_stats[dir_path]['session_count'] += row['sessions']
-
-    # Sort and format
-    sorted_dirs = sorted(dir_stats.items(), key=lambda x: x[1]['watch_ms'], reverse=True)[:20]
-
-    conn.close()
+    rows = cur.fetchall()
 
     return jsonify([{
-        'directory': d[0],
-        'short_name': os.path.basename(d[0]) or d[0],
-        'watch_time': format_duration(d[1]['watch_ms']),
-        'watch_ms': d[1]['watch_ms'],
-        'play_count': d[1]['play_count'],
-        'file_count': d[1]['file_count'],
-        'session_count': d[1]['session_count'],
-        'avg_session_per_file': round(d[1]['session_count'] / d[1]['file_count'], 1) if d[1]['file_count'] > 0 else 0
-    } for d in sorted_dirs])
+        'directory': row['path'],
+        'short_name': os.path.basename(row['path']) or row['path'],
+        'watch_time': format_duration(row['watch_ms']),
+        'watch_ms': row['watch_ms'],
+        'play_count': row['play_count'],
+        'file_count': row['file_count'],
+        'session_count': row['session_count'],
+        'avg_session_per_file': round(row['session_count'] / row['file_count'], 1) if row['file_count'] > 0 else 0
+    } for row in rows])
 
 
 @app.route('/api/open-mpv', methods=['POST'])
@@ -965,6 +889,31 @@ def api_open_mpv():
         return jsonify({'error': str(e)}), 500
 
 
+def thumbnail_key(path):
+    """Store key for a media file; mirrors ThumbnailCache::keyFor()"""
+    st = os.stat(path)
+    identity = f"{path}\n{st.st_size}\n{st.st_mtime_ns // 1_000_000}".encode('utf-8')
+    return hashlib.sha1(identity).hexdigest()
+
+
+@app.route('/thumbnails/<path:name>')
+def thumbnail_file(name):
+    """Serve a stored thumbnail or sprite by key (<ab>/<key>.jpg)"""
+    return send_from_directory(THUMBNAIL_DIR, name, max_age=86400)
+
+
+@app.route('/api/thumbnail')
+def api_thumbnail():
+    """Thumbnail (or ?kind=sprite preview sprite) for a media path, if Goobert generated one"""
+    path = request.args.get('path')
+    if not path or not os.path.isfile(path):
+        abort(404)
+
+    key = thumbnail_key(path)
+    suffix = '.sprite.jpg' if request.args.get('kind') == 'sprite' else '.jpg'
+    return send_from_directory(THUMBNAIL_DIR, f"{key[:2]}/{key}{suffix}", max_age=86400)
+
+
 @app.route('/browse')
 @app.route('/browse/<path:folder_path>')
 def browse_folder(folder_path=''):
@@ -0,0 +1,99 @@
+#include "cellstatusstore.h"
+#include "perfmetrics.h"
+
+CellStatusStore& CellStatusStore::instance()
+{
+    static CellStatusStore instance;
+    return instance;
+}
+
+CellStatusStore::CellStatusStore()
+    : QObject(nullptr)
+{
+    m_timer.setInterval(CellStatusConstants::kTickIntervalMs);
+    m_timer.setTimerType(Qt::CoarseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &CellStatusStore::publish);
+}
+
+void CellStatusStore::reset(int rows, int cols)
+{
+    m_rows = rows;
+    m_cols = cols;
+    m_back.clear();
+    m_back.reserve(rows * cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            CellStatus status;
+            status.row = r;
+            status.col = c;
+            m_back.append(status);
+        }
+    }
+    m_front = m_back;
+    m_dirty = false;
+    m_timer.start();
+}
+
+void CellStatusStore::clear()
+{
+    m_timer.stop();
+    m_rows = 0;
+    m_cols = 0;
+    m_back.clear();
+    m_front.clear();
+    m_dirty = false;
+}
+
+void CellStatusStore::write(const CellStatus &status)
+{
+    if (status.row < 0 || status.row >= m_rows || status.col < 0 || status.col >= m_cols) {
+        return;
+    }
+
+    CellStatus &slot = m_back[status.row * m_cols + status.col];
+    slot = status;
+    slot.changes = CellStatus::NoChange;
+    m_dirty = true;
+}
+
+void CellStatusStore::publish()
+{
+    if (!m_dirty) return;
+    m_dirty = false;
+
+    // Diff against what consumers saw last, so they can skip untouched cells.
+    // Render time moves on every paint; metrics only count while someone
+    // samples them, and all of them count as new when sampling starts.
+    QVector<CellStatus> next = m_back;
+    const bool sampling = PerfMetrics::instance().isSampling();
+    const bool samplingStarted = sampling && !m_metricsSampled;
+    m_metricsSampled = sampling;
+    bool changed = false;
+    for (qsizetype i = 0; i < next.size(); ++i) {
+        CellStatus &now = next[i];
+        const CellStatus &before = m_front.at(i);
+        if (now.path != before.path) {
+            now.changes |= CellStatus::FileChange;
+        }
+        if (now.position != before.position || now.duration != before.duration) {
+            now.changes |= CellStatus::PositionChange;
+        }
+        if (now.paused != before.paused || now.idle != before.idle
+            || now.looping != before.looping || now.suspended != before.suspended
+            || now.restarts != before.restarts || now.buffering != before.buffering) {
+            now.changes |= CellStatus::StateChange;
+        }
+        if (sampling && (samplingStarted
+            || now.fps != before.fps || now.frameDrops != before.frameDrops
+            || now.decoderDrops != before.decoderDrops || now.hwdec != before.hwdec
+            || now.cacheSecs != before.cacheSecs || now.renderMs != before.renderMs)) {
+            now.changes |= CellStatus::MetricsChange;
+        }
+        changed = changed || now.changes != CellStatus::NoChange;
+    }
+
+    m_front.swap(next);
+    if (changed) {
+        emit snapshotReady();
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+namespace CellStatusConstants {
+    inline constexpr int kTickIntervalMs = 250;  // One snapshot for the whole grid, ~4Hz
+}
+
+// What a cell last reported. Cells overwrite it freely; consumers only ever
+// see it through a snapshot.
+struct CellStatus {
+    enum Change : quint8 {
+        NoChange       = 0,
+        FileChange     = 1 << 0,
+        PositionChange = 1 << 1,   // Position or duration
+        StateChange    = 1 << 2,   // Pause, idle, loop, suspend, buffering or a restart
+        MetricsChange  = 1 << 3    // Any of the PerfMetrics fields below
+    };
+
+    int row = 0;
+    int col = 0;
+    QString path;
+    double position = 0.0;
+    double duration = 0.0;
+    bool paused = false;
+    bool idle = true;
+    bool looping = false;
+    bool suspended = false;
+    int restarts = 0;              // By the CellSupervisor since the grid started
+    bool buffering = false;        // Starved: waiting on the demuxer cache
+    int cacheStalls = 0;           // Buffering episodes since the cell started
+    qint64 cacheStallMs = 0;       // Their total, up to the last one that ended
+
+    // PerfMetrics; only refreshed while sampling, see PerfMetrics::sampleDue()
+    double fps = 0.0;              // estimated-vf-fps
+    qint64 frameDrops = 0;         // Per file
+    qint64 decoderDrops = 0;
+    QString hwdec;                 // hwdec-current
+    double cacheSecs = 0.0;        // Demuxer cache ahead of the playhead
+    double renderMs = 0.0;
+    quint8 changes = NoChange;     // Since the previous snapshot; set by the store
+};
+
+// Central status of every grid cell. Cells write into a back buffer with
+// no signals; once per tick the store publishes a snapshot of the grid and
+// emits snapshotReady() once, so each consumer does one batched pass
+// instead of reacting to every cell separately.
+class CellStatusStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static CellStatusStore& instance();
+
+    void reset(int rows, int cols);   // New grid; every slot starts idle
+    void clear();
+
+    // GUI thread; a plain copy into the back buffer
+    void write(const CellStatus &status);
+
+    // Row-major, rows * cols entries; valid until the next tick
+    [[nodiscard]] const QVector<CellStatus>& snapshot() const noexcept { return m_front; }
+
+signals:
+    void snapshotReady();   // At most once per tick, only when something changed
+
+private:
+    CellStatusStore();
+    CellStatusStore(const CellStatusStore&) = delete;
+    CellStatusStore& operator=(const CellStatusStore&) = delete;
+
+    void publish();
+
+    QVector<CellStatus> m_back;    // Written by cells
+    QVector<CellStatus> m_front;   // Read by consumers
+    QTimer m_timer;
+    int m_rows = 0;
+    int m_cols = 0;
+    bool m_dirty = false;
+    bool m_metricsSampled = false;   // PerfMetrics was sampling at the last publish
+};
@@ -0,0 +1,219 @@
+#include "cellsupervisor.h"
+#include "gridcell.h"
+#include "cellstatusstore.h"
+#include "config.h"
+#include "filescanner.h"
+#include <QDeadlineTimer>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+qint64 nowMs()
+{
+    return QDeadlineTimer::current().deadline();
+}
+
+bool isImage(const QString &path)
+{
+    return FileScanner::imageExtensions().contains(QFileInfo(path).suffix().toLower());
+}
+
+} // namespace
+
+CellSupervisor::CellSupervisor(QObject *parent)
+    : QObject(parent)
+{
+    m_sweepTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_sweepTimer, &QTimer::timeout, this, &CellSupervisor::sweep);
+    connect(&CellStatusStore::instance(), &CellStatusStore::snapshotReady, this, &CellSupervisor::onSnapshot);
+}
+
+void CellSupervisor::start(const QVector<GridCell*> &cells)
+{
+    stop();
+
+    for (GridCell *cell : cells) {
+        Health health;
+        health.cell = cell;
+        m_health.insert({cell->row(), cell->col()}, health);
+        connect(cell, &GridCell::fileFailed, this, &CellSupervisor::onFileFailed, Qt::UniqueConnection);
+    }
+    m_sweepTimer.start(Config::instance().watchdogIntervalMs());
+}
+
+void CellSupervisor::stop()
+{
+    ++m_generation;
+    m_sweepTimer.stop();
+    m_health.clear();
+    m_failures.clear();
+    m_blockedFiles = 0;
+}
+
+CellSupervisor::Health* CellSupervisor::healthOf(int row, int col)
+{
+    auto it = m_health.find({row, col});
+    return it != m_health.end() ? &it.value() : nullptr;
+}
+
+const char* CellSupervisor::faultName(Fault fault) noexcept
+{
+    switch (fault) {
+    case Fault::Idle:       return "idle";
+    case Fault::LoadHang:   return "load timed out";
+    case Fault::Stall:      return "playback stalled";
+    case Fault::CacheStall: return "stuck buffering";
+    }
+    return "unknown";
+}
+
+void CellSupervisor::onSnapshot()
+{
+    if (m_health.isEmpty()) return;
+
+    // Cells going idle are picked up on the tick they report it
+    for (const CellStatus &status : CellStatusStore::instance().snapshot()) {
+        if (!(status.changes & CellStatus::StateChange) || !status.idle || status.suspended) continue;
+
+        Health *health = healthOf(status.row, status.col);
+        if (health && health->cell && !health->cell->isStartDeferred()) {
+            scheduleRecovery(*health, Fault::Idle);
+        }
+    }
+}
+
+void CellSupervisor::onFileFailed(int row, int col, const QString &path)
+{
+    // mpv moves on to the next entry by itself; an idle cell is handled on the snapshot
+    if (Health *health = healthOf(row, col); health && health->cell) {
+        recordFailure(health->cell, path);
+    }
+}
+
+void CellSupervisor::sweep()
+{
+    const qint64 now = nowMs();
+
+    for (Health &health : m_health) {
+        GridCell *cell = health.cell;
+        if (!cell || health.pending || cell->isSuspended() || cell->isStartDeferred()) continue;
+
+        const MpvState &state = cell->mpvState();
+        const qint64 sinceProgress = now - state.progressAt;
+
+        if (state.idle && !state.loading) {
+            scheduleRecovery(health, Fault::Idle);  // A restart that did not take
+        } else if (state.loading) {
+            if (now - state.loadStartedAt > SupervisorConstants::kLoadTimeoutMs) {
+                // The path observer may not have caught up with the file that hangs
+                recordFailure(cell, state.openingPath);
+                scheduleRecovery(health, Fault::LoadHang);
+            }
+        } else if (!state.paused && state.duration > 0 && !isImage(state.path)) {
+            const qint64 timeout = state.pausedForCache ? SupervisorConstants::kCacheStallTimeoutMs
+                                                        : SupervisorConstants::kStallTimeoutMs;
+            if (sinceProgress > timeout) {
+                scheduleRecovery(health, state.pausedForCache ? Fault::CacheStall : Fault::Stall);
+                continue;
+            }
+        }
+
+        // Playing fine for a while: the next fault starts the backoff over
+        if (health.attempts > 0 && now - health.lastRecoveryAt > SupervisorConstants::kHealthyResetMs
+            && !state.idle && sinceProgress < SupervisorConstants::kStallTimeoutMs) {
+            health.attempts = 0;
+        }
+    }
+}
+
+void CellSupervisor::scheduleRecovery(Health &health, Fault fault)
+{
+    if (health.pending) return;
+    health.pending = true;
+
+    const int shift = std::min(health.attempts, 6);
+    const int delay = std::min(SupervisorConstants::kBaseBackoffMs << shift, SupervisorConstants::kMaxBackoffMs);
+
+    const QPointer<GridCell> cell = health.cell;
+    const QPair<int,int> key{cell->row(), cell->col()};
+    const quint64 generation = m_generation;
+    QTimer::singleShot(delay, this, [this, cell, key, generation, fault]() {
+        if (generation != m_generation) return;
+        if (Health *health = healthOf(key.first, key.second)) {
+            health->pending = false;
+        }
+        if (cell) {
+            recover(cell, fault);
+        }
+    });
+}
+
+void CellSupervisor::recover(GridCell *cell, Fault fault)
+{
+    if (cell->isSuspended() || cell->isStartDeferred()) return;
+
+    // It may have sorted itself out during the backoff
+    const MpvState &state = cell->mpvState();
+    const qint64 now = nowMs();
+    switch (fault) {
+    case Fault::Idle:
+        if (!state.idle || state.loading) return;
+        break;
+    case Fault::LoadHang:
+        if (!state.loading) return;
+        break;
+    case Fault::Stall:
+    case Fault::CacheStall:
+        if (state.loading || state.paused || now - state.progressAt <= SupervisorConstants::kStallTimeoutMs) return;
+        break;
+    }
+
+    Health *health = healthOf(cell->row(), cell->col());
+    if (!health) return;
+    ++health->attempts;   // Also backs off checking a cell that has nothing left
+
+    if (cell->playlist().isEmpty() || cell->playlist().allBlocked()) {
+        qWarning() << "CellSupervisor: nothing playable left for cell" << cell->row() << cell->col();
+        return;
+    }
+
+    ++health->restarts;
+    health->lastRecoveryAt = now;
+    cell->setRestartCount(health->restarts);
+
+    // A stuck file is skipped first; a cell that keeps failing gets a fresh start
+    if (fault != Fault::Idle && health->attempts == 1) {
+        cell->next();
+    } else {
+        reload(cell);
+    }
+
+    qDebug() << "CellSupervisor: recovered cell" << cell->row() << cell->col() << faultName(fault)
+             << "attempt" << health->attempts;
+    emit cellRestarted(cell->row(), cell->col(), QString::fromLatin1(faultName(fault)));
+}
+
+void CellSupervisor::reload(GridCell *cell)
+{
+    Playlist playlist = cell->playlist();
+    playlist.shuffle(s_rng);
+    cell->setPlaylist(playlist);
+    cell->play();
+}
+
+void CellSupervisor::recordFailure(GridCell *cell, const QString &path)
+{
+    if (path.isEmpty()) return;
+
+    if (++m_failures[path] != SupervisorConstants::kMaxFileFailures) return;
+
+    // The table is shared by the grid, so no cell opens it again
+    if (const PathTablePtr &table = cell->playlist().table()) {
+        table->block(path);
+        ++m_blockedFiles;
+        qWarning() << "CellSupervisor: blocked" << path << "after" << SupervisorConstants::kMaxFileFailures << "failures";
+        emit fileBlocked(path);
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <random>
+
+class GridCell;
+
+namespace SupervisorConstants {
+    inline constexpr qint64 kLoadTimeoutMs = 15000;        // Open, probe and first frame
+    inline constexpr qint64 kStallTimeoutMs = 10000;       // Playing, but time-pos stopped moving
+    inline constexpr qint64 kCacheStallTimeoutMs = 30000;  // Waiting on the cache; slow shares get longer
+    inline constexpr int kBaseBackoffMs = 1000;            // First retry; doubles per failed attempt
+    inline constexpr int kMaxBackoffMs = 60000;
+    inline constexpr int kMaxFileFailures = 2;             // Then the file is blocked for the grid
+    inline constexpr qint64 kHealthyResetMs = 60000;       // Backoff resets after this long playing fine
+}
+
+// Keeps every cell of the running grid playing. Idle cells are noticed on
+// the status snapshot and mpv's end-file errors as they happen; hung loads
+// and stalled playback are found by a heartbeat over the cached MpvState of
+// each cell (no mpv round trips), every Config::watchdogIntervalMs(). Retries
+// back off exponentially per cell, and files that keep failing are blocked
+// in the grid's PathTable so no cell opens them again.
+class CellSupervisor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CellSupervisor(QObject *parent = nullptr);
+
+    void start(const QVector<GridCell*> &cells);
+    void stop();   // Call before the grid's cells are deleted
+
+    [[nodiscard]] int blockedFiles() const noexcept { return m_blockedFiles; }
+
+signals:
+    void cellRestarted(int row, int col, const QString &reason);
+    void fileBlocked(const QString &path);
+
+private slots:
+    void onSnapshot();
+    void onFileFailed(int row, int col, const QString &path);
+    void sweep();
+
+private:
+    struct Health {
+        QPointer<GridCell> cell;
+        int attempts = 0;            // Recoveries since the cell last played fine
+        int restarts = 0;            // Total, for the monitor
+        qint64 lastRecoveryAt = 0;
+        bool pending = false;        // A recovery is scheduled
+    };
+
+    enum class Fault {
+        Idle,
+        LoadHang,
+        Stall,
+        CacheStall
+    };
+
+    [[nodiscard]] Health* healthOf(int row, int col);
+    [[nodiscard]] static const char* faultName(Fault fault) noexcept;
+    void scheduleRecovery(Health &health, Fault fault);
+    void recover(GridCell *cell, Fault fault);
+    void reload(GridCell *cell);
+    void recordFailure(GridCell *cell, const QString &path);
+
+    QHash<QPair<int,int>, Health> m_health;
+    QHash<QString, int> m_failures;    // Per path, across the grid
+    QTimer m_sweepTimer;
+    quint64 m_generation = 0;          // Recoveries scheduled before stop() are dropped
+    int m_blockedFiles = 0;
+
+    static inline std::mt19937 s_rng{std::random_device{}()};
+};
@@ -37,6 +37,21 @@ void Config::load()
     m_rotationStep = settings.value("video/rotation_step", 90).toInt();
     m_osdDurationMs = settings.value("video/osd_duration_ms", 1500).toInt();
     m_watchdogIntervalMs = settings.value("video/watchdog_interval_ms", 5000).toInt();
+    m_adaptiveQuality = settings.value("video/adaptive_quality", true).toBool();
+    m_decodeCapEnabled = settings.value("video/decode_cap", false).toBool();
+    m_wallRendererEnabled = settings.value("video/wall_renderer", false).toBool();
+    m_releaseHiddenVideo = settings.value("video/release_hidden_video", false).toBool();
+    m_hwdecBudget = settings.value("video/hwdec_budget", 16).toInt();
+    m_imageFastPath = settings.value("video/image_fast_path", true).toBool();
+
+    // I/O
+    m_localIo = loadIo(settings, "io/local_", IoProfile());
+    m_networkIo = loadIo(settings, "io/network_", networkDefaults());
+    m_networkPaths = settings.value("io/network_paths").toStringList();
+    m_cacheMemoryMb = settings.value("io/cache_memory_mb", 2048).toInt();
+
+    // Perf
+    m_metricsPort = settings.value("perf/metrics_port", 0).toInt();
 
     // Grid
     m_defaultRows = settings.value("grid/default_rows", 3).toInt();
@@ -86,6 +101,21 @@ void Config::save()
     settings.setValue("video/rotation_step", m_rotationStep);
     settings.setValue("video/osd_duration_ms", m_osdDurationMs);
     settings.setValue("video/watchdog_interval_ms", m_watchdogIntervalMs);
+    settings.setValue("video/adaptive_quality", m_adaptiveQuality);
+    settings.setValue("video/decode_cap", m_decodeCapEnabled);
+    settings.setValue("video/wall_renderer", m_wallRendererEnabled);
+    settings.setValue("video/release_hidden_video", m_releaseHiddenVideo);
+    settings.setValue("video/hwdec_budget", m_hwdecBudget);
+    settings.setValue("video/image_fast_path", m_imageFastPath);
+
+    // I/O
+    saveIo(settings, "io/local_", m_localIo);
+    saveIo(settings, "io/network_", m_networkIo);
+    settings.setValue("io/network_paths", m_networkPaths);
+    settings.setValue("io/cache_memory_mb", m_cacheMemoryMb);
+
+    // Perf
+    settings.setValue("perf/metrics_port", m_metricsPort);
 
     // Grid
     settings.setValue("grid/default_rows", m_defaultRows);
@@ -127,6 +157,21 @@ void Config::resetToDefaults()
     m_rotationStep = 90;
     m_osdDurationMs = 1500;
     m_watchdogIntervalMs = 5000;
+    m_adaptiveQuality = true;
+    m_decodeCapEnabled = false;
+    m_wallRendererEnabled = false;
+    m_releaseHiddenVideo = false;
+    m_hwdecBudget = 16;
+    m_imageFastPath = true;
+
+    // I/O
+    m_localIo = IoProfile();
+    m_networkIo = networkDefaults();
+    m_networkPaths.clear();
+    m_cacheMemoryMb = 2048;
+
+    // Perf
+    m_metricsPort = 0;
 
     // Grid
     m_defaultRows = 3;
@@ -148,3 +193,32 @@ void Config::resetToDefaults()
 
     save();
 }
+
+IoProfile Config::networkDefaults()
+{
+    // Latency-bound shares: always cache, read ahead far and in large blocks
+    IoProfile profile;
+    profile.cache = "yes";
+    profile.demuxerMaxMb = 96;
+    profile.readaheadSecs = 20.0;
+    profile.streamBufferKb = 1024;
+    return profile;
+}
+
+IoProfile Config::loadIo(const QSettings &settings, const QString &prefix, const IoProfile &defaults)
+{
+    IoProfile profile;
+    profile.cache = settings.value(prefix + "cache", defaults.cache).toString();
+    profile.demuxerMaxMb = settings.value(prefix + "demuxer_max_mb", defaults.demuxerMaxMb).toInt();
+    profile.readaheadSecs = settings.value(prefix + "readahead_secs", defaults.readaheadSecs).toDouble();
+    profile.streamBufferKb = settings.value(prefix + "stream_buffer_kb", defaults.streamBufferKb).toInt();
+    return profile;
+}
+
+void Config::saveIo(QSettings &settings, const QString &prefix, const IoProfile &profile)
+{
+    settings.setValue(prefix + "cache", profile.cache);
+    settings.setValue(prefix + "demuxer_max_mb", profile.demuxerMaxMb);
+    settings.setValue(prefix + "readahead_secs", profile.readaheadSecs);
+    settings.setValue(prefix + "stream_buffer_kb", profile.streamBufferKb);
+}
@@ -1,8 +1,17 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 #include <QSettings>
 
+// Demuxer and stream buffering for one kind of source (see IoProfiles)
+struct IoProfile {
+    QString cache = "auto";        // mpv "cache": yes, no or auto (network protocols only)
+    int demuxerMaxMb = 32;         // Forward cache per cell, before the global cap
+    double readaheadSecs = 2.0;    // demuxer-readahead-secs
+    int streamBufferKb = 128;      // Bytes per read; larger blocks save round trips on shares
+};
+
 class Config
 {
 public:
@@ -44,6 +53,45 @@ public:
     [[nodiscard]] int watchdogIntervalMs() const noexcept { return m_watchdogIntervalMs; }
     void setWatchdogIntervalMs(int ms) { m_watchdogIntervalMs = ms; save(); }
 
+    [[nodiscard]] bool adaptiveQuality() const noexcept { return m_adaptiveQuality; }
+    void setAdaptiveQuality(bool enabled) { m_adaptiveQuality = enabled; save(); }
+
+    [[nodiscard]] bool decodeCapEnabled() const noexcept { return m_decodeCapEnabled; }
+    void setDecodeCapEnabled(bool enabled) { m_decodeCapEnabled = enabled; save(); }
+
+    [[nodiscard]] bool wallRendererEnabled() const noexcept { return m_wallRendererEnabled; }
+    void setWallRendererEnabled(bool enabled) { m_wallRendererEnabled = enabled; save(); }
+
+    [[nodiscard]] bool releaseHiddenVideo() const noexcept { return m_releaseHiddenVideo; }
+    void setReleaseHiddenVideo(bool enabled) { m_releaseHiddenVideo = enabled; save(); }
+
+    // Stills drawn by a lightweight view instead of mpv's video pipeline (applies to new grids)
+    [[nodiscard]] bool imageFastPath() const noexcept { return m_imageFastPath; }
+    void setImageFastPath(bool enabled) { m_imageFastPath = enabled; save(); }
+
+    // Cells allowed to decode on the GPU at once (see PlaybackScheduler); 0 = software only
+    [[nodiscard]] int hwdecBudget() const noexcept { return m_hwdecBudget; }
+    void setHwdecBudget(int cells) { m_hwdecBudget = cells; save(); }
+
+    // I/O settings, per kind of source; profiles apply to files opened after the change
+    [[nodiscard]] const IoProfile& localIo() const noexcept { return m_localIo; }
+    void setLocalIo(const IoProfile &profile) { m_localIo = profile; save(); }
+
+    [[nodiscard]] const IoProfile& networkIo() const noexcept { return m_networkIo; }
+    void setNetworkIo(const IoProfile &profile) { m_networkIo = profile; save(); }
+
+    // Treated as network shares in addition to the auto-detected SMB/NFS mounts
+    [[nodiscard]] QStringList networkPaths() const { return m_networkPaths; }
+    void setNetworkPaths(const QStringList &paths) { m_networkPaths = paths; save(); }
+
+    // Demuxer cache of the whole grid, shared out by the PlaybackScheduler
+    [[nodiscard]] int cacheMemoryMb() const noexcept { return m_cacheMemoryMb; }
+    void setCacheMemoryMb(int mb) { m_cacheMemoryMb = mb; save(); }
+
+    // Prometheus endpoint on localhost; 0 = off
+    [[nodiscard]] int metricsPort() const noexcept { return m_metricsPort; }
+    void setMetricsPort(int port) { m_metricsPort = port; save(); }
+
     // Grid settings
     [[nodiscard]] int defaultRows() const noexcept { return m_defaultRows; }
     void setDefaultRows(int rows) { m_defaultRows = rows; save(); }
@@ -87,6 +135,10 @@ private:
     Config(const Config&) = delete;
     Config& operator=(const Config&) = delete;
 
+    [[nodiscard]] static IoProfile networkDefaults();
+    static IoProfile loadIo(const QSettings &settings, const QString &prefix, const IoProfile &defaults);
+    static void saveIo(QSettings &settings, const QString &prefix, const IoProfile &profile);
+
     // Playback
     int m_loopCount = 5;
     int m_defaultVolume = 30;
@@ -103,6 +155,21 @@ private:
     int m_rotationStep = 90;
     int m_osdDurationMs = 1500;
     int m_watchdogIntervalMs = 5000;
+    bool m_adaptiveQuality = true;
+    bool m_decodeCapEnabled = false;
+    bool m_wallRendererEnabled = false;
+    bool m_releaseHiddenVideo = false;
+    int m_hwdecBudget = 16;
+    bool m_imageFastPath = true;
+
+    // I/O
+    IoProfile m_localIo;
+    IoProfile m_networkIo = networkDefaults();
+    QStringList m_networkPaths;
+    int m_cacheMemoryMb = 2048;
+
+    // Perf
+    int m_metricsPort = 0;
 
     // Grid
     int m_defaultRows = 3;
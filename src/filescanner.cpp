@@ -1,34 +1,296 @@
 #include "filescanner.h"
+#include "filterengine.h"
 #include <QDir>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
 #include <algorithm>
 #include <ranges>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
-QStringList FileScanner::scan(const QString &path) const
+namespace {
+
+// Work-stealing directory walker. Each worker lists one directory at a time,
+// pushes subdirectories onto its own deque (LIFO, keeps the walk cache-warm)
+// and steals from the front of other deques when it runs dry, sleeping until
+// another worker pushes a directory when there is nothing to steal. Results
+// are handed to the calling thread through a single output queue.
+class ScanPool
 {
-    QStringList result;
-    QFileInfo fi(path);
+public:
+    ScanPool(int threadCount, const std::atomic_bool *abort, bool withMetadata)
+        : m_abort(abort)
+        , m_withMetadata(withMetadata)
+    {
+        for (int i = 0; i < threadCount; ++i) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    void run(const QStringList &roots, const FileScanner::BatchCallback &onBatch)
+    {
+        FileScanner::ScanBatch rootFiles;
+        int next = 0;
+        for (const QString &root : roots) {
+            QFileInfo fi(root);
+            if (!fi.exists()) {
+                continue;
+            }
+            if (fi.isFile()) {
+                FileScanner::Entry entry;
+                if (makeEntry(fi, fi.absoluteFilePath(), entry)) {
+                    rootFiles.files.append(entry);
+                }
+                continue;
+            }
+            push(next++ % static_cast<int>(m_workers.size()), root);
+        }
+
+        if (!rootFiles.files.isEmpty()) {
+            onBatch(rootFiles);
+        }
+        if (m_pending.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        m_running = static_cast<int>(m_workers.size());
+        for (int i = 0; i < static_cast<int>(m_workers.size()); ++i) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+
+        // Deliver batches on the caller's thread as they arrive
+        while (true) {
+            std::unique_lock lock(m_outMutex);
+            m_outCv.wait(lock, [this]() { return !m_out.empty() || m_running == 0; });
+            if (m_out.empty()) {
+                break;
+            }
+            FileScanner::ScanBatch batch = std::move(m_out.front());
+            m_out.pop_front();
+            lock.unlock();
+            onBatch(batch);
+        }
+
+        for (std::thread &t : threads) {
+            t.join();
+        }
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QString> dirs;
+    };
+
+    [[nodiscard]] bool aborted() const noexcept
+    {
+        return m_abort && m_abort->load(std::memory_order_relaxed);
+    }
+
+    bool makeEntry(const QFileInfo &fi, const QString &path, FileScanner::Entry &entry) const
+    {
+        const QString ext = fi.suffix().toLower();
+        const bool isVideo = FileScanner::videoExtensions().contains(ext);
+        const bool isImage = !isVideo && FileScanner::imageExtensions().contains(ext);
+        if (!isVideo && !isImage) {
+            return false;
+        }
+
+        entry.path = path;
+        entry.dir = fi.path();
+        entry.isImage = isImage;
+        if (m_withMetadata) {
+            entry.mtime = fi.lastModified().toMSecsSinceEpoch();
+            entry.size = fi.size();
+        }
+        return true;
+    }
+
+    void push(int index, const QString &dir)
+    {
+        m_pending.fetch_add(1, std::memory_order_acq_rel);
+        {
+            Worker &w = *m_workers[index];
+            std::lock_guard lock(w.mutex);
+            w.dirs.push_back(dir);
+        }
+        wakeIdle(false);
+    }
+
+    // Bumps the generation idle workers compare against, so a push between
+    // their last look at the deques and their wait is not lost
+    void wakeIdle(bool all)
+    {
+        bool waiting = false;
+        {
+            std::lock_guard lock(m_workMutex);
+            ++m_workGeneration;
+            waiting = m_idle > 0;
+        }
+        if (!waiting) return;
+        if (all) {
+            m_workCv.notify_all();
+        } else {
+            m_workCv.notify_one();
+        }
+    }
+
+    [[nodiscard]] quint64 workGeneration()
+    {
+        std::lock_guard lock(m_workMutex);
+        return m_workGeneration;
+    }
+
+    void waitForWork(quint64 seen)
+    {
+        std::unique_lock lock(m_workMutex);
+        ++m_idle;
+        m_workCv.wait_for(lock, std::chrono::milliseconds(FileScannerConstants::kAbortPollMs), [this, seen]() {
+            return m_workGeneration != seen || aborted();
+        });
+        --m_idle;
+    }
+
+    bool pop(int index, QString &dir)
+    {
+        Worker &w = *m_workers[index];
+        std::lock_guard lock(w.mutex);
+        if (w.dirs.empty()) {
+            return false;
+        }
+        dir = std::move(w.dirs.back());
+        w.dirs.pop_back();
+        return true;
+    }
 
-    if (!fi.exists()) {
-        return result;
+    bool steal(int thief, QString &dir)
+    {
+        const int count = static_cast<int>(m_workers.size());
+        for (int offset = 1; offset < count; ++offset) {
+            Worker &victim = *m_workers[(thief + offset) % count];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.dirs.empty()) {
+                dir = std::move(victim.dirs.front());
+                victim.dirs.pop_front();
+                return true;
+            }
+        }
+        return false;
     }
 
-    if (fi.isFile()) {
-        if (QString ext = fi.suffix().toLower(); s_videoExts.contains(ext) || s_imageExts.contains(ext)) {
-            result.append(fi.absoluteFilePath());
+    void publish(FileScanner::ScanBatch &&batch)
+    {
+        {
+            std::lock_guard lock(m_outMutex);
+            m_out.push_back(std::move(batch));
+        }
+        m_outCv.notify_one();
+    }
+
+    void processDirectory(int index, const QString &dir, FileScanner::ScanBatch &local)
+    {
+        QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        while (it.hasNext()) {
+            if (aborted()) {
+                return;
+            }
+
+            it.next();
+            const QFileInfo fi = it.fileInfo();
+
+            // Same traversal rules as QDirIterator::Subdirectories: don't follow symlinked dirs
+            if (fi.isDir()) {
+                if (!fi.isSymLink()) {
+                    push(index, it.filePath());
+                    local.directories.append(it.filePath());
+                }
+                continue;
+            }
+
+            FileScanner::Entry entry;
+            if (makeEntry(fi, it.filePath(), entry)) {
+                local.files.append(std::move(entry));
+            }
         }
-        return result;
     }
 
-    QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        it.next();
-        if (QString ext = it.fileInfo().suffix().toLower(); s_videoExts.contains(ext) || s_imageExts.contains(ext)) {
-            result.append(it.filePath());
+    void workerLoop(int index)
+    {
+        using namespace FileScannerConstants;
+        FileScanner::ScanBatch local;
+
+        while (!aborted()) {
+            const quint64 seen = workGeneration();
+            QString dir;
+            if (pop(index, dir) || steal(index, dir)) {
+                processDirectory(index, dir, local);
+                if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    wakeIdle(true);   // Walk done; let everyone out
+                }
+                if (local.files.size() >= kBatchSize) {
+                    publish(std::exchange(local, {}));
+                }
+                continue;
+            }
+
+            if (m_pending.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+
+            // Nothing to steal right now; don't sit on a partial batch while waiting
+            if (!local.files.isEmpty() || !local.directories.isEmpty()) {
+                publish(std::exchange(local, {}));
+            }
+            waitForWork(seen);
         }
+
+        if (!local.files.isEmpty() || !local.directories.isEmpty()) {
+            publish(std::move(local));
+        }
+
+        {
+            std::lock_guard lock(m_outMutex);
+            --m_running;
+        }
+        m_outCv.notify_one();
     }
 
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<int> m_pending{0};  // Directories queued or being listed
+    const std::atomic_bool *m_abort = nullptr;
+    bool m_withMetadata = true;
+
+    std::mutex m_workMutex;
+    std::condition_variable m_workCv;   // Idle workers; signalled by push() and the end of the walk
+    quint64 m_workGeneration = 0;
+    int m_idle = 0;
+
+    std::mutex m_outMutex;
+    std::condition_variable m_outCv;
+    std::deque<FileScanner::ScanBatch> m_out;
+    int m_running = 0;
+};
+
+}
+
+QStringList FileScanner::scan(const QString &path) const
+{
+    QStringList result;
+    scanParallel({path}, [&result](const ScanBatch &batch) {
+        for (const Entry &entry : batch.files) {
+            result.append(entry.path);
+        }
+    }, nullptr, false);
+
     result.sort();
     return result;
 }
@@ -39,33 +301,26 @@ QStringList FileScanner::scan(const QString &path, const QString &filter) const
     return filter.isEmpty() ? files : applyFilter(files, filter);
 }
 
-QStringList FileScanner::applyFilter(const QStringList &files, const QString &filter)
+void FileScanner::scanParallel(const QStringList &roots, const BatchCallback &onBatch,
+                               const std::atomic_bool *abort, bool withMetadata) const
 {
-    if (filter.isEmpty()) {
-        return files;
-    }
-
-    // Split filter into AND terms (space-separated)
-    const QStringList terms = filter.toLower().split(' ', Qt::SkipEmptyParts);
-    if (terms.isEmpty()) {
-        return files;
+    if (roots.isEmpty() || !onBatch) {
+        return;
     }
 
-    QStringList result;
-    for (const QString &file : files) {
-        const QString filename = QFileInfo(file).fileName().toLower();
-
-        // All terms must match (AND) - using std::ranges::all_of
-        bool allMatch = std::ranges::all_of(terms, [&filename](const QString &term) {
-            return filename.contains(term);
-        });
+    const int threads = std::max(FileScannerConstants::kMinScanThreads, QThread::idealThreadCount());
+    ScanPool pool(threads, abort, withMetadata);
+    pool.run(roots, onBatch);
+}
 
-        if (allMatch) {
-            result.append(file);
-        }
+QStringList FileScanner::applyFilter(const QStringList &files, const QString &filter)
+{
+    if (filter.isEmpty()) {
+        return files;
     }
 
-    return result;
+    // One-off engine; indexed snapshots keep theirs (see MediaIndex::filteredFiles)
+    return FilterEngine(files).filter(filter);
 }
 
 const QSet<QString>& FileScanner::videoExtensions() noexcept
@@ -2,16 +2,46 @@
 
 #include <QStringList>
 #include <QSet>
+#include <QList>
+#include <atomic>
+#include <functional>
+
+namespace FileScannerConstants {
+    inline constexpr int kBatchSize = 256;        // Files per streamed batch
+    inline constexpr int kMinScanThreads = 2;     // Directory listing is IO-bound, even on one core
+    inline constexpr int kAbortPollMs = 50;       // Idle workers wake on new directories; this only bounds abort latency
+}
 
 class FileScanner
 {
 public:
+    struct Entry {
+        QString path;
+        QString dir;
+        qint64 mtime = 0;    // Unix timestamp ms (only with metadata)
+        qint64 size = 0;     // Bytes (only with metadata)
+        bool isImage = false;
+    };
+
+    struct ScanBatch {
+        QList<Entry> files;
+        QStringList directories;  // Subdirectories discovered while producing this batch
+    };
+
+    // Invoked on the thread that called scanParallel(), one batch at a time
+    using BatchCallback = std::function<void(const ScanBatch &batch)>;
+
     FileScanner() = default;
 
     [[nodiscard]] QStringList scan(const QString &path) const;
     [[nodiscard]] QStringList scan(const QString &path, const QString &filter) const;
 
-    // Filter: space-separated AND terms, case-insensitive
+    // Walks all roots with a work-stealing pool and streams results in
+    // unsorted batches. Blocks until the walk is done or abort is set.
+    void scanParallel(const QStringList &roots, const BatchCallback &onBatch,
+                      const std::atomic_bool *abort = nullptr, bool withMetadata = true) const;
+
+    // Filter: space-separated AND terms, -negation, "quoted phrases" (see FilterEngine)
     [[nodiscard]] static QStringList applyFilter(const QStringList &files, const QString &filter);
 
     [[nodiscard]] static const QSet<QString>& videoExtensions() noexcept;
@@ -0,0 +1,198 @@
+#include "filterengine.h"
+#include <QThread>
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+#include <thread>
+
+void FilterEngine::build(const QStringList &paths)
+{
+    m_paths = paths;
+    m_names.clear();
+    m_offsets.clear();
+    m_offsets.reserve(paths.size() + 1);
+
+    // Rough guess of the average filename length to avoid regrowth
+    m_names.reserve(static_cast<size_t>(paths.size()) * 48);
+
+    for (const QString &path : paths) {
+        m_offsets.push_back(static_cast<quint32>(m_names.size()));
+        const qsizetype slash = path.lastIndexOf('/');
+        const QByteArray name = path.mid(slash + 1).toLower().toUtf8();
+        m_names.append(name.constData(), static_cast<size_t>(name.size()));
+        m_names.push_back('\0');
+    }
+    m_offsets.push_back(static_cast<quint32>(m_names.size()));
+}
+
+FilterEngine::Query FilterEngine::parse(const QString &filter)
+{
+    Query query;
+    const QString text = filter.toLower();
+    const qsizetype length = text.size();
+    qsizetype i = 0;
+
+    while (i < length) {
+        while (i < length && text.at(i).isSpace()) {
+            ++i;
+        }
+        if (i >= length) {
+            break;
+        }
+
+        bool negate = false;
+        if (text.at(i) == '-') {
+            negate = true;
+            ++i;
+        }
+
+        QString term;
+        if (i < length && text.at(i) == '"') {
+            // Quoted phrase; an unterminated quote runs to the end
+            const qsizetype close = text.indexOf('"', i + 1);
+            const qsizetype end = close < 0 ? length : close;
+            term = text.mid(i + 1, end - i - 1);
+            i = close < 0 ? length : close + 1;
+        } else {
+            const qsizetype start = i;
+            while (i < length && !text.at(i).isSpace()) {
+                ++i;
+            }
+            term = text.mid(start, i - start);
+        }
+
+        if (term.isEmpty()) {
+            continue;
+        }
+
+        const QByteArray utf8 = term.toUtf8();
+        (negate ? query.exclude : query.include).emplace_back(utf8.constData(), static_cast<size_t>(utf8.size()));
+    }
+
+    // Longest include first: it anchors the buffer scan and is usually the most selective
+    std::stable_sort(query.include.begin(), query.include.end(), [](const std::string &a, const std::string &b) {
+        return a.size() > b.size();
+    });
+
+    return query;
+}
+
+void FilterEngine::matchRange(const Query &query, int begin, int end, std::vector<int> &out) const
+{
+    const std::string_view all(m_names);
+
+    auto accepts = [&](int index, size_t skipInclude) {
+        const std::string_view name = all.substr(m_offsets[index], m_offsets[index + 1] - m_offsets[index] - 1);
+        for (size_t t = skipInclude; t < query.include.size(); ++t) {
+            if (name.find(query.include[t]) == std::string_view::npos) {
+                return false;
+            }
+        }
+        for (const std::string &term : query.exclude) {
+            if (name.find(term) != std::string_view::npos) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (query.include.empty()) {
+        for (int i = begin; i < end; ++i) {
+            if (accepts(i, 0)) {
+                out.push_back(i);
+            }
+        }
+        return;
+    }
+
+    // Scan the packed buffer for the anchor term, then map hits back to entries.
+    // Hits arrive in ascending order, so the entry cursor only moves forward.
+    const std::string_view anchor(query.include.front());
+    const size_t regionEnd = m_offsets[end];
+    size_t pos = m_offsets[begin];
+    int entry = begin;
+
+    while (pos < regionEnd) {
+        const size_t hit = all.find(anchor, pos);
+        if (hit == std::string_view::npos || hit >= regionEnd) {
+            break;
+        }
+
+        while (m_offsets[entry + 1] <= hit) {
+            ++entry;
+        }
+
+        if (accepts(entry, 1)) {
+            out.push_back(entry);
+        }
+
+        // One hit per entry is enough
+        pos = m_offsets[entry + 1];
+        ++entry;
+    }
+}
+
+QVector<int> FilterEngine::match(const Query &query) const
+{
+    QVector<int> result;
+    const int count = size();
+
+    if (query.isEmpty()) {
+        result.resize(count);
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    const int chunks = std::clamp(count / FilterEngineConstants::kMinChunkEntries, 1, QThread::idealThreadCount());
+    std::vector<std::vector<int>> partial(chunks);
+
+    auto rangeFor = [count, chunks](int chunk) {
+        return std::pair<int, int>(static_cast<int>(static_cast<qint64>(count) * chunk / chunks),
+                                   static_cast<int>(static_cast<qint64>(count) * (chunk + 1) / chunks));
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for (int chunk = 1; chunk < chunks; ++chunk) {
+        threads.emplace_back([this, &query, &partial, rangeFor, chunk]() {
+            auto [begin, end] = rangeFor(chunk);
+            matchRange(query, begin, end, partial[chunk]);
+        });
+    }
+
+    auto [begin, end] = rangeFor(0);
+    matchRange(query, begin, end, partial[0]);
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    size_t total = 0;
+    for (const auto &p : partial) {
+        total += p.size();
+    }
+    result.reserve(static_cast<qsizetype>(total));
+    for (const auto &p : partial) {
+        for (int index : p) {
+            result.append(index);
+        }
+    }
+
+    return result;
+}
+
+QStringList FilterEngine::filter(const QString &filter) const
+{
+    const Query query = parse(filter);
+    if (query.isEmpty()) {
+        return m_paths;
+    }
+
+    const QVector<int> indices = match(query);
+    QStringList result;
+    result.reserve(indices.size());
+    for (int index : indices) {
+        result.append(m_paths.at(index));
+    }
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QStringList>
+#include <QVector>
+#include <QMetaType>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace FilterEngineConstants {
+    inline constexpr int kMinChunkEntries = 32768;  // Below this a single thread wins
+}
+
+// Precompiled filename filter. Lowercased UTF-8 filenames are packed into one
+// NUL-separated buffer at build time, so matching allocates nothing per entry
+// and a term can never match across two names.
+//
+// Syntax (case-insensitive, all terms AND-ed):
+//   foo bar        both substrings must occur
+//   -foo           foo must not occur
+//   "foo bar"      phrase, spaces included
+//   -"foo bar"     phrase must not occur
+class FilterEngine
+{
+public:
+    struct Query {
+        std::vector<std::string> include;
+        std::vector<std::string> exclude;
+        [[nodiscard]] bool isEmpty() const noexcept { return include.empty() && exclude.empty(); }
+    };
+
+    FilterEngine() = default;
+    explicit FilterEngine(const QStringList &paths) { build(paths); }
+
+    void build(const QStringList &paths);
+
+    [[nodiscard]] const QStringList& paths() const noexcept { return m_paths; }
+    [[nodiscard]] int size() const noexcept { return m_paths.size(); }
+
+    // Indices into paths(), ascending
+    [[nodiscard]] QVector<int> match(const Query &query) const;
+    [[nodiscard]] QStringList filter(const QString &filter) const;
+
+    [[nodiscard]] static Query parse(const QString &filter);
+
+private:
+    void matchRange(const Query &query, int begin, int end, std::vector<int> &out) const;
+
+    QStringList m_paths;
+    std::string m_names;            // "name0\0name1\0...", lowercased UTF-8
+    std::vector<quint32> m_offsets; // size() + 1 entries; name i is [m_offsets[i], m_offsets[i+1] - 1)
+};
+
+using FilterEnginePtr = std::shared_ptr<const FilterEngine>;
+Q_DECLARE_METATYPE(FilterEnginePtr)
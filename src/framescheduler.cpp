@@ -0,0 +1,79 @@
+#include "framescheduler.h"
+#include <QEvent>
+#include <QMetaObject>
+#include <vector>
+
+FrameScheduler& FrameScheduler::instance()
+{
+    static FrameScheduler instance;
+    return instance;
+}
+
+void FrameScheduler::setWindow(QWidget *window)
+{
+    m_widget = window;
+    m_window = nullptr;
+}
+
+void FrameScheduler::requestFrame(FrameClient *client)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_dirty.insert(client);
+        if (m_flushQueued) return;
+        m_flushQueued = true;
+    }
+    QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+}
+
+void FrameScheduler::cancel(FrameClient *client)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dirty.erase(client);
+}
+
+void FrameScheduler::scheduleFlush()
+{
+    if (!m_window && m_widget) {
+        m_window = m_widget->windowHandle();
+        if (m_window) {
+            m_window->installEventFilter(this);
+        }
+    }
+
+    // No exposed window to pace against (startup, minimized): serve right away
+    if (!m_window || !m_window->isExposed()) {
+        flush();
+        return;
+    }
+
+    if (!m_updateRequested) {
+        m_updateRequested = true;
+        m_window->requestUpdate();
+    }
+}
+
+bool FrameScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    // Runs before the window repaints, so widgets updated here go out in this frame
+    if (watched == m_window && event->type() == QEvent::UpdateRequest) {
+        m_updateRequested = false;
+        flush();
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameScheduler::flush()
+{
+    std::vector<FrameClient*> due;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        due.assign(m_dirty.begin(), m_dirty.end());
+        m_dirty.clear();
+        m_flushQueued = false;
+    }
+
+    for (FrameClient *client : due) {
+        client->onFrameDue();
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QWidget>
+#include <QWindow>
+#include <mutex>
+#include <unordered_set>
+
+// Something that renders when mpv reports a new frame (an MpvWidget or a
+// WallRenderer tile). onFrameDue() runs on the GUI thread.
+class FrameClient
+{
+public:
+    virtual ~FrameClient() = default;
+    virtual void onFrameDue() = 0;
+};
+
+// Coalesces mpv update callbacks from every cell into one pass per display
+// refresh. Callbacks may arrive on any thread; the first one after a flush
+// posts a single event that asks the window for a vsync-paced
+// UpdateRequest, and all clients marked dirty by then are served in it.
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static FrameScheduler& instance();
+
+    // Top-level widget whose QWindow paces the flushes. Call on the GUI thread
+    // before any client registers, so the scheduler lives there too.
+    void setWindow(QWidget *window);
+
+    void requestFrame(FrameClient *client);  // Thread-safe
+    void cancel(FrameClient *client);        // Call after the client's render context is freed
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void scheduleFlush();
+
+private:
+    FrameScheduler() = default;
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    void flush();
+
+    std::mutex m_mutex;
+    std::unordered_set<FrameClient*> m_dirty;
+    bool m_flushQueued = false;            // Guarded by m_mutex
+
+    QPointer<QWidget> m_widget;
+    QPointer<QWindow> m_window;            // Resolved lazily; exists once the widget is shown
+    bool m_updateRequested = false;
+};
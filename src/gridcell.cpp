@@ -2,10 +2,16 @@
 #include "config.h"
 #include "theme.h"
 #include "statsmanager.h"
+#include "keyframeindex.h"
+#include "cellstatusstore.h"
+#include "perfmetrics.h"
 #include <QVBoxLayout>
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QResizeEvent>
+#include <QApplication>
+#include <QClipboard>
+#include <QDebug>
 #include <cmath>
 
 GridCell::GridCell(int row, int col, QWidget *parent)
@@ -15,8 +21,7 @@ GridCell::GridCell(int row, int col, QWidget *parent)
 {
     setFrameStyle(QFrame::Box);
     setObjectName("GridCell");
-    setStyleSheet(QString("QFrame#GridCell { background-color: %1; border: 1px solid %2; border-radius: %3px; }")
-        .arg(Theme::Colors::Background, Theme::Colors::Border, QString::number(Theme::Radius::SM)));
+    applyFrameStyle();
     setMouseTracking(true);  // Enable mouse tracking for hover events
 
     auto *layout = new QVBoxLayout(this);
@@ -24,6 +29,7 @@ GridCell::GridCell(int row, int col, QWidget *parent)
 
     m_mpv = new MpvWidget(this);
     layout->addWidget(m_mpv);
+    m_stillView = new StillView(this);
 
     // Loop indicator overlay (top-right corner)
     m_loopIndicator = new QLabel("LOOP", this);
@@ -34,30 +40,98 @@ GridCell::GridCell(int row, int col, QWidget *parent)
     m_loopIndicator->setAlignment(Qt::AlignCenter);
     m_loopIndicator->hide();
 
+    // Perf HUD overlay (top-left corner)
+    m_hudLabel = new QLabel(this);
+    m_hudLabel->setStyleSheet(QString(
+        "background: %1; color: %2; padding: 2px 6px; border-radius: 3px; font-size: 10px; font-family: monospace;"
+    ).arg(Theme::Colors::GlassBg, Theme::Colors::TextPrimary));
+    m_hudLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_hudLabel->move(8, 8);
+    m_hudLabel->setVisible(PerfMetrics::instance().isHudVisible());
+
     // Apply skipper settings from Config
     Config &cfg = Config::instance();
     m_mpv->setSkipperEnabled(cfg.skipperEnabled());
     m_mpv->setSkipPercent(cfg.skipPercent());
+    m_mpv->setStillFastPath(cfg.imageFastPath());
 
     connect(m_mpv, &MpvWidget::fileChanged, this, &GridCell::onFileChanged);
     connect(m_mpv, &MpvWidget::positionChanged, this, &GridCell::onPositionChanged);
     connect(m_mpv, &MpvWidget::durationChanged, this, [this](double dur) {
         m_duration = dur;
+        publishStatus();
     });
+    // Every pause source (togglePause(), grid-wide broadcasts, the OSC) ends
+    // up here, so watch time and pause events are tracked on this path only
     connect(m_mpv, &MpvWidget::pauseChanged, this, [this](bool paused) {
+        if (paused == m_paused) return;
         m_paused = paused;
+        const bool internal = m_suspended || m_suspendPauseChange;
+        m_suspendPauseChange = false;
+        if (!internal && Config::instance().statsEnabled() && !m_currentFile.isEmpty()) {
+            StatsManager::instance().setPaused(m_row, m_col, paused);
+            StatsManager::instance().logPauseEvent(m_currentFile, m_position, paused);
+        }
+        publishStatus();
     });
+    connect(m_mpv, &MpvWidget::idleChanged, this, &GridCell::publishStatus);
     connect(m_mpv, &MpvWidget::loopChanged, this, [this](bool looping) {
         m_looping = looping;
         updateLoopIndicator();
+        publishStatus();
         emit loopChanged(m_row, m_col, looping);
     });
+    connect(m_mpv, &MpvWidget::videoFormatChanged, this, [this]() {
+        emit videoFormatChanged(m_row, m_col);
+    });
+    connect(m_mpv, &MpvWidget::cacheStateChanged, this, &GridCell::publishStatus);
+    const auto mirrorTransform = [this]() {
+        const MpvState &state = m_mpv->state();
+        m_stillView->setTransform(state.videoZoom, state.videoPanX, state.videoPanY, state.rotation);
+    };
+    connect(m_mpv, &MpvWidget::transformChanged, this, mirrorTransform);
+    connect(m_stillView, &StillView::screenshotSaved, this, [](const QString &file) {
+        if (file.isEmpty()) {
+            qWarning() << "Still screenshot failed";
+            return;
+        }
+        QApplication::clipboard()->setText(file);
+        qDebug() << "Screenshot saved and copied to clipboard:" << file;
+    });
+    connect(m_mpv, &MpvWidget::stillChanged, this, [this, mirrorTransform](const QString &path) {
+        mirrorTransform();
+        m_stillView->showStill(path);
+        m_loopIndicator->raise();
+        m_hudLabel->raise();
+    });
+    connect(m_mpv, &MpvWidget::fileFailed, this, [this](const QString &path) {
+        emit fileFailed(m_row, m_col, path);
+    });
+    connect(m_mpv, &MpvWidget::firstFrameRendered, this, [this]() {
+        emit firstFrame(m_row, m_col);
+    });
+
+    PerfMetrics &perf = PerfMetrics::instance();
+    connect(&perf, &PerfMetrics::sampleDue, m_mpv, &MpvWidget::sampleMetrics);
+    connect(&perf, &PerfMetrics::hudVisibilityChanged, this, [this](bool visible) {
+        m_hudLabel->setVisible(visible);
+        if (visible) updateHud();
+    });
+    connect(m_mpv, &MpvWidget::metricsUpdated, this, [this]() {
+        publishStatus();
+        if (m_hudLabel->isVisible()) updateHud();
+    });
 }
 
 
-void GridCell::setPlaylist(const QStringList &files)
+void GridCell::setPlaylist(const Playlist &playlist)
 {
-    m_mpv->loadPlaylist(files);
+    m_mpv->loadPlaylist(playlist);
+}
+
+int GridCell::appendToPlaylist(const QVector<quint32> &indices)
+{
+    return m_mpv->appendToPlaylist(indices);
 }
 
 void GridCell::loadFile(const QString &file)
@@ -65,14 +139,37 @@ void GridCell::loadFile(const QString &file)
     m_mpv->loadFile(file);
 }
 
+void GridCell::sendCommand(const MpvCommand &cmd)
+{
+    m_mpv->command(cmd);
+}
+
 void GridCell::setSelected(bool selected)
 {
-    if (selected) {
+    m_selected = selected;
+    applyFrameStyle();
+}
+
+void GridCell::setWallRenderer(WallRenderer *wall)
+{
+    if (wall) {
+        m_mpv->attachToWall(wall);
+    } else {
+        m_mpv->detachFromWall();
+    }
+    applyFrameStyle();
+}
+
+void GridCell::applyFrameStyle()
+{
+    // On the wall the video is drawn underneath us, so only the border is painted
+    const QString background = m_mpv && m_mpv->isOnWall() ? QString("transparent") : QString(Theme::Colors::Background);
+    if (m_selected) {
         setStyleSheet(QString("QFrame#GridCell { background-color: %1; border: 2px solid %2; border-radius: %3px; }")
-            .arg(Theme::Colors::Background, Theme::Colors::AccentPrimary, QString::number(Theme::Radius::SM)));
+            .arg(background, Theme::Colors::AccentPrimary, QString::number(Theme::Radius::SM)));
     } else {
         setStyleSheet(QString("QFrame#GridCell { background-color: %1; border: 1px solid %2; border-radius: %3px; }")
-            .arg(Theme::Colors::Background, Theme::Colors::Border, QString::number(Theme::Radius::SM)));
+            .arg(background, Theme::Colors::Border, QString::number(Theme::Radius::SM)));
     }
 }
 
@@ -95,17 +192,50 @@ void GridCell::pause()
     m_mpv->pause();
 }
 
-void GridCell::togglePause()
+void GridCell::setSuspended(bool suspended)
 {
-    m_mpv->togglePause();
+    if (suspended == m_suspended) return;
+    m_suspended = suspended;
 
-    // Log pause event and update stats
     Config &cfg = Config::instance();
-    if (cfg.statsEnabled() && !m_currentFile.isEmpty()) {
-        bool willBePaused = !m_paused;  // State after toggle
-        StatsManager::instance().setPaused(m_row, m_col, willBePaused);
-        StatsManager::instance().logPauseEvent(m_currentFile, m_position, willBePaused);
+    const bool trackStats = cfg.statsEnabled() && !m_currentFile.isEmpty();
+
+    if (suspended) {
+        m_resumePaused = m_paused;
+        m_mpv->pause();
+        m_suspendPauseChange = !m_paused;
+
+        // Dropping the track frees the decoder and its surfaces; switching it
+        // back on costs a short re-init, so plain pausing is the default
+        if (cfg.releaseHiddenVideo()) {
+            m_mpv->setProperty("vid", "no");
+            m_videoReleased = true;
+        }
+
+        // Keep the session open, just stop counting watch time
+        if (trackStats) {
+            StatsManager::instance().setPaused(m_row, m_col, true);
+        }
+    } else {
+        if (m_videoReleased) {
+            m_mpv->setProperty("vid", "auto");
+            m_videoReleased = false;
+        }
+        if (!m_resumePaused) {
+            m_mpv->play();
+            m_suspendPauseChange = m_paused;
+        }
+        if (trackStats) {
+            StatsManager::instance().setPaused(m_row, m_col, m_resumePaused);
+        }
     }
+    publishStatus();
+}
+
+void GridCell::togglePause()
+{
+    // Stats follow from pauseChanged()
+    m_mpv->togglePause();
 }
 
 void GridCell::next()
@@ -228,6 +358,11 @@ void GridCell::seekRelative(double seconds)
 
 void GridCell::screenshot()
 {
+    // mpv only has the black placeholder of a fast-path still
+    if (!m_stillView->path().isEmpty()) {
+        m_stillView->saveScreenshot(Config::instance().screenshotPath());
+        return;
+    }
     m_mpv->screenshot();
 }
 
@@ -241,13 +376,17 @@ void GridCell::setOsdLevel(int level)
     m_mpv->setOsdLevel(level);
 }
 
-void GridCell::updatePlaylistPath(const QString &oldPath, const QString &newPath)
+void GridCell::setQualityPinned(bool pinned)
 {
-    m_mpv->updatePlaylistPath(oldPath, newPath);
+    m_mpv->setQualityPinned(pinned);
+}
 
-    // Update current file reference if it matches
+void GridCell::updateCurrentFilePath(const QString &oldPath, const QString &newPath)
+{
+    // Playlist entries are renamed through the shared PathTable
     if (m_currentFile == oldPath) {
         m_currentFile = newPath;
+        publishStatus();
     }
 }
 
@@ -261,6 +400,11 @@ QStringList GridCell::currentPlaylist() const
     return m_mpv->currentPlaylist();
 }
 
+const Playlist& GridCell::playlist() const noexcept
+{
+    return m_mpv->playlist();
+}
+
 double GridCell::position() const noexcept
 {
     return m_position;
@@ -276,6 +420,11 @@ bool GridCell::isPaused() const noexcept
     return m_paused;
 }
 
+bool GridCell::isIdle() const noexcept
+{
+    return m_mpv->state().idle;
+}
+
 void GridCell::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
@@ -344,11 +493,13 @@ void GridCell::wheelEvent(QWheelEvent *event)
     else if (vdelta != 0) {
         // Get mouse position relative to the video widget
         QPointF globalPos = event->globalPosition();
-        QPointF localPos = m_mpv->mapFromGlobal(globalPos.toPoint());
+        // On the wall the MpvWidget is hidden and the cell itself is the video area
+        const QWidget *video = m_mpv->isOnWall() ? static_cast<QWidget*>(this) : m_mpv;
+        QPointF localPos = video->mapFromGlobal(globalPos.toPoint());
 
         // Normalize to 0.0 - 1.0 range
-        double normalizedX = localPos.x() / m_mpv->width();
-        double normalizedY = localPos.y() / m_mpv->height();
+        double normalizedX = localPos.x() / video->width();
+        double normalizedY = localPos.y() / video->height();
 
         // Clamp to valid range
         normalizedX = std::clamp(normalizedX, 0.0, 1.0);
@@ -363,14 +514,16 @@ void GridCell::wheelEvent(QWheelEvent *event)
 
 void GridCell::onFileChanged(const QString &path)
 {
-    // Stop tracking previous file
+    // Stop tracking previous file; the store only hands positions over per tick
     Config &cfg = Config::instance();
     if (cfg.statsEnabled() && !m_currentFile.isEmpty()) {
+        StatsManager::instance().updatePosition(m_row, m_col, m_position);
         StatsManager::instance().stopWatching(m_row, m_col);
     }
 
     m_currentFile = path;
-    emit fileChanged(m_row, m_col, path, m_position, m_duration, m_paused);
+    publishStatus();
+    emit videoFormatChanged(m_row, m_col);
 
     // Start tracking new file
     if (cfg.statsEnabled() && !path.isEmpty()) {
@@ -380,32 +533,58 @@ void GridCell::onFileChanged(const QString &path)
                        path.endsWith(".gif", Qt::CaseInsensitive) ||
                        path.endsWith(".bmp", Qt::CaseInsensitive) ||
                        path.endsWith(".webp", Qt::CaseInsensitive);
-        StatsManager::instance().startWatching(m_row, m_col, path, m_duration, isImage);
+        // m_duration still belongs to the previous file here
+        const double duration = KeyframeIndex::instance().duration(path);
+        StatsManager::instance().startWatching(m_row, m_col, path, duration, isImage);
     }
 }
 
 void GridCell::onPositionChanged(double pos)
 {
+    // Called for every frame; consumers batch it through the store
     m_position = pos;
+    publishStatus();
+}
 
-    // Update stats position
-    if (Config::instance().statsEnabled()) {
-        StatsManager::instance().updatePosition(m_row, m_col, pos);
-    }
+void GridCell::setRestartCount(int restarts)
+{
+    m_restarts = restarts;
+    publishStatus();
+}
 
-    // Throttle to ~4Hz to avoid excessive UI updates
-    using namespace GridCellConstants;
-    if (m_lastEmitPos < 0 || std::abs(m_position - m_lastEmitPos) >= kPositionEmitInterval) {
-        m_lastEmitPos = m_position;
-        if (!m_currentFile.isEmpty()) {
-            emit fileChanged(m_row, m_col, m_currentFile, m_position, m_duration, m_paused);
-        }
-    }
+void GridCell::publishStatus()
+{
+    CellStatus status;
+    status.row = m_row;
+    status.col = m_col;
+    status.path = m_currentFile;
+    status.position = m_position;
+    status.duration = m_duration;
+    status.paused = m_paused;
+    status.idle = m_mpv->state().idle;
+    status.looping = m_looping;
+    status.suspended = m_suspended;
+    status.restarts = m_restarts;
+    status.buffering = m_mpv->state().pausedForCache;
+    status.cacheStalls = m_mpv->state().cacheStalls;
+    status.cacheStallMs = m_mpv->state().cacheStallMs;
+
+    const MpvState &state = m_mpv->state();
+    status.fps = state.vfFps;
+    status.frameDrops = state.frameDropCount;
+    status.decoderDrops = state.decoderDropCount;
+    status.hwdec = state.hwdecCurrent;
+    status.cacheSecs = state.cacheAheadSecs;
+    status.renderMs = state.renderMs;
+    CellStatusStore::instance().write(status);
 }
 
 void GridCell::resizeEvent(QResizeEvent *event)
 {
     QFrame::resizeEvent(event);
+    m_mpv->updateDecodeCap();
+    m_stillView->setGeometry(contentsRect());
+
     // Reposition loop indicator on resize
     if (m_looping) {
         updateLoopIndicator();
@@ -423,3 +602,18 @@ void GridCell::updateLoopIndicator()
         m_loopIndicator->hide();
     }
 }
+
+void GridCell::updateHud()
+{
+    const MpvState &state = m_mpv->state();
+    const QString hwdec = state.hwdecCurrent.isEmpty() ? QStringLiteral("no") : state.hwdecCurrent;
+    m_hudLabel->setText(QString("%1 fps  drop %2/%3\n%4  cache %5s  %6 ms")
+        .arg(state.vfFps, 0, 'f', 1)
+        .arg(state.frameDropCount)
+        .arg(state.decoderDropCount)
+        .arg(hwdec)
+        .arg(state.cacheAheadSecs, 0, 'f', 1)
+        .arg(state.renderMs, 0, 'f', 2));
+    m_hudLabel->adjustSize();
+    m_hudLabel->raise();
+}
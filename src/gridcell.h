@@ -3,11 +3,7 @@
 #include <QFrame>
 #include <QLabel>
 #include "mpvwidget.h"
-
-// Constants
-namespace GridCellConstants {
-    inline constexpr double kPositionEmitInterval = 0.25;  // ~4Hz throttle
-}
+#include "stillview.h"
 
 class GridCell : public QFrame
 {
@@ -20,9 +16,12 @@ public:
     [[nodiscard]] int row() const noexcept { return m_row; }
     [[nodiscard]] int col() const noexcept { return m_col; }
 
-    void setPlaylist(const QStringList &files);
+    void setPlaylist(const Playlist &playlist);
+    int appendToPlaylist(const QVector<quint32> &indices);   // First changed position (MpvWidget::appendToPlaylist)
     void loadFile(const QString &file);
+    void sendCommand(const MpvCommand &cmd);  // Prebuilt command, e.g. a grid-wide broadcast
     void setSelected(bool selected);
+    void setWallRenderer(WallRenderer *wall);  // nullptr renders in the cell's own MpvWidget
     void play();
     void stop();
     void pause();
@@ -65,21 +64,44 @@ public:
     // OSC/OSD control (for fullscreen mode)
     void setOscEnabled(bool enabled);
     void setOsdLevel(int level);
+    void setQualityPinned(bool pinned);
+
+    // PlaybackScheduler hooks: staggered start and the per-cell decoder
+    void deferStart() { m_mpv->deferStart(); }
+    void releaseStart() { m_mpv->releaseStart(); }
+    [[nodiscard]] bool isStartDeferred() const noexcept { return m_mpv->isStartDeferred(); }
+    void setHardwareDecoding(bool enabled) { m_mpv->setHardwareDecoding(enabled); }
+    void setCacheLimit(qint64 bytes) { m_mpv->setCacheLimit(bytes); }
+    [[nodiscard]] bool hardwareDecoding() const noexcept { return m_mpv->hardwareDecoding(); }
+    [[nodiscard]] const MpvState& mpvState() const noexcept { return m_mpv->state(); }
+
+    // Restarts by the CellSupervisor, shown in the monitor
+    void setRestartCount(int restarts);
+    [[nodiscard]] int restartCount() const noexcept { return m_restarts; }
+
+    // Hidden or off-screen cells stop decoding; the playlist position and the
+    // stats session are kept, and resuming restores the previous pause state
+    void setSuspended(bool suspended);
+    [[nodiscard]] bool isSuspended() const noexcept { return m_suspended; }
 
-    // Playlist management
-    void updatePlaylistPath(const QString &oldPath, const QString &newPath);
+    // Keeps the file label in sync after a rename
+    void updateCurrentFilePath(const QString &oldPath, const QString &newPath);
 
     [[nodiscard]] QString currentFile() const;
     [[nodiscard]] QStringList currentPlaylist() const;
+    [[nodiscard]] const Playlist& playlist() const noexcept;
     [[nodiscard]] double position() const noexcept;
     [[nodiscard]] double duration() const noexcept;
     [[nodiscard]] bool isPaused() const noexcept;
+    [[nodiscard]] bool isIdle() const noexcept;  // mpv has nothing loaded
 
 signals:
     void selected(int row, int col);
     void doubleClicked(int row, int col);
-    void fileChanged(int row, int col, const QString &path, double pos, double dur, bool paused);
     void loopChanged(int row, int col, bool looping);
+    void videoFormatChanged(int row, int col);   // New file, or mpv reported its video format
+    void fileFailed(int row, int col, const QString &path);
+    void firstFrame(int row, int col);   // Of every file the cell opens
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
@@ -93,15 +115,25 @@ private slots:
 
 private:
     void updateLoopIndicator();
+    void updateHud();
+    void applyFrameStyle();
+    void publishStatus();   // Into CellStatusStore; consumers read it on the next tick
 
     int m_row;
     int m_col;
     MpvWidget *m_mpv = nullptr;
+    StillView *m_stillView = nullptr;   // Over m_mpv while a still is up
     QLabel *m_loopIndicator = nullptr;
+    QLabel *m_hudLabel = nullptr;       // Perf HUD, top-left; see PerfMetrics
     QString m_currentFile;
     double m_position = 0.0;
     double m_duration = 0.0;
     bool m_paused = false;
     bool m_looping = false;
-    double m_lastEmitPos = -1.0;
+    bool m_selected = false;
+    bool m_suspended = false;
+    bool m_resumePaused = false;   // Pause state to restore on resume
+    bool m_videoReleased = false;  // vid=no while suspended
+    bool m_suspendPauseChange = false;  // Next pauseChanged() is ours, not a user pause
+    int m_restarts = 0;
 };
@@ -0,0 +1,88 @@
+#include "ioprofiles.h"
+#include <QStorageInfo>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+QString withSlash(QString path)
+{
+    if (!path.endsWith('/')) {
+        path += '/';
+    }
+    return path;
+}
+
+} // namespace
+
+IoProfiles& IoProfiles::instance()
+{
+    static IoProfiles instance;
+    return instance;
+}
+
+bool IoProfiles::isNetworkFileSystem(const QByteArray &type) noexcept
+{
+    static constexpr const char *kNetworkTypes[] = {
+        "cifs", "smb", "smb2", "smb3", "smbfs", "nfs", "nfs4", "afpfs", "webdav", "davfs", "fuse.sshfs", "9p"
+    };
+    return std::any_of(std::begin(kNetworkTypes), std::end(kNetworkTypes), [&type](const char *network) {
+        return type == network;
+    });
+}
+
+void IoProfiles::refresh()
+{
+    m_mounts.clear();
+
+    // Configured paths go first, so the stable sort keeps them ahead of a mount with the same root
+    for (const QString &path : Config::instance().networkPaths()) {
+        if (!path.isEmpty()) {
+            m_mounts.append({withSlash(QDir::cleanPath(path)), Source::Network});
+        }
+    }
+    int networkMounts = 0;
+    for (const QStorageInfo &volume : QStorageInfo::mountedVolumes()) {
+        if (!volume.isValid()) continue;
+
+        const Source source = isNetworkFileSystem(volume.fileSystemType()) ? Source::Network : Source::Local;
+        networkMounts += source == Source::Network ? 1 : 0;
+        m_mounts.append({withSlash(volume.rootPath()), source});
+    }
+
+    // Longest root first, so nested mounts and configured subtrees win
+    std::stable_sort(m_mounts.begin(), m_mounts.end(), [](const Mount &a, const Mount &b) {
+        return a.root.size() > b.root.size();
+    });
+    m_loaded = true;
+
+    qDebug() << "IoProfiles:" << m_mounts.size() << "mounts," << networkMounts << "network,"
+             << Config::instance().networkPaths().size() << "configured";
+}
+
+IoProfiles::Source IoProfiles::sourceOf(const QString &path)
+{
+    if (!m_loaded) {
+        refresh();
+    }
+
+    for (const Mount &mount : std::as_const(m_mounts)) {
+        if (path.startsWith(mount.root)) {
+            return mount.source;
+        }
+    }
+    return Source::Local;
+}
+
+IoProfile IoProfiles::profileFor(const QString &path)
+{
+    const Config &config = Config::instance();
+    return sourceOf(path) == Source::Network ? config.networkIo() : config.localIo();
+}
+
+qint64 IoProfiles::cacheShareBytes(int cells) noexcept
+{
+    const qint64 total = static_cast<qint64>(Config::instance().cacheMemoryMb()) << 20;
+    return std::max(total / std::max(cells, 1), IoConstants::kMinCacheShareBytes);
+}
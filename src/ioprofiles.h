@@ -0,0 +1,48 @@
+#pragma once
+
+#include "config.h"
+#include <QString>
+#include <QVector>
+
+namespace IoConstants {
+    inline constexpr qint64 kMinCacheShareBytes = 8LL << 20;  // Per cell, however large the grid
+    inline constexpr int kBackBufferDivisor = 4;              // demuxer-max-back-bytes per forward byte
+}
+
+// Picks the I/O profile for a file by where it lives. Mounts come from the
+// system mount table, read once and matched by longest root; SMB, NFS and
+// similar file systems, and anything under Config::networkPaths(), get the
+// network profile. GUI thread only.
+class IoProfiles
+{
+public:
+    enum class Source {
+        Local,
+        Network
+    };
+
+    [[nodiscard]] static IoProfiles& instance();
+
+    void refresh();   // Re-reads the mount table and the configured paths
+
+    [[nodiscard]] Source sourceOf(const QString &path);
+    [[nodiscard]] IoProfile profileFor(const QString &path);
+
+    // Forward demuxer cache per cell when cells split Config::cacheMemoryMb()
+    [[nodiscard]] static qint64 cacheShareBytes(int cells) noexcept;
+
+    [[nodiscard]] static bool isNetworkFileSystem(const QByteArray &type) noexcept;
+
+private:
+    IoProfiles() = default;
+    IoProfiles(const IoProfiles&) = delete;
+    IoProfiles& operator=(const IoProfiles&) = delete;
+
+    struct Mount {
+        QString root;   // With a trailing slash
+        Source source;
+    };
+
+    QVector<Mount> m_mounts;   // Longest root first
+    bool m_loaded = false;
+};
@@ -0,0 +1,567 @@
+#include "keyframeindex.h"
+#include "mediaindex.h"
+#include "filescanner.h"
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <numeric>
+
+#ifdef GOOBERT_HAVE_AVFORMAT
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+#endif
+
+namespace {
+    const QString kConnectionName = QStringLiteral("keyframe_index_connection");
+
+    // One blob per file: (double time, qint64 offset) pairs in host byte order.
+    // The database is a local cache, never shared between machines.
+    struct PackedKeyframe {
+        double time;
+        qint64 offset;
+    };
+
+    QByteArray packKeyframes(const KeyframeInfo &info)
+    {
+        QByteArray blob;
+        blob.resize(info.times.size() * static_cast<qsizetype>(sizeof(PackedKeyframe)));
+        auto *out = reinterpret_cast<PackedKeyframe*>(blob.data());
+        for (qsizetype i = 0; i < info.times.size(); ++i) {
+            out[i] = {info.times.at(i), info.offsets.at(i)};
+        }
+        return blob;
+    }
+
+    void unpackKeyframes(const QByteArray &blob, KeyframeInfo &info)
+    {
+        const qsizetype count = blob.size() / static_cast<qsizetype>(sizeof(PackedKeyframe));
+        const auto *in = reinterpret_cast<const PackedKeyframe*>(blob.constData());
+        info.times.resize(count);
+        info.offsets.resize(count);
+        for (qsizetype i = 0; i < count; ++i) {
+            info.times[i] = in[i].time;
+            info.offsets[i] = in[i].offset;
+        }
+    }
+
+    bool isVideo(const QString &path)
+    {
+        return FileScanner::videoExtensions().contains(QFileInfo(path).suffix().toLower());
+    }
+
+#ifdef GOOBERT_HAVE_AVFORMAT
+    int interruptProbe(void *opaque)
+    {
+        return static_cast<const std::atomic_bool*>(opaque)->load(std::memory_order_relaxed) ? 1 : 0;
+    }
+#endif
+}
+
+// ============ KeyframeInfo ============
+
+double KeyframeInfo::keyframeAtOrBefore(double seconds) const
+{
+    auto it = std::upper_bound(times.cbegin(), times.cend(), seconds);
+    return it == times.cbegin() ? -1.0 : *(it - 1);
+}
+
+double KeyframeInfo::keyframeAtOrAfter(double seconds) const
+{
+    auto it = std::lower_bound(times.cbegin(), times.cend(), seconds);
+    return it == times.cend() ? -1.0 : *it;
+}
+
+// ============ KeyframeIndexWorker ============
+
+KeyframeIndexWorker::KeyframeIndexWorker(std::atomic_bool *abort)
+    : QObject(nullptr)
+    , m_abort(abort)
+{
+}
+
+KeyframeIndexWorker::~KeyframeIndexWorker()
+{
+    close();
+}
+
+void KeyframeIndexWorker::open(const QString &dbPath)
+{
+    if (m_db.isOpen()) {
+        return;
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    m_db.setDatabaseName(dbPath);
+
+    if (!m_db.open()) {
+        qWarning() << "Failed to open keyframe index database:" << m_db.lastError().text();
+        return;
+    }
+
+    QSqlQuery pragma(m_db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+
+    if (!createTables()) {
+        qWarning() << "Failed to create keyframe index tables";
+    }
+
+    m_selectQuery = QSqlQuery(m_db);
+    m_selectQuery.prepare("SELECT mtime, size, duration, keyframes, width, height, codec FROM media_keyframes WHERE path = ?");
+    m_upsertQuery = QSqlQuery(m_db);
+    m_upsertQuery.prepare("INSERT OR REPLACE INTO media_keyframes (path, mtime, size, duration, keyframes, width, height, codec) "
+                          "VALUES (?, ?, ?, ?, ?, ?, ?, ?)");
+
+    qDebug() << "KeyframeIndex opened, database:" << dbPath;
+}
+
+void KeyframeIndexWorker::close()
+{
+    m_backfillQueue.clear();
+    m_backfillQueued.clear();
+
+    if (!m_db.isValid()) {
+        return;
+    }
+
+    m_selectQuery = QSqlQuery();
+    m_upsertQuery = QSqlQuery();
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(kConnectionName);
+}
+
+bool KeyframeIndexWorker::createTables()
+{
+    QSqlQuery query(m_db);
+
+    bool ok = query.exec(R"(
+        CREATE TABLE IF NOT EXISTS media_keyframes (
+            path TEXT PRIMARY KEY,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            duration REAL NOT NULL DEFAULT 0,
+            keyframes BLOB,
+            width INTEGER NOT NULL DEFAULT 0,
+            height INTEGER NOT NULL DEFAULT 0,
+            codec TEXT
+        )
+    )");
+
+    if (!ok) {
+        qWarning() << "Failed to create media_keyframes table:" << query.lastError().text();
+        return false;
+    }
+
+    // Older caches lack the video format; their rows read as unknown until probed again
+    QStringList columns;
+    if (query.exec("PRAGMA table_info(media_keyframes)")) {
+        while (query.next()) {
+            columns.append(query.value(1).toString());
+        }
+    }
+    if (!columns.contains("width")) {
+        query.exec("ALTER TABLE media_keyframes ADD COLUMN width INTEGER NOT NULL DEFAULT 0");
+        query.exec("ALTER TABLE media_keyframes ADD COLUMN height INTEGER NOT NULL DEFAULT 0");
+        query.exec("ALTER TABLE media_keyframes ADD COLUMN codec TEXT");
+    }
+
+    return true;
+}
+
+KeyframeInfoPtr KeyframeIndexWorker::load(const QString &path, qint64 mtime, qint64 size)
+{
+    if (!m_db.isOpen()) {
+        return nullptr;
+    }
+
+    m_selectQuery.addBindValue(path);
+    if (!m_selectQuery.exec() || !m_selectQuery.next()) {
+        m_selectQuery.finish();
+        return nullptr;
+    }
+
+    // A changed file invalidates the row; the caller probes again
+    if (m_selectQuery.value(0).toLongLong() != mtime || m_selectQuery.value(1).toLongLong() != size) {
+        m_selectQuery.finish();
+        return nullptr;
+    }
+
+    auto info = std::make_shared<KeyframeInfo>();
+    info->duration = m_selectQuery.value(2).toDouble();
+    unpackKeyframes(m_selectQuery.value(3).toByteArray(), *info);
+    info->width = m_selectQuery.value(4).toInt();
+    info->height = m_selectQuery.value(5).toInt();
+    info->codec = m_selectQuery.value(6).toString();
+    m_selectQuery.finish();
+    return info;
+}
+
+KeyframeInfoPtr KeyframeIndexWorker::probe(const QString &path) const
+{
+#ifdef GOOBERT_HAVE_AVFORMAT
+    AVFormatContext *ctx = avformat_alloc_context();
+    if (!ctx) {
+        return nullptr;
+    }
+    ctx->interrupt_callback = {interruptProbe, m_abort};
+
+    // Headers only: no avformat_find_stream_info(), which would decode.
+    // MP4 sample tables, Matroska cues and AVI indexes are all read here.
+    if (avformat_open_input(&ctx, path.toUtf8().constData(), nullptr, nullptr) < 0) {
+        return nullptr;  // ctx is freed on failure
+    }
+
+    auto info = std::make_shared<KeyframeInfo>();
+    if (ctx->duration != AV_NOPTS_VALUE && ctx->duration > 0) {
+        info->duration = static_cast<double>(ctx->duration) / AV_TIME_BASE;
+    }
+
+    const int streamIndex = av_find_best_stream(ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIndex >= 0) {
+        const AVStream *stream = ctx->streams[streamIndex];
+        info->width = stream->codecpar->width;
+        info->height = stream->codecpar->height;
+        info->codec = QString::fromLatin1(avcodec_get_name(stream->codecpar->codec_id));
+
+        const int count = avformat_index_get_entries_count(stream);
+        const AVIndexEntry *first = count > 0 ? avformat_index_get_entry(const_cast<AVStream*>(stream), 0) : nullptr;
+
+        // mpv rebases time-pos to the stream start
+        const int64_t base = stream->start_time != AV_NOPTS_VALUE ? stream->start_time
+                                                                  : (first ? first->timestamp : 0);
+        const double timeBase = av_q2d(stream->time_base);
+
+        for (int i = 0; i < count; ++i) {
+            const AVIndexEntry *entry = avformat_index_get_entry(const_cast<AVStream*>(stream), i);
+            if (!entry || !(entry->flags & AVINDEX_KEYFRAME)) {
+                continue;
+            }
+            info->times.append(static_cast<double>(entry->timestamp - base) * timeBase);
+            info->offsets.append(entry->pos);
+        }
+
+        // Index order is by position; seek lookups need time order
+        if (!std::is_sorted(info->times.cbegin(), info->times.cend())) {
+            QVector<int> order(info->times.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](int a, int b) { return info->times.at(a) < info->times.at(b); });
+            QVector<double> times;
+            QVector<qint64> offsets;
+            times.reserve(order.size());
+            offsets.reserve(order.size());
+            for (int i : order) {
+                times.append(info->times.at(i));
+                offsets.append(info->offsets.at(i));
+            }
+            info->times = std::move(times);
+            info->offsets = std::move(offsets);
+        }
+    }
+
+    avformat_close_input(&ctx);
+    return info;
+#else
+    Q_UNUSED(path);
+    return nullptr;
+#endif
+}
+
+void KeyframeIndexWorker::store(const QString &path, qint64 mtime, qint64 size, const KeyframeInfo &info)
+{
+    if (!m_db.isOpen()) {
+        return;
+    }
+
+    m_upsertQuery.addBindValue(path);
+    m_upsertQuery.addBindValue(mtime);
+    m_upsertQuery.addBindValue(size);
+    m_upsertQuery.addBindValue(info.duration);
+    m_upsertQuery.addBindValue(packKeyframes(info));
+    m_upsertQuery.addBindValue(info.width);
+    m_upsertQuery.addBindValue(info.height);
+    m_upsertQuery.addBindValue(info.codec);
+    if (!m_upsertQuery.exec()) {
+        qWarning() << "Failed to store keyframe index:" << m_upsertQuery.lastError().text();
+    }
+}
+
+KeyframeInfoPtr KeyframeIndexWorker::resolve(const QString &path, bool probeMissing)
+{
+    const QFileInfo fi(path);
+    if (!fi.isFile()) {
+        return nullptr;
+    }
+
+    const qint64 mtime = fi.lastModified().toMSecsSinceEpoch();
+    const qint64 size = fi.size();
+
+    if (KeyframeInfoPtr cached = load(path, mtime, size)) {
+        return cached;
+    }
+    if (!probeMissing || !isVideo(path)) {
+        return nullptr;
+    }
+
+    KeyframeInfoPtr probed = probe(path);
+    if (probed) {
+        store(path, mtime, size, *probed);
+    }
+    return probed;
+}
+
+void KeyframeIndexWorker::request(const QStringList &paths)
+{
+    for (const QString &path : paths) {
+        if (m_abort->load(std::memory_order_relaxed)) {
+            return;
+        }
+        // Always answer, so the GUI can clear its in-flight entry
+        emit infoReady(path, resolve(path, true));
+    }
+}
+
+void KeyframeIndexWorker::backfill(const QStringList &paths)
+{
+    if (!KeyframeIndex::canProbe()) {
+        return;
+    }
+
+    for (const QString &path : paths) {
+        if (isVideo(path) && !m_backfillQueued.contains(path)) {
+            m_backfillQueued.insert(path);
+            m_backfillQueue.append(path);
+        }
+    }
+
+    if (!m_backfillScheduled && !m_backfillQueue.isEmpty()) {
+        m_backfillScheduled = true;
+        QMetaObject::invokeMethod(this, &KeyframeIndexWorker::processBackfill, Qt::QueuedConnection);
+    }
+}
+
+void KeyframeIndexWorker::processBackfill()
+{
+    m_backfillScheduled = false;
+
+    // A few files per step, then yield so queued requests for files that are
+    // about to play are not stuck behind a whole library
+    if (m_db.isOpen()) {
+        m_db.transaction();
+    }
+    for (int i = 0; i < KeyframeIndexConstants::kBackfillBatch && !m_backfillQueue.isEmpty(); ++i) {
+        if (m_abort->load(std::memory_order_relaxed)) {
+            break;
+        }
+        // Forgotten once resolved: a file changed later is checked again on the next indexUpdated
+        const QString path = m_backfillQueue.takeFirst();
+        m_backfillQueued.remove(path);
+        (void)resolve(path, true);
+    }
+    if (m_db.isOpen()) {
+        m_db.commit();
+    }
+
+    if (!m_backfillQueue.isEmpty() && !m_abort->load(std::memory_order_relaxed)) {
+        m_backfillScheduled = true;
+        QMetaObject::invokeMethod(this, &KeyframeIndexWorker::processBackfill, Qt::QueuedConnection);
+    }
+}
+
+void KeyframeIndexWorker::storeDuration(const QString &path, double duration)
+{
+    const QFileInfo fi(path);
+    if (duration <= 0 || !fi.isFile()) {
+        return;
+    }
+
+    const qint64 mtime = fi.lastModified().toMSecsSinceEpoch();
+    const qint64 size = fi.size();
+
+    // Keep any keyframes already known, only fill in the duration
+    KeyframeInfo info;
+    if (KeyframeInfoPtr cached = load(path, mtime, size)) {
+        if (cached->duration > 0) {
+            return;
+        }
+        info = *cached;
+    }
+    info.duration = duration;
+    store(path, mtime, size, info);
+}
+
+// ============ KeyframeIndex ============
+
+KeyframeIndex& KeyframeIndex::instance()
+{
+    static KeyframeIndex instance;
+    return instance;
+}
+
+KeyframeIndex::KeyframeIndex()
+    : QObject(nullptr)
+{
+    qRegisterMetaType<KeyframeInfoPtr>();
+
+    // New library snapshots feed the background probe
+    connect(&MediaIndex::instance(), &MediaIndex::indexReady, this, &KeyframeIndex::onIndexReady);
+    connect(&MediaIndex::instance(), &MediaIndex::indexUpdated, this, &KeyframeIndex::onIndexReady);
+}
+
+KeyframeIndex::~KeyframeIndex()
+{
+    shutdown();
+}
+
+QString KeyframeIndex::databasePath()
+{
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+    return configPath + "/goobert/keyframe_index.db";
+}
+
+bool KeyframeIndex::canProbe() noexcept
+{
+#ifdef GOOBERT_HAVE_AVFORMAT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void KeyframeIndex::startWorker()
+{
+    QDir().mkpath(QFileInfo(databasePath()).path());
+
+    m_abort = false;
+    m_thread = new QThread(this);
+    m_thread->setObjectName("KeyframeIndex");
+
+    m_worker = new KeyframeIndexWorker(&m_abort);
+    m_worker->moveToThread(m_thread);
+    connect(m_worker, &KeyframeIndexWorker::infoReady, this, &KeyframeIndex::onInfoReady);
+
+    m_thread->start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, path = databasePath()]() {
+        worker->open(path);
+    }, Qt::QueuedConnection);
+}
+
+void KeyframeIndex::shutdown()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    // Interrupts a probe in progress, then closes the connection on its own thread
+    m_abort = true;
+    QMetaObject::invokeMethod(m_worker, &KeyframeIndexWorker::close, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+
+    delete m_worker;
+    m_worker = nullptr;
+    delete m_thread;
+    m_thread = nullptr;
+    m_inFlight.clear();
+}
+
+void KeyframeIndex::prefetch(const QStringList &paths)
+{
+    QStringList missing;
+    for (const QString &path : paths) {
+        // object() also moves a resident entry to the front of the LRU
+        if (!path.isEmpty() && !m_resident.object(path) && !m_inFlight.contains(path)) {
+            m_inFlight.insert(path);
+            missing.append(path);
+        }
+    }
+    if (missing.isEmpty()) {
+        return;
+    }
+
+    if (!m_thread) {
+        startWorker();
+    }
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, missing]() {
+        worker->request(missing);
+    }, Qt::QueuedConnection);
+}
+
+void KeyframeIndex::reserveForGrid(int cells, int windowEntries)
+{
+    using namespace KeyframeIndexConstants;
+    m_resident.setMaxCost(std::max<qsizetype>(kResidentEntries, qsizetype(cells) * windowEntries * kResidentHeadroom));
+}
+
+KeyframeInfoPtr KeyframeIndex::lookup(const QString &path) const
+{
+    const KeyframeInfoPtr *info = m_resident.object(path);
+    return info ? *info : nullptr;
+}
+
+double KeyframeIndex::duration(const QString &path) const
+{
+    const KeyframeInfoPtr info = lookup(path);
+    return info ? info->duration : 0.0;
+}
+
+void KeyframeIndex::recordDuration(const QString &path, double duration)
+{
+    if (path.isEmpty() || duration <= 0) {
+        return;
+    }
+
+    const KeyframeInfoPtr info = lookup(path);
+    if (info && info->duration > 0) {
+        return;
+    }
+
+    auto updated = info ? std::make_shared<KeyframeInfo>(*info) : std::make_shared<KeyframeInfo>();
+    updated->duration = duration;
+    insertResident(path, updated);
+
+    if (!m_thread) {
+        startWorker();
+    }
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, path, duration]() {
+        worker->storeDuration(path, duration);
+    }, Qt::QueuedConnection);
+}
+
+void KeyframeIndex::insertResident(const QString &path, const KeyframeInfoPtr &info)
+{
+    m_resident.insert(path, new KeyframeInfoPtr(info));
+}
+
+void KeyframeIndex::onInfoReady(const QString &path, const KeyframeInfoPtr &info)
+{
+    m_inFlight.remove(path);
+
+    // Unprobeable files stay resident as empty entries so the window does
+    // not ask again on every top-up; recordDuration() can still fill them
+    static const KeyframeInfoPtr s_unknown = std::make_shared<const KeyframeInfo>();
+    insertResident(path, info ? info : s_unknown);
+}
+
+void KeyframeIndex::onIndexReady(const QString &root)
+{
+    if (!canProbe()) {
+        return;
+    }
+
+    if (!m_thread) {
+        startWorker();
+    }
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, files = MediaIndex::instance().files(root)]() {
+        worker->backfill(files);
+    }, Qt::QueuedConnection);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QThread>
+#include <QHash>
+#include <QCache>
+#include <QSet>
+#include <QList>
+#include <QVector>
+#include <QMetaType>
+#include <atomic>
+#include <memory>
+
+namespace KeyframeIndexConstants {
+    inline constexpr int kResidentEntries = 256;  // Files kept in memory at least; the rest stay in the database
+    inline constexpr int kResidentHeadroom = 2;   // Resident files per playlist window entry of the grid
+    inline constexpr int kBackfillBatch = 32;     // Files probed per backfill step before requests get a turn
+}
+
+// Container-level seek data for one file. Times are relative to the
+// stream start, like mpv's time-pos.
+struct KeyframeInfo {
+    double duration = 0.0;
+    QVector<double> times;     // Keyframe timestamps in seconds, ascending
+    QVector<qint64> offsets;   // Byte offset of each keyframe, -1 if unknown
+    int width = 0;             // Video stream from the container header; 0/empty if unknown
+    int height = 0;
+    QString codec;             // FFmpeg codec name, e.g. "hevc"
+
+    [[nodiscard]] bool hasKeyframes() const noexcept { return !times.isEmpty(); }
+    [[nodiscard]] double keyframeAtOrBefore(double seconds) const;  // -1 if none
+    [[nodiscard]] double keyframeAtOrAfter(double seconds) const;   // -1 if none
+};
+
+using KeyframeInfoPtr = std::shared_ptr<const KeyframeInfo>;
+Q_DECLARE_METATYPE(KeyframeInfoPtr)
+
+// Lives on the keyframe thread with its own SQLite connection; all slots
+// must be invoked via queued connections.
+class KeyframeIndexWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KeyframeIndexWorker(std::atomic_bool *abort);
+    ~KeyframeIndexWorker() override;
+
+public slots:
+    void open(const QString &dbPath);
+    void close();
+    void request(const QStringList &paths);   // Load or probe, then publish
+    void backfill(const QStringList &paths);  // Probe uncached files, database only
+    void storeDuration(const QString &path, double duration);
+
+signals:
+    void infoReady(const QString &path, const KeyframeInfoPtr &info);
+
+private slots:
+    void processBackfill();
+
+private:
+    bool createTables();
+    [[nodiscard]] KeyframeInfoPtr load(const QString &path, qint64 mtime, qint64 size);
+    [[nodiscard]] KeyframeInfoPtr probe(const QString &path) const;
+    void store(const QString &path, qint64 mtime, qint64 size, const KeyframeInfo &info);
+    [[nodiscard]] KeyframeInfoPtr resolve(const QString &path, bool probeMissing);
+
+    std::atomic_bool *m_abort = nullptr;
+    QSqlDatabase m_db;
+    QSqlQuery m_selectQuery;
+    QSqlQuery m_upsertQuery;
+
+    QStringList m_backfillQueue;
+    QSet<QString> m_backfillQueued;   // Paths in m_backfillQueue
+    bool m_backfillScheduled = false;
+};
+
+// Persistent per-file cache of duration and keyframe positions. Probing only
+// reads container headers (MP4 sample tables, Matroska cues) on a background
+// thread; the GUI reads a small resident set that cells request for the
+// entries they are about to play.
+class KeyframeIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static KeyframeIndex& instance();
+
+    void shutdown();
+
+    // Makes these files resident soon; cheap to call repeatedly. Files
+    // already resident count as recently used again.
+    void prefetch(const QStringList &paths);
+
+    // Room for every cell's playlist window; called per grid
+    void reserveForGrid(int cells, int windowEntries);
+
+    // nullptr until the file is resident
+    [[nodiscard]] KeyframeInfoPtr lookup(const QString &path) const;
+    [[nodiscard]] double duration(const QString &path) const;  // 0 if unknown
+
+    // Playback learned the duration; kept for files that could not be probed
+    void recordDuration(const QString &path, double duration);
+
+    [[nodiscard]] static QString databasePath();
+    [[nodiscard]] static bool canProbe() noexcept;  // Built with libavformat
+
+private slots:
+    void onInfoReady(const QString &path, const KeyframeInfoPtr &info);
+    void onIndexReady(const QString &root);
+
+private:
+    KeyframeIndex();
+    ~KeyframeIndex() override;
+    KeyframeIndex(const KeyframeIndex&) = delete;
+    KeyframeIndex& operator=(const KeyframeIndex&) = delete;
+
+    void startWorker();
+    void insertResident(const QString &path, const KeyframeInfoPtr &info);
+
+    QThread *m_thread = nullptr;
+    KeyframeIndexWorker *m_worker = nullptr;
+    std::atomic_bool m_abort{false};
+
+    QCache<QString, KeyframeInfoPtr> m_resident{KeyframeIndexConstants::kResidentEntries};   // LRU, one cost per file
+    QSet<QString> m_inFlight;
+};
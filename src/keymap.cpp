@@ -42,6 +42,7 @@ void KeyMap::setupDefaultBindings()
     m_bindings[{Qt::Key_4, Qt::NoModifier}] = Action::NextSelected;
     m_bindings[{Qt::Key_Y, Qt::NoModifier}] = Action::ShowPlaylistPicker;
     m_bindings[{Qt::Key_QuoteLeft, Qt::NoModifier}] = Action::ToggleMute;  // ` backtick
+    m_bindings[{Qt::Key_5, Qt::NoModifier}] = Action::TogglePerfHud;
     m_bindings[{Qt::Key_6, Qt::NoModifier}] = Action::PanicReset;  // Panic button - reset session
 
     // === Top Row (QWERT) ===
@@ -102,6 +103,7 @@ void KeyMap::setupDefaultBindings()
     m_descriptions[Action::Rotate] = "Rotate video";
     m_descriptions[Action::Screenshot] = "Take screenshot";
     m_descriptions[Action::PanicReset] = "Panic! Stop & reset session";
+    m_descriptions[Action::TogglePerfHud] = "Toggle performance HUD";
 }
 
 KeyMap::Action KeyMap::getAction(QKeyEvent *event) const
@@ -169,6 +171,7 @@ QString KeyMap::generateTooltip() const
     tooltip += QString("  %1 - %2\n").arg(getKeysForAction(Action::ShuffleThenNextAll).join("/")).arg(getActionDescription(Action::ShuffleThenNextAll));
     tooltip += QString("  %1 - %2\n").arg(getKeysForAction(Action::FullscreenGlobal).join("/")).arg(getActionDescription(Action::FullscreenGlobal));
     tooltip += QString("  %1 - %2\n").arg(getKeysForAction(Action::PanicReset).join("/")).arg(getActionDescription(Action::PanicReset));
+    tooltip += QString("  %1 - %2\n").arg(getKeysForAction(Action::TogglePerfHud).join("/")).arg(getActionDescription(Action::TogglePerfHud));
 
     // Navigation
     tooltip += "\nNavigation:\n";
@@ -238,6 +241,7 @@ QString KeyMap::actionToString(Action action) const
         {Action::Rotate, "Rotate"},
         {Action::Screenshot, "Screenshot"},
         {Action::PanicReset, "PanicReset"},
+        {Action::TogglePerfHud, "TogglePerfHud"},
         {Action::NoAction, "NoAction"}
     };
     return names.value(action, "Unknown");
@@ -276,7 +280,8 @@ KeyMap::Action KeyMap::stringToAction(const QString &str)
         {"ZoomOut", Action::ZoomOut},
         {"Rotate", Action::Rotate},
         {"Screenshot", Action::Screenshot},
-        {"PanicReset", Action::PanicReset}
+        {"PanicReset", Action::PanicReset},
+        {"TogglePerfHud", Action::TogglePerfHud}
     };
     return names.value(str, Action::NoAction);
 }
@@ -46,6 +46,7 @@ public:
         Rotate,
         Screenshot,
         PanicReset,
+        TogglePerfHud,
 
         // No action
         NoAction
@@ -2,12 +2,95 @@
 #include <QCommandLineParser>
 #include <QDir>
 #include <QStandardPaths>
+#include <QTimer>
+#include <QSocketNotifier>
+#include <QDebug>
+#include <chrono>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#ifdef Q_OS_UNIX
+#include <csignal>
+#include <unistd.h>
+#endif
 #include "mainwindow.h"
+#include "soakmonitor.h"
 #include "config.h"
 
+namespace {
+
+// "90", "90s", "30m", "24h"; -1 when unparsable
+qint64 parseDurationSecs(QString value)
+{
+    qint64 unit = 1;
+    if (value.endsWith('h')) unit = 3600;
+    else if (value.endsWith('m')) unit = 60;
+    if (value.endsWith('h') || value.endsWith('m') || value.endsWith('s')) value.chop(1);
+
+    bool ok = false;
+    const qint64 n = value.toLongLong(&ok);
+    return ok && n >= 0 ? n * unit : -1;
+}
+
+// The platform plugin is picked when QApplication is constructed, before
+// the parser runs; headless runs need no display server
+void selectHeadlessPlatform(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0 && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+}
+
+#ifdef Q_OS_UNIX
+int s_terminatePipe[2] = {-1, -1};
+
+void onTerminateSignal(int signal)
+{
+    // Async-signal-safe: the event loop picks it up from the pipe. A second
+    // signal while the summary is written kills the process as usual.
+    std::signal(signal, SIG_DFL);
+    const char byte = 1;
+    (void)::write(s_terminatePipe[1], &byte, 1);
+}
+#endif
+
+// SIGINT/SIGTERM run onTerminate on the GUI thread, once; a soak run that
+// is killed still writes its summary and shuts the stats database down
+void handleTerminateSignals(QObject *context, std::function<void()> onTerminate)
+{
+#ifdef Q_OS_UNIX
+    if (::pipe(s_terminatePipe) != 0) {
+        qWarning() << "Cannot watch for SIGINT/SIGTERM";
+        return;
+    }
+    auto *notifier = new QSocketNotifier(s_terminatePipe[0], QSocketNotifier::Read, context);
+    QObject::connect(notifier, &QSocketNotifier::activated, context, [notifier, onTerminate = std::move(onTerminate)]() {
+        char byte = 0;
+        (void)::read(s_terminatePipe[0], &byte, 1);
+        notifier->setEnabled(false);
+        onTerminate();
+    });
+
+    struct sigaction action = {};
+    action.sa_handler = onTerminateSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+#else
+    Q_UNUSED(context);
+    Q_UNUSED(onTerminate);
+#endif
+}
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
+    selectHeadlessPlatform(argc, argv);
+
     QApplication app(argc, argv);
     app.setApplicationName("Goobert");
     app.setApplicationVersion(GOOBERT_VERSION);
@@ -36,7 +119,7 @@ int main(int argc, char *argv[])
     parser.addHelpOption();
     parser.addVersionOption();
 
-    parser.addPositionalArgument("source", "Source directory containing media files");
+    parser.addPositionalArgument("source", "Source directories containing media files", "[source...]");
 
     QCommandLineOption broadcastOption(
         "broadcast",
@@ -45,6 +128,16 @@ int main(int argc, char *argv[])
     );
     parser.addOption(broadcastOption);
 
+    // Soak testing without a desktop
+    QCommandLineOption headlessOption("headless", "Play the grid without a window or GPU (vo=null) until --duration ends");
+    QCommandLineOption gridOption("grid", QString("Headless grid size, up to %1 each")
+                                  .arg(ToolBarConstants::kMaxGridSize), "COLSxROWS");
+    QCommandLineOption durationOption("duration", "Headless run time, e.g. 90s, 30m or 24h; 0 runs until SIGINT or SIGTERM", "time", "0");
+    QCommandLineOption soakLogOption("soak-log", "JSON lines of memory and per-cell throughput", "file");
+    QCommandLineOption soakIntervalOption("soak-interval", "Seconds between soak samples", "secs",
+                                          QString::number(SoakConstants::kDefaultIntervalSecs));
+    parser.addOptions({headlessOption, gridOption, durationOption, soakLogOption, soakIntervalOption});
+
     parser.process(app);
 
     // Handle broadcast mode
@@ -60,8 +153,8 @@ QString sourceDir;
 const QStringList args = parser.positionalArguments();
 
 if (!args.isEmpty()) {
-    // Command line argument takes priority
-    sourceDir = args.first();
+    // Command line arguments take priority; several roots share one grid
+    sourceDir = args.join(';');
 } else {
     // Try config file first, then fallbacks
     Config &cfg = Config::instance();
@@ -85,6 +178,52 @@ if (!args.isEmpty()) {
     }
 }
 
+    if (parser.isSet(headlessOption)) {
+        Config &cfg = Config::instance();
+        int rows = cfg.defaultRows();
+        int cols = cfg.defaultCols();
+        if (parser.isSet(gridOption)) {
+            const QStringList size = parser.value(gridOption).split('x');
+            cols = size.size() == 2 ? size.at(0).toInt() : 0;
+            rows = size.size() == 2 ? size.at(1).toInt() : 0;
+            // The grid is built through the toolbar, whose spin boxes would clamp silently
+            const int limit = ToolBarConstants::kMaxGridSize;
+            if (cols <= 0 || rows <= 0 || cols > limit || rows > limit) {
+                std::cerr << "Invalid --grid, expected COLSxROWS of at most " << limit << "x" << limit << ": "
+                          << parser.value(gridOption).toStdString() << std::endl;
+                return 2;
+            }
+        }
+        const qint64 durationSecs = parseDurationSecs(parser.value(durationOption));
+        if (durationSecs < 0) {
+            std::cerr << "Invalid --duration: " << parser.value(durationOption).toStdString() << std::endl;
+            return 2;
+        }
+
+        MainWindow window(sourceDir);
+        window.setHeadless(true);
+        // Queued: a warm index fails inside startGrid(), before exec() runs
+        QObject::connect(&window, &MainWindow::gridFailed, &app, [](const QString &reason) {
+            qCritical().noquote() << reason;
+            QCoreApplication::exit(1);
+        }, Qt::QueuedConnection);
+
+        SoakMonitor soak;
+        if (!soak.start(parser.value(soakLogOption), parser.value(soakIntervalOption).toInt())) {
+            return 2;
+        }
+        const auto finish = [&soak]() {
+            soak.stop();
+            QCoreApplication::quit();
+        };
+        handleTerminateSignals(&app, finish);
+        if (durationSecs > 0) {
+            QTimer::singleShot(std::chrono::seconds(durationSecs), &app, finish);
+        }
+        window.startGrid(rows, cols);
+        return app.exec();
+    }
+
     MainWindow window(sourceDir);
     window.show();
 
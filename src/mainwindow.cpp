@@ -1,5 +1,13 @@
 #include "mainwindow.h"
 #include "filescanner.h"
+#include "mediaindex.h"
+#include "keyframeindex.h"
+#include "ioprofiles.h"
+#include "thumbnailcache.h"
+#include "stillimagecache.h"
+#include "framescheduler.h"
+#include "cellstatusstore.h"
+#include "perfmetrics.h"
 #include "config.h"
 #include "keymap.h"
 #include "playlistpicker.h"
@@ -9,15 +17,18 @@
 #include <QKeyEvent>
 #include <QWheelEvent>
 #include <QMouseEvent>
+#include <QMoveEvent>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QApplication>
+#include <QGuiApplication>
 #include <QScreen>
 #include <QDateTime>
 #include <QStatusBar>
 #include <QFileInfo>
 #include <QFileDialog>
+#include <QDebug>
 #include <random>
 #include <algorithm>
 #include <utility>
@@ -41,13 +52,42 @@ MainWindow::MainWindow(QString sourceDir, QWidget *parent)
     setWindowTitle(QString("Goobert %1").arg(GOOBERT_VERSION));
     resize(kDefaultWidth, kDefaultHeight);
 
+    m_scheduler = new PlaybackScheduler(this);
+    m_supervisor = new CellSupervisor(this);
+    connect(m_supervisor, &CellSupervisor::cellRestarted, this, &MainWindow::onCellRestarted);
+    connect(m_supervisor, &CellSupervisor::fileBlocked, this, [this](const QString &path) {
+        log(QString("Skipping %1 after repeated failures").arg(QFileInfo(path).fileName()));
+    });
     setupUi();
+
+    PerfMetrics &perf = PerfMetrics::instance();
+    connect(&perf, &PerfMetrics::hudVisibilityChanged, m_sidePanel->monitor(), &MonitorWidget::setPerfColumnsVisible);
+    connect(&perf, &PerfMetrics::firstFrame, this, [this](qint64 ms) {
+        log(QString("First frame after %1 ms").arg(ms));
+    });
+    m_metricsServer = new MetricsServer(this);
+    m_metricsServer->listen(static_cast<quint16>(cfg.metricsPort()));
+
+    // Cell repaints are paced by this window's vsync
+    FrameScheduler::instance().setWindow(this);
+
+    // Created before indexing starts so it sees the first snapshots
+    (void)KeyframeIndex::instance();
+
+    // Warm the media index for the default sources so Start doesn't wait
+    for (const QString &dir : m_toolBar->sourceDirs()) {
+        MediaIndex::instance().ensureIndexed(dir);
+    }
 }
 
 MainWindow::~MainWindow()
 {
     stopGrid();
     StatsManager::instance().shutdown();
+    ThumbnailCache::instance().shutdown();
+    StillImageCache::instance().shutdown();
+    KeyframeIndex::instance().shutdown();
+    MediaIndex::instance().shutdown();
 }
 
 void MainWindow::setupUi()
@@ -138,13 +178,17 @@ void MainWindow::setupUi()
         m_sidePanel->setVisible(!m_sidePanel->isVisible());
     });
     connect(m_toolBar, &ToolBar::browseClicked, this, [this]() {
-        QString dir = QFileDialog::getExistingDirectory(this, "Select Media Directory", m_toolBar->sourceDir());
+        QString dir = QFileDialog::getExistingDirectory(this, "Select Media Directory", m_toolBar->sourceDirs().value(0));
         if (!dir.isEmpty()) {
             m_toolBar->setSourceDir(dir);
         }
     });
     connect(m_toolBar, &ToolBar::settingsClicked, this, &MainWindow::showSettings);
 
+    connect(&MediaIndex::instance(), &MediaIndex::indexBatch, this, &MainWindow::onIndexBatch);
+    connect(&MediaIndex::instance(), &MediaIndex::indexReady, this, &MainWindow::onIndexReady);
+    connect(&CellStatusStore::instance(), &CellStatusStore::snapshotReady, this, &MainWindow::onCellStatusSnapshot);
+
     // Connect side panel signals
     connect(m_sidePanel, &SidePanel::cellSelected, this, &MainWindow::onCellSelected);
     connect(m_sidePanel, &SidePanel::fileRenamed, this, &MainWindow::onFileRenamed);
@@ -159,22 +203,143 @@ void MainWindow::setupUi()
     });
 }
 
+void MainWindow::setHeadless(bool headless)
+{
+    m_headless = headless;
+    MpvWidget::setHeadless(headless);
+}
+
+void MainWindow::startGrid(int rows, int cols)
+{
+    m_toolBar->setGridSize(rows, cols);
+    startGrid();
+}
+
 void MainWindow::startGrid()
 {
     m_sourceDir = m_toolBar->sourceDir();
     m_rows = m_toolBar->rows();
     m_cols = m_toolBar->cols();
-    QString filter = m_toolBar->filter();
+    m_pendingGridFilter = m_toolBar->filter();
+    m_pendingGridRoots.clear();
+    m_streamedRoots.clear();
+    m_pendingGridFiles.clear();
+    m_gridStreaming = false;
+    PerfMetrics::instance().gridStarting();
+
+    // Files come from the background media index; never walk the tree here
+    MediaIndex &index = MediaIndex::instance();
+    for (const QString &dir : m_toolBar->sourceDirs()) {
+        const QString root = MediaIndex::normalizedRoot(dir);
+        index.ensureIndexed(root);
+
+        if (index.isReady(root)) {
+            m_pendingGridFiles.append(index.filteredFiles(root, m_pendingGridFilter));
+            continue;
+        }
 
-    // Scan for media files with optional filter
-    FileScanner scanner;
-    QStringList files = scanner.scan(m_sourceDir, filter);
+        // First walk already under way (e.g. from the startup warm-up): pick up what it found
+        m_pendingGridRoots.insert(root);
+        const QStringList discovered = index.discoveredFiles(root);
+        if (!discovered.isEmpty()) {
+            m_streamedRoots.insert(root);
+            m_pendingGridFiles.append(FileScanner::applyFilter(discovered, m_pendingGridFilter));
+        }
+    }
+
+    if (m_pendingGridRoots.isEmpty()) {
+        launchGrid(std::exchange(m_pendingGridFiles, {}));
+        return;
+    }
+
+    // Enough discovered already? Start now and stream the rest
+    log(QString("Indexing %1...").arg(m_sourceDir));
+    addPendingGridFiles({});
+}
+
+void MainWindow::onIndexBatch(const QString &root, const QStringList &files)
+{
+    if (!m_pendingGridRoots.contains(root)) {
+        return;
+    }
+
+    m_streamedRoots.insert(root);
+    addPendingGridFiles(FileScanner::applyFilter(files, m_pendingGridFilter));
+}
+
+void MainWindow::onIndexReady(const QString &root, int fileCount)
+{
+    Q_UNUSED(fileCount);
+
+    if (!m_pendingGridRoots.remove(root)) {
+        return;
+    }
+
+    // Streamed roots already delivered every file through onIndexBatch
+    if (!m_streamedRoots.contains(root)) {
+        addPendingGridFiles(MediaIndex::instance().filteredFiles(root, m_pendingGridFilter));
+    }
+
+    if (!m_pendingGridRoots.isEmpty()) {
+        return;
+    }
+
+    if (!m_gridStreaming) {
+        launchGrid(std::exchange(m_pendingGridFiles, {}));
+    }
+    m_gridStreaming = false;
+    m_streamedRoots.clear();
+}
+
+void MainWindow::addPendingGridFiles(const QStringList &files)
+{
+    if (m_gridStreaming) {
+        appendToGrid(files);
+        return;
+    }
+
+    m_pendingGridFiles.append(files);
+    if (m_pendingGridFiles.size() >= MainWindowConstants::kStreamingStartFiles) {
+        m_gridStreaming = true;
+        launchGrid(std::exchange(m_pendingGridFiles, {}));
+    }
+}
+
+void MainWindow::appendToGrid(const QStringList &files)
+{
+    if (files.isEmpty() || !m_pathTable) return;
+
+    const QVector<quint32> indices = m_pathTable->addAll(files);
+
+    for (int r = 0; r < m_rows; ++r) {
+        for (int c = 0; c < m_cols; ++c) {
+            GridCell *cell = m_cellMap.value({r, c});
+            if (cell) {
+                // Each cell scatters the batch over its own unplayed entries
+                const int previousSize = cell->playlist().size();
+                const int changedFrom = cell->appendToPlaylist(indices);
+                m_sidePanel->playlist()->appendToCellPlaylist(r, c, cell->playlist(), previousSize, changedFrom);
+            }
+        }
+    }
+
+    m_gridFileCount += files.size();
+    m_cellCountLabel->setText(QString("%1 cells • %2 files").arg(m_rows * m_cols).arg(m_gridFileCount));
+}
+
+void MainWindow::launchGrid(const QStringList &files)
+{
+    const QString filter = m_pendingGridFilter;
 
     if (files.isEmpty()) {
         QString msg = filter.isEmpty()
             ? QString("No media files found in %1").arg(m_sourceDir)
             : QString("No files matching filter '%1' in %2").arg(filter, m_sourceDir);
-        QMessageBox::warning(this, "No Media", msg);
+        if (m_headless) {
+            emit gridFailed(msg);
+        } else {
+            QMessageBox::warning(this, "No Media", msg);
+        }
         return;
     }
 
@@ -186,23 +351,28 @@ void MainWindow::startGrid()
     clearGrid();
     buildGrid(m_rows, m_cols);
     m_currentFilter = filter;
-    m_cellPlaylists.clear();
+
+    IoProfiles::instance().refresh();   // Shares may have been mounted since the last grid
+
+    // One path table for the whole grid; cells only hold index permutations
+    m_pathTable = std::make_shared<PathTable>();
+    const Playlist base(m_pathTable, m_pathTable->addAll(files));
 
     // Clear and populate playlist widget
     m_sidePanel->playlist()->clear();
 
-    // Distribute files to cells
+    // Distribute files to cells; the scheduler releases them a few at a time
     for (int r = 0; r < m_rows; ++r) {
         for (int c = 0; c < m_cols; ++c) {
             GridCell *cell = m_cellMap[{r, c}];
             if (cell) {
-                // Shuffle files for each cell using static RNG
-                QStringList shuffled = files;
-                std::shuffle(shuffled.begin(), shuffled.end(), s_rng);
+                // Shuffle order for each cell using static RNG
+                Playlist shuffled = base;
+                shuffled.shuffle(s_rng);
+                cell->deferStart();
                 cell->setPlaylist(shuffled);
                 cell->play();
-                // Store playlist for auto-restart and UI
-                m_cellPlaylists[{r, c}] = shuffled;
+                m_scheduler->schedule(cell);
                 m_sidePanel->playlist()->setCellPlaylist(r, c, shuffled);
             }
         }
@@ -210,7 +380,8 @@ void MainWindow::startGrid()
 
     m_toolBar->setRunning(true);
     m_runningIndicator->setStyleSheet(QString("color: %1; font-size: 14px; padding: 0 8px;").arg(Theme::Colors::Success));
-    m_cellCountLabel->setText(QString("%1 cells • %2 files").arg(m_rows * m_cols).arg(files.size()));
+    m_gridFileCount = files.size();
+    m_cellCountLabel->setText(QString("%1 cells • %2 files").arg(m_rows * m_cols).arg(m_gridFileCount));
     log(QString("Started %1x%2 grid").arg(m_cols).arg(m_rows));
 
     // Log grid start event
@@ -224,20 +395,19 @@ void MainWindow::startGrid()
         onCellSelected(0, 0);
     }
 
-    // Start watchdog timer
-    if (!m_watchdogTimer) {
-        m_watchdogTimer = new QTimer(this);
-        connect(m_watchdogTimer, &QTimer::timeout, this, &MainWindow::watchdogCheck);
-    }
-    m_watchdogTimer->start(cfg.watchdogIntervalMs());
+    m_supervisor->start(m_cells);
+    emit gridLaunched();
 }
 
 void MainWindow::stopGrid()
 {
-    // Stop watchdog
-    if (m_watchdogTimer) {
-        m_watchdogTimer->stop();
-    }
+    m_pendingGridRoots.clear();
+    m_streamedRoots.clear();
+    m_pendingGridFiles.clear();
+    m_gridStreaming = false;
+
+    // Before stop(), so stopped cells are not restarted
+    m_supervisor->stop();
 
     // Stop all stats tracking
     Config &cfg = Config::instance();
@@ -250,7 +420,7 @@ void MainWindow::stopGrid()
         cell->stop();
     }
     clearGrid();
-    m_cellPlaylists.clear();
+    m_pathTable.reset();
     m_selectedCell = nullptr;
     m_selectedRow = -1;
     m_selectedCol = -1;
@@ -266,38 +436,52 @@ void MainWindow::stopGrid()
 
 void MainWindow::buildGrid(int rows, int cols)
 {
+    // Every cell's playlist window stays resident, or seeks and the skipper miss
+    KeyframeIndex::instance().reserveForGrid(rows * cols, MpvConstants::kPlaylistWindow);
+
+    // Shared wall surface; cells only keep their own surface for tile fullscreen
+    const bool wallMode = !m_headless && Config::instance().wallRendererEnabled();
+    if (wallMode && !m_wallRenderer) {
+        m_wallRenderer = new WallRenderer(m_wallContainer);
+        m_wallRenderer->show();
+    } else if (!wallMode && m_wallRenderer) {
+        delete m_wallRenderer;
+        m_wallRenderer = nullptr;
+    }
+
     for (int r = 0; r < rows; ++r) {
         m_gridLayout->setRowStretch(r, 1);
         for (int c = 0; c < cols; ++c) {
             m_gridLayout->setColumnStretch(c, 1);
 
             auto *cell = new GridCell(r, c, m_wallContainer);
+            if (m_wallRenderer) {
+                cell->setWallRenderer(m_wallRenderer);
+            }
             m_gridLayout->addWidget(cell, r, c);
             m_cells.append(cell);
             m_cellMap[{r, c}] = cell;
 
             connect(cell, &GridCell::selected, this, &MainWindow::onCellSelected);
             connect(cell, &GridCell::doubleClicked, this, &MainWindow::onCellDoubleClicked);
-
-            // Connect to monitor widget
-            connect(cell, &GridCell::fileChanged, m_sidePanel->monitor(), &MonitorWidget::updateCellStatus);
-
-            // Update playlist highlight when file changes
-            connect(cell, &GridCell::fileChanged, this, [this](int row, int col, const QString &path, double, double, bool) {
-                m_sidePanel->playlist()->updateCurrentFile(row, col, path);
-            });
         }
     }
+
+    // Cells report into the store; the side panel reads it once per tick
+    CellStatusStore::instance().reset(rows, cols);
 }
 
 void MainWindow::clearGrid()
 {
+    m_scheduler->clear();
+    m_supervisor->stop();
     for (GridCell *cell : m_cells) {
         m_gridLayout->removeWidget(cell);
         delete cell;
     }
     m_cells.clear();
     m_cellMap.clear();
+    CellStatusStore::instance().clear();
 
     // Reset all stretch factors
     for (int i = 0; i < MainWindowConstants::kMaxGridSize; ++i) {
@@ -374,6 +558,9 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
     case KeyMap::Action::PanicReset:
         panicReset();
         break;
+    case KeyMap::Action::TogglePerfHud:
+        PerfMetrics::instance().setHudVisible(!PerfMetrics::instance().isHudVisible());
+        break;
 
     // Navigation
     case KeyMap::Action::NavigateUp:
@@ -509,21 +696,27 @@ void MainWindow::enterTileFullscreen(int row, int col)
     for (GridCell *c : m_cells) {
         if (c != cell) {
             c->hide();
-            c->pause();
-            c->mute();
         }
     }
 
+    // The fullscreen cell renders on its own surface so the OSC works
+    if (m_wallRenderer) {
+        cell->setWallRenderer(nullptr);
+        m_wallRenderer->hide();
+    }
+
     // Make selected cell fill the grid
     m_gridLayout->removeWidget(cell);
     m_gridLayout->addWidget(cell, 0, 0, m_rows, m_cols);
 
     m_isTileFullscreen = true;
     m_fullscreenCell = cell;
+    updateCellSuspension();
 
     // Enable full mpv GUI (OSC) for fullscreen cell
     cell->setOscEnabled(true);
     cell->setOsdLevel(1);
+    cell->setQualityPinned(true);
 
     if (!m_isFullscreen) {
         toggleFullscreen();
@@ -545,6 +738,11 @@ void MainWindow::exitTileFullscreen()
     if (m_fullscreenCell) {
         m_fullscreenCell->setOscEnabled(false);
         m_fullscreenCell->setOsdLevel(0);
+        m_fullscreenCell->setQualityPinned(false);
+        if (m_wallRenderer) {
+            m_wallRenderer->show();
+            m_fullscreenCell->setWallRenderer(m_wallRenderer);
+        }
     }
 
     // Restore all cells
@@ -558,14 +756,13 @@ void MainWindow::exitTileFullscreen()
             if (cell) {
                 m_gridLayout->addWidget(cell, r, c);
                 cell->show();
-                cell->unmute();
-                cell->play();
             }
         }
     }
 
     m_isTileFullscreen = false;
     m_fullscreenCell = nullptr;
+    updateCellSuspension();
     log("Tile fullscreen OFF");
 
     // Log tile fullscreen exit event
@@ -604,13 +801,61 @@ void MainWindow::onCellDoubleClicked(int row, int col)
     }
 }
 
-void MainWindow::playPauseAll()
+void MainWindow::broadcast(const QVariantList &args, bool includeSuspended)
 {
+    const MpvCommand cmd(args);
     for (GridCell *cell : m_cells) {
-        cell->togglePause();
+        if (!includeSuspended && cell->isSuspended()) continue;
+        cell->sendCommand(cmd);
     }
 }
 
+void MainWindow::updateCellSuspension()
+{
+    // Nothing is on screen, but a soak run plays every cell
+    if (m_headless) return;
+
+    const bool minimized = isMinimized();
+    const QList<QScreen*> screens = QGuiApplication::screens();
+
+    for (GridCell *cell : m_cells) {
+        bool hidden = minimized || (m_isTileFullscreen && cell != m_fullscreenCell);
+
+        // Cells dragged past every screen edge are not visible either
+        if (!hidden) {
+            const QRect global(cell->mapToGlobal(QPoint(0, 0)), cell->size());
+            hidden = std::none_of(screens.cbegin(), screens.cend(), [&global](const QScreen *screen) {
+                return screen->geometry().intersects(global);
+            });
+        }
+
+        cell->setSuspended(hidden);
+    }
+
+    // Hidden cells give up their hardware decoders
+    m_scheduler->requestRebalance();
+}
+
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::WindowStateChange) {
+        updateCellSuspension();
+    }
+    QMainWindow::changeEvent(event);
+}
+
+void MainWindow::moveEvent(QMoveEvent *event)
+{
+    QMainWindow::moveEvent(event);
+    updateCellSuspension();
+}
+
+void MainWindow::playPauseAll()
+{
+    // Suspended cells resume with whatever pause state they had
+    broadcast({"cycle", "pause"}, false);
+}
+
 void MainWindow::nextAll()
 {
     for (GridCell *cell : m_cells) {
@@ -635,13 +880,7 @@ void MainWindow::shuffleAll()
 void MainWindow::muteAll()
 {
     m_isMuted = !m_isMuted;
-    for (GridCell *cell : m_cells) {
-        if (m_isMuted) {
-            cell->mute();
-        } else {
-            cell->unmute();
-        }
-    }
+    broadcast({"set", "mute", m_isMuted ? "yes" : "no"});
     m_toolBar->setMuteActive(m_isMuted);
 
     // Log mute event
@@ -653,9 +892,7 @@ void MainWindow::muteAll()
 void MainWindow::setVolumeAll(int volume)
 {
     m_currentVolume = volume;
-    for (GridCell *cell : m_cells) {
-        cell->setVolume(volume);
-    }
+    broadcast({"set", "volume", volume});
 }
 
 void MainWindow::volumeUpAll()
@@ -729,8 +966,8 @@ void MainWindow::showPlaylistPicker()
 {
     if (!m_selectedCell) return;
 
-    // Get actual playlist from mpv (matches internal order)
-    QStringList playlist = m_selectedCell->currentPlaylist();
+    // Logical playlist of the cell; indices map straight to playIndex()
+    const Playlist &playlist = m_selectedCell->playlist();
     if (playlist.isEmpty()) return;
 
     // Show picker dialog
@@ -836,9 +1073,12 @@ void MainWindow::mousePressEvent(QMouseEvent *event)
 
 void MainWindow::onFileRenamed(const QString &oldPath, const QString &newPath)
 {
-    // Update all cells' playlists
+    // All cell playlists resolve through the shared table
+    if (m_pathTable) {
+        m_pathTable->rename(oldPath, newPath);
+    }
     for (GridCell *cell : m_cells) {
-        cell->updatePlaylistPath(oldPath, newPath);
+        cell->updateCurrentFilePath(oldPath, newPath);
     }
 
     // Log rename event
@@ -852,11 +1092,12 @@ void MainWindow::onCustomSource(int row, int col, const QStringList &paths)
     GridCell *cell = m_cellMap.value({row, col});
     if (!cell) return;
 
-    // Scan for media files
+    // Prefer the media index; custom sources are usually small hand-picked folders
+    MediaIndex &index = MediaIndex::instance();
     FileScanner scanner;
     QStringList files;
     for (const QString &path : paths) {
-        files.append(scanner.scan(path));
+        files.append(index.isReady(path) ? index.files(path) : scanner.scan(path));
     }
 
     if (files.isEmpty()) {
@@ -864,11 +1105,15 @@ void MainWindow::onCustomSource(int row, int col, const QStringList &paths)
         return;
     }
 
-    // Shuffle files
-    std::shuffle(files.begin(), files.end(), s_rng);
+    // Share the grid's path table so renames reach this cell too
+    if (!m_pathTable) {
+        m_pathTable = std::make_shared<PathTable>();
+    }
+    Playlist playlist(m_pathTable, m_pathTable->addAll(files));
+    playlist.shuffle(s_rng);
 
     // Set playlist and play
-    cell->setPlaylist(files);
+    cell->setPlaylist(playlist);
     cell->play();
     cell->setVolume(m_currentVolume);
 
@@ -906,30 +1151,27 @@ void MainWindow::navigateSelection(int colDelta, int rowDelta)
     onCellSelected(newRow, newCol);
 }
 
-void MainWindow::watchdogCheck()
+void MainWindow::onCellRestarted(int row, int col, const QString &reason)
 {
-    // Check each cell and restart if it seems dead (no file playing)
-    for (int r = 0; r < m_rows; ++r) {
-        for (int c = 0; c < m_cols; ++c) {
-            GridCell *cell = m_cellMap.value({r, c});
-            if (!cell) continue;
-
-            // Skip if cell is in tile fullscreen mode (hidden cells are expected to be idle)
-            if (m_isTileFullscreen && cell != m_fullscreenCell) continue;
-
-            // Check if cell has no current file (indicates it may have stopped)
-            QString currentFile = cell->currentFile();
-            if (currentFile.isEmpty()) {
-                // Try to restart with stored playlist
-                QStringList playlist = m_cellPlaylists.value({r, c});
-                if (!playlist.isEmpty()) {
-                    log(QString("Restarting cell [%1,%2]").arg(r).arg(c));
-                    std::shuffle(playlist.begin(), playlist.end(), s_rng);
-                    cell->setPlaylist(playlist);
-                    cell->play();
-                    cell->setVolume(m_currentVolume);
-                }
-            }
+    log(QString("Restarting cell [%1,%2]: %3").arg(row).arg(col).arg(reason));
+    if (GridCell *cell = m_cellMap.value({row, col})) {
+        cell->setVolume(m_currentVolume);
+    }
+}
+
+void MainWindow::onCellStatusSnapshot()
+{
+    const QVector<CellStatus> &cells = CellStatusStore::instance().snapshot();
+    m_sidePanel->monitor()->updateCellStatus(cells);
+
+    const bool trackStats = Config::instance().statsEnabled();
+    PlaylistWidget *playlist = m_sidePanel->playlist();
+    for (const CellStatus &status : cells) {
+        if (status.changes & CellStatus::FileChange) {
+            playlist->updateCurrentFile(status.row, status.col, status.path);
+        }
+        if (trackStats && (status.changes & CellStatus::PositionChange) && !status.path.isEmpty()) {
+            StatsManager::instance().updatePosition(status.row, status.col, status.position);
         }
     }
 }
@@ -938,6 +1180,9 @@ void MainWindow::log(const QString &message)
 {
     QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
     m_statusLabel->setText(QString("[%1] %2").arg(timestamp, message));
+    if (m_headless) {
+        qInfo().noquote() << QString("[%1] %2").arg(timestamp, message);
+    }
 }
 
 void MainWindow::showSettings()
@@ -946,6 +1191,11 @@ void MainWindow::showSettings()
     if (dialog.exec() == QDialog::Accepted) {
         // Refresh tooltip with updated key bindings
         m_toolBar->setToolTip(KeyMap::instance().generateTooltip());
+        IoProfiles::instance().refresh();   // Network paths may have changed
+        m_scheduler->requestRebalance();  // hwdec budget and cache memory may have changed
+        if (const int port = Config::instance().metricsPort(); port != m_metricsServer->serverPort()) {
+            m_metricsServer->listen(static_cast<quint16>(port));
+        }
         log("Settings saved");
     }
 }
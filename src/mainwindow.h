@@ -5,6 +5,7 @@
 #include <QSplitter>
 #include <QVector>
 #include <QMap>
+#include <QSet>
 #include <QTimer>
 #include <QLabel>
 #include <memory>
@@ -13,6 +14,10 @@
 #include "toolbar.h"
 #include "sidepanel.h"
 #include "settingsdialog.h"
+#include "wallrenderer.h"
+#include "playbackscheduler.h"
+#include "cellsupervisor.h"
+#include "metricsserver.h"
 
 // Constants
 namespace MainWindowConstants {
@@ -25,8 +30,8 @@ namespace MainWindowConstants {
     inline constexpr int kGridMargin = 2;
     inline constexpr int kGridSpacing = 2;
     inline constexpr int kMaxGridSize = 10;
-    inline constexpr int kWatchdogIntervalMs = 5000;
     inline constexpr int kShuffleNextDelayMs = 200;
+    inline constexpr int kStreamingStartFiles = 200;
     inline constexpr int kVolumeStep = 5;
     inline constexpr double kSeekStepSeconds = 5.0;
     inline constexpr double kSeekStepLongSeconds = 120.0;
@@ -44,21 +49,40 @@ public:
     MainWindow(const MainWindow&) = delete;
     MainWindow& operator=(const MainWindow&) = delete;
 
+    // Scripted control (goobert_bench); the same path as the toolbar's Start
+    void startGrid(int rows, int cols);
+    [[nodiscard]] const QVector<GridCell*>& cells() const noexcept { return m_cells; }
+
+    // Headless (--headless): the window is never shown, cells play with
+    // vo=null, there is no wall renderer and log lines go to stderr
+    void setHeadless(bool headless);
+    [[nodiscard]] bool isHeadless() const noexcept { return m_headless; }
+
+public slots:
+    void stopGrid();
+    void nextAll();
+
+signals:
+    void gridLaunched();   // Cells built and scheduled; none has started playing yet
+    void gridFailed(const QString &reason);   // Nothing to play; headless only, otherwise a message box
+
 protected:
     void keyPressEvent(QKeyEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     bool eventFilter(QObject *watched, QEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void moveEvent(QMoveEvent *event) override;
 
 private slots:
     void startGrid();
-    void stopGrid();
+    void onIndexBatch(const QString &root, const QStringList &files);
+    void onIndexReady(const QString &root, int fileCount);
     void toggleFullscreen();
     void exitFullscreen();
     void panicReset();
 
     void playPauseAll();
-    void nextAll();
     void prevAll();
     void shuffleAll();
     void shuffleThenNextAll();
@@ -84,18 +108,24 @@ private slots:
     void onCellDoubleClicked(int row, int col);
     void onFileRenamed(const QString &oldPath, const QString &newPath);
     void onCustomSource(int row, int col, const QStringList &paths);
+    void onCellStatusSnapshot();
     void navigateSelection(int colDelta, int rowDelta);
-    void watchdogCheck();
+    void onCellRestarted(int row, int col, const QString &reason);
     void log(const QString &message);
     void showSettings();
 
 private:
     void setupUi();
+    void launchGrid(const QStringList &files);
+    void appendToGrid(const QStringList &files);
+    void addPendingGridFiles(const QStringList &files);
     void buildGrid(int rows, int cols);
     void clearGrid();
     void enterTileFullscreen(int row, int col);
     void exitTileFullscreen();
     [[nodiscard]] GridCell* selectedCell() const noexcept;
+    void broadcast(const QVariantList &args, bool includeSuspended = true);  // Same mpv command to every cell, converted once
+    void updateCellSuspension();  // Suspends cells that cannot be seen, resumes the rest
 
     QString m_sourceDir;
     int m_rows = 3;
@@ -105,6 +135,10 @@ private:
     QSplitter *m_splitter = nullptr;
     QWidget *m_wallContainer = nullptr;
     QGridLayout *m_gridLayout = nullptr;
+    WallRenderer *m_wallRenderer = nullptr;  // Only with video/wall_renderer
+    PlaybackScheduler *m_scheduler = nullptr;  // Staggered start and the hwdec budget
+    CellSupervisor *m_supervisor = nullptr;    // Auto-restart and the failed-file blocklist
+    MetricsServer *m_metricsServer = nullptr;  // Only listening with perf/metrics_port
 
     // New UI components
     ToolBar *m_toolBar = nullptr;
@@ -119,17 +153,26 @@ private:
     bool m_isFullscreen = false;
     bool m_isTileFullscreen = false;
     bool m_isMuted = false;
+    bool m_headless = false;
     GridCell *m_fullscreenCell = nullptr;
     GridCell *m_selectedCell = nullptr;
     int m_selectedRow = -1;
     int m_selectedCol = -1;
     int m_currentVolume = 30;
 
-    // Watchdog for auto-restart
-    QTimer *m_watchdogTimer = nullptr;
-    QMap<QPair<int,int>, QStringList> m_cellPlaylists;
+    PathTablePtr m_pathTable;  // Shared by every cell playlist of the running grid
     QString m_currentFilter;
 
+    int m_gridFileCount = 0;
+
+    // Grid start waiting on the media index. Cold roots stream batches and the
+    // grid starts once kStreamingStartFiles have arrived; the rest is appended.
+    QSet<QString> m_pendingGridRoots;
+    QSet<QString> m_streamedRoots;
+    QStringList m_pendingGridFiles;
+    QString m_pendingGridFilter;
+    bool m_gridStreaming = false;
+
     // Random number generator for shuffle operations
     static inline std::mt19937 s_rng{std::random_device{}()};
 };
@@ -0,0 +1,605 @@
+#include "mediaindex.h"
+#include "filescanner.h"
+#include "perfmetrics.h"
+#include <QSqlError>
+#include <QStandardPaths>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDebug>
+#include <utility>
+
+namespace {
+    const QString kConnectionName = QStringLiteral("media_index_connection");
+
+    bool mediaTypeFor(const QFileInfo &fi, MediaType &type)
+    {
+        const QString ext = fi.suffix().toLower();
+        if (FileScanner::videoExtensions().contains(ext)) {
+            type = MediaType::Video;
+            return true;
+        }
+        if (FileScanner::imageExtensions().contains(ext)) {
+            type = MediaType::Image;
+            return true;
+        }
+        return false;
+    }
+
+    bool isUnder(const QString &path, const QString &dir)
+    {
+        return path.size() > dir.size() && path.startsWith(dir) && path.at(dir.size()) == QLatin1Char('/');
+    }
+}
+
+// ============ MediaIndexWorker ============
+
+MediaIndexWorker::MediaIndexWorker(std::atomic_bool *abort)
+    : QObject(nullptr)
+    , m_abort(abort)
+{
+}
+
+MediaIndexWorker::~MediaIndexWorker()
+{
+    close();
+}
+
+void MediaIndexWorker::open(const QString &dbPath)
+{
+    if (m_db.isOpen()) {
+        return;
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    m_db.setDatabaseName(dbPath);
+
+    if (!m_db.open()) {
+        qWarning() << "Failed to open media index database:" << m_db.lastError().text();
+    } else {
+        QSqlQuery pragma(m_db);
+        pragma.exec("PRAGMA journal_mode=WAL");
+        pragma.exec("PRAGMA synchronous=NORMAL");
+
+        if (!createTables()) {
+            qWarning() << "Failed to create media index tables";
+        }
+
+        m_upsertQuery = QSqlQuery(m_db);
+        m_upsertQuery.prepare("INSERT OR REPLACE INTO media_files (root, path, dir, mtime, size, media_type) "
+                              "VALUES (?, ?, ?, ?, ?, ?)");
+        m_deleteQuery = QSqlQuery(m_db);
+        m_deleteQuery.prepare("DELETE FROM media_files WHERE root = ? AND path = ?");
+    }
+
+    // Without a database the index still works, it just starts cold every run
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &MediaIndexWorker::onDirectoryChanged);
+
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(MediaIndexConstants::kWatchDebounceMs);
+    connect(m_debounceTimer, &QTimer::timeout, this, &MediaIndexWorker::processPendingDirectories);
+
+    qDebug() << "MediaIndex opened, database:" << dbPath;
+}
+
+void MediaIndexWorker::close()
+{
+    // Children must go while we are still on the index thread
+    delete m_debounceTimer;
+    m_debounceTimer = nullptr;
+    delete m_watcher;
+    m_watcher = nullptr;
+    m_pendingDirs.clear();
+    m_watchedDirs.clear();
+    m_knownDirs.clear();
+
+    if (!m_db.isValid()) {
+        return;
+    }
+
+    commitIfNeeded(true);
+    m_upsertQuery = QSqlQuery();
+    m_deleteQuery = QSqlQuery();
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(kConnectionName);
+}
+
+bool MediaIndexWorker::createTables()
+{
+    QSqlQuery query(m_db);
+
+    bool ok = query.exec(R"(
+        CREATE TABLE IF NOT EXISTS media_files (
+            root TEXT NOT NULL,
+            path TEXT NOT NULL,
+            dir TEXT NOT NULL,
+            mtime INTEGER NOT NULL,
+            size INTEGER NOT NULL,
+            media_type INTEGER NOT NULL,
+            PRIMARY KEY (root, path)
+        )
+    )");
+
+    if (!ok) {
+        qWarning() << "Failed to create media_files table:" << query.lastError().text();
+        return false;
+    }
+
+    query.exec("CREATE INDEX IF NOT EXISTS idx_media_files_dir ON media_files(root, dir)");
+
+    return true;
+}
+
+void MediaIndexWorker::indexRoot(const QString &root)
+{
+    if (m_roots.contains(root)) {
+        emitSnapshot(root, false);
+        return;
+    }
+
+    QHash<QString, MediaEntry> &entries = m_roots[root];
+
+    // Publish the persisted snapshot first so a grid can start immediately
+    loadRoot(root, entries);
+    if (!entries.isEmpty()) {
+        emitSnapshot(root, true);
+    }
+
+    // Reconcile against the filesystem once per session; watchers take over afterwards.
+    // With nothing cached, stream what the walk finds so a waiting grid can start early.
+    const bool cold = entries.isEmpty();
+    QSet<QString> seen;
+    seen.reserve(entries.size());
+    indexTree(root, root, entries, &seen, cold);
+
+    if (m_abort->load(std::memory_order_relaxed)) {
+        commitIfNeeded(true);
+        return;
+    }
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!seen.contains(it.key())) {
+            remove(root, it.key());
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    commitIfNeeded(true);
+    emitSnapshot(root, false);
+}
+
+void MediaIndexWorker::loadRoot(const QString &root, QHash<QString, MediaEntry> &entries)
+{
+    if (!m_db.isOpen()) {
+        return;
+    }
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT path, dir, mtime, size, media_type FROM media_files WHERE root = ?");
+    query.addBindValue(root);
+
+    if (!query.exec()) {
+        qWarning() << "Failed to load media index:" << query.lastError().text();
+        return;
+    }
+
+    while (query.next()) {
+        MediaEntry entry;
+        entry.dir = query.value(1).toString();
+        entry.mtime = query.value(2).toLongLong();
+        entry.size = query.value(3).toLongLong();
+        entry.type = static_cast<MediaType>(query.value(4).toInt());
+        entries.insert(query.value(0).toString(), entry);
+        m_knownDirs.insert(entry.dir);
+    }
+}
+
+void MediaIndexWorker::indexTree(const QString &root, const QString &dir,
+                                 QHash<QString, MediaEntry> &entries, QSet<QString> *seen, bool stream)
+{
+    if (!QFileInfo(dir).isDir()) {
+        return;
+    }
+
+    watchDirectory(dir);
+
+    FileScanner scanner;
+    scanner.scanParallel({dir}, [&](const FileScanner::ScanBatch &batch) {
+        for (const QString &subdir : batch.directories) {
+            watchDirectory(subdir);
+        }
+
+        QStringList found;
+        for (const FileScanner::Entry &file : batch.files) {
+            if (seen) {
+                seen->insert(file.path);
+            }
+            if (stream) {
+                found.append(file.path);
+            }
+
+            MediaEntry entry{file.dir, file.mtime, file.size, file.isImage ? MediaType::Image : MediaType::Video};
+            auto existing = entries.constFind(file.path);
+            if (existing != entries.cend() && existing->mtime == entry.mtime && existing->size == entry.size) {
+                continue;
+            }
+
+            entries.insert(file.path, entry);
+            upsert(root, file.path, entry);
+        }
+
+        if (!found.isEmpty()) {
+            emit batchFound(root, found);
+        }
+    }, m_abort);
+}
+
+void MediaIndexWorker::rescanDirectory(const QString &root, const QString &dir)
+{
+    if (!QFileInfo(dir).isDir()) {
+        removeTree(root, dir);
+        return;
+    }
+
+    QHash<QString, MediaEntry> &entries = m_roots[root];
+    QSet<QString> presentFiles;
+    QSet<QString> presentDirs;
+
+    // Only the direct children changed; new subdirectories get a full walk
+    QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        const QString path = it.filePath();
+
+        if (fi.isDir()) {
+            presentDirs.insert(path);
+            if (!m_knownDirs.contains(path)) {
+                indexTree(root, path, entries, nullptr);
+            }
+            continue;
+        }
+
+        MediaType type;
+        if (!mediaTypeFor(fi, type)) {
+            continue;
+        }
+
+        presentFiles.insert(path);
+        MediaEntry entry{dir, fi.lastModified().toMSecsSinceEpoch(), fi.size(), type};
+        auto existing = entries.constFind(path);
+        if (existing != entries.cend() && existing->mtime == entry.mtime && existing->size == entry.size) {
+            continue;
+        }
+
+        entries.insert(path, entry);
+        upsert(root, path, entry);
+    }
+
+    // Files removed from dir, or living in a subdirectory that disappeared
+    const QString prefix = dir + '/';
+    for (auto e = entries.begin(); e != entries.end();) {
+        bool gone = false;
+        if (e->dir == dir) {
+            gone = !presentFiles.contains(e.key());
+        } else if (isUnder(e->dir, dir)) {
+            const QString child = prefix + e->dir.mid(prefix.size()).section('/', 0, 0);
+            gone = !presentDirs.contains(child);
+        }
+
+        if (gone) {
+            remove(root, e.key());
+            e = entries.erase(e);
+        } else {
+            ++e;
+        }
+    }
+
+    for (auto d = m_knownDirs.begin(); d != m_knownDirs.end();) {
+        if (isUnder(*d, dir) && !presentDirs.contains(prefix + d->mid(prefix.size()).section('/', 0, 0))) {
+            if (m_watchedDirs.remove(*d)) {
+                m_watcher->removePath(*d);
+            }
+            d = m_knownDirs.erase(d);
+        } else {
+            ++d;
+        }
+    }
+}
+
+void MediaIndexWorker::removeTree(const QString &root, const QString &dir)
+{
+    QHash<QString, MediaEntry> &entries = m_roots[root];
+    for (auto e = entries.begin(); e != entries.end();) {
+        if (e->dir == dir || isUnder(e->dir, dir)) {
+            remove(root, e.key());
+            e = entries.erase(e);
+        } else {
+            ++e;
+        }
+    }
+
+    for (auto d = m_knownDirs.begin(); d != m_knownDirs.end();) {
+        if (*d == dir || isUnder(*d, dir)) {
+            if (m_watchedDirs.remove(*d)) {
+                m_watcher->removePath(*d);
+            }
+            d = m_knownDirs.erase(d);
+        } else {
+            ++d;
+        }
+    }
+}
+
+void MediaIndexWorker::upsert(const QString &root, const QString &path, const MediaEntry &entry)
+{
+    if (!m_db.isOpen()) {
+        return;
+    }
+
+    if (m_pendingWrites == 0) {
+        m_db.transaction();
+    }
+
+    m_upsertQuery.addBindValue(root);
+    m_upsertQuery.addBindValue(path);
+    m_upsertQuery.addBindValue(entry.dir);
+    m_upsertQuery.addBindValue(entry.mtime);
+    m_upsertQuery.addBindValue(entry.size);
+    m_upsertQuery.addBindValue(static_cast<int>(entry.type));
+    if (!m_upsertQuery.exec()) {
+        qWarning() << "Failed to index media file:" << m_upsertQuery.lastError().text();
+    }
+
+    ++m_pendingWrites;
+    commitIfNeeded();
+}
+
+void MediaIndexWorker::remove(const QString &root, const QString &path)
+{
+    if (!m_db.isOpen()) {
+        return;
+    }
+
+    if (m_pendingWrites == 0) {
+        m_db.transaction();
+    }
+
+    m_deleteQuery.addBindValue(root);
+    m_deleteQuery.addBindValue(path);
+    m_deleteQuery.exec();
+
+    ++m_pendingWrites;
+    commitIfNeeded();
+}
+
+void MediaIndexWorker::commitIfNeeded(bool force)
+{
+    if (m_pendingWrites == 0) {
+        return;
+    }
+
+    if (force || m_pendingWrites >= MediaIndexConstants::kCommitBatchSize) {
+        m_db.commit();
+        m_pendingWrites = 0;
+    }
+}
+
+void MediaIndexWorker::watchDirectory(const QString &dir)
+{
+    m_knownDirs.insert(dir);
+
+    if (!m_watcher || m_watchedDirs.contains(dir)) {
+        return;
+    }
+
+    if (m_watchedDirs.size() >= MediaIndexConstants::kMaxWatchedDirectories) {
+        if (!m_watchLimitWarned) {
+            qWarning() << "MediaIndex: watch limit reached, further directories refresh on next start only";
+            m_watchLimitWarned = true;
+        }
+        return;
+    }
+
+    if (m_watcher->addPath(dir)) {
+        m_watchedDirs.insert(dir);
+    }
+}
+
+void MediaIndexWorker::onDirectoryChanged(const QString &dir)
+{
+    m_pendingDirs.insert(dir);
+    m_debounceTimer->start();
+}
+
+void MediaIndexWorker::processPendingDirectories()
+{
+    const QSet<QString> dirs = std::exchange(m_pendingDirs, {});
+    QSet<QString> touchedRoots;
+
+    for (const QString &dir : dirs) {
+        for (auto it = m_roots.cbegin(); it != m_roots.cend(); ++it) {
+            const QString &root = it.key();
+            if (dir == root || isUnder(dir, root)) {
+                touchedRoots.insert(root);
+            }
+        }
+    }
+
+    for (const QString &root : touchedRoots) {
+        for (const QString &dir : dirs) {
+            if (dir == root || isUnder(dir, root)) {
+                rescanDirectory(root, dir);
+            }
+        }
+    }
+
+    commitIfNeeded(true);
+
+    for (const QString &root : touchedRoots) {
+        emitSnapshot(root, false);
+    }
+}
+
+void MediaIndexWorker::emitSnapshot(const QString &root, bool fromCache)
+{
+    QStringList files = m_roots.value(root).keys();
+    files.sort();
+    emit snapshotReady(root, std::make_shared<const FilterEngine>(files), fromCache);
+}
+
+// ============ MediaIndex ============
+
+MediaIndex& MediaIndex::instance()
+{
+    static MediaIndex instance;
+    return instance;
+}
+
+MediaIndex::MediaIndex()
+    : QObject(nullptr)
+{
+    qRegisterMetaType<FilterEnginePtr>();
+}
+
+MediaIndex::~MediaIndex()
+{
+    shutdown();
+}
+
+QString MediaIndex::databasePath()
+{
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+    return configPath + "/goobert/media_index.db";
+}
+
+QString MediaIndex::normalizedRoot(const QString &path)
+{
+    if (path.trimmed().isEmpty()) {
+        return {};
+    }
+    return QDir::cleanPath(QFileInfo(path.trimmed()).absoluteFilePath());
+}
+
+void MediaIndex::startWorker()
+{
+    QDir().mkpath(QFileInfo(databasePath()).path());
+
+    m_abort = false;
+    m_thread = new QThread(this);
+    m_thread->setObjectName("MediaIndex");
+
+    m_worker = new MediaIndexWorker(&m_abort);
+    m_worker->moveToThread(m_thread);
+    connect(m_worker, &MediaIndexWorker::snapshotReady, this, &MediaIndex::onSnapshotReady);
+    connect(m_worker, &MediaIndexWorker::batchFound, this, &MediaIndex::onBatchFound);
+
+    m_thread->start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, path = databasePath()]() {
+        worker->open(path);
+    }, Qt::QueuedConnection);
+}
+
+void MediaIndex::shutdown()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    // Abort any walk in progress, then close the connection on its own thread
+    m_abort = true;
+    QMetaObject::invokeMethod(m_worker, &MediaIndexWorker::close, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+
+    delete m_worker;
+    m_worker = nullptr;
+    delete m_thread;
+    m_thread = nullptr;
+    m_requested.clear();
+}
+
+void MediaIndex::ensureIndexed(const QString &root)
+{
+    const QString key = normalizedRoot(root);
+    if (key.isEmpty() || m_requested.contains(key)) {
+        return;
+    }
+    m_requested.insert(key);
+
+    // A single file needs no index
+    if (QFileInfo(key).isFile()) {
+        m_snapshots.insert(key, std::make_shared<const FilterEngine>(FileScanner().scan(key)));
+        return;
+    }
+
+    if (!m_thread) {
+        startWorker();
+    }
+
+    m_indexTimers[key].start();
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, key]() {
+        worker->indexRoot(key);
+    }, Qt::QueuedConnection);
+}
+
+bool MediaIndex::isReady(const QString &root) const
+{
+    return m_snapshots.contains(normalizedRoot(root));
+}
+
+QStringList MediaIndex::files(const QString &root) const
+{
+    const FilterEnginePtr snapshot = m_snapshots.value(normalizedRoot(root));
+    return snapshot ? snapshot->paths() : QStringList();
+}
+
+QStringList MediaIndex::filteredFiles(const QString &root, const QString &filter) const
+{
+    const FilterEnginePtr snapshot = m_snapshots.value(normalizedRoot(root));
+    return snapshot ? snapshot->filter(filter) : QStringList();
+}
+
+QStringList MediaIndex::discoveredFiles(const QString &root) const
+{
+    return m_discovered.value(normalizedRoot(root));
+}
+
+void MediaIndex::onBatchFound(const QString &root, const QStringList &files)
+{
+    m_discovered[root].append(files);
+    emit indexBatch(root, files);
+}
+
+void MediaIndex::onSnapshotReady(const QString &root, const FilterEnginePtr &snapshot, bool fromCache)
+{
+    const bool first = !m_snapshots.contains(root);
+    m_snapshots.insert(root, snapshot);
+    m_discovered.remove(root);
+
+    if (!fromCache) {
+        qDebug() << "MediaIndex:" << snapshot->size() << "files in" << root;
+    }
+
+    // The cached snapshot comes first, the finished walk after it
+    if (auto it = m_indexTimers.find(root); it != m_indexTimers.end()) {
+        PerfMetrics::instance().recordIndexTime(it->elapsed(), fromCache);
+        if (!fromCache) {
+            m_indexTimers.erase(it);
+        }
+    }
+
+    if (first) {
+        emit indexReady(root, snapshot->size());
+    } else {
+        emit indexUpdated(root, snapshot->size());
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QFileSystemWatcher>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <atomic>
+#include "filterengine.h"
+
+namespace MediaIndexConstants {
+    inline constexpr int kWatchDebounceMs = 500;       // Coalesce bursts of directory change notifications
+    inline constexpr int kMaxWatchedDirectories = 8192; // Default inotify max_user_watches on older kernels
+    inline constexpr int kCommitBatchSize = 5000;       // Rows per transaction during a full walk
+}
+
+enum class MediaType {
+    Video = 0,
+    Image = 1
+};
+
+struct MediaEntry {
+    QString dir;         // Parent directory (for incremental rescans)
+    qint64 mtime = 0;    // Unix timestamp ms
+    qint64 size = 0;
+    MediaType type = MediaType::Video;
+};
+
+// Lives on the index thread. Owns its own SQLite connection and the
+// QFileSystemWatcher; all slots must be invoked via queued connections.
+class MediaIndexWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MediaIndexWorker(std::atomic_bool *abort);
+    ~MediaIndexWorker() override;
+
+public slots:
+    void open(const QString &dbPath);
+    void close();
+    void indexRoot(const QString &root);
+
+signals:
+    // Every media file under root, sorted, with its filter buffer prebuilt
+    void snapshotReady(const QString &root, const FilterEnginePtr &snapshot, bool fromCache);
+    // Unsorted files found so far during the first walk of an uncached root
+    void batchFound(const QString &root, const QStringList &files);
+
+private slots:
+    void onDirectoryChanged(const QString &dir);
+    void processPendingDirectories();
+
+private:
+    bool createTables();
+    void loadRoot(const QString &root, QHash<QString, MediaEntry> &entries);
+    void indexTree(const QString &root, const QString &dir,
+                   QHash<QString, MediaEntry> &entries, QSet<QString> *seen, bool stream = false);
+    void rescanDirectory(const QString &root, const QString &dir);
+    void removeTree(const QString &root, const QString &dir);
+    void upsert(const QString &root, const QString &path, const MediaEntry &entry);
+    void remove(const QString &root, const QString &path);
+    void watchDirectory(const QString &dir);
+    void commitIfNeeded(bool force = false);
+    void emitSnapshot(const QString &root, bool fromCache);
+
+    std::atomic_bool *m_abort = nullptr;
+    QSqlDatabase m_db;
+    QSqlQuery m_upsertQuery;
+    QSqlQuery m_deleteQuery;
+    int m_pendingWrites = 0;
+
+    // root -> (path -> entry)
+    QHash<QString, QHash<QString, MediaEntry>> m_roots;
+
+    QFileSystemWatcher *m_watcher = nullptr;
+    QTimer *m_debounceTimer = nullptr;
+    QSet<QString> m_pendingDirs;
+    QSet<QString> m_knownDirs;     // Every directory seen under an indexed root
+    QSet<QString> m_watchedDirs;   // Subset actually registered with the watcher
+    bool m_watchLimitWarned = false;
+};
+
+// Persistent media library index. Scans run on a dedicated thread; the GUI
+// only ever reads the last published snapshot for a root. Snapshots carry a
+// FilterEngine so filtering never has to touch the paths again.
+class MediaIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static MediaIndex& instance();
+
+    void shutdown();
+
+    // Kick off (or reuse) indexing for a root. Single files are resolved
+    // synchronously and are ready on return.
+    void ensureIndexed(const QString &root);
+
+    [[nodiscard]] bool isReady(const QString &root) const;
+    [[nodiscard]] QStringList files(const QString &root) const;
+    [[nodiscard]] QStringList filteredFiles(const QString &root, const QString &filter) const;
+    // Files streamed so far for a root whose first walk is still running
+    [[nodiscard]] QStringList discoveredFiles(const QString &root) const;
+
+    [[nodiscard]] static QString normalizedRoot(const QString &path);
+    [[nodiscard]] static QString databasePath();
+
+signals:
+    void indexBatch(const QString &root, const QStringList &files);  // Streamed during a cold first walk
+    void indexReady(const QString &root, int fileCount);    // First snapshot available
+    void indexUpdated(const QString &root, int fileCount);  // Snapshot changed afterwards
+
+private slots:
+    void onSnapshotReady(const QString &root, const FilterEnginePtr &snapshot, bool fromCache);
+    void onBatchFound(const QString &root, const QStringList &files);
+
+private:
+    MediaIndex();
+    ~MediaIndex() override;
+    MediaIndex(const MediaIndex&) = delete;
+    MediaIndex& operator=(const MediaIndex&) = delete;
+
+    void startWorker();
+
+    QThread *m_thread = nullptr;
+    MediaIndexWorker *m_worker = nullptr;
+    std::atomic_bool m_abort{false};
+
+    QHash<QString, FilterEnginePtr> m_snapshots;
+    QHash<QString, QStringList> m_discovered;
+    QSet<QString> m_requested;
+    QHash<QString, QElapsedTimer> m_indexTimers;   // Root -> since ensureIndexed(), until the walk is done
+};
@@ -0,0 +1,85 @@
+#include "metricsserver.h"
+#include "perfmetrics.h"
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QDebug>
+
+namespace {
+
+void respond(QTcpSocket *socket, const QByteArray &status, const QByteArray &contentType, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &MetricsServer::onNewConnection);
+}
+
+MetricsServer::~MetricsServer()
+{
+    close();
+}
+
+bool MetricsServer::listen(quint16 port)
+{
+    close();
+    if (port == 0) {
+        return false;
+    }
+
+    // Local only; scrapes from other hosts go through a proxy or an SSH tunnel
+    if (!m_server.listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "MetricsServer: cannot listen on port" << port << m_server.errorString();
+        return false;
+    }
+    PerfMetrics::instance().setExporting(true);
+    qDebug() << "MetricsServer: serving /metrics on 127.0.0.1:" << port;
+    return true;
+}
+
+void MetricsServer::close()
+{
+    if (m_server.isListening()) {
+        m_server.close();
+        PerfMetrics::instance().setExporting(false);
+    }
+}
+
+void MetricsServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+            if (socket->bytesAvailable() > MetricsConstants::kMaxRequestBytes) {
+                socket->abort();
+                return;
+            }
+
+            // Wait for the whole header block; scrapes have no body
+            const QByteArray head = socket->peek(socket->bytesAvailable());
+            if (!head.contains("\r\n\r\n")) return;
+
+            const QList<QByteArray> requestLine = head.left(head.indexOf("\r\n")).split(' ');
+            socket->readAll();
+
+            if (requestLine.size() < 2 || requestLine.at(0) != "GET") {
+                respond(socket, "405 Method Not Allowed", "text/plain", "GET only\n");
+            } else if (requestLine.at(1) != "/metrics") {
+                respond(socket, "404 Not Found", "text/plain", "See /metrics\n");
+            } else {
+                respond(socket, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                        PerfMetrics::instance().prometheusText());
+            }
+        });
+    }
+}
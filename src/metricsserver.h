@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+
+namespace MetricsConstants {
+    inline constexpr int kMaxRequestBytes = 8 * 1024;   // Headers of a scrape; anything larger is dropped
+}
+
+// Minimal HTTP server for Prometheus scrapes of PerfMetrics on
+// 127.0.0.1:<perf/metrics_port>. GET /metrics only; one response per
+// connection, closed afterwards.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer() override;
+
+    bool listen(quint16 port);   // 0 stops serving
+    void close();
+    [[nodiscard]] bool isListening() const { return m_server.isListening(); }
+    [[nodiscard]] int serverPort() const { return m_server.isListening() ? m_server.serverPort() : 0; }
+
+private slots:
+    void onNewConnection();
+
+private:
+    QTcpServer m_server;
+};
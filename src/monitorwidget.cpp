@@ -22,12 +22,16 @@ void MonitorWidget::setupUi()
     layout->setContentsMargins(0, 0, 0, 0);
 
     m_table = new QTableWidget();
-    m_table->setColumnCount(3);
-    m_table->setHorizontalHeaderLabels({"Cell", "Status", "File"});
-    m_table->horizontalHeader()->setStretchLastSection(true);
+    m_table->setColumnCount(ColumnCount);
+    m_table->setHorizontalHeaderLabels({"Cell", "Status", "File", "FPS", "Drops", "Decoder", "Cache", "Render"});
     m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
     m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Fixed);
+    m_table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
     m_table->setColumnWidth(1, 140);
+    for (int column = FpsColumn; column < ColumnCount; ++column) {
+        m_table->horizontalHeader()->setSectionResizeMode(column, QHeaderView::ResizeToContents);
+        m_table->setColumnHidden(column, true);
+    }
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_table->setSelectionMode(QAbstractItemView::SingleSelection);
     m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -41,50 +45,131 @@ void MonitorWidget::setupUi()
 
     connect(m_table, &QWidget::customContextMenuRequested, this, &MonitorWidget::onContextMenu);
     connect(m_table, &QTableWidget::itemDoubleClicked, this, &MonitorWidget::onItemDoubleClicked);
+    connect(&ThumbnailCache::instance(), &ThumbnailCache::ready, this, &MonitorWidget::onThumbnailReady);
+
+    m_table->setIconSize(QSize(ThumbnailConstants::kThumbWidth / 3, ThumbnailConstants::kThumbHeight / 3));
 
     layout->addWidget(m_table);
 }
 
-void MonitorWidget::updateCellStatus(int row, int col, const QString &path, double pos, double dur, bool paused)
+void MonitorWidget::updateCellStatus(const QVector<CellStatus> &cells)
 {
-    QString cellId = QString("%1,%2").arg(row).arg(col);
+    if (m_tableRows.size() != cells.size()) {
+        m_tableRows.fill(-1, cells.size());
+    }
 
-    // Find or create row
-    int tableRow = -1;
-    for (int i = 0; i < m_table->rowCount(); ++i) {
-        if (m_table->item(i, 0) && m_table->item(i, 0)->text() == cellId) {
-            tableRow = i;
-            break;
+    bool filesChanged = false;
+    for (qsizetype i = 0; i < cells.size(); ++i) {
+        const CellStatus &status = cells.at(i);
+        if (status.changes == CellStatus::NoChange || status.path.isEmpty()) {
+            continue;
+        }
+
+        // Rows appear in the order cells start playing
+        int tableRow = m_tableRows.at(i);
+        if (tableRow < 0) {
+            tableRow = m_table->rowCount();
+            m_tableRows[i] = tableRow;
+            m_table->insertRow(tableRow);
+            m_table->setItem(tableRow, 0, new QTableWidgetItem(QString("%1,%2").arg(status.row).arg(status.col)));
+            m_table->setItem(tableRow, 1, new QTableWidgetItem());
+            for (int column = 2; column < ColumnCount; ++column) {
+                m_table->setItem(tableRow, column, new QTableWidgetItem());
+            }
+        }
+
+        // Status with play/pause indicator
+        QString statusIcon = status.paused ? "||" : (status.buffering ? "..." : ">");
+        QString text = QString("%1 %2 / %3")
+            .arg(statusIcon)
+            .arg(formatTime(status.position))
+            .arg(formatTime(status.duration));
+        if (status.restarts > 0) {
+            text += QString("  (%1 restarts)").arg(status.restarts);
+        }
+        m_table->item(tableRow, 1)->setText(text);
+        if (status.changes & CellStatus::StateChange) {
+            m_table->item(tableRow, 1)->setToolTip(status.cacheStalls > 0
+                ? QString("Buffered %1 times, %2 s in total").arg(status.cacheStalls).arg(status.cacheStallMs / 1000.0, 0, 'f', 1)
+                : QString());
         }
+
+        if (m_perfColumnsVisible && (status.changes & CellStatus::MetricsChange)) {
+            setMetrics(tableRow, status);
+        }
+
+        QTableWidgetItem *fileItem = m_table->item(tableRow, 2);
+        if (!(status.changes & CellStatus::FileChange) && fileItem->data(Qt::UserRole).toString() == status.path) {
+            continue;  // Position tick, same file
+        }
+        fileItem->setText(QFileInfo(status.path).fileName());
+        fileItem->setData(Qt::UserRole, status.path);  // Store full path
+        fileItem->setToolTip(status.path);
+        fileItem->setIcon(QIcon(ThumbnailCache::instance().pixmap(status.path)));
+        filesChanged = true;
     }
 
-    if (tableRow < 0) {
-        tableRow = m_table->rowCount();
-        m_table->insertRow(tableRow);
-        m_table->setItem(tableRow, 0, new QTableWidgetItem(cellId));
-        m_table->setItem(tableRow, 1, new QTableWidgetItem());
-        m_table->setItem(tableRow, 2, new QTableWidgetItem());
+    if (filesChanged) {
+        requestThumbnails();
     }
+}
 
-    // Status with play/pause indicator
-    QString statusIcon = paused ? "||" : ">";
-    QString status = QString("%1 %2 / %3")
-        .arg(statusIcon)
-        .arg(formatTime(pos))
-        .arg(formatTime(dur));
+void MonitorWidget::requestThumbnails()
+{
+    // Every row is small enough to keep wanted
+    QStringList paths;
+    paths.reserve(m_table->rowCount());
+    for (int i = 0; i < m_table->rowCount(); ++i) {
+        if (QTableWidgetItem *fileItem = m_table->item(i, 2)) {
+            paths.append(fileItem->data(Qt::UserRole).toString());
+        }
+    }
+    ThumbnailCache::instance().setWanted(this, paths);
+}
 
-    QFileInfo fi(path);
-    m_table->item(tableRow, 1)->setText(status);
+void MonitorWidget::onThumbnailReady(const QString &path, ThumbnailCache::Kind kind)
+{
+    if (kind != ThumbnailCache::Kind::Thumbnail) return;
 
-    QTableWidgetItem *fileItem = m_table->item(tableRow, 2);
-    fileItem->setText(fi.fileName());
-    fileItem->setData(Qt::UserRole, path);  // Store full path
-    fileItem->setToolTip(path);
+    for (int i = 0; i < m_table->rowCount(); ++i) {
+        QTableWidgetItem *fileItem = m_table->item(i, 2);
+        if (fileItem && fileItem->data(Qt::UserRole).toString() == path) {
+            fileItem->setIcon(QIcon(ThumbnailCache::instance().pixmap(path)));
+        }
+    }
 }
 
 void MonitorWidget::clear()
 {
     m_table->setRowCount(0);
+    m_tableRows.clear();
+    ThumbnailCache::instance().setWanted(this, {});
+}
+
+void MonitorWidget::setPerfColumnsVisible(bool visible)
+{
+    m_perfColumnsVisible = visible;
+    for (int column = FpsColumn; column < ColumnCount; ++column) {
+        m_table->setColumnHidden(column, !visible);
+    }
+    if (!visible) return;
+
+    // Hidden columns were left stale; catch up from the current snapshot
+    const QVector<CellStatus> &cells = CellStatusStore::instance().snapshot();
+    for (qsizetype i = 0; i < cells.size() && i < m_tableRows.size(); ++i) {
+        if (m_tableRows.at(i) >= 0) {
+            setMetrics(m_tableRows.at(i), cells.at(i));
+        }
+    }
+}
+
+void MonitorWidget::setMetrics(int tableRow, const CellStatus &status)
+{
+    m_table->item(tableRow, FpsColumn)->setText(QString::number(status.fps, 'f', 1));
+    m_table->item(tableRow, DropsColumn)->setText(QString("%1 / %2").arg(status.frameDrops).arg(status.decoderDrops));
+    m_table->item(tableRow, DecoderColumn)->setText(status.hwdec.isEmpty() ? QStringLiteral("no") : status.hwdec);
+    m_table->item(tableRow, CacheColumn)->setText(QString("%1 s").arg(status.cacheSecs, 0, 'f', 1));
+    m_table->item(tableRow, RenderColumn)->setText(QString("%1 ms").arg(status.renderMs, 0, 'f', 2));
 }
 
 QString MonitorWidget::formatTime(double seconds) const
@@ -2,6 +2,8 @@
 
 #include <QWidget>
 #include <QTableWidget>
+#include "thumbnailcache.h"
+#include "cellstatusstore.h"
 
 class MonitorWidget : public QWidget
 {
@@ -10,8 +12,9 @@ class MonitorWidget : public QWidget
 public:
     explicit MonitorWidget(QWidget *parent = nullptr);
 
-    void updateCellStatus(int row, int col, const QString &path, double pos, double dur, bool paused);
+    void updateCellStatus(const QVector<CellStatus> &cells);  // One CellStatusStore snapshot
     void clear();
+    void setPerfColumnsVisible(bool visible);   // FPS, drops, cache and render time; with the perf HUD
 
 signals:
     void cellSelected(int row, int col);
@@ -21,12 +24,27 @@ signals:
 private slots:
     void onContextMenu(const QPoint &pos);
     void onItemDoubleClicked(QTableWidgetItem *item);
+    void onThumbnailReady(const QString &path, ThumbnailCache::Kind kind);
 
 private:
     void setupUi();
     [[nodiscard]] QString formatTime(double seconds) const;
     void renameFile(int row, int col, const QString &currentPath);
     void setCustomSource(int row, int col);
+    void requestThumbnails();
+    void setMetrics(int tableRow, const CellStatus &status);
+
+    // Columns 0-2 are always shown
+    enum PerfColumn {
+        FpsColumn = 3,
+        DropsColumn,
+        DecoderColumn,
+        CacheColumn,
+        RenderColumn,
+        ColumnCount
+    };
 
     QTableWidget *m_table = nullptr;
+    QVector<int> m_tableRows;   // Snapshot slot -> table row, -1 until the cell has played a file
+    bool m_perfColumnsVisible = false;
 };
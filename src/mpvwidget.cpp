@@ -1,23 +1,175 @@
 #include "mpvwidget.h"
 #include "config.h"
+#include "wallrenderer.h"
+#include "filescanner.h"
+#include "keyframeindex.h"
+#include "ioprofiles.h"
+#include "stillimagecache.h"
+#include "perfmetrics.h"
 #include <QOpenGLFunctions>
 #include <QOpenGLContext>
 #include <QMetaObject>
 #include <QDebug>
 #include <QTimer>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QDir>
 #include <QClipboard>
 #include <QApplication>
 #include <QMouseEvent>
+#include <algorithm>
+#include <utility>
 #include <stdexcept>
 #include <clocale>
 
-static void wakeup(void *ctx)
+namespace {
+
+QVariant toVariant(mpv_format format, void *data)
+{
+    if (!data) return QVariant();
+
+    switch (format) {
+    case MPV_FORMAT_STRING:
+        return QString::fromUtf8(*static_cast<char**>(data));
+    case MPV_FORMAT_FLAG:
+        return *static_cast<int*>(data) != 0;
+    case MPV_FORMAT_INT64:
+        return static_cast<qint64>(*static_cast<int64_t*>(data));
+    case MPV_FORMAT_DOUBLE:
+        return *static_cast<double*>(data);
+    case MPV_FORMAT_NODE: {
+        mpv_node *node = static_cast<mpv_node*>(data);
+        return node->format == MPV_FORMAT_NODE ? QVariant() : toVariant(node->format, &node->u);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+constexpr uint64_t kOnLoadHookId = 1;  // reply_userdata of the on_load hook
+
+enum class PropertyId : uint64_t {
+    TimePos = 1,
+    Duration,
+    Pause,
+    Path,
+    Idle,
+    PlaylistPos,
+    LoopFile,
+    Volume,
+    Mute,
+    VideoZoom,
+    VideoPanX,
+    VideoPanY,
+    VideoRotate,
+    FrameDrops,
+    DelayedFrames,
+    VideoWidth,
+    VideoHeight,
+    HwdecCurrent,
+    VideoCodec,
+    PausedForCache,
+    CacheDuration,
+};
+
+struct ObservedProperty {
+    PropertyId id;
+    const char *name;
+    mpv_format format;
+};
+
+constexpr ObservedProperty kObservedProperties[] = {
+    {PropertyId::TimePos,       "time-pos",               MPV_FORMAT_DOUBLE},
+    {PropertyId::Duration,      "duration",               MPV_FORMAT_DOUBLE},
+    {PropertyId::Pause,         "pause",                  MPV_FORMAT_FLAG},
+    {PropertyId::Path,          "path",                   MPV_FORMAT_STRING},
+    {PropertyId::Idle,          "idle-active",            MPV_FORMAT_FLAG},
+    {PropertyId::PlaylistPos,   "playlist-pos",           MPV_FORMAT_INT64},
+    {PropertyId::LoopFile,      "loop-file",              MPV_FORMAT_STRING},
+    {PropertyId::Volume,        "volume",                 MPV_FORMAT_DOUBLE},
+    {PropertyId::Mute,          "mute",                   MPV_FORMAT_FLAG},
+    {PropertyId::VideoZoom,     "video-zoom",             MPV_FORMAT_DOUBLE},
+    {PropertyId::VideoPanX,     "video-pan-x",            MPV_FORMAT_DOUBLE},
+    {PropertyId::VideoPanY,     "video-pan-y",            MPV_FORMAT_DOUBLE},
+    {PropertyId::VideoRotate,   "video-rotate",           MPV_FORMAT_INT64},
+    {PropertyId::FrameDrops,    "frame-drop-count",       MPV_FORMAT_INT64},
+    {PropertyId::DelayedFrames, "vo-delayed-frame-count", MPV_FORMAT_INT64},
+    {PropertyId::VideoWidth,    "width",                  MPV_FORMAT_INT64},
+    {PropertyId::VideoHeight,   "height",                 MPV_FORMAT_INT64},
+    {PropertyId::HwdecCurrent,  "hwdec-current",          MPV_FORMAT_STRING},
+    {PropertyId::VideoCodec,    "current-tracks/video/codec", MPV_FORMAT_STRING},
+    {PropertyId::PausedForCache, "paused-for-cache",      MPV_FORMAT_FLAG},
+    {PropertyId::CacheDuration, "demuxer-cache-duration", MPV_FORMAT_DOUBLE},
+};
+
+struct QualityOption {
+    const char *name;
+    const char *fast;
+    const char *balanced;
+    const char *high;
+};
+
+// High matches the former fixed setup: the gpu-hq profile's options with EWA
+// luma/chroma scaling on top. They are spelled out because a profile cannot be
+// taken back when the governor drops a tier.
+constexpr QualityOption kQualityOptions[] = {
+    {"scale",               "bilinear", "spline36", "ewa_lanczos"},
+    {"cscale",              "bilinear", "bilinear", "ewa_lanczos"},
+    {"dscale",              "bilinear", "mitchell", "mitchell"},
+    {"correct-downscaling", "no",       "yes",      "yes"},
+    {"linear-downscaling",  "no",       "no",       "yes"},
+    {"sigmoid-upscaling",   "no",       "no",       "yes"},
+    {"deband",              "no",       "no",       "yes"},
+    {"dither-depth",        "no",       "no",       "auto"},
+    {"video-sync",          "audio",    "audio",    "display-resample"},
+};
+
+const char* qualityValue(const QualityOption &option, QualityTier tier)
 {
-    QMetaObject::invokeMethod(static_cast<MpvWidget*>(ctx), "onMpvEvents", Qt::QueuedConnection);
+    switch (tier) {
+    case QualityTier::Fast: return option.fast;
+    case QualityTier::Balanced: return option.balanced;
+    case QualityTier::High: return option.high;
+    }
+    return option.high;
 }
 
+} // namespace
+
+// ============ MpvCommand ============
+
+MpvCommand::MpvCommand(const QVariantList &args)
+{
+    m_args.reserve(args.size());
+    for (const QVariant &arg : args) {
+        m_args.append(arg.toString().toUtf8());
+    }
+}
+
+std::vector<const char*> MpvCommand::argv() const
+{
+    std::vector<const char*> result;
+    result.reserve(static_cast<size_t>(m_args.size()) + 1);
+    for (const QByteArray &arg : m_args) {
+        result.push_back(arg.constData());
+    }
+    result.push_back(nullptr);
+    return result;
+}
+
+QByteArray MpvCommand::toDebugString() const
+{
+    QByteArray result;
+    for (const QByteArray &arg : m_args) {
+        if (!result.isEmpty()) result += ' ';
+        result += arg;
+    }
+    return result;
+}
+
+// ============ MpvWidget ============
+
 MpvWidget::MpvWidget(QWidget *parent)
     : QOpenGLWidget(parent)
 {
@@ -27,6 +179,26 @@ MpvWidget::MpvWidget(QWidget *parent)
     setUpdateBehavior(QOpenGLWidget::NoPartialUpdate);
     setAutoFillBackground(false);
     setAttribute(Qt::WA_OpaquePaintEvent);
+
+    // Keeps mpv's display-resample timing in step with real presentation
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this]() {
+        if (m_mpvGl) {
+            mpv_render_context_report_swap(m_mpvGl);
+        }
+    });
+
+    // Qt could not decode the still on screen: play the entry again, through mpv this time
+    connect(&StillImageCache::instance(), &StillImageCache::failed, this, [this](const QString &path) {
+        // Still loading: FILE_LOADED sees hasFailed() and replays then
+        if (m_openingStill && !m_state.loading && path == m_openingPath) {
+            command(QVariantList{"playlist-play-index", "current"});
+        }
+    });
+
+    // Never shown, so initializeGL() would never start the core
+    if (s_headless) {
+        startCore();
+    }
 }
 
 MpvWidget::~MpvWidget()
@@ -48,29 +220,45 @@ void MpvWidget::createMpv()
     // Set options before initialization
     mpv_set_option_string(m_mpv, "terminal", "no");
     mpv_set_option_string(m_mpv, "msg-level", "all=no");
-    mpv_set_option_string(m_mpv, "vo", "libmpv");
+    mpv_set_option_string(m_mpv, "vo", s_headless ? "null" : "libmpv");  // null: decode and time frames, present nothing
     mpv_set_option_string(m_mpv, "keep-open", "no");
 
-    // High-quality playback settings
-    mpv_set_option_string(m_mpv, "hwdec", "auto-safe");      // GPU decoding when available
-    mpv_set_option_string(m_mpv, "profile", "gpu-hq");       // High-quality GPU rendering
-    mpv_set_option_string(m_mpv, "scale", "ewa_lanczos");    // Best upscaling algorithm
-    mpv_set_option_string(m_mpv, "cscale", "ewa_lanczos");   // Chroma upscaling
-    mpv_set_option_string(m_mpv, "dscale", "mitchell");      // Downscaling
-    mpv_set_option_string(m_mpv, "video-sync", "display-resample");  // Smooth playback
+    mpv_set_option_string(m_mpv, "hwdec", m_hardwareDecoding ? "auto-safe" : "no");  // Per cell, see PlaybackScheduler
+
+    // Scaling and sync start at the tier for the current tile size; the
+    // governor adjusts them at runtime (see QualityGovernor)
+    if (Config::instance().adaptiveQuality()) {
+        m_governor.update(pixelSize(), 0);
+    }
+    for (const QualityOption &option : kQualityOptions) {
+        mpv_set_option_string(m_mpv, option.name, qualityValue(option, m_governor.tier()));
+    }
     mpv_set_option_string(m_mpv, "idle", "yes");
     mpv_set_option_string(m_mpv, "input-default-bindings", "no");
     mpv_set_option_string(m_mpv, "input-vo-keyboard", "no");
     mpv_set_option_string(m_mpv, "osc", "yes");  // Load OSC script
     mpv_set_option_string(m_mpv, "osd-bar", "yes");
     mpv_set_option_string(m_mpv, "script-opts", "osc-visibility=never");  // Hidden by default
+    // Looping is handled on the logical playlist; this only matters for
+    // playlists shorter than the window, which mpv then holds in full
     mpv_set_option_string(m_mpv, "loop-playlist", "inf");
+    // Open and demux the next entry before the current one ends, so the
+    // handover does not wait on file open and probing. The prefetched demuxer
+    // reads from the head of the file; a skipper start= still seeks at the
+    // handover, which only a keyframe-aligned start keeps cheap
+    mpv_set_option_string(m_mpv, "prefetch-playlist", "yes");
 
     // Load settings from config
     Config &cfg = Config::instance();
+
+    // Local defaults; the on_load hook switches to the profile of each file's source
+    m_ioProfile = cfg.localIo();
+    applyIoProfile("");
+
     m_originalLoopCount = cfg.loopCount();  // Store for restoring after inf toggle
     mpv_set_option_string(m_mpv, "loop-file", QString::number(m_originalLoopCount).toUtf8().constData());
     mpv_set_option_string(m_mpv, "image-display-duration", QString::number(cfg.imageDisplayDuration()).toUtf8().constData());
+    m_imageDuration = cfg.imageDisplayDuration();
     mpv_set_option_string(m_mpv, "volume", QString::number(cfg.defaultVolume()).toUtf8().constData());
     mpv_set_option_string(m_mpv, "screenshot-directory", cfg.screenshotPath().toUtf8().constData());
     mpv_set_option_string(m_mpv, "screenshot-template", "%f-%P");
@@ -79,31 +267,63 @@ void MpvWidget::createMpv()
     if (mpv_initialize(m_mpv) < 0)
         throw std::runtime_error("Failed to initialize mpv");
 
-    // Request property updates
-    mpv_observe_property(m_mpv, 0, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 0, "duration", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 0, "pause", MPV_FORMAT_FLAG);
-    mpv_observe_property(m_mpv, 0, "path", MPV_FORMAT_STRING);
+    // Request property updates; reply_userdata identifies the property
+    for (const ObservedProperty &p : kObservedProperties) {
+        mpv_observe_property(m_mpv, static_cast<uint64_t>(p.id), p.name, p.format);
+    }
 
-    mpv_set_wakeup_callback(m_mpv, wakeup, this);
+    // The skipper's start position has to be in place before the file opens
+    mpv_hook_add(m_mpv, kOnLoadHookId, "on_load", 0);
+
+    mpv_set_wakeup_callback(m_mpv, onWakeup, this);
 }
 
 void MpvWidget::destroyMpv()
 {
-    if (m_mpvGl) {
-        mpv_render_context_free(m_mpvGl);
-        m_mpvGl = nullptr;
+    if (m_wall) {
+        m_wall->removeTile(this);
+        m_wall = nullptr;
     }
+    freeRenderContext();
     if (m_mpv) {
         mpv_terminate_destroy(m_mpv);
         m_mpv = nullptr;
     }
+    m_replies.clear();
 }
 
 void MpvWidget::initializeGL()
 {
     qDebug() << "MpvWidget::initializeGL()";
+    startCore();
+
+    // On the wall the WallRenderer owns the render context
+    if (!m_wall) {
+        createRenderContext();
+    }
+}
+
+void MpvWidget::startCore()
+{
+    if (m_mpv) return;
+
     createMpv();
+    m_initialized = true;
+
+    if (Config::instance().adaptiveQuality()) {
+        m_qualityTimer = new QTimer(this);
+        connect(m_qualityTimer, &QTimer::timeout, this, &MpvWidget::sampleQuality);
+        m_qualityTimer->start(QualityConstants::kSampleIntervalMs);
+    }
+    qDebug() << "MpvWidget initialized successfully";
+
+    // Process any pending commands
+    processPendingCommands();
+}
+
+void MpvWidget::createRenderContext()
+{
+    if (m_mpvGl || !m_mpv) return;
 
     mpv_opengl_init_params gl_init_params{
         .get_proc_address = getGlProcAddress,
@@ -122,20 +342,155 @@ void MpvWidget::initializeGL()
     }
 
     mpv_render_context_set_update_callback(m_mpvGl, onUpdate, this);
-    m_initialized = true;
-    qDebug() << "MpvWidget initialized successfully";
+}
 
-    // Process any pending commands
-    processPendingCommands();
+void MpvWidget::freeRenderContext()
+{
+    if (m_mpvGl) {
+        mpv_render_context_free(m_mpvGl);
+        m_mpvGl = nullptr;
+        FrameScheduler::instance().cancel(this);
+    }
+}
+
+// ============ Wall Mode ============
+
+void MpvWidget::attachToWall(WallRenderer *wall)
+{
+    if (!wall || m_wall == wall) return;
+
+    // Core must exist without ever showing this widget's surface
+    startCore();
+
+    // mpv allows one render context per handle
+    if (m_mpvGl) {
+        makeCurrent();
+        freeRenderContext();
+        doneCurrent();
+    }
+
+    m_wall = wall;
+    hide();
+    wall->addTile(this, parentWidget());
+}
+
+void MpvWidget::detachFromWall()
+{
+    if (!m_wall) return;
+
+    m_wall->removeTile(this);
+    m_wall = nullptr;
+    show();
+
+    // A surface that was initialized before gets the context back here;
+    // otherwise initializeGL() creates it on first show
+    if (context()) {
+        makeCurrent();
+        createRenderContext();
+        doneCurrent();
+        update();
+    }
+}
+
+void MpvWidget::releaseStart()
+{
+    if (!m_startDeferred) return;
+    m_startDeferred = false;
+
+    // Not up yet: initializeGL loads the queued playlist itself
+    if (m_initialized && m_playlistPending) {
+        m_playlistPending = false;
+        loadPlaylist(m_playlist);
+        play();
+    }
+}
+
+void MpvWidget::setHardwareDecoding(bool enabled)
+{
+    if (enabled == m_hardwareDecoding) return;
+    m_hardwareDecoding = enabled;
+
+    if (m_mpv) {
+        setProperty("hwdec", QString(enabled ? "auto-safe" : "no"));
+    }
+}
+
+void MpvWidget::setCacheLimit(qint64 bytes)
+{
+    if (bytes == m_cacheLimit) return;
+    m_cacheLimit = bytes;
+
+    // The current file keeps its file-local sizes unless updated here; the
+    // demuxer picks the new limits up without reopening
+    if (m_mpv && m_initialized && !m_state.path.isEmpty()) {
+        const qint64 forward = cacheBytes();
+        setProperty("file-local-options/demuxer-max-bytes", QString::number(forward));
+        setProperty("file-local-options/demuxer-max-back-bytes", QString::number(forward / IoConstants::kBackBufferDivisor));
+    }
+}
+
+void MpvWidget::sampleMetrics()
+{
+    if (!m_mpv || !m_initialized || m_state.idle) return;
+
+    // Both change every frame, far too often to observe on a large wall
+    getPropertyAsync("estimated-vf-fps", MPV_FORMAT_DOUBLE, [this](int error, const QVariant &result) {
+        m_state.vfFps = error >= 0 ? result.toDouble() : 0.0;
+    });
+    getPropertyAsync("decoder-frame-drop-count", MPV_FORMAT_INT64, [this](int error, const QVariant &result) {
+        m_state.decoderDropCount = error >= 0 ? result.toLongLong() : 0;
+        emit metricsUpdated();   // Replies arrive in request order
+    });
+}
+
+void MpvWidget::recordRenderTime(qint64 nsecs, bool newFrame)
+{
+    const double ms = nsecs / 1.0e6;
+    m_state.renderMs = m_state.renderMs > 0.0
+        ? m_state.renderMs + PerfConstants::kRenderEmaWeight * (ms - m_state.renderMs)
+        : ms;
+
+    // Expose and resize repaints redraw whatever is there; only a frame
+    // mpv reported after file-loaded belongs to the new file
+    if (m_awaitingFirstFrame && newFrame) {
+        firstFrameShown();
+    }
+}
+
+void MpvWidget::firstFrameShown()
+{
+    m_awaitingFirstFrame = false;
+    PerfMetrics::instance().frameRendered();
+    emit firstFrameRendered();
+}
+
+qint64 MpvWidget::cacheBytes() const noexcept
+{
+    const qint64 profile = static_cast<qint64>(m_ioProfile.demuxerMaxMb) << 20;
+    return m_cacheLimit > 0 ? std::min(profile, m_cacheLimit) : profile;
+}
+
+void MpvWidget::applyIoProfile(const char *prefix)
+{
+    const qint64 forward = cacheBytes();
+
+    // Synchronous: only called before mpv_initialize() or from the on_load hook
+    auto set = [this, prefix](const char *name, const QByteArray &value) {
+        mpv_set_property_string(m_mpv, (QByteArray(prefix) + name).constData(), value.constData());
+    };
+    set("cache", m_ioProfile.cache.toUtf8());
+    set("demuxer-max-bytes", QByteArray::number(forward));
+    set("demuxer-max-back-bytes", QByteArray::number(forward / IoConstants::kBackBufferDivisor));
+    set("demuxer-readahead-secs", QByteArray::number(m_ioProfile.readaheadSecs, 'f', 1));
+    set("stream-buffer-size", QByteArray::number(static_cast<qint64>(m_ioProfile.streamBufferKb) << 10));
 }
 
 void MpvWidget::processPendingCommands()
 {
-    if (!m_pendingPlaylist.isEmpty()) {
-        qDebug() << "Processing pending playlist with" << m_pendingPlaylist.size() << "files";
-        QStringList playlist = m_pendingPlaylist;
-        m_pendingPlaylist.clear();
-        loadPlaylist(playlist);
+    if (m_playlistPending) {
+        qDebug() << "Processing pending playlist with" << m_playlist.size() << "files";
+        m_playlistPending = false;
+        loadPlaylist(m_playlist);
         play(); // Start playback
     }
     m_pendingCommands.clear();
@@ -164,19 +519,25 @@ void MpvWidget::paintGL()
         {MPV_RENDER_PARAM_INVALID, nullptr}
     };
 
+    QElapsedTimer timer;
+    timer.start();
     mpv_render_context_render(m_mpvGl, params);
+    recordRenderTime(timer.nsecsElapsed(), std::exchange(m_frameUpdated, false));
 }
 
 void MpvWidget::onUpdate(void *ctx)
 {
-    QMetaObject::invokeMethod(static_cast<MpvWidget*>(ctx), "maybeUpdate", Qt::QueuedConnection);
+    // mpv's render thread; the scheduler coalesces all cells into one flush per refresh
+    FrameScheduler::instance().requestFrame(static_cast<MpvWidget*>(ctx));
 }
 
-void MpvWidget::maybeUpdate()
+void MpvWidget::onFrameDue()
 {
     if (m_mpvGl) {
-        if (mpv_render_context_update(m_mpvGl) & MPV_RENDER_UPDATE_FRAME)
+        if (mpv_render_context_update(m_mpvGl) & MPV_RENDER_UPDATE_FRAME) {
+            m_frameUpdated = true;
             update();
+        }
     }
 }
 
@@ -189,8 +550,18 @@ void *MpvWidget::getGlProcAddress(void *ctx, const char *name)
     return reinterpret_cast<void*>(glctx->getProcAddress(QByteArray(name)));
 }
 
+void MpvWidget::onWakeup(void *ctx)
+{
+    // Called from mpv's thread; one queued drain per burst of events
+    auto *self = static_cast<MpvWidget*>(ctx);
+    if (!self->m_eventsQueued.exchange(true)) {
+        QMetaObject::invokeMethod(self, "onMpvEvents", Qt::QueuedConnection);
+    }
+}
+
 void MpvWidget::onMpvEvents()
 {
+    m_eventsQueued = false;
     while (m_mpv) {
         mpv_event *event = mpv_wait_event(m_mpv, 0);
         if (event->event_id == MPV_EVENT_NONE)
@@ -202,19 +573,9 @@ void MpvWidget::onMpvEvents()
 void MpvWidget::handleMpvEvent(mpv_event *event)
 {
     switch (event->event_id) {
-    case MPV_EVENT_PROPERTY_CHANGE: {
-        mpv_event_property *prop = static_cast<mpv_event_property*>(event->data);
-        if (strcmp(prop->name, "time-pos") == 0 && prop->format == MPV_FORMAT_DOUBLE) {
-            emit positionChanged(*static_cast<double*>(prop->data));
-        } else if (strcmp(prop->name, "duration") == 0 && prop->format == MPV_FORMAT_DOUBLE) {
-            emit durationChanged(*static_cast<double*>(prop->data));
-        } else if (strcmp(prop->name, "pause") == 0 && prop->format == MPV_FORMAT_FLAG) {
-            emit pauseChanged(*static_cast<int*>(prop->data));
-        } else if (strcmp(prop->name, "path") == 0 && prop->format == MPV_FORMAT_STRING) {
-            emit fileChanged(QString::fromUtf8(*static_cast<char**>(prop->data)));
-        }
+    case MPV_EVENT_PROPERTY_CHANGE:
+        handlePropertyChange(event->reply_userdata, static_cast<mpv_event_property*>(event->data));
         break;
-    }
     case MPV_EVENT_LOG_MESSAGE: {
         mpv_event_log_message *msg = static_cast<mpv_event_log_message*>(event->data);
         qDebug() << "[mpv]" << msg->prefix << msg->level << msg->text;
@@ -222,58 +583,218 @@ void MpvWidget::handleMpvEvent(mpv_event *event)
     }
     case MPV_EVENT_FILE_LOADED: {
         qDebug() << "MPV: File loaded";
-        QString path = getProperty("path").toString();
+        // path is set at start-file, so the snapshot is already current here
+        const QString path = m_state.path;
+        m_state.loading = false;
+        m_state.progressAt = QDeadlineTimer::current().deadline();
+        m_blockedSkips = 0;
+        m_awaitingFirstFrame = true;
+        m_frameUpdated = false;   // A paint still pending from the previous file
+        // The still failed to decode before mpv finished opening its
+        // placeholder; failed() came too early to replay it
+        if (m_openingStill && StillImageCache::instance().hasFailed(m_openingPath)) {
+            command(QVariantList{"playlist-play-index", "current"});
+            break;
+        }
+        if (m_openingStill || m_state.still) {
+            m_state.still = m_openingStill;
+            emit stillChanged(m_openingStill ? m_openingPath : QString());
+        }
         emit fileLoaded(path);
 
-        // Skipper: seek to percentage if enabled and file not seen before
-        // Use delay (like original Lua script) to let decoder stabilize
-        if (m_skipperEnabled && !path.isEmpty() && !m_seenFiles.contains(path)) {
-            m_seenFiles.insert(path);
-            QTimer::singleShot(MpvConstants::kSkipperDelayMs, this, [this]() {
-                if (double dur = getProperty("duration").toDouble(); dur > 0) {
-                    double target = dur * m_skipPercent;
-                    command(QVariantList{"seek", QString::number(target), "absolute", "keyframes"});
-                    command(QVariantList{"show-text", QString("start@%1%").arg(int(m_skipPercent * 100)), QString::number(MpvConstants::kOsdDurationMs)});
-                }
-            });
+        // The skip position was applied in onLoadHook(); the first frame
+        // shown is already the one at the skip point
+        if (m_skipApplied) {
+            m_skipApplied = false;
+            command(QVariantList{"show-text", QString("start@%1%").arg(int(m_skipPercent * 100)), QString::number(MpvConstants::kOsdDurationMs)});
+        }
+        break;
+    }
+    case MPV_EVENT_PLAYBACK_RESTART:
+        // vo=null renders nothing; playback starting is the closest stand-in
+        if (s_headless && m_awaitingFirstFrame) {
+            firstFrameShown();
         }
         break;
+    case MPV_EVENT_HOOK: {
+        mpv_event_hook *hook = static_cast<mpv_event_hook*>(event->data);
+        if (event->reply_userdata == kOnLoadHookId) {
+            onLoadHook();
+        }
+        mpv_hook_continue(m_mpv, hook->id);
+        break;
+    }
+    case MPV_EVENT_COMMAND_REPLY: {
+        mpv_event_command *cmd = static_cast<mpv_event_command*>(event->data);
+        dispatchReply(event->reply_userdata, event->error, toVariant(MPV_FORMAT_NODE, &cmd->result));
+        break;
+    }
+    case MPV_EVENT_GET_PROPERTY_REPLY: {
+        mpv_event_property *prop = static_cast<mpv_event_property*>(event->data);
+        dispatchReply(event->reply_userdata, event->error, toVariant(prop->format, prop->data));
+        break;
     }
-    case MPV_EVENT_END_FILE:
-        qDebug() << "MPV: End file";
+    case MPV_EVENT_SET_PROPERTY_REPLY:
+        dispatchReply(event->reply_userdata, event->error, QVariant());
         break;
+    case MPV_EVENT_END_FILE: {
+        const auto *end = static_cast<mpv_event_end_file*>(event->data);
+        m_state.loading = false;
+        if (end->reason == MPV_END_FILE_REASON_ERROR) {
+            const QString error = QString::fromUtf8(mpv_error_string(end->error));
+            qWarning() << "MPV: Failed to play" << m_openingPath << error;
+            emit fileFailed(m_openingPath, error);
+        } else {
+            qDebug() << "MPV: End file";
+        }
+        break;
+    }
     default:
         break;
     }
 }
 
+void MpvWidget::handlePropertyChange(quint64 id, const mpv_event_property *prop)
+{
+    // MPV_FORMAT_NONE means the property is currently unavailable (e.g. idle)
+    const bool available = prop->format != MPV_FORMAT_NONE && prop->data;
+    auto asDouble = [&]() { return available ? *static_cast<double*>(prop->data) : 0.0; };
+    auto asFlag = [&]() { return available && *static_cast<int*>(prop->data) != 0; };
+    auto asInt = [&](int64_t fallback) { return available ? *static_cast<int64_t*>(prop->data) : fallback; };
+    auto asString = [&]() { return available ? QString::fromUtf8(*static_cast<char**>(prop->data)) : QString(); };
+
+    switch (static_cast<PropertyId>(id)) {
+    case PropertyId::TimePos: {
+        const double pos = asDouble();
+        if (available && pos != m_state.timePos) {
+            m_state.progressAt = QDeadlineTimer::current().deadline();
+        }
+        m_state.timePos = pos;
+        if (available) emit positionChanged(m_state.timePos);
+        break;
+    }
+    case PropertyId::Duration:
+        m_state.duration = asDouble();
+        if (available) {
+            if (!m_openingStill) {   // The placeholder's length, not the file's
+                KeyframeIndex::instance().recordDuration(m_state.path, m_state.duration);
+            }
+            emit durationChanged(m_state.duration);
+        }
+        break;
+    case PropertyId::Pause:
+        m_state.paused = asFlag();
+        if (!m_state.paused) {
+            m_state.progressAt = QDeadlineTimer::current().deadline();  // Time paused is not a stall
+        }
+        emit pauseChanged(m_state.paused);
+        break;
+    case PropertyId::Path:
+        m_state.path = asString();
+        if (available) emit fileChanged(m_state.path);
+        break;
+    case PropertyId::Idle:
+        m_state.idle = asFlag();
+        if (m_state.idle && m_state.still) {
+            m_state.still = false;
+            emit stillChanged(QString());
+        }
+        emit idleChanged(m_state.idle);
+        break;
+    case PropertyId::PlaylistPos:
+        m_state.playlistPos = asInt(-1);   // Window bookkeeping follows the on_load hook, see advanceWindowTo()
+        break;
+    case PropertyId::LoopFile:
+        m_state.loopFileInf = asString() == "inf";
+        break;
+    case PropertyId::Volume:
+        m_state.volume = asDouble();
+        break;
+    case PropertyId::Mute:
+        m_state.muted = asFlag();
+        break;
+    case PropertyId::VideoZoom:
+        m_state.videoZoom = asDouble();
+        updateDecodeCap();  // Zoomed tiles need source detail
+        emit transformChanged();
+        break;
+    case PropertyId::VideoPanX:
+        m_state.videoPanX = asDouble();
+        emit transformChanged();
+        break;
+    case PropertyId::VideoPanY:
+        m_state.videoPanY = asDouble();
+        emit transformChanged();
+        break;
+    case PropertyId::VideoRotate:
+        m_state.rotation = static_cast<int>(asInt(0));
+        emit transformChanged();
+        break;
+    case PropertyId::FrameDrops:
+        m_state.frameDropCount = asInt(0);
+        break;
+    case PropertyId::DelayedFrames:
+        m_state.delayedFrameCount = asInt(0);
+        break;
+    case PropertyId::VideoWidth:
+        m_state.videoWidth = static_cast<int>(asInt(0));
+        updateDecodeCap();
+        emit videoFormatChanged();
+        break;
+    case PropertyId::VideoHeight:
+        m_state.videoHeight = static_cast<int>(asInt(0));
+        updateDecodeCap();
+        emit videoFormatChanged();
+        break;
+    case PropertyId::HwdecCurrent:
+        m_state.hwdecCurrent = asString();
+        updateDecodeCap();
+        emit videoFormatChanged();
+        break;
+    case PropertyId::VideoCodec:
+        m_state.videoCodec = asString();
+        emit videoFormatChanged();
+        break;
+    case PropertyId::PausedForCache: {
+        const bool starved = asFlag();
+        if (starved == m_state.pausedForCache) break;
+
+        const qint64 now = QDeadlineTimer::current().deadline();
+        if (starved) {
+            ++m_state.cacheStalls;
+            m_cacheStallStartedAt = now;
+        } else {
+            m_state.cacheStallMs += now - m_cacheStallStartedAt;
+            m_state.progressAt = now;   // Buffering time is accounted here, not as a stall
+        }
+        m_state.pausedForCache = starved;
+        emit cacheStateChanged(starved);
+        break;
+    }
+    case PropertyId::CacheDuration:
+        m_state.cacheAheadSecs = asDouble();
+        break;
+    }
+}
+
 void MpvWidget::command(const QVariant &args)
+{
+    command(MpvCommand(args.toList()));
+}
+
+void MpvWidget::command(const MpvCommand &cmd, ReplyCallback onReply)
 {
     if (!m_mpv) {
         qDebug() << "MpvWidget::command: mpv not initialized!";
         return;
     }
 
-    QVariantList list = args.toList();
-    QVector<QByteArray> byteArrays;
-    byteArrays.reserve(list.size());
-
-    // First pass: convert all args to QByteArray
-    for (const QVariant &arg : list) {
-        byteArrays.append(arg.toString().toUtf8());
-    }
-
-    // Second pass: build pointer array (byteArrays won't reallocate now)
-    QVector<const char*> cargs;
-    cargs.reserve(byteArrays.size() + 1);
-    for (const QByteArray &ba : byteArrays) {
-        cargs.append(ba.constData());
-    }
-    cargs.append(nullptr);
-
-    int err = mpv_command(m_mpv, cargs.data());
+    std::vector<const char*> argv = cmd.argv();
+    const quint64 id = registerReply(std::move(onReply));
+    int err = mpv_command_async(m_mpv, id, argv.data());
     if (err < 0) {
-        qDebug() << "mpv_command error:" << mpv_error_string(err) << "for:" << list;
+        m_replies.remove(id);
+        qDebug() << "mpv_command_async error:" << mpv_error_string(err) << "for:" << cmd.toDebugString();
     }
 }
 
@@ -282,32 +803,70 @@ void MpvWidget::setProperty(const QString &name, const QVariant &value)
     if (!m_mpv) return;
 
     QByteArray nameUtf8 = name.toUtf8();
+    const char *cname = nameUtf8.constData();
 
+    // mpv copies the value before returning, so stack storage is fine
     switch (value.typeId()) {
     case QMetaType::Bool: {
         int v = value.toBool();
-        mpv_set_property(m_mpv, nameUtf8.constData(), MPV_FORMAT_FLAG, &v);
+        mpv_set_property_async(m_mpv, 0, cname, MPV_FORMAT_FLAG, &v);
         break;
     }
     case QMetaType::Int:
     case QMetaType::LongLong: {
         int64_t v = value.toLongLong();
-        mpv_set_property(m_mpv, nameUtf8.constData(), MPV_FORMAT_INT64, &v);
+        mpv_set_property_async(m_mpv, 0, cname, MPV_FORMAT_INT64, &v);
         break;
     }
     case QMetaType::Double: {
         double v = value.toDouble();
-        mpv_set_property(m_mpv, nameUtf8.constData(), MPV_FORMAT_DOUBLE, &v);
+        mpv_set_property_async(m_mpv, 0, cname, MPV_FORMAT_DOUBLE, &v);
         break;
     }
     default: {
         QByteArray valueUtf8 = value.toString().toUtf8();
-        mpv_set_property_string(m_mpv, nameUtf8.constData(), valueUtf8.constData());
+        const char *cvalue = valueUtf8.constData();
+        mpv_set_property_async(m_mpv, 0, cname, MPV_FORMAT_STRING, &cvalue);
         break;
     }
     }
 }
 
+void MpvWidget::getPropertyAsync(const QString &name, mpv_format format, ReplyCallback onReply)
+{
+    if (!m_mpv || !onReply) return;
+
+    QByteArray nameUtf8 = name.toUtf8();
+    const quint64 id = registerReply(std::move(onReply));
+    if (mpv_get_property_async(m_mpv, id, nameUtf8.constData(), format) < 0) {
+        m_replies.remove(id);
+    }
+}
+
+quint64 MpvWidget::registerReply(ReplyCallback onReply)
+{
+    if (!onReply) return 0;
+
+    const quint64 id = m_nextReplyId++;
+    m_replies.insert(id, std::move(onReply));
+    return id;
+}
+
+void MpvWidget::dispatchReply(quint64 id, int error, const QVariant &result)
+{
+    if (id == 0) {
+        if (error < 0) {
+            qDebug() << "mpv async request failed:" << mpv_error_string(error);
+        }
+        return;
+    }
+
+    ReplyCallback callback = m_replies.take(id);
+    if (callback) {
+        callback(error, result);
+    }
+}
+
 QVariant MpvWidget::getProperty(const QString &name) const
 {
     if (!m_mpv) return QVariant();
@@ -325,47 +884,141 @@ QVariant MpvWidget::getProperty(const QString &name) const
 void MpvWidget::loadFile(const QString &file)
 {
     qDebug() << "MpvWidget::loadFile:" << file;
+
+    // A file of this cell's list restarts the window there and the list plays on
+    if (const int position = m_playlist.indexOf(file); position >= 0 && m_initialized) {
+        feedWindow(position);
+        return;
+    }
     command(QVariantList{"loadfile", file});
+    m_windowCount = 0;   // replace cleared mpv's playlist; the window is gone
 }
 
-void MpvWidget::loadPlaylist(const QStringList &files)
+void MpvWidget::loadPlaylist(const Playlist &playlist)
 {
-    if (files.isEmpty()) return;
+    if (playlist.isEmpty()) return;
 
-    if (!m_initialized) {
-        qDebug() << "Queueing playlist with" << files.size() << "files";
-        m_pendingPlaylist = files;
+    m_playlist = playlist;
+    m_blockedSkips = 0;
+
+    if (!m_initialized || m_startDeferred) {
+        qDebug() << "Queueing playlist with" << playlist.size() << "files";
+        m_playlistPending = true;
         return;
     }
 
-    qDebug() << "Loading playlist with" << files.size() << "files";
-    m_currentPlaylist = files;  // Store for rename support
-    loadFile(files.first());
-    for (int i = 1; i < files.size(); ++i) {
-        command(QVariantList{"loadfile", files[i], "append"});
+    qDebug() << "Loading playlist with" << playlist.size() << "files";
+    feedWindow(0);
+}
+
+int MpvWidget::appendToPlaylist(const QVector<quint32> &indices)
+{
+    const int count = m_playlist.size();
+    if (indices.isEmpty() || !m_playlist.table()) return count;
+
+    // New entries are mixed into everything not yet handed to mpv, so a
+    // playlist that grows while the walk streams in does not play the
+    // first directories walked before all the rest
+    const bool queued = !m_initialized || m_startDeferred || m_playlistPending;
+    int from = 0;
+    int to = count;
+    if (!queued && m_windowCount > 0) {
+        const int windowEnd = m_windowStart + m_windowCount;
+        if (windowEnd <= count) {
+            from = windowEnd;
+        } else {
+            // The window wraps: what is left lies between its tail and its head
+            from = windowEnd - count;
+            to = m_windowStart;
+            m_windowStart += static_cast<int>(indices.size());
+        }
+    }
+    m_playlist.scatter(indices, from, to, s_rng);
+
+    // Still queued: the window is fed on initializeGL or releaseStart()
+    if (!m_initialized || m_startDeferred) {
+        m_playlistPending = true;
+        return from;
     }
+
+    if (count == 0) {
+        loadPlaylist(m_playlist);
+        return from;
+    }
+
+    topUpWindow();
+    return from;
+}
+
+// ============ Playlist Window ============
+
+void MpvWidget::feedWindow(int position)
+{
+    const int count = m_playlist.size();
+    if (count == 0 || !m_initialized) return;
+
+    m_windowStart = ((position % count) + count) % count;
+    m_windowCount = 1;
+
+    // replace clears mpv's playlist, so the window restarts here
+    command(QVariantList{"loadfile", m_playlist.at(m_windowStart), "replace"});
+    topUpWindow();
 }
 
-void MpvWidget::updatePlaylistPath(const QString &oldPath, const QString &newPath)
+void MpvWidget::topUpWindow()
 {
-    // Update in current playlist
-    for (int i = 0; i < m_currentPlaylist.size(); ++i) {
-        if (m_currentPlaylist[i] == oldPath) {
-            m_currentPlaylist[i] = newPath;
-            qDebug() << "Updated playlist entry:" << oldPath << "->" << newPath;
+    const int count = m_playlist.size();
+    if (count == 0 || m_windowCount == 0) return;
+
+    const int target = std::min(MpvConstants::kPlaylistWindow, count);
+    while (m_windowCount < target) {
+        const int position = (m_windowStart + m_windowCount) % count;
+        command(QVariantList{"loadfile", m_playlist.at(position), "append"});
+        ++m_windowCount;
+    }
+
+    // Seek data for everything mpv may open next, and the next few stills decoded
+    QStringList upcoming;
+    QStringList stills;
+    upcoming.reserve(m_windowCount);
+    for (int i = 0; i < m_windowCount; ++i) {
+        const QString &path = m_playlist.at((m_windowStart + i) % count);
+        upcoming.append(path);
+        if (m_stillFastPath && stills.size() < StillConstants::kPrefetchDepth && StillImageCache::handles(path)) {
+            stills.append(path);
         }
     }
+    KeyframeIndex::instance().prefetch(upcoming);
+    if (m_stillFastPath) {
+        StillImageCache::instance().setWanted(this, stills, pixelSize());
+    }
+}
 
-    // Update pending playlist if not yet initialized
-    for (int i = 0; i < m_pendingPlaylist.size(); ++i) {
-        if (m_pendingPlaylist[i] == oldPath) {
-            m_pendingPlaylist[i] = newPath;
+void MpvWidget::advanceWindowTo(const QString &path)
+{
+    // Matched by path, not by mpv's playlist-pos: a reported position can be
+    // stale against playlist-remove commands still queued, while the window
+    // always mirrors mpv's playlist after every command we sent. Paths are
+    // unique within the window (PathTable dedupes, the window never wraps).
+    const int count = m_playlist.size();
+    if (count == 0 || m_windowCount <= 1 || path.isEmpty()) return;
+
+    int advanced = -1;
+    for (int i = 1; i < m_windowCount; ++i) {
+        if (m_playlist.at((m_windowStart + i) % count) == path) {
+            advanced = i;
+            break;
         }
     }
+    if (advanced < 0) return;
 
-    // Note: mpv's internal playlist already has file handles open,
-    // so we don't need to update it. The rename will work for future
-    // navigation since we store our own playlist copy.
+    // Playback moved forward inside the window: drop what was played, refill the tail
+    m_windowStart = (m_windowStart + advanced) % count;
+    for (int i = 0; i < advanced; ++i) {
+        command(QVariantList{"playlist-remove", 0});
+    }
+    m_windowCount -= advanced;
+    topUpWindow();
 }
 
 void MpvWidget::play()
@@ -385,6 +1038,7 @@ void MpvWidget::pause()
 void MpvWidget::stop()
 {
     command(QVariantList{"stop"});
+    m_windowCount = 0;  // stop clears mpv's playlist
 }
 
 void MpvWidget::togglePause()
@@ -399,21 +1053,46 @@ void MpvWidget::next()
 
 void MpvWidget::prev()
 {
-    command(QVariantList{"playlist-prev"});
+    // mpv never holds played entries, so step back on the logical list
+    feedWindow(m_windowStart - 1);
 }
 
 void MpvWidget::shuffle()
 {
-    command(QVariantList{"playlist-shuffle"});
+    if (m_playlist.isEmpty()) return;
+
+    // Shuffle the logical list, keep the current entry playing
+    const quint32 current = m_playlist.order().at(m_windowStart);
+    m_playlist.shuffle(s_rng);
+    m_windowStart = static_cast<int>(m_playlist.order().indexOf(current));
+
+    if (!m_initialized || m_windowCount == 0) return;
+
+    // playlist-clear keeps only the playing entry
+    command(QVariantList{"playlist-clear"});
+    m_windowCount = 1;
+    topUpWindow();
 }
 
 void MpvWidget::playIndex(int index)
 {
-    command(QVariantList{"playlist-play-index", index});
+    if (index < 0 || index >= m_playlist.size()) return;
+    feedWindow(index);
 }
 
 void MpvWidget::seek(double seconds)
 {
+    // With a known keyframe in the seek direction, land on it exactly; the
+    // demuxer then needs no search and the decoder no catch-up
+    const KeyframeInfoPtr info = KeyframeIndex::instance().lookup(m_state.path);
+    if (info && info->hasKeyframes()) {
+        const double target = m_state.timePos + seconds;
+        const double keyframe = seconds >= 0 ? info->keyframeAtOrAfter(target) : info->keyframeAtOrBefore(target);
+        if (keyframe >= 0) {
+            command(QVariantList{"seek", keyframe, "absolute+exact"});
+            return;
+        }
+    }
     command(QVariantList{"seek", seconds, "relative"});
 }
 
@@ -439,55 +1118,99 @@ void MpvWidget::unmute()
 
 QString MpvWidget::currentFile() const
 {
-    return getProperty("path").toString();
+    return m_state.path;
 }
 
 QStringList MpvWidget::currentPlaylist() const
 {
-    QStringList result;
-    if (!m_mpv) return result;
-
-    // Get playlist count from mpv
-    int64_t count = 0;
-    if (mpv_get_property(m_mpv, "playlist-count", MPV_FORMAT_INT64, &count) < 0) {
-        return m_currentPlaylist;  // Fallback to stored playlist
-    }
-
-    // Get each playlist entry's filename
-    for (int64_t i = 0; i < count; ++i) {
-        QString propName = QString("playlist/%1/filename").arg(i);
-        QByteArray propNameUtf8 = propName.toUtf8();
-        char *filename = nullptr;
-        if (mpv_get_property(m_mpv, propNameUtf8.constData(), MPV_FORMAT_STRING, &filename) >= 0 && filename) {
-            result.append(QString::fromUtf8(filename));
-            mpv_free(filename);
-        }
-    }
-
-    return result.isEmpty() ? m_currentPlaylist : result;
+    // mpv only sees the window; the logical list is the source of truth
+    return m_playlist.toStringList();
 }
 
 double MpvWidget::position() const
 {
-    return getProperty("time-pos").toDouble();
+    return m_state.timePos;
 }
 
 double MpvWidget::duration() const
 {
-    return getProperty("duration").toDouble();
+    return m_state.duration;
 }
 
 bool MpvWidget::isPaused() const
 {
-    return getProperty("pause").toBool();
+    return m_state.paused;
 }
 
 bool MpvWidget::isMuted() const
 {
-    return getProperty("mute").toBool();
+    return m_state.muted;
 }
 
 // Skipper methods
+void MpvWidget::onLoadHook()
+{
+    m_skipApplied = false;
+
+    // mpv waits on the hook, so a synchronous read is safe and already
+    // reflects the file being loaded (the path observer may lag behind)
+    const QString path = getProperty("path").toString();
+    advanceWindowTo(path);
+    m_openingPath = path;
+    m_openingStill = false;
+    m_state.openingPath = path;
+    m_state.loading = true;
+    m_state.loadStartedAt = QDeadlineTimer::current().deadline();
+
+    // Blocked after repeated failures: move on without opening it, and stop
+    // once a whole pass found nothing playable
+    if (const PathTablePtr &table = m_playlist.table(); table && table->isBlocked(path)) {
+        if (++m_blockedSkips >= m_playlist.size()) {
+            stop();   // Also drops the window
+        } else {
+            command(QVariantList{"playlist-next"});
+        }
+        return;
+    }
+
+    // Stills are drawn by the cell's StillView. mpv plays a tiny placeholder
+    // of the same length instead, so loop-file, image-display-duration and
+    // the playlist behave as before without decoding and scaling the image.
+    m_openingStill = m_stillFastPath && StillImageCache::handles(path)
+        && !StillImageCache::instance().hasFailed(path);
+    if (m_openingStill) {
+        const QByteArray placeholder = "av://lavfi:color=c=black:s=16x16:r=1:d="
+            + QByteArray::number(m_imageDuration, 'f', 3);
+        mpv_set_property_string(m_mpv, "stream-open-filename", placeholder.constData());
+        return;
+    }
+
+    if (!path.isEmpty()) {
+        m_ioProfile = IoProfiles::instance().profileFor(path);
+        applyIoProfile("file-local-options/");
+    }
+
+    if (!m_skipperEnabled) return;
+    if (path.isEmpty() || m_seenFiles.object(path)) return;   // object() also refreshes its LRU slot
+    m_seenFiles.insert(path, new bool(true));
+
+    // Images have no timeline to skip into
+    if (FileScanner::imageExtensions().contains(QFileInfo(path).suffix().toLower())) return;
+
+    // file-local: reset by mpv when the next file starts. A cached keyframe
+    // at or before the skip point is used as is, so the start seek lands
+    // without decoding up to it; it is still a seek past what prefetch read.
+    QByteArray start = QByteArray::number(m_skipPercent * 100.0, 'f', 2) + '%';
+    if (const KeyframeInfoPtr info = KeyframeIndex::instance().lookup(path); info && info->duration > 0) {
+        const double keyframe = info->keyframeAtOrBefore(info->duration * m_skipPercent);
+        if (keyframe > 0) {
+            start = QByteArray::number(keyframe, 'f', 3);
+        }
+    }
+    mpv_set_property_string(m_mpv, "file-local-options/start", start.constData());
+    m_skipApplied = true;
+}
+
 void MpvWidget::setSkipPercent(double percent)
 {
     m_skipPercent = qBound(0.0, percent, 1.0);
@@ -509,7 +1232,7 @@ void MpvWidget::setLoopFile(bool loop)
 
 bool MpvWidget::isLoopFile() const
 {
-    return getProperty("loop-file").toString() == "inf";
+    return m_state.loopFileInf;
 }
 
 void MpvWidget::toggleLoopFile()
@@ -535,30 +1258,29 @@ void MpvWidget::frameBackStep()
 void MpvWidget::rotateVideo()
 {
     using namespace MpvConstants;
-    m_rotation = (m_rotation + kRotationStep) % 360;
-    setProperty("video-rotate", m_rotation);
-    command(QVariantList{"show-text", QString("rotate: %1°").arg(m_rotation), QString::number(kOsdDurationMs)});
+    const int rotation = (m_state.rotation + kRotationStep) % 360;
+    setProperty("video-rotate", rotation);
+    command(QVariantList{"show-text", QString("rotate: %1°").arg(rotation), QString::number(kOsdDurationMs)});
 }
 
 void MpvWidget::zoomIn()
 {
-    double zoom = getProperty("video-zoom").toDouble();
-    setProperty("video-zoom", zoom + MpvConstants::kZoomStep);
+    // add is relative on mpv's side, so rapid presses never drop a step
+    command(QVariantList{"add", "video-zoom", MpvConstants::kZoomStep});
 }
 
 void MpvWidget::zoomOut()
 {
-    double zoom = getProperty("video-zoom").toDouble();
-    setProperty("video-zoom", zoom - MpvConstants::kZoomStep);
+    command(QVariantList{"add", "video-zoom", -MpvConstants::kZoomStep});
 }
 
 void MpvWidget::zoomAt(double delta, double normalizedX, double normalizedY)
 {
     // Zoom towards mouse position
     // normalizedX/Y: 0.0 = left/top, 1.0 = right/bottom, 0.5 = center
-    double currentZoom = getProperty("video-zoom").toDouble();
-    double currentPanX = getProperty("video-pan-x").toDouble();
-    double currentPanY = getProperty("video-pan-y").toDouble();
+    double currentZoom = m_state.videoZoom;
+    double currentPanX = m_state.videoPanX;
+    double currentPanY = m_state.videoPanY;
 
     // Convert normalized coords to centered coords (-0.5 to 0.5)
     double cx = normalizedX - 0.5;
@@ -618,6 +1340,116 @@ void MpvWidget::setOsdLevel(int level)
 }
 
 
+// ============ Render Quality ============
+
+QSize MpvWidget::pixelSize() const
+{
+    // Hidden on the wall; the cell's rect is what gets rendered
+    const QWidget *area = (m_wall && parentWidget()) ? parentWidget() : this;
+    const qreal dpr = area->devicePixelRatioF();
+    return QSize(qRound(area->width() * dpr), qRound(area->height() * dpr));
+}
+
+void MpvWidget::sampleQuality()
+{
+    // Hidden cells (tile fullscreen) render nothing worth measuring
+    const QWidget *area = (m_wall && parentWidget()) ? parentWidget() : this;
+    if (!m_mpv || !area->isVisible()) return;
+
+    const qint64 dropped = m_state.frameDropCount + m_state.delayedFrameCount;
+    if (m_governor.update(pixelSize(), dropped)) {
+        applyQualityTier(m_governor.tier());
+    }
+}
+
+void MpvWidget::applyQualityTier(QualityTier tier)
+{
+    qDebug() << "Render quality ->" << QualityGovernor::tierName(tier) << "at" << pixelSize();
+    for (const QualityOption &option : kQualityOptions) {
+        setProperty(option.name, QString::fromLatin1(qualityValue(option, tier)));
+    }
+}
+
+void MpvWidget::setQualityPinned(bool pinned)
+{
+    m_governor.setPinned(pinned);
+
+    // Apply right away instead of waiting for the next sample
+    if (m_mpv && m_governor.update(pixelSize(), m_state.frameDropCount + m_state.delayedFrameCount)) {
+        applyQualityTier(m_governor.tier());
+    }
+    updateDecodeCap();
+}
+
+// ============ Decode Cap ============
+
+void MpvWidget::updateDecodeCap()
+{
+    if (!m_mpv || !Config::instance().decodeCapEnabled()) return;
+
+    if (!m_decodeCapTimer) {
+        m_decodeCapTimer = new QTimer(this);
+        m_decodeCapTimer->setSingleShot(true);
+        m_decodeCapTimer->setInterval(MpvConstants::kDecodeCapDebounceMs);
+        connect(m_decodeCapTimer, &QTimer::timeout, this, &MpvWidget::applyDecodeCap);
+    }
+    m_decodeCapTimer->start();
+}
+
+void MpvWidget::applyDecodeCap()
+{
+    if (!m_mpv) return;
+
+    using namespace MpvConstants;
+    const QSize tile = pixelSize();
+    const int srcW = m_state.videoWidth;
+    const int srcH = m_state.videoHeight;
+
+    // Fit the source inside the tile; never upscale, and leave zoomed or
+    // pinned (tile fullscreen) cells at full resolution
+    QSize target;
+    double ratio = 1.0;
+    if (srcW > 0 && srcH > 0 && !tile.isEmpty() && m_state.videoZoom <= 0.0 && !m_governor.isPinned()) {
+        ratio = std::min({static_cast<double>(tile.width()) / srcW, static_cast<double>(tile.height()) / srcH, 1.0});
+        if (ratio < kDecodeCapMinRatio) {
+            // Even dimensions keep chroma-subsampled formats happy
+            target = QSize(std::max(2, qRound(srcW * ratio) & ~1), std::max(2, qRound(srcH * ratio) & ~1));
+        }
+    }
+
+    // Software decoding can also skip the in-loop deblocking filter on tiny tiles;
+    // takes effect when the next file opens its decoder
+    const bool software = m_state.hwdecCurrent.isEmpty() || m_state.hwdecCurrent == "no";
+    setProperty("vd-lavc-skiploopfilter", software && ratio < kSkipLoopFilterRatio ? "all" : "default");
+
+    // Scale on the GPU surface when the decoder keeps frames there; copy-back
+    // and software frames use the regular swscale filter. The kind is part of
+    // the installed filter, so an hwdec change at the same size rebuilds it.
+    const QString &hwdec = m_state.hwdecCurrent;
+    QString filter;
+    if (!target.isEmpty()) {
+        if (hwdec == "vaapi") {
+            filter = QString("@cap:lavfi=[scale_vaapi=w=%1:h=%2]");
+        } else if (hwdec == "cuda" || hwdec == "nvdec") {
+            filter = QString("@cap:lavfi=[scale_cuda=w=%1:h=%2]");
+        } else {
+            filter = QString("@cap:scale=w=%1:h=%2");
+        }
+        filter = filter.arg(target.width()).arg(target.height());
+    }
+
+    if (filter == m_decodeCap) return;
+
+    if (!m_decodeCap.isEmpty()) {
+        command(QVariantList{"vf", "remove", "@cap"});
+    }
+    m_decodeCap = filter;
+    if (filter.isEmpty()) return;
+
+    command(QVariantList{"vf", "add", filter});
+    qDebug() << "Decode cap" << srcW << "x" << srcH << "->" << target << "hwdec:" << hwdec;
+}
+
 // Screenshot
 void MpvWidget::screenshot()
 {
@@ -1,37 +1,120 @@
 #pragma once
 
 #include <QOpenGLWidget>
-#include <QSet>
+#include <QTimer>
+#include <QCache>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QPointer>
 #include <mpv/client.h>
 #include <mpv/render_gl.h>
+#include <atomic>
 #include <functional>
+#include <random>
+#include <vector>
+#include "playlist.h"
+#include "config.h"
+#include "qualitygovernor.h"
+#include "framescheduler.h"
 
 // Constants
 namespace MpvConstants {
     inline constexpr int kMinWidgetSize = 100;
-    inline constexpr int kSkipperDelayMs = 150;
     inline constexpr int kScreenshotDelayMs = 100;
     inline constexpr int kOsdDurationMs = 1500;
     inline constexpr double kDefaultSkipPercent = 0.33;
     inline constexpr double kZoomStep = 0.1;
     inline constexpr int kRotationStep = 90;
+    inline constexpr int kPlaylistWindow = 8;  // Entries handed to mpv at once (current + upcoming)
+    inline constexpr int kDecodeCapDebounceMs = 250;   // Resize storms settle before the chain is rebuilt
+    inline constexpr double kDecodeCapMinRatio = 0.8;  // Skip capping when the tile is nearly source size
+    inline constexpr double kSkipLoopFilterRatio = 0.5; // Software decode drops the loop filter below this
+    inline constexpr int kSeenFilesLimit = 4096;        // Skipper memory per cell; oldest paths start at 0 again
 }
 
-class MpvWidget : public QOpenGLWidget
+// Command arguments converted to UTF-8 once. A single instance can be sent
+// to any number of widgets, which keeps grid-wide broadcasts to one pass.
+class MpvCommand
+{
+public:
+    MpvCommand() = default;
+    explicit MpvCommand(const QVariantList &args);
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_args.isEmpty(); }
+    [[nodiscard]] std::vector<const char*> argv() const;  // NULL-terminated, valid while this lives
+    [[nodiscard]] QByteArray toDebugString() const;
+
+private:
+    QVector<QByteArray> m_args;
+};
+
+// Last values reported by mpv's property observers. Only updated from
+// MPV_EVENT_PROPERTY_CHANGE, so reading it never calls into libmpv.
+struct MpvState {
+    QString path;               // Empty while idle
+    double timePos = 0.0;
+    double duration = 0.0;
+    bool paused = false;
+    bool idle = true;
+    bool loopFileInf = false;   // loop-file=inf
+    double volume = 0.0;
+    bool muted = false;
+    qint64 playlistPos = -1;     // Position inside mpv's window, not the logical list
+    double videoZoom = 0.0;
+    double videoPanX = 0.0;
+    double videoPanY = 0.0;
+    int rotation = 0;
+    qint64 frameDropCount = 0;      // Decoder drops, per file
+    qint64 delayedFrameCount = 0;   // VO frames shown late, per file
+    int videoWidth = 0;             // Decoded size, before our filters
+    int videoHeight = 0;
+    QString hwdecCurrent;           // Empty or "no" for software decoding
+    QString videoCodec;             // FFmpeg name of the video track's codec, e.g. "hevc"
+    bool pausedForCache = false;    // Waiting on the network or disk
+    double cacheAheadSecs = 0.0;    // demuxer-cache-duration
+    int cacheStalls = 0;            // paused-for-cache episodes since the cell started
+    qint64 cacheStallMs = 0;        // Time spent in finished episodes
+    bool still = false;             // Drawn by the cell's StillView; mpv only keeps the time
+    bool loading = false;           // Between the on_load hook and file-loaded or end-file
+    qint64 loadStartedAt = 0;       // Monotonic ms, see QDeadlineTimer::current()
+    QString openingPath;            // File the on_load hook saw last; path can still name the previous one
+    qint64 progressAt = 0;          // Monotonic ms of the last time-pos advance
+
+    // PerfMetrics; the first two are polled by sampleMetrics() only while someone looks
+    double vfFps = 0.0;             // estimated-vf-fps
+    qint64 decoderDropCount = 0;    // decoder-frame-drop-count, per file
+    double renderMs = 0.0;          // Smoothed mpv_render_context_render time
+};
+
+class WallRenderer;
+
+class MpvWidget : public QOpenGLWidget, public FrameClient
 {
     Q_OBJECT
 
 public:
+    // error is an mpv_error code; result is empty for set-property replies
+    using ReplyCallback = std::function<void(int error, const QVariant &result)>;
+
     explicit MpvWidget(QWidget *parent = nullptr);
     ~MpvWidget() override;
 
+    // Asynchronous: queued on the mpv core, never blocks the GUI thread.
+    // Commands on one widget run in submission order.
     void command(const QVariant &args);
+    void command(const MpvCommand &cmd, ReplyCallback onReply = {});
     void setProperty(const QString &name, const QVariant &value);
+    void getPropertyAsync(const QString &name, mpv_format format, ReplyCallback onReply);
+
+    // Blocking string read; prefer getPropertyAsync() on hot paths
     [[nodiscard]] QVariant getProperty(const QString &name) const;
 
     void loadFile(const QString &file);
-    void loadPlaylist(const QStringList &files);
-    void updatePlaylistPath(const QString &oldPath, const QString &newPath);
+    void loadPlaylist(const Playlist &playlist);
+    // Indices into the loaded playlist's table, spread over the entries mpv
+    // has not been handed yet; returns the first position that changed
+    int appendToPlaylist(const QVector<quint32> &indices);
     void play();
     void pause();
     void stop();
@@ -46,8 +129,10 @@ public:
     void mute();
     void unmute();
 
+    [[nodiscard]] const MpvState& state() const noexcept { return m_state; }
     [[nodiscard]] QString currentFile() const;
-    [[nodiscard]] QStringList currentPlaylist() const;
+    [[nodiscard]] QStringList currentPlaylist() const;  // Full logical list; indices match playIndex()
+    [[nodiscard]] const Playlist& playlist() const noexcept { return m_playlist; }
     [[nodiscard]] double position() const;
     [[nodiscard]] double duration() const;
     [[nodiscard]] bool isPaused() const;
@@ -57,6 +142,9 @@ public:
     void setSkipPercent(double percent);
     [[nodiscard]] double skipPercent() const noexcept { return m_skipPercent; }
     void setSkipperEnabled(bool enabled);
+
+    // Stills go to a StillView (see StillImageCache) instead of mpv's video pipeline
+    void setStillFastPath(bool enabled) noexcept { m_stillFastPath = enabled; }
     [[nodiscard]] bool isSkipperEnabled() const noexcept { return m_skipperEnabled; }
 
     // Loop control
@@ -82,13 +170,62 @@ public:
     void setOscEnabled(bool enabled);
     void setOsdLevel(int level);
 
+    // FrameClient: called by FrameScheduler once per refresh while mpv has a new frame
+    void onFrameDue() override;
+
+    // Render quality (see QualityGovernor); pinned cells always run the high tier
+    void setQualityPinned(bool pinned);
+    [[nodiscard]] QualityTier qualityTier() const noexcept { return m_governor.tier(); }
+
+    // Wall mode: the mpv core runs without this widget's surface and a shared
+    // WallRenderer draws it. Detaching hands rendering back (tile fullscreen).
+    void attachToWall(WallRenderer *wall);
+    void detachFromWall();
+    [[nodiscard]] bool isOnWall() const noexcept { return !m_wall.isNull(); }
+    [[nodiscard]] mpv_handle* handle() const noexcept { return m_mpv; }
+
+    // Decode cap: scale frames down to the tile's pixel size before upload.
+    // Debounced; call on resize and on tile fullscreen changes.
+    void updateDecodeCap();
+
+    // Staggered start (see PlaybackScheduler): a deferred widget keeps its
+    // playlist but opens nothing until releaseStart()
+    void deferStart() noexcept { m_startDeferred = true; }
+    void releaseStart();
+    [[nodiscard]] bool isStartDeferred() const noexcept { return m_startDeferred; }
+
+    // hwdec=auto-safe or no; a running file switches decoders in place
+    void setHardwareDecoding(bool enabled);
+
+    // Upper bound on the forward demuxer cache, from the wall's shared budget;
+    // 0 leaves the I/O profile's own size
+    void setCacheLimit(qint64 bytes);
+
+    // Performance metrics (see PerfMetrics)
+    void sampleMetrics();                   // Async; metricsUpdated() once the replies are in
+    void recordRenderTime(qint64 nsecs, bool newFrame);   // By whichever path rendered this player; newFrame: MPV_RENDER_UPDATE_FRAME
+    [[nodiscard]] bool hardwareDecoding() const noexcept { return m_hardwareDecoding; }
+
+    // Headless (soak runs, CI): vo=null and no GL. Set before the first
+    // widget is created; the core then starts with the widget.
+    static void setHeadless(bool headless) noexcept { s_headless = headless; }
+    [[nodiscard]] static bool isHeadless() noexcept { return s_headless; }
+
 signals:
     void fileChanged(const QString &path);
     void positionChanged(double pos);
     void durationChanged(double dur);
     void pauseChanged(bool paused);
+    void idleChanged(bool idle);
     void fileLoaded(const QString &path);
     void loopChanged(bool looping);
+    void videoFormatChanged();   // Size, codec or active hwdec of the video track
+    void fileFailed(const QString &path, const QString &error);   // end-file with an error
+    void cacheStateChanged(bool starved);   // paused-for-cache toggled
+    void stillChanged(const QString &path);  // Still to show over the video; empty when mpv draws again
+    void transformChanged();   // video-zoom, video-pan-x/y or video-rotate; StillView follows them
+    void metricsUpdated();
+    void firstFrameRendered();   // Once per loaded file
 
 protected:
     void initializeGL() override;
@@ -100,31 +237,86 @@ protected:
 
 private slots:
     void onMpvEvents();
-    void maybeUpdate();
+    void sampleQuality();
+    void applyDecodeCap();
 
 private:
     void createMpv();
     void destroyMpv();
+    void startCore();
+    void createRenderContext();   // Needs this widget's GL context current
+    void freeRenderContext();
     void handleMpvEvent(mpv_event *event);
+    void handlePropertyChange(quint64 id, const mpv_event_property *prop);
     void processPendingCommands();
+    void applyQualityTier(QualityTier tier);
+    void applyIoProfile(const char *prefix);   // m_ioProfile within m_cacheLimit
+    [[nodiscard]] qint64 cacheBytes() const noexcept;   // Forward demuxer cache for the current file
+    [[nodiscard]] QSize pixelSize() const;
+    [[nodiscard]] quint64 registerReply(ReplyCallback onReply);
+    void dispatchReply(quint64 id, int error, const QVariant &result);
 
+    // Sliding playlist window: mpv only holds m_windowCount entries starting
+    // at logical position m_windowStart, topped up as playback advances
+    void feedWindow(int position);
+    void topUpWindow();
+    void advanceWindowTo(const QString &path);   // path is starting; drops the entries before it
+
+    // on_load hook: sets the skipper start position before the file opens
+    void onLoadHook();
+
+    void firstFrameShown();   // By a render, or by playback-restart when headless
+
+    static void onWakeup(void *ctx);
     static void onUpdate(void *ctx);
     static void *getGlProcAddress(void *ctx, const char *name);
 
     mpv_handle *m_mpv = nullptr;
     mpv_render_context *m_mpvGl = nullptr;
-    bool m_initialized = false;
+    bool m_initialized = false;         // mpv core is up and accepts commands
+    QPointer<WallRenderer> m_wall;
     QList<QVariantList> m_pendingCommands;
-    QStringList m_pendingPlaylist;
-    QStringList m_currentPlaylist;
+    MpvState m_state;
+    std::atomic_bool m_eventsQueued{false};     // Coalesces wakeups into one queued drain
+    QHash<quint64, ReplyCallback> m_replies;    // reply_userdata -> callback
+    quint64 m_nextReplyId = 1;                  // 0 means "no callback"
+    Playlist m_playlist;             // Paths resolve through the grid's shared PathTable
+    bool m_playlistPending = false;  // Set before initializeGL; loaded once mpv is up
+    bool m_startDeferred = false;    // Held by the PlaybackScheduler
+    bool m_hardwareDecoding = true;
+    int m_windowStart = 0;           // Logical position of mpv's playlist entry 0
+    int m_windowCount = 0;           // Entries currently in mpv's playlist
+    static inline std::mt19937 s_rng{std::random_device{}()};
+    static inline bool s_headless = false;
 
     // Skipper state
     double m_skipPercent = MpvConstants::kDefaultSkipPercent;
     bool m_skipperEnabled = true;
-    QSet<QString> m_seenFiles;
+    QCache<QString, bool> m_seenFiles{MpvConstants::kSeenFilesLimit};   // LRU; a long run must not grow it forever
+    bool m_skipApplied = false;      // Current file started at the skip position
+
+    // File being opened, for end-file reports; the path observer may lag behind
+    QString m_openingPath;
+    bool m_openingStill = false;     // m_openingPath goes to the still fast path
+    bool m_stillFastPath = true;
+    double m_imageDuration = 0.0;    // image-display-duration, for the still placeholder
+    int m_blockedSkips = 0;          // Blocked entries skipped since the last file loaded
+
+    // I/O profile of the current file's source, see IoProfiles
+    IoProfile m_ioProfile;
+    qint64 m_cacheLimit = 0;
+    qint64 m_cacheStallStartedAt = 0;
+
+    bool m_awaitingFirstFrame = false;   // File loaded, nothing rendered of it yet
+    bool m_frameUpdated = false;         // mpv reported a new frame the next paintGL() draws
+
+    // Render quality governor
+    QualityGovernor m_governor;
+    QTimer *m_qualityTimer = nullptr;
 
-    // Video transform state
-    int m_rotation = 0;
+    // Decode cap state
+    QTimer *m_decodeCapTimer = nullptr;
+    QString m_decodeCap;               // Currently installed @cap filter, empty if none
 
     // Original loop count from config (for restoring after inf toggle)
     int m_originalLoopCount = 5;
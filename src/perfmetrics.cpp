@@ -0,0 +1,153 @@
+#include "perfmetrics.h"
+#include "cellstatusstore.h"
+#include "statsmanager.h"
+#include <QDebug>
+
+namespace {
+
+// One metric family: HELP and TYPE once, then a sample per cell
+class Exposition
+{
+public:
+    void family(const char *name, const char *type, const char *help)
+    {
+        m_text += "# HELP " + QByteArray(name) + ' ' + help + '\n';
+        m_text += "# TYPE " + QByteArray(name) + ' ' + type + '\n';
+    }
+
+    void sample(const char *name, double value, const QByteArray &labels = QByteArray())
+    {
+        m_text += name;
+        if (!labels.isEmpty()) {
+            m_text += '{' + labels + '}';
+        }
+        m_text += ' ' + QByteArray::number(value, 'g', 10) + '\n';
+    }
+
+    [[nodiscard]] QByteArray text() const { return m_text; }
+
+private:
+    QByteArray m_text;
+};
+
+QByteArray cellLabels(const CellStatus &status)
+{
+    return "row=\"" + QByteArray::number(status.row) + "\",col=\"" + QByteArray::number(status.col) + '"';
+}
+
+} // namespace
+
+PerfMetrics& PerfMetrics::instance()
+{
+    static PerfMetrics instance;
+    return instance;
+}
+
+PerfMetrics::PerfMetrics()
+    : QObject(nullptr)
+{
+    m_sampleTimer.setInterval(PerfConstants::kSampleIntervalMs);
+    m_sampleTimer.setTimerType(Qt::CoarseTimer);
+    connect(&m_sampleTimer, &QTimer::timeout, this, &PerfMetrics::sampleDue);
+}
+
+void PerfMetrics::setHudVisible(bool visible)
+{
+    if (visible == m_hudVisible) return;
+    m_hudVisible = visible;
+    updateSampling();
+    emit hudVisibilityChanged(visible);
+}
+
+void PerfMetrics::setExporting(bool exporting)
+{
+    m_exporting = exporting;
+    updateSampling();
+}
+
+void PerfMetrics::setLogging(bool logging)
+{
+    m_logging = logging;
+    updateSampling();
+}
+
+void PerfMetrics::updateSampling()
+{
+    if (m_hudVisible || m_exporting || m_logging) {
+        if (!m_sampleTimer.isActive()) {
+            m_sampleTimer.start();
+            emit sampleDue();   // Don't leave a fresh HUD empty for a whole interval
+        }
+    } else {
+        m_sampleTimer.stop();
+    }
+}
+
+void PerfMetrics::recordIndexTime(qint64 ms, bool fromCache)
+{
+    (fromCache ? m_lastIndexCacheMs : m_lastIndexMs) = ms;
+}
+
+void PerfMetrics::gridStarting()
+{
+    m_gridTimer.start();
+    m_awaitingFirstFrame = true;
+}
+
+void PerfMetrics::frameRendered()
+{
+    if (!m_awaitingFirstFrame) return;
+    m_awaitingFirstFrame = false;
+    m_firstFrameMs = m_gridTimer.elapsed();
+    qDebug() << "PerfMetrics: first frame" << m_firstFrameMs << "ms after grid start";
+    emit firstFrame(m_firstFrameMs);
+}
+
+QByteArray PerfMetrics::prometheusText() const
+{
+    Exposition out;
+    const QVector<CellStatus> &cells = CellStatusStore::instance().snapshot();
+
+    out.family("goobert_cells", "gauge", "Cells in the running grid");
+    out.sample("goobert_cells", cells.size());
+    out.family("goobert_index_duration_ms", "gauge", "Last media index walk of a root, -1 if none yet");
+    out.sample("goobert_index_duration_ms", m_lastIndexMs);
+    out.family("goobert_index_cache_duration_ms", "gauge", "Last root served from the index database, -1 if none yet");
+    out.sample("goobert_index_cache_duration_ms", m_lastIndexCacheMs);
+    out.family("goobert_grid_first_frame_ms", "gauge", "Grid start to the first rendered frame, -1 if none yet");
+    out.sample("goobert_grid_first_frame_ms", m_firstFrameMs);
+    out.family("goobert_stats_queue_depth", "gauge", "Stats records waiting for the writer thread");
+    out.sample("goobert_stats_queue_depth", StatsManager::instance().pendingWrites());
+    out.family("goobert_stats_dropped_total", "counter", "Stats records lost to a full writer backlog");
+    out.sample("goobert_stats_dropped_total", double(StatsManager::instance().droppedWrites()));
+
+    // Cells that never played a file have nothing to report
+    auto perCell = [&](const char *name, const char *type, const char *help, auto value) {
+        out.family(name, type, help);
+        for (const CellStatus &status : cells) {
+            if (!status.path.isEmpty()) {
+                out.sample(name, value(status), cellLabels(status));
+            }
+        }
+    };
+    perCell("goobert_cell_fps", "gauge", "estimated-vf-fps",
+            [](const CellStatus &s) { return s.fps; });
+    perCell("goobert_cell_frame_drops", "gauge", "frame-drop-count of the current file; restarts at 0 per file",
+            [](const CellStatus &s) { return double(s.frameDrops); });
+    perCell("goobert_cell_decoder_drops", "gauge", "decoder-frame-drop-count of the current file; restarts at 0 per file",
+            [](const CellStatus &s) { return double(s.decoderDrops); });
+    perCell("goobert_cell_hwdec", "gauge", "1 while the cell decodes on the GPU",
+            [](const CellStatus &s) { return s.hwdec.isEmpty() || s.hwdec == "no" ? 0.0 : 1.0; });
+    perCell("goobert_cell_cache_seconds", "gauge", "demuxer-cache-duration",
+            [](const CellStatus &s) { return s.cacheSecs; });
+    perCell("goobert_cell_buffering", "gauge", "1 while waiting on the cache",
+            [](const CellStatus &s) { return s.buffering ? 1.0 : 0.0; });
+    perCell("goobert_cell_cache_stalls_total", "counter", "Buffering episodes",
+            [](const CellStatus &s) { return double(s.cacheStalls); });
+    perCell("goobert_cell_render_ms", "gauge", "Smoothed mpv_render_context_render time",
+            [](const CellStatus &s) { return s.renderMs; });
+    perCell("goobert_cell_restarts_total", "counter", "Restarts by the supervisor",
+            [](const CellStatus &s) { return double(s.restarts); });
+
+    return out.text();
+}
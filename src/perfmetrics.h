@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTimer>
+
+namespace PerfConstants {
+    inline constexpr int kSampleIntervalMs = 1000;    // Per-cell mpv metrics while anyone looks at them
+    inline constexpr double kRenderEmaWeight = 0.1;   // Smoothing of per-cell render times
+}
+
+// Performance instrumentation. Per-cell numbers live in MpvState and reach
+// consumers through CellStatusStore like everything else a cell reports;
+// the cells only poll mpv for them (sampleDue()) while the HUD is visible,
+// the metrics endpoint is serving or a soak run is logging. App-level latencies are recorded here.
+class PerfMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static PerfMetrics& instance();
+
+    void setHudVisible(bool visible);
+    [[nodiscard]] bool isHudVisible() const noexcept { return m_hudVisible; }
+    void setExporting(bool exporting);   // MetricsServer is listening
+    void setLogging(bool logging);       // SoakMonitor is recording
+    [[nodiscard]] bool isSampling() const noexcept { return m_sampleTimer.isActive(); }
+
+    // App-level latencies
+    void recordIndexTime(qint64 ms, bool fromCache);
+    void gridStarting();   // launchGrid(); the next frameRendered() ends the measurement
+    void frameRendered();  // First frame of a file in any cell
+
+    [[nodiscard]] qint64 lastIndexMs() const noexcept { return m_lastIndexMs; }
+    [[nodiscard]] qint64 lastIndexCacheMs() const noexcept { return m_lastIndexCacheMs; }
+    [[nodiscard]] qint64 firstFrameMs() const noexcept { return m_firstFrameMs; }
+
+    // Prometheus text exposition of the app and every cell in the current snapshot
+    [[nodiscard]] QByteArray prometheusText() const;
+
+signals:
+    void sampleDue();
+    void hudVisibilityChanged(bool visible);
+    void firstFrame(qint64 ms);
+
+private:
+    PerfMetrics();
+    PerfMetrics(const PerfMetrics&) = delete;
+    PerfMetrics& operator=(const PerfMetrics&) = delete;
+
+    void updateSampling();
+
+    QTimer m_sampleTimer;
+    bool m_hudVisible = false;
+    bool m_exporting = false;
+    bool m_logging = false;
+
+    QElapsedTimer m_gridTimer;
+    bool m_awaitingFirstFrame = false;
+    qint64 m_lastIndexMs = -1;        // Last full walk of a root
+    qint64 m_lastIndexCacheMs = -1;   // Last root served from the index database
+    qint64 m_firstFrameMs = -1;       // launchGrid() to the first rendered frame
+};
@@ -0,0 +1,169 @@
+#include "playbackscheduler.h"
+#include "gridcell.h"
+#include "config.h"
+#include "filescanner.h"
+#include "keyframeindex.h"
+#include "ioprofiles.h"
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+PlaybackScheduler::PlaybackScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_startTimer.setInterval(SchedulerConstants::kStartIntervalMs);
+    connect(&m_startTimer, &QTimer::timeout, this, &PlaybackScheduler::releaseBatch);
+
+    m_rebalanceTimer.setSingleShot(true);
+    m_rebalanceTimer.setInterval(SchedulerConstants::kRebalanceDelayMs);
+    connect(&m_rebalanceTimer, &QTimer::timeout, this, &PlaybackScheduler::rebalance);
+}
+
+void PlaybackScheduler::schedule(GridCell *cell)
+{
+    if (!cell) return;
+
+    connect(cell, &GridCell::videoFormatChanged, this, &PlaybackScheduler::requestRebalance, Qt::UniqueConnection);
+    m_pending.append(cell);
+
+    // The first batch goes out right away
+    if (!m_startTimer.isActive()) {
+        releaseBatch();
+        m_startTimer.start();
+    }
+}
+
+void PlaybackScheduler::clear()
+{
+    m_startTimer.stop();
+    m_rebalanceTimer.stop();
+    m_pending.clear();
+    m_cells.clear();
+}
+
+bool PlaybackScheduler::isPending(const GridCell *cell) const
+{
+    return std::any_of(m_pending.cbegin(), m_pending.cend(), [cell](const QPointer<GridCell> &pending) {
+        return pending == cell;
+    });
+}
+
+void PlaybackScheduler::requestRebalance()
+{
+    if (!m_rebalanceTimer.isActive()) {
+        m_rebalanceTimer.start();
+    }
+}
+
+int PlaybackScheduler::hardwareCells() const
+{
+    return static_cast<int>(std::count_if(m_cells.cbegin(), m_cells.cend(), [](const QPointer<GridCell> &cell) {
+        return cell && cell->hardwareDecoding();
+    }));
+}
+
+double PlaybackScheduler::decodeCost(const QSize &size, const QString &codec) noexcept
+{
+    // Unknown size counts as 1080p
+    const qint64 pixels = size.isEmpty() ? SchedulerConstants::kReferencePixels
+                                         : static_cast<qint64>(size.width()) * size.height();
+
+    // Newer codecs cost roughly twice as much per pixel in software
+    const bool modern = codec == "hevc" || codec == "av1" || codec == "vp9";
+    return static_cast<double>(pixels) / SchedulerConstants::kReferencePixels * (modern ? 2.0 : 1.0);
+}
+
+double PlaybackScheduler::costOf(const GridCell *cell) const
+{
+    // Suspended cells decode nothing worth a session
+    if (cell->isSuspended()) return 0.0;
+
+    QString path = cell->currentFile();
+    if (path.isEmpty() && !cell->playlist().isEmpty()) {
+        path = cell->playlist().at(0);  // Not started yet: first entry
+    }
+    if (path.isEmpty() || FileScanner::imageExtensions().contains(QFileInfo(path).suffix().toLower())) {
+        return 0.0;
+    }
+
+    // Probed container headers first, then what mpv found after opening it
+    if (KeyframeInfoPtr info = KeyframeIndex::instance().lookup(path); info && info->width > 0) {
+        return decodeCost(QSize(info->width, info->height), info->codec);
+    }
+    const MpvState &state = cell->mpvState();
+    if (state.path == path && state.videoWidth > 0) {
+        return decodeCost(QSize(state.videoWidth, state.videoHeight), state.videoCodec);
+    }
+    return decodeCost(QSize(), QString());
+}
+
+qint64 PlaybackScheduler::cacheShare() const
+{
+    return IoProfiles::cacheShareBytes(static_cast<int>(m_cells.size() + m_pending.size()));
+}
+
+void PlaybackScheduler::releaseBatch()
+{
+    const int budget = Config::instance().hwdecBudget();
+    int hardware = hardwareCells();
+    const qint64 share = cacheShare();
+
+    for (int released = 0; released < SchedulerConstants::kStartBatch && !m_pending.isEmpty();) {
+        GridCell *cell = m_pending.takeFirst();
+        if (!cell) continue;
+
+        // Provisional; rebalance() revisits it once the format is known
+        const bool useHardware = hardware < budget && costOf(cell) >= SchedulerConstants::kMinHardwareCost;
+        hardware += useHardware ? 1 : 0;
+        cell->setHardwareDecoding(useHardware);
+        cell->setCacheLimit(share);
+        cell->releaseStart();
+
+        m_cells.append(cell);
+        ++released;
+    }
+
+    if (m_pending.isEmpty()) {
+        m_startTimer.stop();
+        requestRebalance();
+    }
+}
+
+void PlaybackScheduler::rebalance()
+{
+    m_cells.removeAll(QPointer<GridCell>());
+
+    struct Candidate {
+        GridCell *cell;
+        double cost;
+        double rank;    // Cost with the holder bias
+    };
+    QVector<Candidate> candidates;
+    candidates.reserve(m_cells.size());
+    for (const QPointer<GridCell> &cell : std::as_const(m_cells)) {
+        const double cost = costOf(cell);
+        candidates.append({cell, cost, cell->hardwareDecoding() ? cost * SchedulerConstants::kHoldBias : cost});
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.rank > b.rank;
+    });
+
+    const int budget = Config::instance().hwdecBudget();
+    const qint64 share = cacheShare();
+    int granted = 0;
+    int moved = 0;
+    for (const Candidate &candidate : std::as_const(candidates)) {
+        candidate.cell->setCacheLimit(share);   // No-op unless the cap changed
+
+        const bool useHardware = granted < budget && candidate.cost >= SchedulerConstants::kMinHardwareCost;
+        granted += useHardware ? 1 : 0;
+        if (useHardware != candidate.cell->hardwareDecoding()) {
+            candidate.cell->setHardwareDecoding(useHardware);
+            ++moved;
+        }
+    }
+
+    if (moved > 0) {
+        qDebug() << "PlaybackScheduler:" << granted << "of" << budget << "hwdec slots in use," << moved << "cells switched";
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QList>
+#include <QSize>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class GridCell;
+
+namespace SchedulerConstants {
+    inline constexpr int kStartBatch = 4;                     // Cells released per tick
+    inline constexpr int kStartIntervalMs = 50;               // A 10x10 wall is fully started after ~1.25 s
+    inline constexpr int kRebalanceDelayMs = 750;             // Format reports settle before decoders move
+    inline constexpr qint64 kReferencePixels = 1920 * 1080;   // Cost 1.0 in H.264
+    inline constexpr double kMinHardwareCost = 0.5;           // Cheaper files decode in software regardless
+    inline constexpr double kHoldBias = 1.25;                 // Current holders keep hwdec against close rivals
+}
+
+// Wall-level start and decode policy. Cells are released a few per tick
+// instead of all opening files and creating hwdec sessions at once, and at
+// most Config::hwdecBudget() cells decode on the GPU. The budget goes to the
+// most expensive content (codec x resolution, from the keyframe index or what
+// mpv reports) and moves as cells switch between heavy and light files, so
+// the sessions are not used up by whichever cells happened to start first.
+// Config::cacheMemoryMb() is split evenly over the grid's cells the same way,
+// so a large wall does not give every cell the full per-source demuxer cache.
+class PlaybackScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlaybackScheduler(QObject *parent = nullptr);
+
+    // The cell must be deferred (GridCell::deferStart()) with its playlist set
+    void schedule(GridCell *cell);
+    void clear();   // Call before the grid's cells are deleted
+    [[nodiscard]] bool isPending(const GridCell *cell) const;
+
+    // Recomputes decoder assignments shortly; cheap to call repeatedly
+    void requestRebalance();
+
+    [[nodiscard]] int hardwareCells() const;   // Released cells set to hwdec
+    [[nodiscard]] static double decodeCost(const QSize &size, const QString &codec) noexcept;
+
+private slots:
+    void releaseBatch();
+    void rebalance();
+
+private:
+    [[nodiscard]] double costOf(const GridCell *cell) const;
+    [[nodiscard]] qint64 cacheShare() const;   // Per cell, pending ones included
+
+    QList<QPointer<GridCell>> m_pending;   // Release order
+    QList<QPointer<GridCell>> m_cells;     // Released
+    QTimer m_startTimer;
+    QTimer m_rebalanceTimer;
+};
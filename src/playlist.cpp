@@ -0,0 +1,172 @@
+#include "playlist.h"
+#include <algorithm>
+#include <utility>
+
+// ============ PathTable ============
+
+quint32 PathTable::add(const QString &path)
+{
+    auto it = m_lookup.constFind(path);
+    if (it != m_lookup.cend()) {
+        return it.value();
+    }
+
+    const auto index = static_cast<quint32>(m_paths.size());
+    m_paths.append(path);
+    m_lookup.insert(path, index);
+    return index;
+}
+
+QVector<quint32> PathTable::addAll(const QStringList &paths)
+{
+    QVector<quint32> indices;
+    indices.reserve(paths.size());
+    m_lookup.reserve(m_paths.size() + paths.size());
+    for (const QString &path : paths) {
+        indices.append(add(path));
+    }
+    return indices;
+}
+
+qint64 PathTable::indexOf(const QString &path) const
+{
+    auto it = m_lookup.constFind(path);
+    return it != m_lookup.cend() ? static_cast<qint64>(it.value()) : -1;
+}
+
+bool PathTable::rename(const QString &oldPath, const QString &newPath)
+{
+    auto it = m_lookup.find(oldPath);
+    if (it == m_lookup.end()) {
+        return false;
+    }
+
+    const quint32 index = it.value();
+
+    // Taking over newPath's slot would leave its index orphaned and two
+    // indices on one path; the file is played under the index it has, and
+    // the old entry, gone from disk, is skipped
+    if (newPath != oldPath && m_lookup.contains(newPath)) {
+        m_blocked.insert(index);
+        return false;
+    }
+
+    m_lookup.erase(it);
+    m_paths[index] = newPath;
+    m_lookup.insert(newPath, index);
+    return true;
+}
+
+void PathTable::block(const QString &path)
+{
+    const qint64 index = indexOf(path);
+    if (index >= 0) {
+        m_blocked.insert(static_cast<quint32>(index));
+    }
+}
+
+bool PathTable::isBlocked(const QString &path) const
+{
+    if (m_blocked.isEmpty()) {
+        return false;
+    }
+    const qint64 index = indexOf(path);
+    return index >= 0 && m_blocked.contains(static_cast<quint32>(index));
+}
+
+// ============ Playlist ============
+
+Playlist::Playlist(PathTablePtr table, QVector<quint32> order)
+    : m_table(std::move(table))
+    , m_order(std::move(order))
+{
+}
+
+int Playlist::indexOf(const QString &path) const
+{
+    if (!m_table) {
+        return -1;
+    }
+
+    const qint64 index = m_table->indexOf(path);
+    if (index < 0) {
+        return -1;
+    }
+    return m_order.indexOf(static_cast<quint32>(index));
+}
+
+int Playlist::indexOf(const QString &path, int hint) const
+{
+    if (!m_table || m_order.isEmpty()) {
+        return -1;
+    }
+
+    const qint64 index = m_table->indexOf(path);
+    if (index < 0) {
+        return -1;
+    }
+    if (hint >= 0) {
+        // Same entry, the next few (skipped blocked files) and the one before
+        const int count = m_order.size();
+        for (int offset : {0, 1, 2, 3, 4, -1}) {
+            const int position = (((hint + offset) % count) + count) % count;
+            if (m_order.at(position) == static_cast<quint32>(index)) {
+                return position;
+            }
+        }
+    }
+    return m_order.indexOf(static_cast<quint32>(index));
+}
+
+QStringList Playlist::toStringList() const
+{
+    QStringList result;
+    if (!m_table) {
+        return result;
+    }
+
+    result.reserve(m_order.size());
+    for (quint32 index : m_order) {
+        result.append(m_table->at(index));
+    }
+    return result;
+}
+
+void Playlist::append(const QVector<quint32> &indices)
+{
+    m_order.append(indices);
+}
+
+void Playlist::removeAt(int position)
+{
+    m_order.removeAt(position);
+}
+
+void Playlist::move(int from, int to)
+{
+    m_order.move(from, to);
+}
+
+void Playlist::shuffle(std::mt19937 &rng)
+{
+    std::shuffle(m_order.begin(), m_order.end(), rng);
+}
+
+void Playlist::scatter(const QVector<quint32> &indices, int from, int to, std::mt19937 &rng)
+{
+    from = std::clamp(from, 0, static_cast<int>(m_order.size()));
+    to = std::clamp(to, from, static_cast<int>(m_order.size()));
+    m_order.insert(to, indices.size(), 0);
+    std::copy(indices.cbegin(), indices.cend(), m_order.begin() + to);
+    std::shuffle(m_order.begin() + from, m_order.begin() + to + indices.size(), rng);
+}
+
+bool Playlist::allBlocked() const
+{
+    if (!m_table) {
+        return false;
+    }
+    return std::all_of(m_order.cbegin(), m_order.cend(), [this](quint32 index) {
+        return m_table->isBlocked(index);
+    });
+}
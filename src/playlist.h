@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <memory>
+#include <random>
+
+// Table of unique paths shared by every cell of a grid. Entries are only
+// ever appended, so indices stay valid; a rename rewrites one slot in place
+// and every playlist referencing it sees the new path.
+class PathTable
+{
+public:
+    PathTable() = default;
+
+    quint32 add(const QString &path);
+    [[nodiscard]] QVector<quint32> addAll(const QStringList &paths);
+
+    [[nodiscard]] const QString& at(quint32 index) const { return m_paths.at(static_cast<qsizetype>(index)); }
+    [[nodiscard]] qint64 indexOf(const QString &path) const;   // -1 if unknown
+    [[nodiscard]] int size() const noexcept { return m_paths.size(); }
+
+    // False if oldPath is unknown, or newPath has an entry already: the old
+    // one is blocked then instead of sharing the path
+    bool rename(const QString &oldPath, const QString &newPath);
+
+    // Files that keep failing; cells skip them without opening (see CellSupervisor)
+    void block(const QString &path);
+    [[nodiscard]] bool isBlocked(const QString &path) const;
+    [[nodiscard]] bool isBlocked(quint32 index) const { return m_blocked.contains(index); }
+
+private:
+    QStringList m_paths;
+    QHash<QString, quint32> m_lookup;
+    QSet<quint32> m_blocked;
+};
+
+using PathTablePtr = std::shared_ptr<PathTable>;
+
+// A cell's playback order: a permutation of indices into a shared PathTable.
+// Copies are cheap (implicitly shared) until one side reorders.
+class Playlist
+{
+public:
+    Playlist() = default;
+    Playlist(PathTablePtr table, QVector<quint32> order);
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_order.isEmpty(); }
+    [[nodiscard]] int size() const noexcept { return m_order.size(); }
+    [[nodiscard]] const QString& at(int position) const { return m_table->at(m_order.at(position)); }
+    [[nodiscard]] int indexOf(const QString &path) const;      // Position in this order, -1 if absent
+    // Same, trying the few positions around hint first: playback mostly
+    // moves one entry on, and the full search is linear in the list
+    [[nodiscard]] int indexOf(const QString &path, int hint) const;
+    [[nodiscard]] QStringList toStringList() const;
+    [[nodiscard]] bool allBlocked() const;   // Nothing left this playlist could play
+
+    [[nodiscard]] const PathTablePtr& table() const noexcept { return m_table; }
+    [[nodiscard]] const QVector<quint32>& order() const noexcept { return m_order; }
+
+    void append(const QVector<quint32> &indices);
+    void removeAt(int position);
+    void move(int from, int to);
+    void shuffle(std::mt19937 &rng);
+    // Inserts indices into positions [from, to) and shuffles that range, so
+    // the new entries are spread over it instead of queued behind it.
+    // Positions after to shift by indices.size().
+    void scatter(const QVector<quint32> &indices, int from, int to, std::mt19937 &rng);
+
+private:
+    PathTablePtr m_table;
+    QVector<quint32> m_order;
+};
@@ -0,0 +1,563 @@
+#include "playlistmodel.h"
+#include "thumbnailcache.h"
+#include <QMimeData>
+#include <QUrl>
+#include <QFont>
+#include <QColor>
+#include <QIcon>
+#include <algorithm>
+#include <utility>
+
+namespace {
+    QString fileName(const QString &path)
+    {
+        return path.mid(path.lastIndexOf('/') + 1);
+    }
+
+    // Rows keep one height whether or not a thumbnail has arrived
+    QIcon thumbnailIcon(const QString &path)
+    {
+        static const QIcon placeholder = []() {
+            QPixmap blank(ThumbnailConstants::kThumbWidth, ThumbnailConstants::kThumbHeight);
+            blank.fill(Qt::transparent);
+            return QIcon(blank);
+        }();
+
+        const QPixmap thumb = ThumbnailCache::instance().pixmap(path);
+        return thumb.isNull() ? placeholder : QIcon(thumb);
+    }
+}
+
+// ============ PlaylistListModel ============
+
+PlaylistListModel::PlaylistListModel(Playlist playlist, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_playlist(std::move(playlist))
+{
+}
+
+int PlaylistListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_playlist.size();
+}
+
+QVariant PlaylistListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_playlist.size()) {
+        return {};
+    }
+
+    const QString &path = m_playlist.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return fileName(path);
+    case Qt::ToolTipRole:
+    case PathRole:
+        return path;
+    case Qt::DecorationRole:
+        return thumbnailIcon(path);
+    default:
+        return {};
+    }
+}
+
+// ============ PlaylistFilterProxy ============
+
+PlaylistFilterProxy::PlaylistFilterProxy(QObject *parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+void PlaylistFilterProxy::setFilterEngine(FilterEnginePtr engine)
+{
+    beginResetModel();
+    m_engine = std::move(engine);
+    m_rows.clear();
+    m_passAll = true;
+    endResetModel();
+}
+
+void PlaylistFilterProxy::setFilterText(const QString &filter)
+{
+    const FilterEngine::Query query = FilterEngine::parse(filter);
+
+    beginResetModel();
+    m_passAll = !m_engine || query.isEmpty();
+    m_rows = m_passAll ? QVector<int>() : m_engine->match(query);
+    endResetModel();
+}
+
+QModelIndex PlaylistFilterProxy::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || column != 0 || row >= rowCount()) {
+        return {};
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex PlaylistFilterProxy::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return {};
+}
+
+int PlaylistFilterProxy::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return m_passAll ? sourceModel()->rowCount() : m_rows.size();
+}
+
+int PlaylistFilterProxy::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 1;
+}
+
+QModelIndex PlaylistFilterProxy::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel()) {
+        return {};
+    }
+    const int sourceRow = m_passAll ? proxyIndex.row() : m_rows.at(proxyIndex.row());
+    return sourceModel()->index(sourceRow, 0);
+}
+
+QModelIndex PlaylistFilterProxy::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) {
+        return {};
+    }
+    if (m_passAll) {
+        return index(sourceIndex.row(), 0);
+    }
+
+    auto it = std::lower_bound(m_rows.cbegin(), m_rows.cend(), sourceIndex.row());
+    if (it == m_rows.cend() || *it != sourceIndex.row()) {
+        return {};
+    }
+    return index(static_cast<int>(it - m_rows.cbegin()), 0);
+}
+
+// ============ PlaylistTreeModel ============
+
+PlaylistTreeModel::PlaylistTreeModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+int PlaylistTreeModel::cellPosition(int row, int col) const
+{
+    for (int i = 0; i < m_cells.size(); ++i) {
+        if (m_cells.at(i).row == row && m_cells.at(i).col == col) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int PlaylistTreeModel::ensureCell(int row, int col)
+{
+    const int existing = cellPosition(row, col);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    const int position = m_cells.size();
+    beginInsertRows(QModelIndex(), position, position);
+    Cell cell;
+    cell.row = row;
+    cell.col = col;
+    m_cells.append(cell);
+    endInsertRows();
+    return position;
+}
+
+const PlaylistTreeModel::Cell* PlaylistTreeModel::cellFor(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return nullptr;
+    }
+    const int position = index.internalId() == 0 ? index.row() : static_cast<int>(index.internalId()) - 1;
+    return position < m_cells.size() ? &m_cells.at(position) : nullptr;
+}
+
+QModelIndex PlaylistTreeModel::cellIndex(int row, int col) const
+{
+    const int position = cellPosition(row, col);
+    return position < 0 ? QModelIndex() : index(position, 0);
+}
+
+QModelIndex PlaylistTreeModel::fileIndex(int row, int col, const QString &file) const
+{
+    const int position = cellPosition(row, col);
+    if (position < 0) {
+        return {};
+    }
+    const Cell &cell = m_cells.at(position);
+    const int child = cell.playlist.indexOf(file, cell.current);
+    return child < 0 ? QModelIndex() : index(child, 0, index(position, 0));
+}
+
+void PlaylistTreeModel::setCellPlaylist(int row, int col, const Playlist &playlist)
+{
+    const int position = ensureCell(row, col);
+    Cell &cell = m_cells[position];
+    const QModelIndex parentIndex = index(position, 0);
+
+    if (!cell.playlist.isEmpty()) {
+        beginRemoveRows(parentIndex, 0, cell.playlist.size() - 1);
+        cell.playlist = Playlist();
+        cell.current = -1;
+        endRemoveRows();
+    }
+
+    if (!playlist.isEmpty()) {
+        beginInsertRows(parentIndex, 0, playlist.size() - 1);
+        cell.playlist = playlist;
+        endInsertRows();
+    }
+
+    relocateCurrent(cell);
+    emitHeaderChanged(position);
+}
+
+void PlaylistTreeModel::appendToCellPlaylist(int row, int col, const Playlist &playlist, int from, int changedFrom)
+{
+    const int position = ensureCell(row, col);
+    Cell &cell = m_cells[position];
+    const QModelIndex parentIndex = index(position, 0);
+
+    // The cell's playlist grew by the tail rows; the new entries were mixed
+    // into the rows from changedFrom on, which now show other files
+    const int first = std::max(from, 0);
+    if (first >= playlist.size()) {
+        return;
+    }
+
+    beginInsertRows(parentIndex, first, playlist.size() - 1);
+    cell.playlist = playlist;
+    endInsertRows();
+
+    const int changed = std::max(changedFrom, 0);
+    if (changed < first) {
+        emit dataChanged(index(changed, 0, parentIndex), index(first - 1, 0, parentIndex));
+    }
+    relocateCurrent(cell);
+    emitHeaderChanged(position);
+}
+
+void PlaylistTreeModel::setCurrentFile(int row, int col, const QString &file)
+{
+    const int position = cellPosition(row, col);
+    if (position < 0) return;
+
+    Cell &cell = m_cells[position];
+    const int previous = cell.current;
+    cell.currentFile = file;
+    relocateCurrent(cell);
+
+    if (cell.current == previous) return;
+
+    // Only the two affected rows repaint
+    const QModelIndex parentIndex = index(position, 0);
+    const QList<int> roles{Qt::FontRole, Qt::ForegroundRole};
+    if (previous >= 0) {
+        const QModelIndex old = index(previous, 0, parentIndex);
+        emit dataChanged(old, old, roles);
+    }
+    if (cell.current >= 0) {
+        const QModelIndex now = index(cell.current, 0, parentIndex);
+        emit dataChanged(now, now, roles);
+    }
+}
+
+void PlaylistTreeModel::relocateCurrent(Cell &cell)
+{
+    // The previous position is the hint; a file change is usually the next entry
+    cell.current = cell.currentFile.isEmpty() ? -1 : cell.playlist.indexOf(cell.currentFile, cell.current);
+}
+
+void PlaylistTreeModel::clear()
+{
+    beginResetModel();
+    m_cells.clear();
+    endResetModel();
+}
+
+bool PlaylistTreeModel::removeFile(const QModelIndex &fileIndex)
+{
+    if (!fileIndex.isValid() || fileIndex.internalId() == 0) {
+        return false;
+    }
+
+    const int position = static_cast<int>(fileIndex.internalId()) - 1;
+    Cell &cell = m_cells[position];
+
+    beginRemoveRows(fileIndex.parent(), fileIndex.row(), fileIndex.row());
+    cell.playlist.removeAt(fileIndex.row());
+    endRemoveRows();
+
+    relocateCurrent(cell);
+    emitHeaderChanged(position);
+    return true;
+}
+
+bool PlaylistTreeModel::moveFile(const QModelIndex &fileIndex, int delta)
+{
+    if (!fileIndex.isValid() || fileIndex.internalId() == 0) {
+        return false;
+    }
+
+    const int position = static_cast<int>(fileIndex.internalId()) - 1;
+    Cell &cell = m_cells[position];
+    const int from = fileIndex.row();
+    const int to = from + delta;
+    if (delta == 0 || to < 0 || to >= cell.playlist.size()) {
+        return false;
+    }
+
+    // beginMoveRows wants the destination as "insert before" in the old order
+    const QModelIndex parentIndex = fileIndex.parent();
+    if (!beginMoveRows(parentIndex, from, from, parentIndex, delta > 0 ? to + 1 : to)) {
+        return false;
+    }
+    cell.playlist.move(from, to);
+    endMoveRows();
+
+    relocateCurrent(cell);
+    return true;
+}
+
+void PlaylistTreeModel::appendFiles(const QModelIndex &cellIdx, const QStringList &files)
+{
+    if (!cellIdx.isValid() || cellIdx.internalId() != 0 || files.isEmpty()) {
+        return;
+    }
+
+    const int position = cellIdx.row();
+    Cell &cell = m_cells[position];
+
+    // Dropped paths join the grid's shared table, so other cells can reuse them
+    PathTablePtr table = cell.playlist.table();
+    if (!table) {
+        table = std::make_shared<PathTable>();
+        cell.playlist = Playlist(table, {});
+    }
+    const QVector<quint32> indices = table->addAll(files);
+
+    const int first = cell.playlist.size();
+    beginInsertRows(cellIdx, first, first + indices.size() - 1);
+    cell.playlist.append(indices);
+    endInsertRows();
+
+    relocateCurrent(cell);
+    emitHeaderChanged(position);
+}
+
+QStringList PlaylistTreeModel::paths(int row, int col) const
+{
+    const int position = cellPosition(row, col);
+    return position < 0 ? QStringList() : m_cells.at(position).playlist.toStringList();
+}
+
+void PlaylistTreeModel::emitHeaderChanged(int position)
+{
+    const QModelIndex header = index(position, 0);
+    emit dataChanged(header, header, {Qt::DisplayRole});
+}
+
+QModelIndex PlaylistTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column != 0) {
+        return {};
+    }
+
+    if (!parent.isValid()) {
+        return row < m_cells.size() ? createIndex(row, 0, quintptr(0)) : QModelIndex();
+    }
+
+    // Only cell headers have children; internalId is the cell position + 1
+    if (parent.internalId() != 0 || parent.row() >= m_cells.size()) {
+        return {};
+    }
+    if (row >= m_cells.at(parent.row()).playlist.size()) {
+        return {};
+    }
+    return createIndex(row, 0, quintptr(parent.row() + 1));
+}
+
+QModelIndex PlaylistTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0) {
+        return {};
+    }
+    return createIndex(static_cast<int>(child.internalId()) - 1, 0, quintptr(0));
+}
+
+int PlaylistTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return m_cells.size();
+    }
+    if (parent.internalId() != 0 || parent.row() >= m_cells.size()) {
+        return 0;
+    }
+    return m_cells.at(parent.row()).playlist.size();
+}
+
+int PlaylistTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+QVariant PlaylistTreeModel::data(const QModelIndex &index, int role) const
+{
+    const Cell *cell = cellFor(index);
+    if (!cell) {
+        return {};
+    }
+
+    // Cell header
+    if (index.internalId() == 0) {
+        switch (role) {
+        case Qt::DisplayRole:
+            return QString("Cell [%1,%2] (%3)").arg(cell->row).arg(cell->col).arg(cell->playlist.size());
+        case Qt::FontRole: {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        case CellRowRole:
+            return cell->row;
+        case CellColRole:
+            return cell->col;
+        default:
+            return {};
+        }
+    }
+
+    if (index.row() >= cell->playlist.size()) {
+        return {};
+    }
+
+    const QString &path = cell->playlist.at(index.row());
+    const bool isCurrent = index.row() == cell->current;
+    switch (role) {
+    case Qt::DisplayRole:
+        return fileName(path);
+    case Qt::ToolTipRole:
+    case PathRole:
+        return path;
+    case Qt::DecorationRole:
+        return thumbnailIcon(path);
+    case Qt::FontRole:
+        if (isCurrent) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return {};
+    case Qt::ForegroundRole:
+        return isCurrent ? QVariant(QColor(PlaylistModelConstants::kCurrentColor)) : QVariant();
+    default:
+        return {};
+    }
+}
+
+Qt::ItemFlags PlaylistTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    const Qt::ItemFlags base = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    return index.internalId() == 0 ? base | Qt::ItemIsDropEnabled : base | Qt::ItemIsDragEnabled;
+}
+
+QStringList PlaylistTreeModel::mimeTypes() const
+{
+    return {"text/uri-list", PlaylistModelConstants::kMimeType};
+}
+
+QMimeData* PlaylistTreeModel::mimeData(const QModelIndexList &indexes) const
+{
+    auto *mimeData = new QMimeData();
+    QList<QUrl> urls;
+    QStringList paths;
+
+    for (const QModelIndex &index : indexes) {
+        // Only file rows, never cell headers
+        if (index.isValid() && index.internalId() != 0) {
+            const QString path = data(index, PathRole).toString();
+            if (!path.isEmpty()) {
+                urls.append(QUrl::fromLocalFile(path));
+                paths.append(path);
+            }
+        }
+    }
+
+    mimeData->setUrls(urls);
+    mimeData->setData(PlaylistModelConstants::kMimeType, paths.join("\n").toUtf8());
+    return mimeData;
+}
+
+QStringList PlaylistTreeModel::pathsFromMime(const QMimeData *data)
+{
+    QStringList paths;
+    if (data->hasFormat(PlaylistModelConstants::kMimeType)) {
+        paths = QString::fromUtf8(data->data(PlaylistModelConstants::kMimeType)).split("\n", Qt::SkipEmptyParts);
+    } else if (data->hasUrls()) {
+        for (const QUrl &url : data->urls()) {
+            if (url.isLocalFile()) {
+                paths.append(url.toLocalFile());
+            }
+        }
+    }
+    return paths;
+}
+
+QModelIndex PlaylistTreeModel::resolveDropCell(const QModelIndex &parent) const
+{
+    // Dropping on a file targets its cell; the root only takes drops on headers
+    if (!parent.isValid()) {
+        return {};
+    }
+    return parent.internalId() == 0 ? parent : parent.parent();
+}
+
+bool PlaylistTreeModel::canDropMimeData(const QMimeData *data, Qt::DropAction action,
+                                        int row, int column, const QModelIndex &parent) const
+{
+    Q_UNUSED(action);
+    Q_UNUSED(row);
+    Q_UNUSED(column);
+    return resolveDropCell(parent).isValid()
+        && (data->hasFormat(PlaylistModelConstants::kMimeType) || data->hasUrls());
+}
+
+bool PlaylistTreeModel::dropMimeData(const QMimeData *data, Qt::DropAction action,
+                                     int row, int column, const QModelIndex &parent)
+{
+    if (!canDropMimeData(data, action, row, column, parent)) {
+        return false;
+    }
+
+    const QStringList paths = pathsFromMime(data);
+    if (paths.isEmpty()) {
+        return false;
+    }
+
+    // Appended to the target cell; the source cell keeps its copy
+    const QModelIndex target = resolveDropCell(parent);
+    appendFiles(target, paths);
+    const Cell &cell = m_cells.at(target.row());
+    emit cellPlaylistEdited(cell.row, cell.col);
+    return true;
+}
+
+Qt::DropActions PlaylistTreeModel::supportedDropActions() const
+{
+    return Qt::CopyAction | Qt::MoveAction;
+}
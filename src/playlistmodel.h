@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QAbstractListModel>
+#include <QAbstractProxyModel>
+#include <QStringList>
+#include <QVector>
+#include "playlist.h"
+#include "filterengine.h"
+
+namespace PlaylistModelConstants {
+    inline constexpr char kMimeType[] = "application/x-playlist-items";
+    inline constexpr char kCurrentColor[] = "#6a9fd4";
+}
+
+enum PlaylistRole {
+    PathRole = Qt::UserRole,  // Full path of a file row
+    CellRowRole,              // Grid row of a cell header
+    CellColRole               // Grid column of a cell header
+};
+
+// Flat view of one Playlist. Rows are logical positions, so they map
+// straight to MpvWidget::playIndex(). Nothing is materialized per row.
+class PlaylistListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit PlaylistListModel(Playlist playlist, QObject *parent = nullptr);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    [[nodiscard]] const Playlist& playlist() const noexcept { return m_playlist; }
+
+private:
+    Playlist m_playlist;
+};
+
+// Filters a flat source model with a FilterEngine built over the same rows
+// (same order), so one keystroke is one packed-buffer scan instead of a
+// filterAcceptsRow() call per row.
+class PlaylistFilterProxy : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit PlaylistFilterProxy(QObject *parent = nullptr);
+
+    void setFilterEngine(FilterEnginePtr engine);
+    void setFilterText(const QString &filter);
+
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override;
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    [[nodiscard]] QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+private:
+    FilterEnginePtr m_engine;
+    QVector<int> m_rows;      // Matching source rows, ascending
+    bool m_passAll = true;    // Empty filter: no row table at all
+};
+
+// Cells as top-level rows, each cell's playlist as children. Children are
+// indices into the grid's shared PathTable; names are derived in data().
+class PlaylistTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit PlaylistTreeModel(QObject *parent = nullptr);
+
+    void setCellPlaylist(int row, int col, const Playlist &playlist);
+    // Adds entries [from, size); entries [changedFrom, from) were reordered
+    void appendToCellPlaylist(int row, int col, const Playlist &playlist, int from, int changedFrom);
+    void setCurrentFile(int row, int col, const QString &file);
+    void clear();
+
+    // Edits from the view; callers report them, only drops emit cellPlaylistEdited
+    bool removeFile(const QModelIndex &fileIndex);
+    bool moveFile(const QModelIndex &fileIndex, int delta);
+    void appendFiles(const QModelIndex &cellIndex, const QStringList &files);
+
+    [[nodiscard]] QModelIndex cellIndex(int row, int col) const;
+    [[nodiscard]] QModelIndex fileIndex(int row, int col, const QString &file) const;
+    [[nodiscard]] QStringList paths(int row, int col) const;
+
+    [[nodiscard]] QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QModelIndex parent(const QModelIndex &child) const override;
+    [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    // Drag & drop: file rows drag out as URLs; drops append to the target cell
+    [[nodiscard]] QStringList mimeTypes() const override;
+    [[nodiscard]] QMimeData* mimeData(const QModelIndexList &indexes) const override;
+    [[nodiscard]] bool canDropMimeData(const QMimeData *data, Qt::DropAction action,
+                                       int row, int column, const QModelIndex &parent) const override;
+    bool dropMimeData(const QMimeData *data, Qt::DropAction action,
+                      int row, int column, const QModelIndex &parent) override;
+    [[nodiscard]] Qt::DropActions supportedDropActions() const override;
+
+signals:
+    void cellPlaylistEdited(int row, int col);   // Files were dropped onto a cell
+
+private:
+    struct Cell {
+        int row = 0;
+        int col = 0;
+        Playlist playlist;
+        QString currentFile;
+        int current = -1;    // Position of currentFile, -1 if not in the list
+    };
+
+    [[nodiscard]] int cellPosition(int row, int col) const;  // Top-level row, -1 if absent
+    int ensureCell(int row, int col);
+    [[nodiscard]] const Cell* cellFor(const QModelIndex &index) const;  // Owning cell of a header or file row
+    [[nodiscard]] QModelIndex resolveDropCell(const QModelIndex &parent) const;
+    [[nodiscard]] static QStringList pathsFromMime(const QMimeData *data);
+    void emitHeaderChanged(int position);
+    void relocateCurrent(Cell &cell);
+
+    QVector<Cell> m_cells;
+};
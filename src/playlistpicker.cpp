@@ -1,13 +1,12 @@
 #include "playlistpicker.h"
 #include "theme.h"
 #include <QKeyEvent>
-#include <QFileInfo>
 #include <QGraphicsDropShadowEffect>
 #include <QPushButton>
+#include <QScrollBar>
 
-PlaylistPicker::PlaylistPicker(const QStringList &playlist, QWidget *parent)
+PlaylistPicker::PlaylistPicker(const Playlist &playlist, QWidget *parent)
     : QDialog(parent)
-    , m_fullPlaylist(playlist)
 {
     setWindowTitle("Select a playlist entry");
     setMinimumSize(800, 500);
@@ -71,12 +70,27 @@ PlaylistPicker::PlaylistPicker(const QStringList &playlist, QWidget *parent)
     m_countLabel->setStyleSheet(QString("color: %1; font-size: 12px;").arg(Theme::Colors::TextMuted));
     layout->addWidget(m_countLabel);
 
-    // List widget - no word wrap, elide long text
-    m_listWidget = new QListWidget(this);
-    m_listWidget->setWordWrap(false);
-    m_listWidget->setTextElideMode(Qt::ElideMiddle);
-    m_listWidget->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    layout->addWidget(m_listWidget, 1);
+    // List view over the cell's playlist - no word wrap, elide long text
+    m_model = new PlaylistListModel(playlist, this);
+    m_proxy = new PlaylistFilterProxy(this);
+    m_proxy->setSourceModel(m_model);
+    m_proxy->setFilterEngine(std::make_shared<const FilterEngine>(playlist.toStringList()));
+
+    m_listView = new QListView(this);
+    m_listView->setModel(m_proxy);
+    m_listView->setWordWrap(false);
+    m_listView->setTextElideMode(Qt::ElideMiddle);
+    m_listView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_listView->setUniformItemSizes(true);
+    m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_listView->setIconSize(QSize(ThumbnailConstants::kThumbWidth / 2, ThumbnailConstants::kThumbHeight / 2));
+    layout->addWidget(m_listView, 1);
+
+    // Preview sprite of the current entry
+    m_previewLabel = new QLabel(this);
+    m_previewLabel->setAlignment(Qt::AlignCenter);
+    m_previewLabel->setFixedHeight(ThumbnailConstants::kSpriteRows * ThumbnailConstants::kThumbHeight);
+    layout->addWidget(m_previewLabel);
 
     // Keyboard hints at bottom
     auto *hintsLabel = new QLabel("↑↓ Navigate  •  Enter Select  •  Esc Close", this);
@@ -86,19 +100,16 @@ PlaylistPicker::PlaylistPicker(const QStringList &playlist, QWidget *parent)
     ).arg(Theme::Colors::TextMuted, Theme::Colors::SurfaceLight, QString::number(Theme::Radius::SM)));
     layout->addWidget(hintsLabel);
 
-    // Build display names
-    m_displayNames.reserve(m_fullPlaylist.size());
-    for (const QString &path : m_fullPlaylist) {
-        m_displayNames.append(QFileInfo(path).fileName());
-    }
-
     // Initial list
     updateList();
 
     // Connections
     connect(m_searchEdit, &QLineEdit::textChanged, this, &PlaylistPicker::onSearchTextChanged);
-    connect(m_listWidget, &QListWidget::itemDoubleClicked, this, &PlaylistPicker::onItemDoubleClicked);
-    connect(m_listWidget, &QListWidget::itemActivated, this, &PlaylistPicker::onItemActivated);
+    connect(m_listView, &QListView::doubleClicked, this, &PlaylistPicker::selectIndex);
+    connect(m_listView, &QListView::activated, this, &PlaylistPicker::selectIndex);
+    connect(m_listView->selectionModel(), &QItemSelectionModel::currentChanged, this, &PlaylistPicker::onCurrentChanged);
+    connect(m_listView->verticalScrollBar(), &QScrollBar::valueChanged, this, &PlaylistPicker::updateVisibleThumbnails);
+    connect(&ThumbnailCache::instance(), &ThumbnailCache::ready, this, &PlaylistPicker::onThumbnailReady);
 
     // Focus search on open
     m_searchEdit->setFocus();
@@ -106,60 +117,113 @@ PlaylistPicker::PlaylistPicker(const QStringList &playlist, QWidget *parent)
 
 void PlaylistPicker::onSearchTextChanged(const QString &text)
 {
-    m_searchText = text.toLower();
+    m_searchText = text;
     updateList();
 }
 
 void PlaylistPicker::updateList()
 {
-    m_listWidget->clear();
-
-    int matchCount = 0;
-    for (int i = 0; i < m_displayNames.size(); ++i) {
-        const QString &name = m_displayNames[i];
-
-        // Filter by search text (case insensitive)
-        if (m_searchText.isEmpty() || name.toLower().contains(m_searchText)) {
-            auto *item = new QListWidgetItem(name);
-            item->setData(Qt::UserRole, i);  // Store original index
-            m_listWidget->addItem(item);
-            ++matchCount;
-        }
-    }
+    m_proxy->setFilterText(m_searchText);
 
     // Update count label
-    if (m_searchText.isEmpty()) {
-        m_countLabel->setText(QString("%1 files").arg(m_fullPlaylist.size()));
+    const int total = m_model->rowCount();
+    if (m_searchText.trimmed().isEmpty()) {
+        m_countLabel->setText(QString("%1 files").arg(total));
     } else {
-        m_countLabel->setText(QString("%1 of %2 matches").arg(matchCount).arg(m_fullPlaylist.size()));
+        m_countLabel->setText(QString("%1 of %2 matches").arg(m_proxy->rowCount()).arg(total));
     }
 
     // Select first item if available
-    if (m_listWidget->count() > 0) {
-        m_listWidget->setCurrentRow(0);
+    if (m_proxy->rowCount() > 0) {
+        m_listView->setCurrentIndex(m_proxy->index(0, 0));
+    } else {
+        onCurrentChanged(QModelIndex());
     }
+
+    // Layout settles after the event loop runs; visible rows are known then
+    QMetaObject::invokeMethod(this, &PlaylistPicker::updateVisibleThumbnails, Qt::QueuedConnection);
 }
 
-void PlaylistPicker::selectItem(QListWidgetItem *item)
+void PlaylistPicker::updateVisibleThumbnails()
 {
-    if (!item) return;
+    const QRect viewport = m_listView->viewport()->rect();
+    const QModelIndex topIndex = m_listView->indexAt(viewport.topLeft());
+    if (!topIndex.isValid()) {
+        ThumbnailCache::instance().setWanted(this, {});
+        return;
+    }
 
-    int originalIndex = item->data(Qt::UserRole).toInt();
-    if (originalIndex >= 0 && originalIndex < m_fullPlaylist.size()) {
-        m_selectedFile = m_fullPlaylist[originalIndex];
-        m_selectedIndex = originalIndex;
-        accept();
+    const QModelIndex bottomIndex = m_listView->indexAt(viewport.bottomLeft());
+    const int first = topIndex.row();
+    const int last = bottomIndex.isValid() ? bottomIndex.row() : m_proxy->rowCount() - 1;
+
+    QStringList visible;
+    visible.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        visible.append(m_proxy->index(row, 0).data(PathRole).toString());
+    }
+
+    // Only what is on screen; rows scrolled past are cancelled
+    ThumbnailCache::instance().setWanted(this, visible);
+}
+
+void PlaylistPicker::onThumbnailReady(const QString &path, ThumbnailCache::Kind kind)
+{
+    if (m_listView->currentIndex().data(PathRole).toString() == path) {
+        showPreview(path);
+    }
+    if (kind == ThumbnailCache::Kind::Thumbnail) {
+        // Icons come from data(); a repaint picks them up
+        m_listView->viewport()->update();
     }
 }
 
-void PlaylistPicker::onItemDoubleClicked(QListWidgetItem *item)
+void PlaylistPicker::onCurrentChanged(const QModelIndex &current)
 {
-    selectItem(item);
+    if (!current.isValid()) {
+        m_previewLabel->clear();
+        ThumbnailCache::instance().setWanted(m_previewLabel, {}, ThumbnailCache::Kind::Sprite);
+        return;
+    }
+
+    const QString path = current.data(PathRole).toString();
+    ThumbnailCache::instance().setWanted(m_previewLabel, {path}, ThumbnailCache::Kind::Sprite);
+    showPreview(path);
+}
+
+void PlaylistPicker::showPreview(const QString &path)
+{
+    // Sprite when ready, the plain thumbnail until then
+    QPixmap preview = ThumbnailCache::instance().pixmap(path, ThumbnailCache::Kind::Sprite);
+    if (preview.isNull()) {
+        preview = ThumbnailCache::instance().pixmap(path);
+    }
+    if (preview.isNull()) {
+        m_previewLabel->clear();
+        return;
+    }
+    m_previewLabel->setPixmap(preview.scaled(m_previewLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
 }
 
-void PlaylistPicker::onItemActivated(QListWidgetItem *item)
+void PlaylistPicker::selectIndex(const QModelIndex &index)
 {
-    selectItem(item);
+    if (!index.isValid()) return;
+
+    // Source rows are logical playlist positions
+    const QModelIndex source = m_proxy->mapToSource(index);
+    if (source.isValid()) {
+        m_selectedFile = source.data(PathRole).toString();
+        m_selectedIndex = source.row();
+        accept();
+    }
+}
+
+void PlaylistPicker::moveCurrent(int delta)
+{
+    const int row = m_listView->currentIndex().row() + delta;
+    if (row >= 0 && row < m_proxy->rowCount()) {
+        m_listView->setCurrentIndex(m_proxy->index(row, 0));
+    }
 }
 
 void PlaylistPicker::keyPressEvent(QKeyEvent *event)
@@ -170,17 +234,13 @@ void PlaylistPicker::keyPressEvent(QKeyEvent *event)
         break;
     case Qt::Key_Return:
     case Qt::Key_Enter:
-        selectItem(m_listWidget->currentItem());
+        selectIndex(m_listView->currentIndex());
         break;
     case Qt::Key_Up:
-        if (m_listWidget->currentRow() > 0) {
-            m_listWidget->setCurrentRow(m_listWidget->currentRow() - 1);
-        }
+        moveCurrent(-1);
         break;
     case Qt::Key_Down:
-        if (m_listWidget->currentRow() < m_listWidget->count() - 1) {
-            m_listWidget->setCurrentRow(m_listWidget->currentRow() + 1);
-        }
+        moveCurrent(1);
         break;
     default:
         QDialog::keyPressEvent(event);
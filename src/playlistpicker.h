@@ -2,38 +2,44 @@
 
 #include <QDialog>
 #include <QLineEdit>
-#include <QListWidget>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QLabel>
+#include "thumbnailcache.h"
+#include "playlistmodel.h"
 
 class PlaylistPicker : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit PlaylistPicker(const QStringList &playlist, QWidget *parent = nullptr);
+    explicit PlaylistPicker(const Playlist &playlist, QWidget *parent = nullptr);
 
     [[nodiscard]] QString selectedFile() const { return m_selectedFile; }
     [[nodiscard]] int selectedIndex() const { return m_selectedIndex; }
 
 private slots:
     void onSearchTextChanged(const QString &text);
-    void onItemDoubleClicked(QListWidgetItem *item);
-    void onItemActivated(QListWidgetItem *item);
+    void onCurrentChanged(const QModelIndex &current);
+    void onThumbnailReady(const QString &path, ThumbnailCache::Kind kind);
+    void updateVisibleThumbnails();
 
 protected:
     void keyPressEvent(QKeyEvent *event) override;
 
 private:
     void updateList();
-    void selectItem(QListWidgetItem *item);
+    void selectIndex(const QModelIndex &index);
+    void moveCurrent(int delta);
+    void showPreview(const QString &path);
 
     QLineEdit *m_searchEdit = nullptr;
-    QListWidget *m_listWidget = nullptr;
+    QListView *m_listView = nullptr;
     QLabel *m_countLabel = nullptr;
+    QLabel *m_previewLabel = nullptr;   // Sprite of the current entry
 
-    QStringList m_fullPlaylist;  // Full paths
-    QStringList m_displayNames;  // Just filenames for display
+    PlaylistListModel *m_model = nullptr;
+    PlaylistFilterProxy *m_proxy = nullptr;
     QString m_searchText;
     QString m_selectedFile;
     int m_selectedIndex = -1;
@@ -1,146 +1,8 @@
 #include "playlistwidget.h"
 #include <QVBoxLayout>
 #include <QHeaderView>
-#include <QFileInfo>
-#include <QDragEnterEvent>
-#include <QDropEvent>
-#include <QMimeData>
 #include <QMenu>
-#include <QUrl>
-
-// ============================================================================
-// PlaylistTree - Custom QTreeWidget with drag & drop
-// ============================================================================
-
-PlaylistTree::PlaylistTree(QWidget *parent)
-    : QTreeWidget(parent)
-{
-    setDragEnabled(true);
-    setAcceptDrops(true);
-    setDropIndicatorShown(true);
-    setDragDropMode(QAbstractItemView::InternalMove);
-    setDefaultDropAction(Qt::MoveAction);
-}
-
-QStringList PlaylistTree::mimeTypes() const
-{
-    return {"text/uri-list", "application/x-playlist-items"};
-}
-
-QMimeData* PlaylistTree::mimeData(const QList<QTreeWidgetItem*> &items) const
-{
-    auto *mimeData = new QMimeData();
-    QList<QUrl> urls;
-    QStringList paths;
-
-    for (QTreeWidgetItem *item : items) {
-        // Only allow dragging file items (not cell headers)
-        if (item->parent()) {
-            QString path = item->data(0, Qt::UserRole).toString();
-            if (!path.isEmpty()) {
-                urls.append(QUrl::fromLocalFile(path));
-                paths.append(path);
-            }
-        }
-    }
-
-    mimeData->setUrls(urls);
-    mimeData->setData("application/x-playlist-items", paths.join("\n").toUtf8());
-    return mimeData;
-}
-
-void PlaylistTree::dragEnterEvent(QDragEnterEvent *event)
-{
-    if (event->mimeData()->hasUrls() || event->mimeData()->hasFormat("application/x-playlist-items")) {
-        event->acceptProposedAction();
-    } else {
-        event->ignore();
-    }
-}
-
-void PlaylistTree::dragMoveEvent(QDragMoveEvent *event)
-{
-    QTreeWidgetItem *item = itemAt(event->position().toPoint());
-
-    // Allow drop on cell headers or between file items
-    if (item) {
-        // If hovering over a file item, target its parent cell
-        QTreeWidgetItem *targetCell = item->parent() ? item->parent() : item;
-        if (!targetCell->parent()) {  // It's a cell header
-            event->acceptProposedAction();
-            return;
-        }
-    }
-    event->acceptProposedAction();
-}
-
-void PlaylistTree::dropEvent(QDropEvent *event)
-{
-    QTreeWidgetItem *item = itemAt(event->position().toPoint());
-    if (!item) {
-        event->ignore();
-        return;
-    }
-
-    // Find target cell (parent if dropping on file, item itself if cell header)
-    QTreeWidgetItem *targetCell = item->parent() ? item->parent() : item;
-
-    // Only accept drops on cell headers
-    if (targetCell->parent()) {
-        event->ignore();
-        return;
-    }
-
-    const QMimeData *mimeData = event->mimeData();
-    QStringList paths;
-
-    if (mimeData->hasFormat("application/x-playlist-items")) {
-        // Internal move
-        QString data = QString::fromUtf8(mimeData->data("application/x-playlist-items"));
-        paths = data.split("\n", Qt::SkipEmptyParts);
-    } else if (mimeData->hasUrls()) {
-        // External file drop
-        for (const QUrl &url : mimeData->urls()) {
-            if (url.isLocalFile()) {
-                paths.append(url.toLocalFile());
-            }
-        }
-    }
-
-    if (!paths.isEmpty()) {
-        emit filesDropped(targetCell, paths);
-        event->acceptProposedAction();
-    } else {
-        event->ignore();
-    }
-}
-
-bool PlaylistTree::dropMimeData(QTreeWidgetItem *parent, int index, const QMimeData *data, Qt::DropAction action)
-{
-    Q_UNUSED(index);
-    Q_UNUSED(action);
-
-    if (!parent || parent->parent()) {
-        // Only accept drops on cell headers (top-level items)
-        return false;
-    }
-
-    QStringList paths;
-    if (data->hasFormat("application/x-playlist-items")) {
-        QString strData = QString::fromUtf8(data->data("application/x-playlist-items"));
-        paths = strData.split("\n", Qt::SkipEmptyParts);
-    }
-
-    if (!paths.isEmpty()) {
-        emit filesDropped(parent, paths);
-        return true;
-    }
-    return false;
-}
-
-// ============================================================================
-// PlaylistWidget
-// ============================================================================
+#include <QScrollBar>
 
 PlaylistWidget::PlaylistWidget(QWidget *parent)
     : QWidget(parent)
@@ -153,200 +15,124 @@ void PlaylistWidget::setupUi()
     auto *layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
 
-    m_tree = new PlaylistTree();
-    m_tree->setHeaderLabels({"Playlist"});
+    m_model = new PlaylistTreeModel(this);
+
+    m_tree = new QTreeView();
+    m_tree->setModel(m_model);
     m_tree->setRootIsDecorated(true);
     m_tree->setAlternatingRowColors(true);
     m_tree->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_tree->setUniformRowHeights(true);  // Lets the view skip measuring every row
     m_tree->header()->setVisible(false);
     m_tree->setContextMenuPolicy(Qt::CustomContextMenu);
+    m_tree->setDragEnabled(true);
+    m_tree->setAcceptDrops(true);
+    m_tree->setDropIndicatorShown(true);
+    m_tree->setDragDropMode(QAbstractItemView::DragDrop);
+    m_tree->setDefaultDropAction(Qt::CopyAction);
 
     m_tree->setStyleSheet(R"(
-        QTreeWidget {
+        QTreeView {
             background-color: #1e1e1e;
             color: #ccc;
             border: none;
         }
-        QTreeWidget::item { padding: 4px; }
-        QTreeWidget::item:selected { background-color: #3a5a8a; }
-        QTreeWidget::item:alternate { background-color: #222; }
-        QTreeWidget::item:hover { background-color: #2a2a2a; }
+        QTreeView::item { padding: 4px; }
+        QTreeView::item:selected { background-color: #3a5a8a; }
+        QTreeView::item:alternate { background-color: #222; }
+        QTreeView::item:hover { background-color: #2a2a2a; }
     )");
 
-    connect(m_tree, &QTreeWidget::itemDoubleClicked, this, [this](QTreeWidgetItem *item, int) {
-        if (!item || !item->parent()) return;
-
-        QTreeWidgetItem *cellItem = item->parent();
-        int row = cellItem->data(0, Qt::UserRole).toInt();
-        int col = cellItem->data(0, Qt::UserRole + 1).toInt();
-        QString file = item->data(0, Qt::UserRole).toString();
+    connect(m_tree, &QTreeView::doubleClicked, this, [this](const QModelIndex &index) {
+        const QModelIndex cellIndex = index.parent();
+        if (!cellIndex.isValid()) return;  // Cell header
 
-        emit fileSelected(row, col, file);
+        emit fileSelected(cellIndex.data(CellRowRole).toInt(), cellIndex.data(CellColRole).toInt(),
+                          index.data(PathRole).toString());
     });
 
-    connect(m_tree, &PlaylistTree::filesDropped, this, &PlaylistWidget::onFilesDropped);
-    connect(m_tree, &PlaylistTree::fileMovedWithinCell, this, &PlaylistWidget::onFileMovedWithinCell);
+    connect(m_model, &PlaylistTreeModel::cellPlaylistEdited, this, &PlaylistWidget::onCellPlaylistEdited);
     connect(m_tree, &QWidget::customContextMenuRequested, this, &PlaylistWidget::onContextMenu);
 
+    // Thumbnails only for rows on screen
+    m_tree->setIconSize(QSize(ThumbnailConstants::kThumbWidth / 3, ThumbnailConstants::kThumbHeight / 3));
+    connect(m_tree->verticalScrollBar(), &QScrollBar::valueChanged, this, &PlaylistWidget::updateVisibleThumbnails);
+    connect(m_tree, &QTreeView::expanded, this, &PlaylistWidget::updateVisibleThumbnails);
+    connect(m_tree, &QTreeView::collapsed, this, &PlaylistWidget::updateVisibleThumbnails);
+    connect(&ThumbnailCache::instance(), &ThumbnailCache::ready, this, &PlaylistWidget::onThumbnailReady);
+
     layout->addWidget(m_tree);
 }
 
-QTreeWidgetItem* PlaylistWidget::findOrCreateCellItem(int row, int col)
+void PlaylistWidget::setCellPlaylist(int row, int col, const Playlist &playlist)
 {
-    QPair<int,int> key{row, col};
-
-    if (m_cellItems.contains(key)) {
-        return m_cellItems[key];
-    }
-
-    auto *item = new QTreeWidgetItem(m_tree);
-    item->setText(0, QString("Cell [%1,%2]").arg(row).arg(col));
-    item->setData(0, Qt::UserRole, row);
-    item->setData(0, Qt::UserRole + 1, col);
-    item->setExpanded(false);
-    item->setFlags(item->flags() | Qt::ItemIsDropEnabled);
-
-    QFont font = item->font(0);
-    font.setBold(true);
-    item->setFont(0, font);
-
-    m_cellItems[key] = item;
-    return item;
+    m_model->setCellPlaylist(row, col, playlist);
 }
 
-void PlaylistWidget::setCellPlaylist(int row, int col, const QStringList &files)
+void PlaylistWidget::appendToCellPlaylist(int row, int col, const Playlist &playlist, int from, int changedFrom)
 {
-    QTreeWidgetItem *cellItem = findOrCreateCellItem(row, col);
-
-    // Clear existing children
-    while (cellItem->childCount() > 0) {
-        delete cellItem->takeChild(0);
-    }
-
-    // Add files
-    for (const QString &file : files) {
-        QFileInfo fi(file);
-        auto *fileItem = new QTreeWidgetItem(cellItem);
-        fileItem->setText(0, fi.fileName());
-        fileItem->setData(0, Qt::UserRole, file);
-        fileItem->setToolTip(0, file);
-        fileItem->setFlags(fileItem->flags() | Qt::ItemIsDragEnabled);
-    }
-
-    cellItem->setText(0, QString("Cell [%1,%2] (%3)")
-        .arg(row).arg(col).arg(files.size()));
+    m_model->appendToCellPlaylist(row, col, playlist, from, changedFrom);
 }
 
-void PlaylistWidget::updateCurrentFile(int row, int col, const QString &file)
+void PlaylistWidget::updateVisibleThumbnails()
 {
-    QPair<int,int> key{row, col};
-    if (!m_cellItems.contains(key)) return;
-
-    QTreeWidgetItem *cellItem = m_cellItems[key];
-
-    for (int i = 0; i < cellItem->childCount(); ++i) {
-        QTreeWidgetItem *child = cellItem->child(i);
-        QString itemPath = child->data(0, Qt::UserRole).toString();
-
-        QFont font = child->font(0);
-        if (itemPath == file) {
-            font.setBold(true);
-            child->setForeground(0, QColor("#6a9fd4"));
-        } else {
-            font.setBold(false);
-            child->setForeground(0, QColor("#ccc"));
+    QStringList visible;
+    const int height = m_tree->viewport()->height();
+    for (QModelIndex index = m_tree->indexAt(QPoint(0, 0)); index.isValid(); index = m_tree->indexBelow(index)) {
+        if (m_tree->visualRect(index).top() >= height) {
+            break;
+        }
+        if (index.parent().isValid()) {  // Skip cell headers
+            visible.append(index.data(PathRole).toString());
         }
-        child->setFont(0, font);
     }
-}
 
-void PlaylistWidget::clear()
-{
-    m_tree->clear();
-    m_cellItems.clear();
+    ThumbnailCache::instance().setWanted(this, visible);
 }
 
-void PlaylistWidget::removeFile(int row, int col, const QString &file)
+void PlaylistWidget::onThumbnailReady(const QString &path, ThumbnailCache::Kind kind)
 {
-    QPair<int,int> key{row, col};
-    if (!m_cellItems.contains(key)) return;
-
-    QTreeWidgetItem *cellItem = m_cellItems[key];
-
-    for (int i = 0; i < cellItem->childCount(); ++i) {
-        QTreeWidgetItem *child = cellItem->child(i);
-        if (child->data(0, Qt::UserRole).toString() == file) {
-            delete cellItem->takeChild(i);
-            break;
-        }
+    Q_UNUSED(path);
+    if (kind == ThumbnailCache::Kind::Thumbnail) {
+        // Icons come from data(); a repaint picks them up
+        m_tree->viewport()->update();
     }
-
-    // Update count in header
-    cellItem->setText(0, QString("Cell [%1,%2] (%3)")
-        .arg(row).arg(col).arg(cellItem->childCount()));
 }
 
-QStringList PlaylistWidget::getPlaylist(int row, int col) const
+void PlaylistWidget::updateCurrentFile(int row, int col, const QString &file)
 {
-    QPair<int,int> key{row, col};
-    if (!m_cellItems.contains(key)) return {};
-
-    return getPlaylistFromItem(m_cellItems[key]);
+    m_model->setCurrentFile(row, col, file);
 }
 
-QStringList PlaylistWidget::getPlaylistFromItem(QTreeWidgetItem *cellItem) const
+void PlaylistWidget::clear()
 {
-    QStringList files;
-    for (int i = 0; i < cellItem->childCount(); ++i) {
-        files.append(cellItem->child(i)->data(0, Qt::UserRole).toString());
-    }
-    return files;
+    m_model->clear();
 }
 
-void PlaylistWidget::onFilesDropped(QTreeWidgetItem *targetCell, const QStringList &files)
+void PlaylistWidget::removeFile(int row, int col, const QString &file)
 {
-    if (!targetCell) return;
-
-    int row = targetCell->data(0, Qt::UserRole).toInt();
-    int col = targetCell->data(0, Qt::UserRole + 1).toInt();
-
-    // Add files to the cell
-    for (const QString &file : files) {
-        QFileInfo fi(file);
-        auto *fileItem = new QTreeWidgetItem(targetCell);
-        fileItem->setText(0, fi.fileName());
-        fileItem->setData(0, Qt::UserRole, file);
-        fileItem->setToolTip(0, file);
-        fileItem->setFlags(fileItem->flags() | Qt::ItemIsDragEnabled);
-    }
-
-    // Update header count
-    targetCell->setText(0, QString("Cell [%1,%2] (%3)")
-        .arg(row).arg(col).arg(targetCell->childCount()));
-
-    // Emit reordered signal with new playlist
-    emit playlistReordered(row, col, getPlaylistFromItem(targetCell));
+    m_model->removeFile(m_model->fileIndex(row, col, file));
 }
 
-void PlaylistWidget::onFileMovedWithinCell(QTreeWidgetItem *cellItem)
+QStringList PlaylistWidget::getPlaylist(int row, int col) const
 {
-    if (!cellItem) return;
-
-    int row = cellItem->data(0, Qt::UserRole).toInt();
-    int col = cellItem->data(0, Qt::UserRole + 1).toInt();
+    return m_model->paths(row, col);
+}
 
-    emit playlistReordered(row, col, getPlaylistFromItem(cellItem));
+void PlaylistWidget::onCellPlaylistEdited(int row, int col)
+{
+    emit playlistReordered(row, col, m_model->paths(row, col));
 }
 
 void PlaylistWidget::onContextMenu(const QPoint &pos)
 {
-    QTreeWidgetItem *item = m_tree->itemAt(pos);
-    if (!item || !item->parent()) return;  // Only for file items
+    const QModelIndex index = m_tree->indexAt(pos);
+    const QModelIndex cellIndex = index.parent();
+    if (!cellIndex.isValid()) return;  // Only for file items
 
-    QTreeWidgetItem *cellItem = item->parent();
-    int row = cellItem->data(0, Qt::UserRole).toInt();
-    int col = cellItem->data(0, Qt::UserRole + 1).toInt();
-    QString file = item->data(0, Qt::UserRole).toString();
+    const int row = cellIndex.data(CellRowRole).toInt();
+    const int col = cellIndex.data(CellColRole).toInt();
+    const QString file = index.data(PathRole).toString();
 
     QMenu menu(this);
     QAction *playAction = menu.addAction("Play this file");
@@ -356,29 +142,24 @@ void PlaylistWidget::onContextMenu(const QPoint &pos)
     QAction *moveDownAction = menu.addAction("Move down");
 
     // Disable move actions at boundaries
-    int idx = cellItem->indexOfChild(item);
+    const int idx = index.row();
     moveUpAction->setEnabled(idx > 0);
-    moveDownAction->setEnabled(idx < cellItem->childCount() - 1);
+    moveDownAction->setEnabled(idx < m_model->rowCount(cellIndex) - 1);
 
     QAction *selected = menu.exec(m_tree->viewport()->mapToGlobal(pos));
 
     if (selected == playAction) {
         emit fileSelected(row, col, file);
     } else if (selected == removeAction) {
-        delete cellItem->takeChild(idx);
-        cellItem->setText(0, QString("Cell [%1,%2] (%3)")
-            .arg(row).arg(col).arg(cellItem->childCount()));
-        emit playlistReordered(row, col, getPlaylistFromItem(cellItem));
-        emit fileRemovedFromPlaylist(row, col, file);
-    } else if (selected == moveUpAction && idx > 0) {
-        QTreeWidgetItem *taken = cellItem->takeChild(idx);
-        cellItem->insertChild(idx - 1, taken);
-        m_tree->setCurrentItem(taken);
-        emit playlistReordered(row, col, getPlaylistFromItem(cellItem));
-    } else if (selected == moveDownAction && idx < cellItem->childCount()) {
-        QTreeWidgetItem *taken = cellItem->takeChild(idx);
-        cellItem->insertChild(idx + 1, taken);
-        m_tree->setCurrentItem(taken);
-        emit playlistReordered(row, col, getPlaylistFromItem(cellItem));
+        if (m_model->removeFile(index)) {
+            emit playlistReordered(row, col, m_model->paths(row, col));
+            emit fileRemovedFromPlaylist(row, col, file);
+        }
+    } else if (selected == moveUpAction || selected == moveDownAction) {
+        const int delta = selected == moveUpAction ? -1 : 1;
+        if (m_model->moveFile(index, delta)) {
+            m_tree->setCurrentIndex(m_model->index(idx + delta, 0, cellIndex));
+            emit playlistReordered(row, col, m_model->paths(row, col));
+        }
     }
 }
@@ -1,30 +1,10 @@
 #pragma once
 
 #include <QWidget>
-#include <QTreeWidget>
-#include <QMap>
-#include <QPair>
-
-// Custom tree widget with drag & drop support
-class PlaylistTree : public QTreeWidget
-{
-    Q_OBJECT
-
-public:
-    explicit PlaylistTree(QWidget *parent = nullptr);
-
-signals:
-    void filesDropped(QTreeWidgetItem *targetCell, const QStringList &files);
-    void fileMovedWithinCell(QTreeWidgetItem *cellItem);
-
-protected:
-    void dragEnterEvent(QDragEnterEvent *event) override;
-    void dragMoveEvent(QDragMoveEvent *event) override;
-    void dropEvent(QDropEvent *event) override;
-    QStringList mimeTypes() const override;
-    QMimeData* mimeData(const QList<QTreeWidgetItem*> &items) const override;
-    bool dropMimeData(QTreeWidgetItem *parent, int index, const QMimeData *data, Qt::DropAction action) override;
-};
+#include <QTreeView>
+#include "playlist.h"
+#include "playlistmodel.h"
+#include "thumbnailcache.h"
 
 class PlaylistWidget : public QWidget
 {
@@ -33,7 +13,9 @@ class PlaylistWidget : public QWidget
 public:
     explicit PlaylistWidget(QWidget *parent = nullptr);
 
-    void setCellPlaylist(int row, int col, const QStringList &files);
+    void setCellPlaylist(int row, int col, const Playlist &playlist);
+    // Adds entries [from, size); entries [changedFrom, from) were reordered
+    void appendToCellPlaylist(int row, int col, const Playlist &playlist, int from, int changedFrom);
     void updateCurrentFile(int row, int col, const QString &file);
     void clear();
     void removeFile(int row, int col, const QString &file);
@@ -45,15 +27,14 @@ signals:
     void fileRemovedFromPlaylist(int row, int col, const QString &file);
 
 private slots:
-    void onFilesDropped(QTreeWidgetItem *targetCell, const QStringList &files);
-    void onFileMovedWithinCell(QTreeWidgetItem *cellItem);
+    void onCellPlaylistEdited(int row, int col);
     void onContextMenu(const QPoint &pos);
+    void onThumbnailReady(const QString &path, ThumbnailCache::Kind kind);
+    void updateVisibleThumbnails();
 
 private:
     void setupUi();
-    QTreeWidgetItem* findOrCreateCellItem(int row, int col);
-    QStringList getPlaylistFromItem(QTreeWidgetItem *cellItem) const;
 
-    PlaylistTree *m_tree = nullptr;
-    QMap<QPair<int,int>, QTreeWidgetItem*> m_cellItems;
+    QTreeView *m_tree = nullptr;
+    PlaylistTreeModel *m_model = nullptr;
 };
@@ -0,0 +1,50 @@
+#include "qualitygovernor.h"
+#include <algorithm>
+
+QualityTier QualityGovernor::tierForSize(const QSize &pixels) noexcept
+{
+    using namespace QualityConstants;
+    const qint64 area = static_cast<qint64>(pixels.width()) * pixels.height();
+    if (area <= kFastMaxPixels) return QualityTier::Fast;
+    if (area <= kBalancedMaxPixels) return QualityTier::Balanced;
+    return QualityTier::High;
+}
+
+const char* QualityGovernor::tierName(QualityTier tier) noexcept
+{
+    switch (tier) {
+    case QualityTier::Fast: return "fast";
+    case QualityTier::Balanced: return "balanced";
+    case QualityTier::High: return "high";
+    }
+    return "unknown";
+}
+
+bool QualityGovernor::update(const QSize &pixels, qint64 droppedFrames)
+{
+    using namespace QualityConstants;
+
+    // The counter restarts with every file; a drop below the last sample is a new file
+    const qint64 delta = (m_lastDropped < 0 || droppedFrames < m_lastDropped) ? 0 : droppedFrames - m_lastDropped;
+    m_lastDropped = droppedFrames;
+
+    QualityTier target = QualityTier::High;
+    if (m_pinned) {
+        m_penalty = 0;
+        m_cleanSamples = 0;
+    } else {
+        if (delta >= kDropThreshold) {
+            m_penalty = std::min(m_penalty + 1, kMaxPenalty);
+            m_cleanSamples = 0;
+        } else if (m_penalty > 0 && ++m_cleanSamples >= kRecoverySamples) {
+            --m_penalty;
+            m_cleanSamples = 0;
+        }
+        const int sizeTier = static_cast<int>(tierForSize(pixels));
+        target = static_cast<QualityTier>(std::max(sizeTier - m_penalty, static_cast<int>(QualityTier::Fast)));
+    }
+
+    if (target == m_tier) return false;
+    m_tier = target;
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QSize>
+#include <QtGlobal>
+
+namespace QualityConstants {
+    inline constexpr int kSampleIntervalMs = 2000;
+    inline constexpr qint64 kFastMaxPixels = 640 * 360;       // Tiles up to this render with the fast tier
+    inline constexpr qint64 kBalancedMaxPixels = 1280 * 720;  // Above this a tile gets full quality
+    inline constexpr qint64 kDropThreshold = 3;               // Dropped + delayed frames per sample that mean overload
+    inline constexpr int kRecoverySamples = 5;                // Clean samples before stepping back up
+    inline constexpr int kMaxPenalty = 2;                     // Tiers a cell can be pushed below its size tier
+}
+
+enum class QualityTier {
+    Fast = 0,   // Bilinear scaling, no debanding, audio sync
+    Balanced,   // spline36 luma, cheap chroma
+    High        // gpu-hq with EWA scaling and display-resample
+};
+
+// Picks a render tier for one cell from its on-screen pixel size and recent
+// frame drops. Pure policy: MpvWidget samples the counters and applies it.
+class QualityGovernor
+{
+public:
+    QualityGovernor() = default;
+
+    [[nodiscard]] QualityTier tier() const noexcept { return m_tier; }
+    [[nodiscard]] static QualityTier tierForSize(const QSize &pixels) noexcept;
+    [[nodiscard]] static const char* tierName(QualityTier tier) noexcept;
+
+    // Pinned cells (tile fullscreen) always run the high tier
+    void setPinned(bool pinned) noexcept { m_pinned = pinned; }
+    [[nodiscard]] bool isPinned() const noexcept { return m_pinned; }
+
+    // droppedFrames is mpv's cumulative per-file counter. Returns true if the tier changed.
+    bool update(const QSize &pixels, qint64 droppedFrames);
+
+private:
+    QualityTier m_tier = QualityTier::High;
+    qint64 m_lastDropped = -1;
+    int m_penalty = 0;
+    int m_cleanSamples = 0;
+    bool m_pinned = false;
+};
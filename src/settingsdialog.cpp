@@ -17,6 +17,7 @@
 #include <QMenu>
 #include <QClipboard>
 #include <QApplication>
+#include <QProgressDialog>
 
 SettingsDialog::SettingsDialog(QWidget *parent)
     : QDialog(parent)
@@ -25,6 +26,8 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     setMinimumSize(700, 600);
     setupUi();
     loadSettings();
+
+    connect(&m_statsWatcher, &QFutureWatcherBase::finished, this, &SettingsDialog::showStats);
     updateStatsDisplay();
 }
 
@@ -205,8 +208,65 @@ QWidget* SettingsDialog::createPlaybackTab()
     m_watchdogIntervalSpin->setSuffix(" ms");
     videoLayout->addRow("Watchdog Interval:", m_watchdogIntervalSpin);
 
+    m_adaptiveQualityCheck = new QCheckBox("Adaptive Render Quality");
+    m_adaptiveQualityCheck->setToolTip("Use cheaper scaling on small or overloaded tiles (applies to new grids)");
+    videoLayout->addRow(m_adaptiveQualityCheck);
+
+    m_decodeCapCheck = new QCheckBox("Cap Decode Resolution to Tile Size");
+    m_decodeCapCheck->setToolTip("Scale frames down to the tile size before upload; saves memory bandwidth on large grids");
+    videoLayout->addRow(m_decodeCapCheck);
+
+    m_wallRendererCheck = new QCheckBox("Shared Wall Renderer");
+    m_wallRendererCheck->setToolTip("Draw all cells into one GL surface instead of one per cell (applies to new grids)");
+    videoLayout->addRow(m_wallRendererCheck);
+
+    m_releaseHiddenVideoCheck = new QCheckBox("Release Video of Hidden Cells");
+    m_releaseHiddenVideoCheck->setToolTip("Drop the video track of hidden cells to free decoders; resuming reloads it briefly");
+    videoLayout->addRow(m_releaseHiddenVideoCheck);
+
+    m_imageFastPathCheck = new QCheckBox("Fast Path for Still Images");
+    m_imageFastPathCheck->setToolTip("Decode photos at tile size and draw them directly; mpv keeps only videos and animations (applies to new grids)");
+    videoLayout->addRow(m_imageFastPathCheck);
+
+    m_hwdecBudgetSpin = new QSpinBox;
+    m_hwdecBudgetSpin->setRange(0, 100);
+    m_hwdecBudgetSpin->setSuffix(" cells");
+    m_hwdecBudgetSpin->setToolTip("Cells decoded on the GPU at once; the heaviest files get them, the rest decode in software. 0 = software only");
+    videoLayout->addRow("Hardware Decode Budget:", m_hwdecBudgetSpin);
+
     layout->addWidget(videoGroup);
 
+    // I/O
+    auto *ioGroup = new QGroupBox("I/O");
+    auto *ioLayout = new QFormLayout(ioGroup);
+
+    m_cacheMemorySpin = new QSpinBox;
+    m_cacheMemorySpin->setRange(64, 65536);
+    m_cacheMemorySpin->setSingleStep(256);
+    m_cacheMemorySpin->setSuffix(" MB");
+    m_cacheMemorySpin->setToolTip("Demuxer cache of the whole grid, split evenly between cells");
+    ioLayout->addRow("Cache Memory:", m_cacheMemorySpin);
+
+    m_networkPathsEdit = new QLineEdit;
+    m_networkPathsEdit->setPlaceholderText("/mnt/share; /media/nas");
+    m_networkPathsEdit->setToolTip("Also use the network profile (cache on, long read-ahead, large reads) under these paths; "
+                                   "SMB and NFS mounts are detected on their own");
+    ioLayout->addRow("Network Paths:", m_networkPathsEdit);
+
+    layout->addWidget(ioGroup);
+
+    // Diagnostics
+    auto *perfGroup = new QGroupBox("Diagnostics");
+    auto *perfLayout = new QFormLayout(perfGroup);
+
+    m_metricsPortSpin = new QSpinBox;
+    m_metricsPortSpin->setRange(0, 65535);
+    m_metricsPortSpin->setSpecialValueText("Off");
+    m_metricsPortSpin->setToolTip("Serve per-cell and app metrics in Prometheus format on http://127.0.0.1:<port>/metrics");
+    perfLayout->addRow("Metrics Port:", m_metricsPortSpin);
+
+    layout->addWidget(perfGroup);
+
     // Skipper
     auto *skipperGroup = new QGroupBox("Skipper");
     auto *skipperLayout = new QFormLayout(skipperGroup);
@@ -420,6 +480,15 @@ void SettingsDialog::loadSettings()
     m_rotationStepSpin->setValue(config.rotationStep());
     m_osdDurationSpin->setValue(config.osdDurationMs());
     m_watchdogIntervalSpin->setValue(config.watchdogIntervalMs());
+    m_adaptiveQualityCheck->setChecked(config.adaptiveQuality());
+    m_decodeCapCheck->setChecked(config.decodeCapEnabled());
+    m_wallRendererCheck->setChecked(config.wallRendererEnabled());
+    m_releaseHiddenVideoCheck->setChecked(config.releaseHiddenVideo());
+    m_hwdecBudgetSpin->setValue(config.hwdecBudget());
+    m_imageFastPathCheck->setChecked(config.imageFastPath());
+    m_cacheMemorySpin->setValue(config.cacheMemoryMb());
+    m_metricsPortSpin->setValue(config.metricsPort());
+    m_networkPathsEdit->setText(config.networkPaths().join("; "));
     m_skipperEnabledCheck->setChecked(config.skipperEnabled());
     m_skipPercentSpin->setValue(config.skipPercent());
 
@@ -451,6 +520,21 @@ void SettingsDialog::saveSettings()
     config.setRotationStep(m_rotationStepSpin->value());
     config.setOsdDurationMs(m_osdDurationSpin->value());
     config.setWatchdogIntervalMs(m_watchdogIntervalSpin->value());
+    config.setAdaptiveQuality(m_adaptiveQualityCheck->isChecked());
+    config.setDecodeCapEnabled(m_decodeCapCheck->isChecked());
+    config.setWallRendererEnabled(m_wallRendererCheck->isChecked());
+    config.setReleaseHiddenVideo(m_releaseHiddenVideoCheck->isChecked());
+    config.setHwdecBudget(m_hwdecBudgetSpin->value());
+    config.setImageFastPath(m_imageFastPathCheck->isChecked());
+    config.setCacheMemoryMb(m_cacheMemorySpin->value());
+    config.setMetricsPort(m_metricsPortSpin->value());
+    QStringList networkPaths;
+    for (const QString &path : m_networkPathsEdit->text().split(';', Qt::SkipEmptyParts)) {
+        if (!path.trimmed().isEmpty()) {
+            networkPaths.append(path.trimmed());
+        }
+    }
+    config.setNetworkPaths(networkPaths);
     config.setSkipperEnabled(m_skipperEnabledCheck->isChecked());
     config.setSkipPercent(m_skipPercentSpin->value());
 
@@ -506,38 +590,67 @@ void SettingsDialog::updateStatsDisplay()
         return;
     }
 
-    // Summary
-    m_totalWatchTimeLabel->setText(formatDuration(stats.getTotalWatchTime()));
-    m_totalFilesLabel->setText(QString::number(stats.getTotalFilesTracked()));
+    if (m_statsWatcher.isRunning()) {
+        m_statsRefreshPending = true;
+        return;
+    }
 
-    auto sessions = stats.getRecentSessions(1000);
-    m_totalSessionsLabel->setText(QString::number(sessions.size()));
+    // Queries run on the read-only analytics connection; the dialog stays responsive
+    m_statsWatcher.setFuture(stats.runAnalytics([]() {
+        const StatsManager &stats = StatsManager::instance();
+        StatsSnapshot snapshot;
+        snapshot.totalWatchMs = stats.getTotalWatchTime();
+        snapshot.totalFiles = stats.getTotalFilesTracked();
+        snapshot.totalSessions = stats.getRecentSessions(1000).size();
+        snapshot.avgSessionMs = stats.getAverageSessionLength();
+        snapshot.peakHour = stats.getPeakHour();
+        snapshot.peakDay = stats.getPeakDayOfWeek();
+        snapshot.totalSkips = stats.getTotalSkips();
+        snapshot.totalScreenshots = stats.getTotalScreenshots();
+        snapshot.today = stats.getStatsForToday();
+        snapshot.week = stats.getStatsForThisWeek();
+        snapshot.month = stats.getStatsForThisMonth();
+        snapshot.topFiles = stats.getMostWatched(10);
+        snapshot.hourly = stats.getHourlyDistribution();
+        return snapshot;
+    }));
+}
 
-    double avgSession = stats.getAverageSessionLength();
-    m_avgSessionLabel->setText(formatDuration(static_cast<qint64>(avgSession)));
+void SettingsDialog::showStats()
+{
+    if (m_statsWatcher.isCanceled()) {
+        return;
+    }
+    const StatsSnapshot snapshot = m_statsWatcher.result();
 
-    int peakHour = stats.getPeakHour();
+    if (m_statsRefreshPending) {
+        m_statsRefreshPending = false;
+        updateStatsDisplay();
+    }
+
+    // Summary
+    m_totalWatchTimeLabel->setText(formatDuration(snapshot.totalWatchMs));
+    m_totalFilesLabel->setText(QString::number(snapshot.totalFiles));
+    m_totalSessionsLabel->setText(QString::number(snapshot.totalSessions));
+    m_avgSessionLabel->setText(formatDuration(static_cast<qint64>(snapshot.avgSessionMs)));
+
+    const int peakHour = snapshot.peakHour;
     m_peakHourLabel->setText(QString("%1:00 - %2:00").arg(peakHour).arg((peakHour + 1) % 24));
 
     static const QStringList dayNames = {"", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
-    int peakDay = stats.getPeakDayOfWeek();
+    const int peakDay = snapshot.peakDay;
     m_peakDayLabel->setText(peakDay >= 1 && peakDay <= 7 ? dayNames[peakDay] : "--");
 
-    m_totalSkipsLabel->setText(QString::number(stats.getTotalSkips()));
-    m_totalScreenshotsLabel->setText(QString::number(stats.getTotalScreenshots()));
+    m_totalSkipsLabel->setText(QString::number(snapshot.totalSkips));
+    m_totalScreenshotsLabel->setText(QString::number(snapshot.totalScreenshots));
 
     // Time range stats
-    auto todayStats = stats.getStatsForToday();
-    m_todayWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(todayStats.totalWatchMs)).arg(todayStats.sessionCount));
-
-    auto weekStats = stats.getStatsForThisWeek();
-    m_weekWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(weekStats.totalWatchMs)).arg(weekStats.sessionCount));
-
-    auto monthStats = stats.getStatsForThisMonth();
-    m_monthWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(monthStats.totalWatchMs)).arg(monthStats.sessionCount));
+    m_todayWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(snapshot.today.totalWatchMs)).arg(snapshot.today.sessionCount));
+    m_weekWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(snapshot.week.totalWatchMs)).arg(snapshot.week.sessionCount));
+    m_monthWatchTimeLabel->setText(QString("%1 (%2 sessions)").arg(formatDuration(snapshot.month.totalWatchMs)).arg(snapshot.month.sessionCount));
 
     // Top files
-    auto topFiles = stats.getMostWatched(10);
+    const auto &topFiles = snapshot.topFiles;
     m_topFilesTable->setRowCount(topFiles.size());
     for (int i = 0; i < topFiles.size(); ++i) {
         const auto &file = topFiles[i];
@@ -559,7 +672,7 @@ void SettingsDialog::updateStatsDisplay()
     m_topFilesTable->resizeColumnsToContents();
 
     // Hourly distribution
-    auto hourly = stats.getHourlyDistribution();
+    const auto &hourly = snapshot.hourly;
     for (int h = 0; h < 24 && h < hourly.size(); ++h) {
         m_hourlyTable->setItem(0, h, new QTableWidgetItem(QString::number(hourly[h].sessionCount)));
     }
@@ -603,26 +716,60 @@ void SettingsDialog::onReset()
 
 void SettingsDialog::onExportStats()
 {
-    QString path = QFileDialog::getSaveFileName(this, "Export Statistics", "", "CSV Files (*.csv)");
-    if (!path.isEmpty()) {
-        if (StatsManager::instance().exportToCsv(path)) {
-            QMessageBox::information(this, "Export", "Statistics exported successfully.");
-        } else {
-            QMessageBox::warning(this, "Export", "Failed to export statistics.");
-        }
-    }
+    startExport(StatsExportRequest::Table::Files, "Export Statistics");
 }
 
 void SettingsDialog::onExportSessions()
 {
-    QString path = QFileDialog::getSaveFileName(this, "Export Sessions", "", "CSV Files (*.csv)");
-    if (!path.isEmpty()) {
-        if (StatsManager::instance().exportSessionsToCsv(path)) {
-            QMessageBox::information(this, "Export", "Sessions exported successfully.");
+    startExport(StatsExportRequest::Table::Sessions, "Export Sessions");
+}
+
+void SettingsDialog::startExport(StatsExportRequest::Table table, const QString &title)
+{
+    if (m_exportWatcher.isRunning()) {
+        return;
+    }
+
+    static const QString csvFilter = "CSV Files (*.csv)";
+    static const QString parquetFilter = "Parquet Files (*.parquet)";
+    const QString filters = StatsExport::parquetAvailable() ? csvFilter + ";;" + parquetFilter : csvFilter;
+
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, title, "", filters, &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
+
+    StatsExportRequest request;
+    request.table = table;
+    request.format = selectedFilter == parquetFilter || path.endsWith(".parquet", Qt::CaseInsensitive)
+        ? StatsExportRequest::Format::Parquet
+        : StatsExportRequest::Format::Csv;
+    request.path = path;
+
+    // Streams on the analytics thread; the dialog only follows progress
+    auto *progress = new QProgressDialog(title + "...", "Cancel", 0, 100, this);
+    progress->setAttribute(Qt::WA_DeleteOnClose);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(500);
+    connect(&m_exportWatcher, &QFutureWatcherBase::progressValueChanged, progress, &QProgressDialog::setValue);
+    connect(progress, &QProgressDialog::canceled, &m_exportWatcher, &QFutureWatcherBase::cancel);
+    connect(&m_exportWatcher, &QFutureWatcherBase::finished, progress, [this, progress, title]() {
+        m_exportWatcher.disconnect(progress);
+        progress->close();
+
+        if (m_exportWatcher.isCanceled()) {
+            return;
+        }
+        const StatsExportResult result = m_exportWatcher.result();
+        if (result.ok) {
+            QMessageBox::information(this, title, QString("Exported %1 rows.").arg(result.rows));
         } else {
-            QMessageBox::warning(this, "Export", "Failed to export sessions.");
+            QMessageBox::warning(this, title, "Export failed: " + result.error);
         }
-    }
+    });
+
+    m_exportWatcher.setFuture(StatsManager::instance().exportAsync(request));
 }
 
 void SettingsDialog::onClearStats()
@@ -10,6 +10,8 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QKeySequenceEdit>
+#include <QFutureWatcher>
+#include "statsmanager.h"
 
 class SettingsDialog : public QDialog
 {
@@ -42,6 +44,8 @@ private:
     void saveSettings();
     void populateKeyBindings();
     void updateStatsDisplay();
+    void showStats();
+    void startExport(StatsExportRequest::Table table, const QString &title);
     QString formatDuration(qint64 ms) const;
 
     QTabWidget *m_tabWidget = nullptr;
@@ -65,6 +69,15 @@ private:
     QSpinBox *m_rotationStepSpin = nullptr;
     QSpinBox *m_osdDurationSpin = nullptr;
     QSpinBox *m_watchdogIntervalSpin = nullptr;
+    QCheckBox *m_adaptiveQualityCheck = nullptr;
+    QCheckBox *m_decodeCapCheck = nullptr;
+    QCheckBox *m_wallRendererCheck = nullptr;
+    QCheckBox *m_releaseHiddenVideoCheck = nullptr;
+    QSpinBox *m_hwdecBudgetSpin = nullptr;
+    QCheckBox *m_imageFastPathCheck = nullptr;
+    QSpinBox *m_cacheMemorySpin = nullptr;
+    QLineEdit *m_networkPathsEdit = nullptr;
+    QSpinBox *m_metricsPortSpin = nullptr;
     QCheckBox *m_skipperEnabledCheck = nullptr;
     QDoubleSpinBox *m_skipPercentSpin = nullptr;
 
@@ -92,4 +105,24 @@ private:
     QPushButton *m_exportStatsBtn = nullptr;
     QPushButton *m_exportSessionsBtn = nullptr;
     QPushButton *m_clearStatsBtn = nullptr;
+
+    // Everything the stats tab shows, gathered on the analytics thread
+    struct StatsSnapshot {
+        qint64 totalWatchMs = 0;
+        int totalFiles = 0;
+        int totalSessions = 0;
+        double avgSessionMs = 0.0;
+        int peakHour = 0;
+        int peakDay = 0;
+        int totalSkips = 0;
+        int totalScreenshots = 0;
+        TimeRangeStats today;
+        TimeRangeStats week;
+        TimeRangeStats month;
+        QList<FileStats> topFiles;
+        QList<HourlyStats> hourly;
+    };
+    QFutureWatcher<StatsSnapshot> m_statsWatcher;
+    bool m_statsRefreshPending = false;   // Requested while a snapshot was running
+    QFutureWatcher<StatsExportResult> m_exportWatcher;
 };
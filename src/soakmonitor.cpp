@@ -0,0 +1,193 @@
+#include "soakmonitor.h"
+#include "cellstatusstore.h"
+#include "perfmetrics.h"
+#include "statsmanager.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+double toMb(qint64 bytes)
+{
+    return bytes >= 0 ? bytes / (1024.0 * 1024.0) : -1.0;
+}
+
+} // namespace
+
+SoakMonitor::SoakMonitor(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &SoakMonitor::sample);
+}
+
+SoakMonitor::~SoakMonitor()
+{
+    stop();
+}
+
+qint64 SoakMonitor::residentBytes()
+{
+#ifdef Q_OS_LINUX
+    // statm: size resident shared ...; in pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) return -1;
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+bool SoakMonitor::start(const QString &logPath, int intervalSecs)
+{
+    stop();
+
+    if (!logPath.isEmpty()) {
+        m_log.setFileName(logPath);
+        if (!m_log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+            qWarning() << "SoakMonitor: cannot open" << logPath << m_log.errorString();
+            return false;
+        }
+    }
+
+    m_filesPerCell.clear();
+    m_samples = 0;
+    m_startRss = residentBytes();
+    m_peakRss = m_startRss;
+    m_warmRss = -1;
+    m_warmAtMs = 0;
+    m_running = true;
+    m_clock.start();
+
+    connect(&CellStatusStore::instance(), &CellStatusStore::snapshotReady, this, &SoakMonitor::onSnapshot);
+    PerfMetrics::instance().setLogging(true);
+    m_timer.start(std::chrono::seconds(std::max(1, intervalSecs)));
+    qInfo().noquote() << QString("Soak: sampling every %1s, RSS %2 MB").arg(std::max(1, intervalSecs)).arg(toMb(m_startRss), 0, 'f', 1);
+    return true;
+}
+
+void SoakMonitor::stop()
+{
+    if (!m_running) return;
+
+    sample();
+    m_timer.stop();
+    disconnect(&CellStatusStore::instance(), &CellStatusStore::snapshotReady, this, &SoakMonitor::onSnapshot);
+    PerfMetrics::instance().setLogging(false);
+    m_running = false;
+
+    int files = 0;
+    for (int count : std::as_const(m_filesPerCell)) files += count;
+    const double hours = m_clock.elapsed() / 3.6e6;
+
+    QJsonObject summary;
+    summary["summary"] = true;
+    summary["duration_s"] = m_clock.elapsed() / 1000.0;
+    summary["samples"] = m_samples;
+    summary["rss_start_mb"] = toMb(m_startRss);
+    summary["rss_end_mb"] = toMb(residentBytes());
+    summary["rss_peak_mb"] = toMb(m_peakRss);
+    summary["files"] = files;
+    summary["files_per_hour"] = hours > 0.0 ? files / hours : 0.0;
+    summary["stats_dropped"] = static_cast<double>(StatsManager::instance().droppedWrites());
+    writeLine(QJsonDocument(summary).toJson(QJsonDocument::Compact));
+    qInfo().noquote() << QString("Soak: done after %1 samples, %2 files, RSS %3 -> %4 MB (peak %5)")
+        .arg(m_samples).arg(files)
+        .arg(toMb(m_startRss), 0, 'f', 1).arg(toMb(residentBytes()), 0, 'f', 1).arg(toMb(m_peakRss), 0, 'f', 1);
+
+    m_log.close();
+}
+
+void SoakMonitor::onSnapshot()
+{
+    const QVector<CellStatus> &cells = CellStatusStore::instance().snapshot();
+    if (m_filesPerCell.size() < cells.size()) {
+        m_filesPerCell.resize(cells.size(), 0);
+    }
+    for (qsizetype i = 0; i < cells.size(); ++i) {
+        const CellStatus &cell = cells.at(i);
+        if ((cell.changes & CellStatus::FileChange) && !cell.path.isEmpty()) {
+            ++m_filesPerCell[i];
+        }
+    }
+}
+
+void SoakMonitor::sample()
+{
+    ++m_samples;
+    const qint64 elapsedMs = m_clock.elapsed();
+    const qint64 rss = residentBytes();
+    m_peakRss = std::max(m_peakRss, rss);
+    if (m_samples == SoakConstants::kWarmupIntervals) {
+        m_warmRss = rss;
+        m_warmAtMs = elapsedMs;
+    }
+
+    const QVector<CellStatus> &cells = CellStatusStore::instance().snapshot();
+    QJsonArray perCell;
+    int playing = 0;
+    int files = 0;
+    int restarts = 0;
+    double fpsTotal = 0.0;
+    for (qsizetype i = 0; i < cells.size(); ++i) {
+        const CellStatus &cell = cells.at(i);
+        const int cellFiles = i < m_filesPerCell.size() ? m_filesPerCell.at(i) : 0;
+        if (!cell.idle && !cell.paused && !cell.suspended) ++playing;
+        files += cellFiles;
+        restarts += cell.restarts;
+        fpsTotal += cell.fps;
+
+        QJsonObject entry;
+        entry["row"] = cell.row;
+        entry["col"] = cell.col;
+        entry["files"] = cellFiles;
+        entry["fps"] = cell.fps;
+        entry["drops"] = cell.frameDrops;
+        entry["decoder_drops"] = cell.decoderDrops;
+        entry["restarts"] = cell.restarts;
+        entry["stalls"] = cell.cacheStalls;
+        perCell.append(entry);
+    }
+
+    // Growth per hour only once there is a warm baseline and an hour's
+    // fraction to divide by; start-up allocations would swamp it otherwise
+    const double warmHours = (elapsedMs - m_warmAtMs) / 3.6e6;
+    const double mbPerHour = m_warmRss >= 0 && rss >= 0 && warmHours > 0.0
+        ? toMb(rss - m_warmRss) / warmHours : 0.0;
+
+    StatsManager &stats = StatsManager::instance();
+    QJsonObject line;
+    line["t_s"] = elapsedMs / 1000.0;
+    line["rss_mb"] = toMb(rss);
+    line["rss_growth_mb"] = rss >= 0 && m_startRss >= 0 ? toMb(rss - m_startRss) : 0.0;
+    line["rss_mb_per_hour"] = mbPerHour;
+    line["cells"] = static_cast<int>(cells.size());
+    line["playing"] = playing;
+    line["fps_total"] = fpsTotal;
+    line["files"] = files;
+    line["restarts"] = restarts;
+    line["stats_pending"] = stats.pendingWrites();
+    line["stats_dropped"] = static_cast<double>(stats.droppedWrites());
+    line["per_cell"] = perCell;
+    writeLine(QJsonDocument(line).toJson(QJsonDocument::Compact));
+
+    qInfo().noquote() << QString("Soak: %1s RSS %2 MB (%3 MB/h) %4/%5 playing, %6 fps, %7 files, %8 restarts")
+        .arg(elapsedMs / 1000).arg(toMb(rss), 0, 'f', 1).arg(mbPerHour, 0, 'f', 1)
+        .arg(playing).arg(cells.size()).arg(fpsTotal, 0, 'f', 0).arg(files).arg(restarts);
+}
+
+void SoakMonitor::writeLine(const QByteArray &line)
+{
+    if (!m_log.isOpen()) return;
+    m_log.write(line);
+    m_log.write("\n");
+    m_log.flush();   // A soak run usually ends by being killed
+}
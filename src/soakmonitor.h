@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include <QVector>
+
+namespace SoakConstants {
+    inline constexpr int kDefaultIntervalSecs = 60;
+    inline constexpr int kWarmupIntervals = 5;   // Caches and pools fill first; growth is measured after
+}
+
+// Long-run recorder for headless soak tests (--headless). Every interval it
+// appends one JSON line with resident memory, its growth, and per-cell
+// throughput: files started, fps, drops and restarts, taken from the
+// CellStatusStore snapshots. Keeps PerfMetrics sampling on while it runs.
+class SoakMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SoakMonitor(QObject *parent = nullptr);
+    ~SoakMonitor() override;
+
+    bool start(const QString &logPath, int intervalSecs);   // Empty path: summary lines on stderr only
+    void stop();   // Writes a last sample and the run's summary
+
+    // Resident set size of this process; -1 where it cannot be read
+    [[nodiscard]] static qint64 residentBytes();
+
+private slots:
+    void onSnapshot();
+    void sample();
+
+private:
+    void writeLine(const QByteArray &line);
+
+    QFile m_log;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QVector<int> m_filesPerCell;   // FileChange count per grid slot since start()
+    int m_samples = 0;
+    qint64 m_startRss = -1;
+    qint64 m_warmRss = -1;         // After kWarmupIntervals; the base for the growth rate
+    qint64 m_warmAtMs = 0;
+    qint64 m_peakRss = -1;
+    bool m_running = false;
+};
@@ -0,0 +1,428 @@
+#include "statsexport.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QFile>
+#include <QDateTime>
+#include <QVector>
+#include <QDebug>
+#include <memory>
+
+#ifdef GOOBERT_HAVE_PARQUET
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#endif
+
+namespace {
+    enum class ColumnType {
+        Int,
+        Bool,
+        Text,
+        Millis,     // Duration; seconds in CSV
+        Timestamp   // Epoch ms; ISO 8601 in CSV, empty if unset
+    };
+
+    struct Column {
+        const char *name;        // Parquet field, the database column
+        const char *csvHeader;
+        ColumnType type;
+    };
+
+    // Column 0 of a page query is the rowid key; exported columns follow it
+    struct TableSpec {
+        const char *maxKeySql;
+        const char *pageSql;     // Binds: last key, page size
+        QVector<Column> columns;
+    };
+
+    const TableSpec &tableSpec(StatsExportRequest::Table table)
+    {
+        static const TableSpec files = {
+            "SELECT MAX(id) FROM file_stats",
+            R"(
+                SELECT id, file_path, total_watch_ms, play_count, last_watched_at,
+                       last_position_ms, duration_ms, is_image
+                FROM file_stats
+                WHERE id > ?
+                ORDER BY id
+                LIMIT ?
+            )",
+            {
+                {"file_path", "File Path", ColumnType::Text},
+                {"total_watch_ms", "Total Watch Time (seconds)", ColumnType::Millis},
+                {"play_count", "Play Count", ColumnType::Int},
+                {"last_watched_at", "Last Watched", ColumnType::Timestamp},
+                {"last_position_ms", "Last Position (seconds)", ColumnType::Millis},
+                {"duration_ms", "Duration (seconds)", ColumnType::Millis},
+                {"is_image", "Is Image", ColumnType::Bool},
+            }
+        };
+        static const TableSpec sessions = {
+            "SELECT MAX(id) FROM watch_sessions",
+            R"(
+                SELECT ws.id, ws.id, fs.file_path, ws.started_at, ws.ended_at, ws.duration_ms,
+                       ws.cell_row, ws.cell_col, ws.hour_of_day, ws.day_of_week
+                FROM watch_sessions ws
+                JOIN file_stats fs ON ws.file_id = fs.id
+                WHERE ws.id > ?
+                ORDER BY ws.id
+                LIMIT ?
+            )",
+            {
+                {"id", "Session ID", ColumnType::Int},
+                {"file_path", "File Path", ColumnType::Text},
+                {"started_at", "Started At", ColumnType::Timestamp},
+                {"ended_at", "Ended At", ColumnType::Timestamp},
+                {"duration_ms", "Duration (seconds)", ColumnType::Millis},
+                {"cell_row", "Cell Row", ColumnType::Int},
+                {"cell_col", "Cell Col", ColumnType::Int},
+                {"hour_of_day", "Hour of Day", ColumnType::Int},
+                {"day_of_week", "Day of Week", ColumnType::Int},
+            }
+        };
+        return table == StatsExportRequest::Table::Sessions ? sessions : files;
+    }
+
+    // Receives one page at a time; values start at query column 1
+    class RowSink
+    {
+    public:
+        virtual ~RowSink() = default;
+        virtual bool open(const QString &path, const QVector<Column> &columns) = 0;
+        virtual bool addRow(const QSqlQuery &query) = 0;
+        virtual bool endPage() = 0;
+        virtual bool close() = 0;
+        [[nodiscard]] const QString &error() const noexcept { return m_error; }
+
+    protected:
+        QString m_error;
+    };
+
+    // Same layout as the old synchronous exporters
+    class CsvSink : public RowSink
+    {
+    public:
+        bool open(const QString &path, const QVector<Column> &columns) override
+        {
+            m_columns = columns;
+            m_file.setFileName(path);
+            if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                m_error = m_file.errorString();
+                return false;
+            }
+            m_buffer.reserve(StatsExportConstants::kWriteBufferBytes + 4096);
+            for (int i = 0; i < m_columns.size(); ++i) {
+                m_buffer += (i > 0 ? "," : "");
+                m_buffer += m_columns.at(i).csvHeader;
+            }
+            m_buffer += '\n';
+            return true;
+        }
+
+        bool addRow(const QSqlQuery &query) override
+        {
+            for (int i = 0; i < m_columns.size(); ++i) {
+                if (i > 0) {
+                    m_buffer += ',';
+                }
+                appendValue(m_columns.at(i).type, query.value(i + 1));
+            }
+            m_buffer += '\n';
+            return m_buffer.size() < StatsExportConstants::kWriteBufferBytes || writeBuffer();
+        }
+
+        bool endPage() override { return true; }
+
+        bool close() override
+        {
+            const bool ok = writeBuffer();
+            m_file.close();
+            return ok;
+        }
+
+    private:
+        void appendValue(ColumnType type, const QVariant &value)
+        {
+            switch (type) {
+            case ColumnType::Int:
+                m_buffer += QByteArray::number(value.toLongLong());
+                break;
+            case ColumnType::Bool:
+                m_buffer += value.toBool() ? "Yes" : "No";
+                break;
+            case ColumnType::Text: {
+                QByteArray text = value.toString().toUtf8();
+                text.replace("\"", "\"\"");
+                m_buffer += '"' + text + '"';
+                break;
+            }
+            case ColumnType::Millis:
+                m_buffer += QByteArray::number(value.toLongLong() / 1000.0, 'g', 6);
+                break;
+            case ColumnType::Timestamp: {
+                const qint64 ms = value.toLongLong();
+                m_buffer += '"';
+                if (ms > 0) {
+                    m_buffer += QDateTime::fromMSecsSinceEpoch(ms).toString(Qt::ISODate).toUtf8();
+                }
+                m_buffer += '"';
+                break;
+            }
+            }
+        }
+
+        bool writeBuffer()
+        {
+            if (!m_buffer.isEmpty() && m_file.write(m_buffer) != m_buffer.size()) {
+                m_error = m_file.errorString();
+                return false;
+            }
+            m_buffer.clear();
+            return true;
+        }
+
+        QVector<Column> m_columns;
+        QFile m_file;
+        QByteArray m_buffer;
+    };
+
+#ifdef GOOBERT_HAVE_PARQUET
+    // Typed columns in database units (ms, epoch ms); one row group per page
+    class ParquetSink : public RowSink
+    {
+    public:
+        bool open(const QString &path, const QVector<Column> &columns) override
+        {
+            m_columns = columns;
+
+            arrow::FieldVector fields;
+            for (const Column &column : m_columns) {
+                auto type = arrowType(column.type);
+                auto builder = arrow::MakeBuilder(type);
+                if (!builder.ok()) {
+                    return fail(builder.status());
+                }
+                fields.push_back(arrow::field(column.name, type));
+                m_builders.push_back(std::move(*builder));
+            }
+            m_schema = arrow::schema(fields);
+
+            auto sink = arrow::io::FileOutputStream::Open(path.toStdString());
+            if (!sink.ok()) {
+                return fail(sink.status());
+            }
+            m_sink = *sink;
+
+            auto writer = parquet::arrow::FileWriter::Open(*m_schema, arrow::default_memory_pool(), m_sink);
+            if (!writer.ok()) {
+                return fail(writer.status());
+            }
+            m_writer = std::move(*writer);
+            return true;
+        }
+
+        bool addRow(const QSqlQuery &query) override
+        {
+            for (int i = 0; i < m_columns.size(); ++i) {
+                const QVariant value = query.value(i + 1);
+                arrow::ArrayBuilder *builder = m_builders.at(i).get();
+                arrow::Status status;
+                if (value.isNull()) {
+                    status = builder->AppendNull();
+                } else {
+                    switch (m_columns.at(i).type) {
+                    case ColumnType::Int:
+                    case ColumnType::Millis:
+                        status = static_cast<arrow::Int64Builder*>(builder)->Append(value.toLongLong());
+                        break;
+                    case ColumnType::Timestamp:
+                        status = static_cast<arrow::TimestampBuilder*>(builder)->Append(value.toLongLong());
+                        break;
+                    case ColumnType::Bool:
+                        status = static_cast<arrow::BooleanBuilder*>(builder)->Append(value.toBool());
+                        break;
+                    case ColumnType::Text: {
+                        const QByteArray text = value.toString().toUtf8();
+                        status = static_cast<arrow::StringBuilder*>(builder)->Append(text.constData(), static_cast<int32_t>(text.size()));
+                        break;
+                    }
+                    }
+                }
+                if (!status.ok()) {
+                    return fail(status);
+                }
+            }
+            return true;
+        }
+
+        bool endPage() override
+        {
+            arrow::ArrayVector arrays;
+            for (auto &builder : m_builders) {
+                std::shared_ptr<arrow::Array> array;
+                const arrow::Status status = builder->Finish(&array);
+                if (!status.ok()) {
+                    return fail(status);
+                }
+                arrays.push_back(std::move(array));
+            }
+            if (arrays.empty() || arrays.front()->length() == 0) {
+                return true;
+            }
+            auto table = arrow::Table::Make(m_schema, arrays);
+            return check(m_writer->WriteTable(*table, StatsExportConstants::kPageRows));
+        }
+
+        bool close() override
+        {
+            bool ok = true;
+            if (m_writer) {
+                ok = check(m_writer->Close());
+            }
+            if (m_sink) {
+                ok = check(m_sink->Close()) && ok;
+            }
+            return ok;
+        }
+
+    private:
+        static std::shared_ptr<arrow::DataType> arrowType(ColumnType type)
+        {
+            switch (type) {
+            case ColumnType::Bool:      return arrow::boolean();
+            case ColumnType::Text:      return arrow::utf8();
+            case ColumnType::Timestamp: return arrow::timestamp(arrow::TimeUnit::MILLI);
+            case ColumnType::Int:
+            case ColumnType::Millis:    break;
+            }
+            return arrow::int64();
+        }
+
+        bool check(const arrow::Status &status) { return status.ok() || fail(status); }
+
+        bool fail(const arrow::Status &status)
+        {
+            m_error = QString::fromStdString(status.ToString());
+            return false;
+        }
+
+        QVector<Column> m_columns;
+        std::shared_ptr<arrow::Schema> m_schema;
+        std::vector<std::unique_ptr<arrow::ArrayBuilder>> m_builders;
+        std::shared_ptr<arrow::io::FileOutputStream> m_sink;
+        std::unique_ptr<parquet::arrow::FileWriter> m_writer;
+    };
+#endif
+
+    std::unique_ptr<RowSink> makeSink(StatsExportRequest::Format format)
+    {
+        switch (format) {
+        case StatsExportRequest::Format::Csv:
+            return std::make_unique<CsvSink>();
+        case StatsExportRequest::Format::Parquet:
+#ifdef GOOBERT_HAVE_PARQUET
+            return std::make_unique<ParquetSink>();
+#else
+            break;
+#endif
+        }
+        return nullptr;
+    }
+}
+
+bool StatsExport::parquetAvailable() noexcept
+{
+#ifdef GOOBERT_HAVE_PARQUET
+    return true;
+#else
+    return false;
+#endif
+}
+
+StatsExportResult StatsExport::run(const QSqlDatabase &db, const StatsExportRequest &request,
+                                   QPromise<StatsExportResult> *promise)
+{
+    StatsExportResult result;
+
+    std::unique_ptr<RowSink> sink = makeSink(request.format);
+    if (!sink) {
+        result.error = "This build has no Parquet support";
+        return result;
+    }
+
+    const TableSpec &spec = tableSpec(request.table);
+    const QString partPath = request.path + ".part";
+    if (!sink->open(partPath, spec.columns)) {
+        result.error = sink->error();
+        QFile::remove(partPath);
+        return result;
+    }
+
+    QSqlQuery query(db);
+    qint64 maxKey = 0;
+    if (query.exec(spec.maxKeySql) && query.next()) {
+        maxKey = query.value(0).toLongLong();
+    }
+    if (promise) {
+        promise->setProgressRange(0, 100);
+    }
+
+    // Keyset pagination: each page is its own short read transaction
+    query.setForwardOnly(true);
+    query.prepare(spec.pageSql);
+    qint64 lastKey = 0;
+    bool ok = true;
+    bool canceled = false;
+    while (ok) {
+        if (promise && promise->isCanceled()) {
+            canceled = true;
+            break;
+        }
+
+        query.bindValue(0, lastKey);
+        query.bindValue(1, StatsExportConstants::kPageRows);
+        if (!query.exec()) {
+            result.error = query.lastError().text();
+            ok = false;
+            break;
+        }
+
+        int pageRows = 0;
+        while (ok && query.next()) {
+            lastKey = query.value(0).toLongLong();
+            ok = sink->addRow(query);
+            ++pageRows;
+        }
+        query.finish();
+        ok = ok && sink->endPage();
+        result.rows += pageRows;
+
+        if (promise && maxKey > 0) {
+            promise->setProgressValue(static_cast<int>(qMin<qint64>(100, lastKey * 100 / maxKey)));
+        }
+        if (pageRows < StatsExportConstants::kPageRows) {
+            break;
+        }
+    }
+
+    ok = sink->close() && ok;
+    if (!ok && result.error.isEmpty()) {
+        result.error = sink->error();
+    }
+
+    if (!ok || canceled) {
+        QFile::remove(partPath);
+        return result;
+    }
+
+    QFile::remove(request.path);
+    if (!QFile::rename(partPath, request.path)) {
+        result.error = QString("Failed to replace %1").arg(request.path);
+        QFile::remove(partPath);
+        return result;
+    }
+
+    result.ok = true;
+    qDebug() << "StatsExport:" << result.rows << "rows to" << request.path;
+    return result;
+}
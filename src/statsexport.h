@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QString>
+#include <QSqlDatabase>
+#include <QPromise>
+
+namespace StatsExportConstants {
+    inline constexpr int kPageRows = 4096;                // Rows per rowid page, and per Parquet row group
+    inline constexpr qint64 kWriteBufferBytes = 1 << 20;  // CSV bytes buffered between writes
+}
+
+// What to export, and how
+struct StatsExportRequest {
+    enum class Table {
+        Files,      // file_stats
+        Sessions    // watch_sessions
+    };
+    enum class Format {
+        Csv,
+        Parquet     // Needs a build with Apache Arrow, see StatsExport::parquetAvailable()
+    };
+
+    Table table = Table::Files;
+    Format format = Format::Csv;
+    QString path;
+};
+
+struct StatsExportResult {
+    bool ok = false;
+    qint64 rows = 0;
+    QString error;
+};
+
+// Streams a stats table to disk in pages of kPageRows rows keyed on rowid,
+// so each page is a short read that never pins the WAL and memory stays flat
+// however long the history is. Output goes to "<path>.part" and replaces
+// path only once complete; a canceled or failed export leaves path alone.
+class StatsExport
+{
+public:
+    [[nodiscard]] static bool parquetAvailable() noexcept;
+
+    // Runs on the calling thread with db. A non-null promise gets progress
+    // in percent of the rowid range and is polled for cancellation per page.
+    static StatsExportResult run(const QSqlDatabase &db, const StatsExportRequest &request,
+                                 QPromise<StatsExportResult> *promise = nullptr);
+};
@@ -3,10 +3,10 @@
 #include <QSqlError>
 #include <QStandardPaths>
 #include <QDir>
-#include <QFile>
-#include <QTextStream>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QDebug>
+#include <algorithm>
 
 StatsManager& StatsManager::instance()
 {
@@ -24,17 +24,20 @@ StatsManager::~StatsManager()
     shutdown();
 }
 
+QString StatsManager::databasePath()
+{
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+    return configPath + "/goobert/goobert.db";
+}
+
 bool StatsManager::initialize()
 {
     if (m_initialized) {
         return true;
     }
 
-    // Get config directory
-    QString configPath = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
-    QString dbDir = configPath + "/goobert";
-    QDir().mkpath(dbDir);
-    QString dbPath = dbDir + "/goobert.db";
+    const QString dbPath = databasePath();
+    QDir().mkpath(QFileInfo(dbPath).absolutePath());
 
     // Open database
     m_db = QSqlDatabase::addDatabase("QSQLITE", "stats_connection");
@@ -48,12 +51,26 @@ bool StatsManager::initialize()
     // Enable WAL mode for better concurrency
     QSqlQuery pragma(m_db);
     pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA busy_timeout=5000");  // The writer thread may hold the write lock
 
     if (!createTables()) {
         qWarning() << "Failed to create stats tables";
         return false;
     }
 
+    // All writes go through the writer thread; this connection only reads
+    m_writer = new StatsWriter(this);
+    connect(m_writer, &StatsWriter::committed, this, [this](const QStringList &paths) {
+        for (const QString &path : paths) {
+            emit statsUpdated(path);
+        }
+    });
+    m_writer->start(dbPath);
+
+    // Analytics jobs from runAnalytics() read on their own connection
+    m_reader = new StatsReader(this);
+    m_reader->start(dbPath);
+
     // Setup periodic flush timer
     m_flushTimer = new QTimer(this);
     connect(m_flushTimer, &QTimer::timeout, this, &StatsManager::periodicFlush);
@@ -74,8 +91,10 @@ void StatsManager::shutdown()
         m_flushTimer->stop();
     }
 
-    // Flush all active sessions
+    // Flush all active sessions, then drain the writer
     stopAll();
+    m_reader->stop();
+    m_writer->stop();
 
     m_db.close();
     m_initialized = false;
@@ -97,6 +116,8 @@ bool StatsManager::createTables()
             duration_ms INTEGER DEFAULT 0,
             is_image INTEGER DEFAULT 0,
             loop_toggle_count INTEGER DEFAULT 0,
+            skip_count INTEGER DEFAULT 0,
+            directory_id INTEGER REFERENCES directories(id),
             created_at INTEGER DEFAULT (strftime('%s', 'now') * 1000),
             updated_at INTEGER DEFAULT (strftime('%s', 'now') * 1000)
         )
@@ -107,6 +128,44 @@ bool StatsManager::createTables()
         return false;
     }
 
+    // Directories table - interned parent folders of file_stats paths
+    ok = query.exec(R"(
+        CREATE TABLE IF NOT EXISTS directories (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            path TEXT UNIQUE NOT NULL
+        )
+    )");
+
+    if (!ok) {
+        qWarning() << "Failed to create directories table:" << query.lastError().text();
+        return false;
+    }
+
+    // Columns added after the first release
+    QStringList fileColumns;
+    if (query.exec("PRAGMA table_info(file_stats)")) {
+        while (query.next()) {
+            fileColumns.append(query.value(1).toString());
+        }
+    }
+
+    // The writer backfills directory ids when it opens
+    if (!fileColumns.contains("directory_id") &&
+        !query.exec("ALTER TABLE file_stats ADD COLUMN directory_id INTEGER REFERENCES directories(id)")) {
+        qWarning() << "Failed to add file_stats.directory_id:" << query.lastError().text();
+        return false;
+    }
+
+    // Skip counts outlive the raw skip_events rows they are counted from
+    if (!fileColumns.contains("skip_count")) {
+        if (!query.exec("ALTER TABLE file_stats ADD COLUMN skip_count INTEGER DEFAULT 0")) {
+            qWarning() << "Failed to add file_stats.skip_count:" << query.lastError().text();
+            return false;
+        }
+        query.exec("UPDATE file_stats SET skip_count = "
+                   "(SELECT COUNT(*) FROM skip_events WHERE skip_events.file_id = file_stats.id)");
+    }
+
     // Watch sessions table - detailed session tracking
     ok = query.exec(R"(
         CREATE TABLE IF NOT EXISTS watch_sessions (
@@ -328,19 +387,8 @@ bool StatsManager::createTables()
         return false;
     }
 
-    // Position samples table (for heatmap)
-    ok = query.exec(R"(
-        CREATE TABLE IF NOT EXISTS position_samples (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            file_id INTEGER NOT NULL,
-            position_pct INTEGER NOT NULL,
-            timestamp INTEGER NOT NULL,
-            FOREIGN KEY (file_id) REFERENCES file_stats(id)
-        )
-    )");
-
-    if (!ok) {
-        qWarning() << "Failed to create position_samples table:" << query.lastError().text();
+    // Rollup tables - aggregates kept by the stats writer
+    if (!StatsRollups::createTables(query)) {
         return false;
     }
 
@@ -348,9 +396,14 @@ bool StatsManager::createTables()
     query.exec("CREATE INDEX IF NOT EXISTS idx_file_stats_path ON file_stats(file_path)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_file_stats_last_watched ON file_stats(last_watched_at DESC)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_file_stats_total_watch ON file_stats(total_watch_ms DESC)");
+    query.exec("CREATE INDEX IF NOT EXISTS idx_file_stats_directory ON file_stats(directory_id)");
+    // Covering: completion counts never touch the table rows
+    query.exec("CREATE INDEX IF NOT EXISTS idx_file_stats_completion ON file_stats(duration_ms, last_position_ms)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_watch_sessions_file ON watch_sessions(file_id)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_watch_sessions_started ON watch_sessions(started_at DESC)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_watch_sessions_hour ON watch_sessions(hour_of_day)");
+    // Covering: per-cell usage on the dashboard
+    query.exec("CREATE INDEX IF NOT EXISTS idx_watch_sessions_cell ON watch_sessions(cell_row, cell_col, duration_ms)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_skip_events_file ON skip_events(file_id)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_skip_events_timestamp ON skip_events(timestamp DESC)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_loop_events_file ON loop_events(file_id)");
@@ -364,44 +417,48 @@ bool StatsManager::createTables()
     query.exec("CREATE INDEX IF NOT EXISTS idx_grid_events_timestamp ON grid_events(timestamp DESC)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_rotation_events_file ON rotation_events(file_id)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_favorites_file ON favorites(file_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_position_samples_file ON position_samples(file_id)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_position_samples_pct ON position_samples(position_pct)");
 
     return true;
 }
 
+QSqlDatabase StatsManager::connection() const
+{
+    // Getters run on the GUI thread or inside a runAnalytics() job
+    if (m_reader && m_reader->isReaderThread()) {
+        return StatsReader::database();
+    }
+    return m_db;
+}
+
 QString StatsManager::cellKey(int row, int col) const
 {
     return QString("%1,%2").arg(row).arg(col);
 }
 
-qint64 StatsManager::getOrCreateFileId(const QString &filePath, double durationSec, bool isImage)
+void StatsManager::enqueue(StatsRecord::Statement statement, const QString &filePath, const QVariantList &values)
 {
-    QSqlQuery query(m_db);
-
-    // Try to get existing
-    query.prepare("SELECT id FROM file_stats WHERE file_path = ?");
-    query.addBindValue(filePath);
+    StatsRecord record;
+    record.statement = statement;
+    record.filePath = filePath;
+    record.values = values;
+    m_writer->enqueue(std::move(record));
+}
 
-    if (query.exec() && query.next()) {
-        return query.value(0).toLongLong();
-    }
+quint64 StatsManager::droppedWrites() const noexcept
+{
+    return m_writer ? m_writer->droppedCount() : 0;
+}
 
-    // Create new
-    query.prepare(R"(
-        INSERT INTO file_stats (file_path, duration_ms, is_image)
-        VALUES (?, ?, ?)
-    )");
-    query.addBindValue(filePath);
-    query.addBindValue(static_cast<qint64>(durationSec * 1000));
-    query.addBindValue(isImage ? 1 : 0);
+int StatsManager::pendingWrites() const
+{
+    return m_writer ? m_writer->pending() : 0;
+}
 
-    if (query.exec()) {
-        return query.lastInsertId().toLongLong();
+void StatsManager::flushWrites()
+{
+    if (m_writer) {
+        m_writer->flush();
     }
-
-    qWarning() << "Failed to create file_stats entry:" << query.lastError().text();
-    return -1;
 }
 
 void StatsManager::startWatching(int row, int col, const QString &filePath,
@@ -418,29 +475,18 @@ void StatsManager::startWatching(int row, int col, const QString &filePath,
         flushSession(key);
     }
 
-    qint64 fileId = getOrCreateFileId(filePath, durationSec, isImage);
-    if (fileId < 0) {
-        return;
-    }
-
-    // Increment play count
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        UPDATE file_stats
-        SET play_count = play_count + 1,
-            last_watched_at = ?,
-            updated_at = ?
-        WHERE id = ?
-    )");
+    // Increment play count; the writer creates the file row if needed
     qint64 now = QDateTime::currentMSecsSinceEpoch();
-    query.addBindValue(now);
-    query.addBindValue(now);
-    query.addBindValue(fileId);
-    query.exec();
+    StatsRecord record;
+    record.statement = StatsRecord::Statement::PlayCount;
+    record.filePath = filePath;
+    record.durationSec = durationSec;
+    record.isImage = isImage;
+    record.values = {now, now};
+    m_writer->enqueue(std::move(record));
 
     // Create new session
     WatchSession session;
-    session.fileId = fileId;
     session.filePath = filePath;
     session.startedAt = now;
     session.elapsed.start();
@@ -531,47 +577,17 @@ void StatsManager::flushSession(const QString &cellKey)
     qint64 now = QDateTime::currentMSecsSinceEpoch();
     QDateTime nowDt = QDateTime::fromMSecsSinceEpoch(now);
 
-    // Update file_stats
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        UPDATE file_stats
-        SET total_watch_ms = total_watch_ms + ?,
-            last_position_ms = ?,
-            last_watched_at = ?,
-            updated_at = ?
-        WHERE id = ?
-    )");
-
-    query.addBindValue(watchDuration);
-    query.addBindValue(static_cast<qint64>(session.lastPositionSec * 1000));
-    query.addBindValue(now);
-    query.addBindValue(now);
-    query.addBindValue(session.fileId);
+    // Update file_stats, then the watch_sessions entry; statsUpdated follows the commit
+    enqueue(StatsRecord::Statement::SessionEnd, session.filePath,
+            {watchDuration, static_cast<qint64>(session.lastPositionSec * 1000), now, now});
 
-    if (!query.exec()) {
-        qWarning() << "Failed to update file stats:" << query.lastError().text();
-    }
-
-    // Create watch_sessions entry
-    QSqlQuery sessionQuery(m_db);
-    sessionQuery.prepare(R"(
-        INSERT INTO watch_sessions (file_id, started_at, ended_at, duration_ms, cell_row, cell_col, hour_of_day, day_of_week)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
-    )");
-    sessionQuery.addBindValue(session.fileId);
-    sessionQuery.addBindValue(session.startedAt);
-    sessionQuery.addBindValue(now);
-    sessionQuery.addBindValue(watchDuration);
-    sessionQuery.addBindValue(session.cellRow);
-    sessionQuery.addBindValue(session.cellCol);
-    sessionQuery.addBindValue(nowDt.time().hour());
-    sessionQuery.addBindValue(nowDt.date().dayOfWeek());
-
-    if (!sessionQuery.exec()) {
-        qWarning() << "Failed to insert watch session:" << sessionQuery.lastError().text();
-    }
-
-    emit statsUpdated(session.filePath);
+    StatsRecord record;
+    record.statement = StatsRecord::Statement::WatchSession;
+    record.filePath = session.filePath;
+    record.notify = true;
+    record.values = {session.startedAt, now, watchDuration, session.cellRow, session.cellCol,
+                     nowDt.time().hour(), nowDt.date().dayOfWeek()};
+    m_writer->enqueue(std::move(record));
 }
 
 void StatsManager::periodicFlush()
@@ -594,21 +610,9 @@ void StatsManager::periodicFlush()
         }
 
         // Update last position and watch time
-        QSqlQuery query(m_db);
-        query.prepare(R"(
-            UPDATE file_stats
-            SET total_watch_ms = total_watch_ms + ?,
-                last_position_ms = ?,
-                updated_at = ?
-            WHERE id = ?
-        )");
-
-        qint64 now = QDateTime::currentMSecsSinceEpoch();
-        query.addBindValue(watchDuration);
-        query.addBindValue(static_cast<qint64>(session.lastPositionSec * 1000));
-        query.addBindValue(now);
-        query.addBindValue(session.fileId);
-        query.exec();
+        enqueue(StatsRecord::Statement::SessionProgress, session.filePath,
+                {watchDuration, static_cast<qint64>(session.lastPositionSec * 1000),
+                 QDateTime::currentMSecsSinceEpoch()});
 
         // Reset elapsed counters
         session.elapsed.restart();
@@ -626,7 +630,7 @@ FileStats StatsManager::getStats(const QString &filePath) const
         return stats;
     }
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT id, file_path, total_watch_ms, play_count, last_watched_at,
                last_position_ms, duration_ms, is_image
@@ -656,16 +660,14 @@ QList<FileStats> StatsManager::getMostWatched(int limit) const
         return result;
     }
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT fs.id, fs.file_path, fs.total_watch_ms, fs.play_count, fs.last_watched_at,
                fs.last_position_ms, fs.duration_ms, fs.is_image,
-               COALESCE(skip_cnt.cnt, 0) as skip_count,
-               COALESCE(loop_cnt.cnt, 0) as loop_count,
+               fs.skip_count,
+               (SELECT COUNT(*) FROM loop_events le WHERE le.file_id = fs.id) as loop_count,
                CASE WHEN fs.duration_ms > 0 THEN (fs.last_position_ms * 100.0 / fs.duration_ms) ELSE 0 END as avg_pct
         FROM file_stats fs
-        LEFT JOIN (SELECT file_id, COUNT(*) as cnt FROM skip_events GROUP BY file_id) skip_cnt ON fs.id = skip_cnt.file_id
-        LEFT JOIN (SELECT file_id, COUNT(*) as cnt FROM loop_events GROUP BY file_id) loop_cnt ON fs.id = loop_cnt.file_id
         WHERE fs.total_watch_ms > 0
         ORDER BY fs.total_watch_ms DESC
         LIMIT ?
@@ -700,7 +702,7 @@ QList<FileStats> StatsManager::getRecentlyWatched(int limit) const
         return result;
     }
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT id, file_path, total_watch_ms, play_count, last_watched_at,
                last_position_ms, duration_ms, is_image
@@ -735,8 +737,8 @@ qint64 StatsManager::getTotalWatchTime() const
         return 0;
     }
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COALESCE(SUM(total_watch_ms), 0) FROM file_stats") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT COALESCE(SUM(watch_ms), 0) FROM rollup_file_types") && query.next()) {
         return query.value(0).toLongLong();
     }
     return 0;
@@ -748,8 +750,8 @@ int StatsManager::getTotalFilesTracked() const
         return 0;
     }
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COUNT(*) FROM file_stats WHERE total_watch_ms > 0") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT COALESCE(SUM(file_count), 0) FROM rollup_directories") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -761,7 +763,7 @@ double StatsManager::getLastPosition(const QString &filePath) const
         return 0.0;
     }
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT last_position_ms, duration_ms FROM file_stats WHERE file_path = ?");
     query.addBindValue(filePath);
 
@@ -786,37 +788,7 @@ bool StatsManager::exportToCsv(const QString &path) const
         return false;
     }
 
-    QFile file(path);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        return false;
-    }
-
-    QTextStream out(&file);
-    out << "File Path,Total Watch Time (seconds),Play Count,Last Watched,Last Position (seconds),Duration (seconds),Is Image\n";
-
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT file_path, total_watch_ms, play_count, last_watched_at, last_position_ms, duration_ms, is_image FROM file_stats ORDER BY total_watch_ms DESC")) {
-        while (query.next()) {
-            QString filePath = query.value(0).toString();
-            filePath.replace("\"", "\"\"");  // Escape quotes
-
-            qint64 lastWatched = query.value(3).toLongLong();
-            QString lastWatchedStr = lastWatched > 0
-                ? QDateTime::fromMSecsSinceEpoch(lastWatched).toString(Qt::ISODate)
-                : "";
-
-            out << "\"" << filePath << "\","
-                << query.value(1).toLongLong() / 1000.0 << ","
-                << query.value(2).toInt() << ","
-                << "\"" << lastWatchedStr << "\","
-                << query.value(4).toLongLong() / 1000.0 << ","
-                << query.value(5).toLongLong() / 1000.0 << ","
-                << (query.value(6).toBool() ? "Yes" : "No") << "\n";
-        }
-    }
-
-    file.close();
-    return true;
+    return StatsExport::run(connection(), {StatsExportRequest::Table::Files, StatsExportRequest::Format::Csv, path}).ok;
 }
 
 // ============ Event Logging Methods ============
@@ -825,192 +797,86 @@ void StatsManager::logSkipEvent(const QString &filePath, double fromPos, double
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO skip_events (file_id, timestamp, from_position_ms, to_position_ms, skip_type)
-        VALUES (?, ?, ?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(static_cast<qint64>(fromPos * 1000));
-    query.addBindValue(static_cast<qint64>(toPos * 1000));
-    query.addBindValue(skipType);
-    query.exec();
+    enqueue(StatsRecord::Statement::SkipEvent, filePath,
+            {QDateTime::currentMSecsSinceEpoch(), static_cast<qint64>(fromPos * 1000),
+             static_cast<qint64>(toPos * 1000), skipType});
 }
 
 void StatsManager::logLoopToggle(const QString &filePath, bool loopEnabled, int loopCount)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO loop_events (file_id, timestamp, loop_enabled, loop_count)
-        VALUES (?, ?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(loopEnabled ? 1 : 0);
-    query.addBindValue(loopCount);
-    query.exec();
+    enqueue(StatsRecord::Statement::LoopEvent, filePath,
+            {QDateTime::currentMSecsSinceEpoch(), loopEnabled ? 1 : 0, loopCount});
 
     // Update loop toggle count in file_stats
-    query.prepare("UPDATE file_stats SET loop_toggle_count = loop_toggle_count + 1 WHERE id = ?");
-    query.addBindValue(fileId);
-    query.exec();
+    enqueue(StatsRecord::Statement::LoopToggleCount, filePath);
 }
 
 void StatsManager::logRename(const QString &oldPath, const QString &newPath)
 {
     if (!m_initialized) return;
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO rename_history (old_path, new_path, timestamp)
-        VALUES (?, ?, ?)
-    )");
-    query.addBindValue(oldPath);
-    query.addBindValue(newPath);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.exec();
+    enqueue(StatsRecord::Statement::RenameHistory, QString(),
+            {oldPath, newPath, QDateTime::currentMSecsSinceEpoch()});
 
     // Update file_stats path if exists
-    query.prepare("UPDATE file_stats SET file_path = ? WHERE file_path = ?");
-    query.addBindValue(newPath);
-    query.addBindValue(oldPath);
-    query.exec();
+    enqueue(StatsRecord::Statement::RenameFile, QString(), {newPath, oldPath});
 }
 
 void StatsManager::logPauseEvent(const QString &filePath, double positionSec, bool isPause)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO pause_events (file_id, timestamp, position_ms, is_pause)
-        VALUES (?, ?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(static_cast<qint64>(positionSec * 1000));
-    query.addBindValue(isPause ? 1 : 0);
-    query.exec();
+    enqueue(StatsRecord::Statement::PauseEvent, filePath,
+            {QDateTime::currentMSecsSinceEpoch(), static_cast<qint64>(positionSec * 1000), isPause ? 1 : 0});
 }
 
 void StatsManager::logVolumeChange(int oldVolume, int newVolume, bool isMute)
 {
     if (!m_initialized) return;
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO volume_events (timestamp, old_volume, new_volume, is_mute)
-        VALUES (?, ?, ?, ?)
-    )");
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(oldVolume);
-    query.addBindValue(newVolume);
-    query.addBindValue(isMute ? 1 : 0);
-    query.exec();
+    enqueue(StatsRecord::Statement::VolumeEvent, QString(),
+            {QDateTime::currentMSecsSinceEpoch(), oldVolume, newVolume, isMute ? 1 : 0});
 }
 
 void StatsManager::logZoomEvent(const QString &filePath, double zoomLevel, double panX, double panY)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO zoom_events (file_id, timestamp, zoom_level, pan_x, pan_y)
-        VALUES (?, ?, ?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(zoomLevel);
-    query.addBindValue(panX);
-    query.addBindValue(panY);
-    query.exec();
+    enqueue(StatsRecord::Statement::ZoomEvent, filePath,
+            {QDateTime::currentMSecsSinceEpoch(), zoomLevel, panX, panY});
 }
 
 void StatsManager::logScreenshot(const QString &filePath, double positionSec, const QString &screenshotPath)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO screenshot_events (file_id, timestamp, position_ms, screenshot_path)
-        VALUES (?, ?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(static_cast<qint64>(positionSec * 1000));
-    query.addBindValue(screenshotPath);
-    query.exec();
+    enqueue(StatsRecord::Statement::ScreenshotEvent, filePath,
+            {QDateTime::currentMSecsSinceEpoch(), static_cast<qint64>(positionSec * 1000), screenshotPath});
 }
 
 void StatsManager::logFullscreenEvent(bool isFullscreen, bool isTile, int row, int col)
 {
     if (!m_initialized) return;
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO fullscreen_events (timestamp, is_fullscreen, is_tile_fullscreen, cell_row, cell_col)
-        VALUES (?, ?, ?, ?, ?)
-    )");
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(isFullscreen ? 1 : 0);
-    query.addBindValue(isTile ? 1 : 0);
-    query.addBindValue(row);
-    query.addBindValue(col);
-    query.exec();
+    enqueue(StatsRecord::Statement::FullscreenEvent, QString(),
+            {QDateTime::currentMSecsSinceEpoch(), isFullscreen ? 1 : 0, isTile ? 1 : 0, row, col});
 }
 
 void StatsManager::logGridEvent(int rows, int cols, const QString &sourcePath, const QString &filter, bool isStart)
 {
     if (!m_initialized) return;
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO grid_events (timestamp, rows, cols, source_path, filter, is_start)
-        VALUES (?, ?, ?, ?, ?, ?)
-    )");
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(rows);
-    query.addBindValue(cols);
-    query.addBindValue(sourcePath);
-    query.addBindValue(filter);
-    query.addBindValue(isStart ? 1 : 0);
-    query.exec();
+    enqueue(StatsRecord::Statement::GridEvent, QString(),
+            {QDateTime::currentMSecsSinceEpoch(), rows, cols, sourcePath, filter, isStart ? 1 : 0});
 }
 
 void StatsManager::logRotation(const QString &filePath, int rotation)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO rotation_events (file_id, timestamp, rotation)
-        VALUES (?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.addBindValue(rotation);
-    query.exec();
+    enqueue(StatsRecord::Statement::RotationEvent, filePath, {QDateTime::currentMSecsSinceEpoch(), rotation});
 }
 
 // ============ Session Query Methods ============
@@ -1020,7 +886,7 @@ QList<WatchSessionInfo> StatsManager::getSessionsForFile(const QString &filePath
     QList<WatchSessionInfo> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT ws.id, ws.file_id, fs.file_path, ws.started_at, ws.ended_at,
                ws.duration_ms, ws.cell_row, ws.cell_col, ws.hour_of_day, ws.day_of_week
@@ -1057,7 +923,7 @@ QList<WatchSessionInfo> StatsManager::getRecentSessions(int limit) const
     QList<WatchSessionInfo> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT ws.id, ws.file_id, fs.file_path, ws.started_at, ws.ended_at,
                ws.duration_ms, ws.cell_row, ws.cell_col, ws.hour_of_day, ws.day_of_week
@@ -1099,8 +965,8 @@ QList<HourlyStats> StatsManager::getHourlyDistribution() const
         result.append(stats);
     }
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT hour_of_day, SUM(duration_ms), COUNT(*) FROM watch_sessions GROUP BY hour_of_day")) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT hour_of_day, SUM(watch_ms), SUM(session_count) FROM rollup_hourly GROUP BY hour_of_day")) {
         while (query.next()) {
             int hour = query.value(0).toInt();
             if (hour >= 0 && hour < 24) {
@@ -1124,8 +990,8 @@ QList<DailyStats> StatsManager::getDailyDistribution() const
         result.append(stats);
     }
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT day_of_week, SUM(duration_ms), COUNT(*) FROM watch_sessions GROUP BY day_of_week")) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT day_of_week, SUM(watch_ms), SUM(session_count) FROM rollup_hourly GROUP BY day_of_week")) {
         while (query.next()) {
             int day = query.value(0).toInt();
             if (day >= 1 && day <= 7) {
@@ -1141,7 +1007,7 @@ qint64 StatsManager::getWatchTimeForDateRange(qint64 startMs, qint64 endMs) cons
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT COALESCE(SUM(duration_ms), 0) FROM watch_sessions WHERE started_at >= ? AND started_at <= ?");
     query.addBindValue(startMs);
     query.addBindValue(endMs);
@@ -1159,7 +1025,7 @@ QList<SkipEvent> StatsManager::getSkipEvents(const QString &filePath, int limit)
     QList<SkipEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (filePath.isEmpty()) {
         query.prepare(R"(
             SELECT se.id, se.file_id, fs.file_path, se.timestamp, se.from_position_ms, se.to_position_ms, se.skip_type
@@ -1203,7 +1069,7 @@ QList<LoopEvent> StatsManager::getLoopEvents(const QString &filePath, int limit)
     QList<LoopEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (filePath.isEmpty()) {
         query.prepare(R"(
             SELECT le.id, le.file_id, fs.file_path, le.timestamp, le.loop_enabled, le.loop_count
@@ -1246,7 +1112,7 @@ QList<RenameEvent> StatsManager::getRenameHistory(int limit) const
     QList<RenameEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT id, old_path, new_path, timestamp FROM rename_history ORDER BY timestamp DESC LIMIT ?");
     query.addBindValue(limit);
 
@@ -1268,7 +1134,7 @@ QList<PauseEvent> StatsManager::getPauseEvents(const QString &filePath, int limi
     QList<PauseEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (filePath.isEmpty()) {
         query.prepare(R"(
             SELECT pe.id, pe.file_id, fs.file_path, pe.timestamp, pe.position_ms, pe.pause_duration_ms, pe.is_pause
@@ -1312,7 +1178,7 @@ QList<VolumeEvent> StatsManager::getVolumeHistory(int limit) const
     QList<VolumeEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT id, timestamp, old_volume, new_volume, is_mute FROM volume_events ORDER BY timestamp DESC LIMIT ?");
     query.addBindValue(limit);
 
@@ -1335,7 +1201,7 @@ QList<ZoomEvent> StatsManager::getZoomEvents(const QString &filePath, int limit)
     QList<ZoomEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (filePath.isEmpty()) {
         query.prepare(R"(
             SELECT ze.id, ze.file_id, ze.timestamp, ze.zoom_level, ze.pan_x, ze.pan_y
@@ -1377,7 +1243,7 @@ QList<ScreenshotEvent> StatsManager::getScreenshotHistory(int limit) const
     QList<ScreenshotEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT se.id, se.file_id, fs.file_path, se.timestamp, se.position_ms, se.screenshot_path
         FROM screenshot_events se
@@ -1407,7 +1273,7 @@ QList<FullscreenEvent> StatsManager::getFullscreenHistory(int limit) const
     QList<FullscreenEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT id, timestamp, is_fullscreen, is_tile_fullscreen, cell_row, cell_col FROM fullscreen_events ORDER BY timestamp DESC LIMIT ?");
     query.addBindValue(limit);
 
@@ -1431,7 +1297,7 @@ QList<GridEvent> StatsManager::getGridHistory(int limit) const
     QList<GridEvent> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT id, timestamp, rows, cols, source_path, filter, is_start FROM grid_events ORDER BY timestamp DESC LIMIT ?");
     query.addBindValue(limit);
 
@@ -1455,7 +1321,7 @@ int StatsManager::getLoopCountForFile(const QString &filePath) const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare("SELECT loop_toggle_count FROM file_stats WHERE file_path = ?");
     query.addBindValue(filePath);
 
@@ -1473,7 +1339,7 @@ QList<CompletionStats> StatsManager::getCompletionStats(int limit) const
     if (!m_initialized) return result;
 
     // Calculate completion stats based on last_position_ms vs duration_ms
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT file_path,
                CASE WHEN duration_ms > 0 THEN (last_position_ms * 100.0 / duration_ms) ELSE 0 END as completion_pct,
@@ -1511,34 +1377,27 @@ QList<DirectoryStats> StatsManager::getDirectoryStats(int limit) const
     QList<DirectoryStats> result;
     if (!m_initialized) return result;
 
-    // Group stats by directory
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT file_path, total_watch_ms, play_count FROM file_stats WHERE total_watch_ms > 0")) {
-        QMap<QString, DirectoryStats> dirMap;
+    QSqlQuery query(connection());
+    query.prepare(R"(
+        SELECT d.id, d.path, r.watch_ms, r.file_count, r.play_count, r.session_count
+        FROM rollup_directories r
+        JOIN directories d ON d.id = r.directory_id
+        WHERE r.watch_ms > 0
+        ORDER BY r.watch_ms DESC
+        LIMIT ?
+    )");
+    query.addBindValue(limit);
 
+    if (query.exec()) {
         while (query.next()) {
-            QString path = query.value(0).toString();
-            QString dir = path.section('/', 0, -2);  // Get directory part
-
-            if (!dirMap.contains(dir)) {
-                DirectoryStats stats;
-                stats.directoryPath = dir;
-                dirMap[dir] = stats;
-            }
-
-            dirMap[dir].totalWatchMs += query.value(1).toLongLong();
-            dirMap[dir].fileCount++;
-            dirMap[dir].playCount += query.value(2).toInt();
-        }
-
-        // Sort by watch time and take top limit
-        QList<DirectoryStats> sorted = dirMap.values();
-        std::sort(sorted.begin(), sorted.end(), [](const DirectoryStats &a, const DirectoryStats &b) {
-            return a.totalWatchMs > b.totalWatchMs;
-        });
-
-        for (int i = 0; i < std::min(limit, static_cast<int>(sorted.size())); ++i) {
-            result.append(sorted[i]);
+            DirectoryStats stats;
+            stats.directoryId = query.value(0).toLongLong();
+            stats.directoryPath = query.value(1).toString();
+            stats.totalWatchMs = query.value(2).toLongLong();
+            stats.fileCount = query.value(3).toInt();
+            stats.playCount = query.value(4).toInt();
+            stats.sessionCount = query.value(5).toInt();
+            result.append(stats);
         }
     }
     return result;
@@ -1575,7 +1434,7 @@ TimeRangeStats StatsManager::getStatsForDateRange(qint64 startMs, qint64 endMs)
 
     if (!m_initialized) return stats;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
 
     // Watch time and sessions
     query.prepare("SELECT COALESCE(SUM(duration_ms), 0), COUNT(*), COUNT(DISTINCT file_id) FROM watch_sessions WHERE started_at >= ? AND started_at <= ?");
@@ -1587,12 +1446,30 @@ TimeRangeStats StatsManager::getStatsForDateRange(qint64 startMs, qint64 endMs)
         stats.fileCount = query.value(2).toInt();
     }
 
-    // Skip count
-    query.prepare("SELECT COUNT(*) FROM skip_events WHERE timestamp >= ? AND timestamp <= ?");
-    query.addBindValue(startMs);
-    query.addBindValue(endMs);
-    if (query.exec() && query.next()) {
-        stats.skipCount = query.value(0).toInt();
+    // Skip count. Raw skip rows older than kRawEventRetentionDays are
+    // compacted away, but rollup_daily keeps every day's count: days up to
+    // the compaction cutoff's (which may be partly compacted) come from the
+    // rollup, later ones from the raw rows
+    const qint64 rawFromMs = QDateTime::currentDateTime().addDays(-RollupConstants::kRawEventRetentionDays)
+                                 .date().addDays(1).startOfDay().toMSecsSinceEpoch();
+    if (startMs < rawFromMs) {
+        query.prepare(R"(
+            SELECT COALESCE(SUM(skip_count), 0) FROM rollup_daily
+            WHERE day >= date(? / 1000, 'unixepoch', 'localtime') AND day <= date(? / 1000, 'unixepoch', 'localtime')
+        )");
+        query.addBindValue(startMs);
+        query.addBindValue(std::min(endMs, rawFromMs - 1));
+        if (query.exec() && query.next()) {
+            stats.skipCount += query.value(0).toInt();
+        }
+    }
+    if (endMs >= rawFromMs) {
+        query.prepare("SELECT COUNT(*) FROM skip_events WHERE timestamp >= ? AND timestamp <= ?");
+        query.addBindValue(std::max(startMs, rawFromMs));
+        query.addBindValue(endMs);
+        if (query.exec() && query.next()) {
+            stats.skipCount += query.value(0).toInt();
+        }
     }
 
     // Loop count
@@ -1610,8 +1487,9 @@ double StatsManager::getAverageSessionLength() const
 {
     if (!m_initialized) return 0.0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT AVG(duration_ms) FROM watch_sessions WHERE duration_ms > 0") && query.next()) {
+    QSqlQuery query(connection());
+    // Sessions shorter than kMinSessionDurationMs are never stored, so all of them count
+    if (query.exec("SELECT SUM(watch_ms) * 1.0 / NULLIF(SUM(session_count), 0) FROM rollup_daily") && query.next()) {
         return query.value(0).toDouble();
     }
     return 0.0;
@@ -1621,8 +1499,8 @@ int StatsManager::getPeakHour() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT hour_of_day, SUM(duration_ms) as total FROM watch_sessions GROUP BY hour_of_day ORDER BY total DESC LIMIT 1") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT hour_of_day, SUM(watch_ms) as total FROM rollup_hourly GROUP BY hour_of_day ORDER BY total DESC LIMIT 1") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -1632,8 +1510,8 @@ int StatsManager::getPeakDayOfWeek() const
 {
     if (!m_initialized) return 1;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT day_of_week, SUM(duration_ms) as total FROM watch_sessions GROUP BY day_of_week ORDER BY total DESC LIMIT 1") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT day_of_week, SUM(watch_ms) as total FROM rollup_hourly GROUP BY day_of_week ORDER BY total DESC LIMIT 1") && query.next()) {
         return query.value(0).toInt();
     }
     return 1;
@@ -1643,8 +1521,8 @@ qint64 StatsManager::getLongestSession() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT MAX(duration_ms) FROM watch_sessions") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT MAX(longest_session_ms) FROM rollup_daily") && query.next()) {
         return query.value(0).toLongLong();
     }
     return 0;
@@ -1665,7 +1543,7 @@ double StatsManager::getAverageCompletionRate() const
 {
     if (!m_initialized) return 0.0;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (query.exec("SELECT AVG(CASE WHEN duration_ms > 0 THEN (last_position_ms * 100.0 / duration_ms) ELSE 0 END) FROM file_stats WHERE duration_ms > 0") && query.next()) {
         return query.value(0).toDouble();
     }
@@ -1676,8 +1554,8 @@ int StatsManager::getTotalScreenshots() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COUNT(*) FROM screenshot_events") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT COALESCE(SUM(screenshot_count), 0) FROM rollup_daily") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -1687,8 +1565,8 @@ int StatsManager::getTotalSkips() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COUNT(*) FROM skip_events") && query.next()) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT COALESCE(SUM(skip_count), 0) FROM rollup_daily") && query.next()) {
         return query.value(0).toInt();
     }
     return 0;
@@ -1698,8 +1576,12 @@ qint64 StatsManager::getTotalPauseTime() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT COALESCE(SUM(pause_duration_ms), 0) FROM pause_events WHERE pause_duration_ms > 0") && query.next()) {
+    QSqlQuery query(connection());
+    // Compacted rows were folded into rollup_daily
+    if (query.exec(R"(
+            SELECT (SELECT COALESCE(SUM(pause_ms), 0) FROM rollup_daily)
+                 + (SELECT COALESCE(SUM(pause_duration_ms), 0) FROM pause_events WHERE pause_duration_ms > 0)
+        )") && query.next()) {
         return query.value(0).toLongLong();
     }
     return 0;
@@ -1711,43 +1593,18 @@ bool StatsManager::exportSessionsToCsv(const QString &path) const
 {
     if (!m_initialized) return false;
 
-    QFile file(path);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        return false;
-    }
-
-    QTextStream out(&file);
-    out << "Session ID,File Path,Started At,Ended At,Duration (seconds),Cell Row,Cell Col,Hour of Day,Day of Week\n";
+    return StatsExport::run(connection(), {StatsExportRequest::Table::Sessions, StatsExportRequest::Format::Csv, path}).ok;
+}
 
-    QSqlQuery query(m_db);
-    if (query.exec(R"(
-        SELECT ws.id, fs.file_path, ws.started_at, ws.ended_at, ws.duration_ms,
-               ws.cell_row, ws.cell_col, ws.hour_of_day, ws.day_of_week
-        FROM watch_sessions ws
-        JOIN file_stats fs ON ws.file_id = fs.id
-        ORDER BY ws.started_at DESC
-    )")) {
-        while (query.next()) {
-            QString filePath = query.value(1).toString();
-            filePath.replace("\"", "\"\"");
-
-            qint64 startedAt = query.value(2).toLongLong();
-            qint64 endedAt = query.value(3).toLongLong();
-
-            out << query.value(0).toLongLong() << ","
-                << "\"" << filePath << "\","
-                << "\"" << QDateTime::fromMSecsSinceEpoch(startedAt).toString(Qt::ISODate) << "\","
-                << "\"" << QDateTime::fromMSecsSinceEpoch(endedAt).toString(Qt::ISODate) << "\","
-                << query.value(4).toLongLong() / 1000.0 << ","
-                << query.value(5).toInt() << ","
-                << query.value(6).toInt() << ","
-                << query.value(7).toInt() << ","
-                << query.value(8).toInt() << "\n";
+QFuture<StatsExportResult> StatsManager::exportAsync(const StatsExportRequest &request) const
+{
+    return StatsReader::runWithPromise<StatsExportResult>(m_reader, [this, request](QPromise<StatsExportResult> &promise) {
+        if (!m_initialized) {
+            promise.addResult(StatsExportResult{false, 0, "Statistics not initialized"});
+            return;
         }
-    }
-
-    file.close();
-    return true;
+        promise.addResult(StatsExport::run(connection(), request, &promise));
+    });
 }
 
 void StatsManager::clearAllStats()
@@ -1756,21 +1613,9 @@ void StatsManager::clearAllStats()
 
     stopAll();
 
-    QSqlQuery query(m_db);
-    query.exec("DELETE FROM watch_sessions");
-    query.exec("DELETE FROM skip_events");
-    query.exec("DELETE FROM loop_events");
-    query.exec("DELETE FROM pause_events");
-    query.exec("DELETE FROM volume_events");
-    query.exec("DELETE FROM zoom_events");
-    query.exec("DELETE FROM screenshot_events");
-    query.exec("DELETE FROM fullscreen_events");
-    query.exec("DELETE FROM grid_events");
-    query.exec("DELETE FROM rotation_events");
-    query.exec("DELETE FROM rename_history");
-    query.exec("DELETE FROM favorites");
-    query.exec("DELETE FROM position_samples");
-    query.exec("DELETE FROM file_stats");
+    // Behind everything already queued; readers see the empty tables afterwards
+    enqueue(StatsRecord::Statement::ClearAll, QString());
+    flushWrites();
 }
 
 // ============ Favorites Methods ============
@@ -1779,33 +1624,16 @@ void StatsManager::toggleFavorite(const QString &filePath)
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
-
-    QSqlQuery query(m_db);
-
-    // Check if already favorite
-    query.prepare("SELECT id FROM favorites WHERE file_id = ?");
-    query.addBindValue(fileId);
-
-    if (query.exec() && query.next()) {
-        // Remove from favorites
-        query.prepare("DELETE FROM favorites WHERE file_id = ?");
-        query.addBindValue(fileId);
-        query.exec();
-    } else {
-        // Add to favorites
-        query.prepare("INSERT INTO favorites (file_id) VALUES (?)");
-        query.addBindValue(fileId);
-        query.exec();
-    }
+    // Callers usually re-read isFavorite() right away
+    enqueue(StatsRecord::Statement::ToggleFavorite, filePath);
+    flushWrites();
 }
 
 bool StatsManager::isFavorite(const QString &filePath) const
 {
     if (!m_initialized) return false;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT f.id FROM favorites f
         JOIN file_stats fs ON f.file_id = fs.id
@@ -1821,7 +1649,7 @@ QList<FileStats> StatsManager::getFavorites() const
     QList<FileStats> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT fs.id, fs.file_path, fs.total_watch_ms, fs.play_count, fs.last_watched_at,
                fs.last_position_ms, fs.duration_ms, fs.is_image, f.added_at
@@ -1851,7 +1679,7 @@ int StatsManager::getFavoriteCount() const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     if (query.exec("SELECT COUNT(*) FROM favorites") && query.next()) {
         return query.value(0).toInt();
     }
@@ -1864,21 +1692,32 @@ void StatsManager::logPositionSample(const QString &filePath, double positionPct
 {
     if (!m_initialized || filePath.isEmpty()) return;
 
-    qint64 fileId = getOrCreateFileId(filePath, 0, false);
-    if (fileId < 0) return;
+    // Counted into the file's position histogram on the writer thread
+    enqueue(StatsRecord::Statement::PositionSample, filePath, {positionPct});
+}
 
-    // Bucket into 5% increments (0-100 in steps of 5 = 20 buckets)
-    int bucket = qBound(0, static_cast<int>(positionPct / 5) * 5, 100);
+QVector<quint32> StatsManager::readHistogram(const QString &filePath, StatsRollups::Histogram kind) const
+{
+    QSqlQuery query(connection());
+    if (filePath.isEmpty()) {
+        query.prepare("SELECT buckets FROM rollup_histograms WHERE file_id = ? AND kind = ?");
+        query.addBindValue(RollupConstants::kAllFiles);
+    } else {
+        query.prepare(R"(
+            SELECT h.buckets
+            FROM rollup_histograms h
+            JOIN file_stats fs ON h.file_id = fs.id
+            WHERE fs.file_path = ? AND h.kind = ?
+        )");
+        query.addBindValue(filePath);
+    }
+    query.addBindValue(static_cast<int>(kind));
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        INSERT INTO position_samples (file_id, position_pct, timestamp)
-        VALUES (?, ?, ?)
-    )");
-    query.addBindValue(fileId);
-    query.addBindValue(bucket);
-    query.addBindValue(QDateTime::currentMSecsSinceEpoch());
-    query.exec();
+    QByteArray blob;
+    if (query.exec() && query.next()) {
+        blob = query.value(0).toByteArray();
+    }
+    return StatsRollups::decodeHistogram(blob);
 }
 
 QMap<int, int> StatsManager::getPositionHeatmap(const QString &filePath) const
@@ -1891,25 +1730,10 @@ QMap<int, int> StatsManager::getPositionHeatmap(const QString &filePath) const
         result[i] = 0;
     }
 
-    QSqlQuery query(m_db);
-    if (filePath.isEmpty()) {
-        query.prepare("SELECT position_pct, COUNT(*) as cnt FROM position_samples GROUP BY position_pct");
-    } else {
-        query.prepare(R"(
-            SELECT ps.position_pct, COUNT(*) as cnt
-            FROM position_samples ps
-            JOIN file_stats fs ON ps.file_id = fs.id
-            WHERE fs.file_path = ?
-            GROUP BY ps.position_pct
-        )");
-        query.addBindValue(filePath);
-    }
-
-    if (query.exec()) {
-        while (query.next()) {
-            int pct = query.value(0).toInt();
-            result[pct] = query.value(1).toInt();
-        }
+    // 1% histogram buckets folded into the 5% steps callers expect
+    const QVector<quint32> counts = readHistogram(filePath, StatsRollups::Histogram::Position);
+    for (int i = 0; i < counts.size(); ++i) {
+        result[i / 5 * 5] += static_cast<int>(counts.at(i));
     }
     return result;
 }
@@ -1921,29 +1745,14 @@ QMap<int, qint64> StatsManager::getSessionLengthDistribution() const
     QMap<int, qint64> result;
     if (!m_initialized) return result;
 
-    // Buckets: <30s, 30s-1m, 1-2m, 2-5m, 5-10m, 10-30m, 30m-1h, >1h
-    result[0] = 0;    // <30s
-    result[30] = 0;   // 30s-1m
-    result[60] = 0;   // 1-2m
-    result[120] = 0;  // 2-5m
-    result[300] = 0;  // 5-10m
-    result[600] = 0;  // 10-30m
-    result[1800] = 0; // 30m-1h
-    result[3600] = 0; // >1h
+    for (int bucket : RollupConstants::kSessionLengthBuckets) {
+        result[bucket] = 0;
+    }
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT duration_ms FROM watch_sessions WHERE duration_ms > 0")) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT bucket_sec, session_count FROM rollup_session_lengths")) {
         while (query.next()) {
-            qint64 durationSec = query.value(0).toLongLong() / 1000;
-
-            if (durationSec < 30) result[0]++;
-            else if (durationSec < 60) result[30]++;
-            else if (durationSec < 120) result[60]++;
-            else if (durationSec < 300) result[120]++;
-            else if (durationSec < 600) result[300]++;
-            else if (durationSec < 1800) result[600]++;
-            else if (durationSec < 3600) result[1800]++;
-            else result[3600]++;
+            result[query.value(0).toInt()] = query.value(1).toLongLong();
         }
     }
     return result;
@@ -1954,8 +1763,8 @@ QPair<qint64, qint64> StatsManager::getFileTypeBreakdown() const
     QPair<qint64, qint64> result{0, 0}; // video_ms, image_ms
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT is_image, SUM(total_watch_ms) FROM file_stats GROUP BY is_image")) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT is_image, watch_ms FROM rollup_file_types")) {
         while (query.next()) {
             if (query.value(0).toBool()) {
                 result.second = query.value(1).toLongLong(); // images
@@ -1972,8 +1781,8 @@ QMap<QString, int> StatsManager::getSkipTypeBreakdown() const
     QMap<QString, int> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
-    if (query.exec("SELECT skip_type, COUNT(*) FROM skip_events GROUP BY skip_type")) {
+    QSqlQuery query(connection());
+    if (query.exec("SELECT skip_type, skip_count FROM rollup_skip_types")) {
         while (query.next()) {
             result[query.value(0).toString()] = query.value(1).toInt();
         }
@@ -1991,20 +1800,9 @@ QMap<int, int> StatsManager::getSkipPositionHeatmap() const
         result[i] = 0;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        SELECT
-            CAST(se.from_position_ms * 100.0 / fs.duration_ms AS INTEGER) / 10 * 10 as bucket
-        FROM skip_events se
-        JOIN file_stats fs ON se.file_id = fs.id
-        WHERE fs.duration_ms > 0
-    )");
-
-    if (query.exec()) {
-        while (query.next()) {
-            int bucket = qBound(0, query.value(0).toInt(), 100);
-            result[bucket]++;
-        }
+    const QVector<quint32> counts = readHistogram(QString(), StatsRollups::Histogram::Skip);
+    for (int i = 0; i < counts.size(); ++i) {
+        result[i / 10 * 10] += static_cast<int>(counts.at(i));
     }
     return result;
 }
@@ -2014,7 +1812,7 @@ int StatsManager::getMaxConcurrentCells() const
     if (!m_initialized) return 0;
 
     // Find max overlapping sessions
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT MAX(concurrent) FROM (
             SELECT COUNT(*) as concurrent
@@ -2035,13 +1833,12 @@ double StatsManager::getAverageConcurrentCells() const
     if (!m_initialized) return 1.0;
 
     // Simple estimate: total accumulated / real elapsed
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT
-            COALESCE(SUM(duration_ms), 0) as total,
-            (MAX(ended_at) - MIN(started_at)) as elapsed
-        FROM watch_sessions
-        WHERE started_at > 0
+            COALESCE(SUM(watch_ms), 0) as total,
+            (MAX(last_end) - MIN(first_start)) as elapsed
+        FROM rollup_daily
     )");
 
     if (query.exec() && query.next()) {
@@ -2059,17 +1856,15 @@ QList<QPair<QString, qint64>> StatsManager::getWeeklyTrend(int weeks) const
     QList<QPair<QString, qint64>> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
-        SELECT
-            strftime('%Y-W%W', started_at / 1000, 'unixepoch', 'localtime') as week,
-            SUM(duration_ms) as total
-        FROM watch_sessions
-        WHERE started_at >= ?
+        SELECT strftime('%Y-W%W', day) as week, SUM(watch_ms) as total
+        FROM rollup_daily
+        WHERE day >= ?
         GROUP BY week
         ORDER BY week
     )");
-    query.addBindValue(QDateTime::currentDateTime().addDays(-weeks * 7).toMSecsSinceEpoch());
+    query.addBindValue(QDate::currentDate().addDays(-weeks * 7).toString(Qt::ISODate));
 
     if (query.exec()) {
         while (query.next()) {
@@ -2084,17 +1879,15 @@ QList<QPair<QString, qint64>> StatsManager::getMonthlyTrend(int months) const
     QList<QPair<QString, qint64>> result;
     if (!m_initialized) return result;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
-        SELECT
-            strftime('%Y-%m', started_at / 1000, 'unixepoch', 'localtime') as month,
-            SUM(duration_ms) as total
-        FROM watch_sessions
-        WHERE started_at >= ?
+        SELECT substr(day, 1, 7) as month, SUM(watch_ms) as total
+        FROM rollup_daily
+        WHERE day >= ?
         GROUP BY month
         ORDER BY month
     )");
-    query.addBindValue(QDateTime::currentDateTime().addMonths(-months).toMSecsSinceEpoch());
+    query.addBindValue(QDate::currentDate().addMonths(-months).toString(Qt::ISODate));
 
     if (query.exec()) {
         while (query.next()) {
@@ -2116,21 +1909,7 @@ QMap<QString, TimeRangeStats> StatsManager::getDirectoryTimeAnalysis(int limit)
         TimeRangeStats stats;
         stats.totalWatchMs = dir.totalWatchMs;
         stats.fileCount = dir.fileCount;
-
-        // Get session count and other stats for this directory
-        QSqlQuery query(m_db);
-        query.prepare(R"(
-            SELECT COUNT(*), COUNT(DISTINCT ws.file_id)
-            FROM watch_sessions ws
-            JOIN file_stats fs ON ws.file_id = fs.id
-            WHERE fs.file_path LIKE ?
-        )");
-        query.addBindValue(dir.directoryPath + "/%");
-
-        if (query.exec() && query.next()) {
-            stats.sessionCount = query.value(0).toInt();
-        }
-
+        stats.sessionCount = dir.sessionCount;
         result[dir.directoryPath] = stats;
     }
     return result;
@@ -2140,7 +1919,7 @@ int StatsManager::getCompletionCount(double thresholdPct) const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         SELECT COUNT(*) FROM file_stats
         WHERE duration_ms > 0
@@ -2158,17 +1937,11 @@ int StatsManager::getEarlySkipCount(double thresholdPct) const
 {
     if (!m_initialized) return 0;
 
-    QSqlQuery query(m_db);
-    query.prepare(R"(
-        SELECT COUNT(*) FROM skip_events se
-        JOIN file_stats fs ON se.file_id = fs.id
-        WHERE fs.duration_ms > 0
-        AND (se.from_position_ms * 100.0 / fs.duration_ms) < ?
-    )");
-    query.addBindValue(thresholdPct);
-
-    if (query.exec() && query.next()) {
-        return query.value(0).toInt();
+    // Skips from the first thresholdPct percent of the file
+    const QVector<quint32> counts = readHistogram(QString(), StatsRollups::Histogram::Skip);
+    int result = 0;
+    for (int i = 0; i < counts.size() && i < thresholdPct; ++i) {
+        result += static_cast<int>(counts.at(i));
     }
-    return 0;
+    return result;
 }
@@ -7,6 +7,10 @@
 #include <QMap>
 #include <QElapsedTimer>
 #include <QList>
+#include <QVariantList>
+#include "statsexport.h"
+#include "statsreader.h"
+#include "statswriter.h"
 
 struct FileStats {
     qint64 id = -1;
@@ -137,10 +141,12 @@ struct CompletionStats {
 };
 
 struct DirectoryStats {
+    qint64 directoryId = 0;    // directories.id
     QString directoryPath;
     qint64 totalWatchMs = 0;
     int fileCount = 0;
     int playCount = 0;
+    int sessionCount = 0;
 };
 
 struct TimeRangeStats {
@@ -169,6 +175,17 @@ public:
     bool initialize();
     void shutdown();
     [[nodiscard]] bool isInitialized() const noexcept { return m_initialized; }
+    [[nodiscard]] static QString databasePath();
+
+    // Writes are queued for the writer thread; flushWrites() blocks until they are committed
+    void flushWrites();
+    [[nodiscard]] quint64 droppedWrites() const noexcept;  // Records lost to a full backlog
+    [[nodiscard]] int pendingWrites() const;               // Queued, not yet committed
+
+    // Runs fn on the read-only analytics thread; the getters it calls read
+    // through that connection, so a whole report costs the GUI thread nothing
+    template <typename Fn>
+    [[nodiscard]] auto runAnalytics(Fn fn) const { return StatsReader::run(m_reader, std::move(fn)); }
 
     // Watch tracking
     void startWatching(int row, int col, const QString &filePath,
@@ -207,7 +224,8 @@ public:
     void logGridEvent(int rows, int cols, const QString &sourcePath, const QString &filter, bool isStart);
     void logRotation(const QString &filePath, int rotation);
 
-    // Event queries
+    // Event queries. Skip, pause, volume and zoom lists only reach back
+    // kRawEventRetentionDays; their totals live on in rollup_daily
     [[nodiscard]] QList<SkipEvent> getSkipEvents(const QString &filePath = QString(), int limit = 100) const;
     [[nodiscard]] QList<LoopEvent> getLoopEvents(const QString &filePath = QString(), int limit = 100) const;
     [[nodiscard]] QList<RenameEvent> getRenameHistory(int limit = 100) const;
@@ -236,9 +254,10 @@ public:
     [[nodiscard]] int getTotalSkips() const;
     [[nodiscard]] qint64 getTotalPauseTime() const;
 
-    // Export/Clear
+    // Export/Clear; the CSV shortcuts block, exportAsync() streams on the analytics thread
     bool exportToCsv(const QString &path) const;
     bool exportSessionsToCsv(const QString &path) const;
+    [[nodiscard]] QFuture<StatsExportResult> exportAsync(const StatsExportRequest &request) const;
     void clearAllStats();
 
     // Favorites
@@ -274,7 +293,6 @@ private:
     StatsManager& operator=(const StatsManager&) = delete;
 
     struct WatchSession {
-        qint64 fileId = -1;
         QString filePath;
         qint64 startedAt = 0;
         QElapsedTimer elapsed;
@@ -289,12 +307,16 @@ private:
     };
 
     bool createTables();
-    qint64 getOrCreateFileId(const QString &filePath, double durationSec, bool isImage);
+    [[nodiscard]] QSqlDatabase connection() const;   // Reader connection on the reader thread, else m_db
+    [[nodiscard]] QVector<quint32> readHistogram(const QString &filePath, StatsRollups::Histogram kind) const;
+    void enqueue(StatsRecord::Statement statement, const QString &filePath, const QVariantList &values = {});
     void flushSession(const QString &cellKey);
     void periodicFlush();
     [[nodiscard]] QString cellKey(int row, int col) const;
 
     QSqlDatabase m_db;
+    StatsWriter *m_writer = nullptr;
+    StatsReader *m_reader = nullptr;
     QMap<QString, WatchSession> m_activeSessions;
     QTimer *m_flushTimer = nullptr;
     bool m_initialized = false;
@@ -0,0 +1,81 @@
+#include "statsreader.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+    const QString kConnectionName = QStringLiteral("stats_reader_connection");
+}
+
+StatsReader::StatsReader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+StatsReader::~StatsReader()
+{
+    stop();
+}
+
+bool StatsReader::isReaderThread() const noexcept
+{
+    return m_thread && QThread::currentThread() == m_thread;
+}
+
+QSqlDatabase StatsReader::database()
+{
+    return QSqlDatabase::database(kConnectionName, false);
+}
+
+void StatsReader::start(const QString &dbPath)
+{
+    if (m_thread) {
+        return;
+    }
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName("StatsReader");
+
+    m_context = new QObject;
+    m_context->moveToThread(m_thread);
+
+    m_thread->start(QThread::LowPriority);
+
+    // Queued first, so it runs before any job
+    QMetaObject::invokeMethod(m_context, [dbPath]() {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+        db.setDatabaseName(dbPath);
+        db.setConnectOptions(QString("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=%1")
+                                 .arg(StatsReaderConstants::kBusyTimeoutMs));
+        if (!db.open()) {
+            qWarning() << "Failed to open stats reader connection:" << db.lastError().text();
+            return;
+        }
+
+        // WAL is persistent, so snapshots here never block the writer
+        QSqlQuery pragma(db);
+        pragma.exec("PRAGMA query_only=1");
+    }, Qt::QueuedConnection);
+}
+
+void StatsReader::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_context, []() {
+        {
+            QSqlDatabase db = QSqlDatabase::database(kConnectionName, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(kConnectionName);
+    }, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+
+    delete m_context;
+    m_context = nullptr;
+    delete m_thread;
+    m_thread = nullptr;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QFuture>
+#include <QPromise>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace StatsReaderConstants {
+    inline constexpr int kBusyTimeoutMs = 5000;   // Checkpoints by the writer can briefly lock the WAL
+}
+
+// Read-only SQLite connection on a thread of its own, for analytics that are
+// too slow for the GUI thread. Jobs run one at a time in submission order;
+// StatsManager getters called from a job use this connection (see
+// StatsManager::connection()), so a job can just call them.
+class StatsReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatsReader(QObject *parent = nullptr);
+    ~StatsReader() override;
+
+    void start(const QString &dbPath);
+    void stop();    // Runs the jobs already queued, then closes the connection
+
+    [[nodiscard]] bool isRunning() const noexcept { return m_thread != nullptr; }
+    [[nodiscard]] bool isReaderThread() const noexcept;
+
+    // The reader connection; only valid on the reader thread
+    [[nodiscard]] static QSqlDatabase database();
+
+    // Runs fn on reader's thread, or inline if it isn't running
+    template <typename Fn>
+    static QFuture<std::invoke_result_t<Fn>> run(StatsReader *reader, Fn fn);
+
+    // As run(), for long jobs: fn(QPromise<T>&) adds its own result, reports
+    // progress and polls isCanceled(). Skipped if canceled while queued.
+    template <typename T, typename Fn>
+    static QFuture<T> runWithPromise(StatsReader *reader, Fn fn);
+
+private:
+    template <typename Job>
+    static void dispatch(StatsReader *reader, Job job);
+
+    QThread *m_thread = nullptr;
+    QObject *m_context = nullptr;   // Lives on m_thread; jobs are queued to it
+};
+
+template <typename Fn>
+QFuture<std::invoke_result_t<Fn>> StatsReader::run(StatsReader *reader, Fn fn)
+{
+    using Result = std::invoke_result_t<Fn>;
+
+    auto promise = std::make_shared<QPromise<Result>>();
+    QFuture<Result> future = promise->future();
+    promise->start();
+
+    auto job = [promise, fn = std::move(fn)]() mutable {
+        if constexpr (std::is_void_v<Result>) {
+            fn();
+        } else {
+            promise->addResult(fn());
+        }
+        promise->finish();
+    };
+
+    dispatch(reader, std::move(job));
+    return future;
+}
+
+template <typename T, typename Fn>
+QFuture<T> StatsReader::runWithPromise(StatsReader *reader, Fn fn)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+
+    dispatch(reader, [promise, fn = std::move(fn)]() mutable {
+        if (!promise->isCanceled()) {
+            fn(*promise);
+        }
+        promise->finish();
+    });
+    return future;
+}
+
+template <typename Job>
+void StatsReader::dispatch(StatsReader *reader, Job job)
+{
+    if (reader && reader->isRunning()) {
+        QMetaObject::invokeMethod(reader->m_context, std::move(job), Qt::QueuedConnection);
+    } else {
+        job();
+    }
+}
@@ -0,0 +1,664 @@
+#include "statsrollups.h"
+#include "statswriter.h"
+#include <QSqlError>
+#include <QStringList>
+#include <QtEndian>
+#include <QDebug>
+#include <utility>
+
+namespace {
+    constexpr const char *kTables[] = {
+        R"(CREATE TABLE IF NOT EXISTS rollup_hourly (
+            hour_of_day INTEGER NOT NULL,
+            day_of_week INTEGER NOT NULL,
+            watch_ms INTEGER DEFAULT 0,
+            session_count INTEGER DEFAULT 0,
+            PRIMARY KEY (hour_of_day, day_of_week)
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_daily (
+            day TEXT PRIMARY KEY,
+            watch_ms INTEGER DEFAULT 0,
+            session_count INTEGER DEFAULT 0,
+            longest_session_ms INTEGER DEFAULT 0,
+            first_start INTEGER,
+            last_end INTEGER,
+            skip_count INTEGER DEFAULT 0,
+            screenshot_count INTEGER DEFAULT 0,
+            pause_count INTEGER DEFAULT 0,
+            pause_ms INTEGER DEFAULT 0,
+            volume_change_count INTEGER DEFAULT 0,
+            mute_count INTEGER DEFAULT 0,
+            zoom_count INTEGER DEFAULT 0
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_directories (
+            directory_id INTEGER PRIMARY KEY REFERENCES directories(id),
+            watch_ms INTEGER DEFAULT 0,
+            file_count INTEGER DEFAULT 0,
+            play_count INTEGER DEFAULT 0,
+            session_count INTEGER DEFAULT 0
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_file_types (
+            is_image INTEGER PRIMARY KEY,
+            watch_ms INTEGER DEFAULT 0,
+            file_count INTEGER DEFAULT 0
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_session_lengths (
+            bucket_sec INTEGER PRIMARY KEY,
+            session_count INTEGER DEFAULT 0
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_skip_types (
+            skip_type TEXT PRIMARY KEY,
+            skip_count INTEGER DEFAULT 0
+        ))",
+        R"(CREATE TABLE IF NOT EXISTS rollup_histograms (
+            file_id INTEGER NOT NULL,
+            kind INTEGER NOT NULL,
+            buckets BLOB NOT NULL,
+            PRIMARY KEY (file_id, kind)
+        ))",
+    };
+
+    // Built by rebuild()
+    constexpr const char *kTotalsTables[] = {
+        "rollup_hourly", "rollup_daily", "rollup_directories", "rollup_file_types", "rollup_session_lengths",
+    };
+
+    // Built by rebuildHistograms() and foldPositionSamples()
+    constexpr const char *kHistogramTables[] = {
+        "rollup_skip_types", "rollup_histograms",
+    };
+
+    // Raw event tables trimmed by compact(). Skips feed rollup_daily, the skip
+    // types and histograms; pauses, volume changes and zooms keep per-day
+    // counts in rollup_daily, and compact() folds pause durations there first
+    constexpr const char *kCompactedTables[] = {
+        "skip_events", "pause_events", "volume_events", "zoom_events",
+    };
+
+    constexpr int kHistogramBytes = RollupConstants::kHistogramBuckets * static_cast<int>(sizeof(quint32));
+
+    // Local calendar day of a millisecond timestamp bound at ?
+    constexpr const char *kDayOf = "date(? / 1000, 'unixepoch', 'localtime')";
+
+    // rollup_daily columns added after the first release
+    constexpr const char *kDailyControlColumns[] = {
+        "pause_count", "pause_ms", "volume_change_count", "mute_count", "zoom_count",
+    };
+
+    // Per-day pause, volume and zoom counts from the raw rows still kept;
+    // used by the rebuild and when the columns are first added
+    void fillDailyControlCounts(QSqlQuery &query)
+    {
+        query.exec(R"(
+            INSERT INTO rollup_daily (day, pause_count, pause_ms)
+            SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d,
+                   SUM(is_pause), COALESCE(SUM(pause_duration_ms), 0)
+            FROM pause_events WHERE true GROUP BY d
+            ON CONFLICT(day) DO UPDATE SET pause_count = excluded.pause_count, pause_ms = excluded.pause_ms
+        )");
+        query.exec(R"(
+            INSERT INTO rollup_daily (day, volume_change_count, mute_count)
+            SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, COUNT(*), SUM(is_mute)
+            FROM volume_events WHERE true GROUP BY d
+            ON CONFLICT(day) DO UPDATE SET
+                volume_change_count = excluded.volume_change_count, mute_count = excluded.mute_count
+        )");
+        query.exec(R"(
+            INSERT INTO rollup_daily (day, zoom_count)
+            SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, COUNT(*)
+            FROM zoom_events WHERE true GROUP BY d
+            ON CONFLICT(day) DO UPDATE SET zoom_count = excluded.zoom_count
+        )");
+    }
+
+    // SQL twin of StatsRollups::sessionLengthBucket(), for the rebuild
+    QString sessionBucketSql(const QString &durationColumn)
+    {
+        const auto &buckets = RollupConstants::kSessionLengthBuckets;
+        QString sql = "CASE";
+        for (size_t i = buckets.size() - 1; i > 0; --i) {
+            sql += QString(" WHEN %1 >= %2 THEN %3").arg(durationColumn).arg(buckets[i] * 1000LL).arg(buckets[i]);
+        }
+        return sql + QString(" ELSE %1 END").arg(buckets[0]);
+    }
+}
+
+bool StatsRollups::createTables(QSqlQuery &query)
+{
+    for (const char *sql : kTables) {
+        if (!query.exec(QString::fromLatin1(sql))) {
+            qWarning() << "Failed to create rollup table:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // Older databases summarize skips and screenshots only; the raw rows
+    // still kept fill the new counts before compaction can drop them
+    QStringList dailyColumns;
+    if (query.exec("PRAGMA table_info(rollup_daily)")) {
+        while (query.next()) {
+            dailyColumns.append(query.value(1).toString());
+        }
+    }
+    if (!dailyColumns.contains(QLatin1String(kDailyControlColumns[0]))) {
+        for (const char *column : kDailyControlColumns) {
+            if (!query.exec(QString("ALTER TABLE rollup_daily ADD COLUMN %1 INTEGER DEFAULT 0").arg(QLatin1String(column)))) {
+                qWarning() << "Failed to add rollup_daily." << column << ":" << query.lastError().text();
+                return false;
+            }
+        }
+        fillDailyControlCounts(query);
+    }
+    return true;
+}
+
+QVector<quint32> StatsRollups::decodeHistogram(const QByteArray &blob)
+{
+    QVector<quint32> counts(RollupConstants::kHistogramBuckets, 0);
+    if (blob.size() != kHistogramBytes) {
+        return counts;
+    }
+    for (int i = 0; i < counts.size(); ++i) {
+        counts[i] = qFromLittleEndian<quint32>(blob.constData() + i * sizeof(quint32));
+    }
+    return counts;
+}
+
+QByteArray StatsRollups::encodeHistogram(const QVector<quint32> &counts)
+{
+    QByteArray blob(kHistogramBytes, Qt::Uninitialized);
+    for (int i = 0; i < counts.size(); ++i) {
+        qToLittleEndian<quint32>(counts.at(i), blob.data() + i * sizeof(quint32));
+    }
+    return blob;
+}
+
+int StatsRollups::sessionLengthBucket(qint64 durationMs)
+{
+    const qint64 seconds = durationMs / 1000;
+    int bucket = RollupConstants::kSessionLengthBuckets.front();
+    for (int lower : RollupConstants::kSessionLengthBuckets) {
+        if (seconds < lower) break;
+        bucket = lower;
+    }
+    return bucket;
+}
+
+void StatsRollups::prepare(const QSqlDatabase &db)
+{
+    m_db = db;
+
+    auto prepare = [this](QSqlQuery &query, const QString &sql) {
+        query = QSqlQuery(m_db);
+        if (!query.prepare(sql)) {
+            qWarning() << "Failed to prepare rollup statement:" << query.lastError().text();
+        }
+    };
+
+    prepare(m_hourQuery, R"(
+        INSERT INTO rollup_hourly (hour_of_day, day_of_week, watch_ms, session_count) VALUES (?, ?, ?, 1)
+        ON CONFLICT(hour_of_day, day_of_week) DO UPDATE SET
+            watch_ms = watch_ms + excluded.watch_ms, session_count = session_count + 1
+    )");
+    prepare(m_daySessionQuery, QString(R"(
+        INSERT INTO rollup_daily (day, watch_ms, session_count, longest_session_ms, first_start, last_end)
+        VALUES (%1, ?, 1, ?, ?, ?)
+        ON CONFLICT(day) DO UPDATE SET
+            watch_ms = watch_ms + excluded.watch_ms,
+            session_count = session_count + 1,
+            longest_session_ms = MAX(longest_session_ms, excluded.longest_session_ms),
+            first_start = MIN(COALESCE(first_start, excluded.first_start), excluded.first_start),
+            last_end = MAX(COALESCE(last_end, excluded.last_end), excluded.last_end)
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_daySkipQuery, QString(R"(
+        INSERT INTO rollup_daily (day, skip_count) VALUES (%1, 1)
+        ON CONFLICT(day) DO UPDATE SET skip_count = skip_count + 1
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_dayScreenshotQuery, QString(R"(
+        INSERT INTO rollup_daily (day, screenshot_count) VALUES (%1, 1)
+        ON CONFLICT(day) DO UPDATE SET screenshot_count = screenshot_count + 1
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_dayPauseQuery, QString(R"(
+        INSERT INTO rollup_daily (day, pause_count) VALUES (%1, ?)
+        ON CONFLICT(day) DO UPDATE SET pause_count = pause_count + excluded.pause_count
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_dayVolumeQuery, QString(R"(
+        INSERT INTO rollup_daily (day, volume_change_count, mute_count) VALUES (%1, 1, ?)
+        ON CONFLICT(day) DO UPDATE SET
+            volume_change_count = volume_change_count + 1, mute_count = mute_count + excluded.mute_count
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_dayZoomQuery, QString(R"(
+        INSERT INTO rollup_daily (day, zoom_count) VALUES (%1, 1)
+        ON CONFLICT(day) DO UPDATE SET zoom_count = zoom_count + 1
+    )").arg(QLatin1String(kDayOf)));
+    prepare(m_sessionLengthQuery, R"(
+        INSERT INTO rollup_session_lengths (bucket_sec, session_count) VALUES (?, 1)
+        ON CONFLICT(bucket_sec) DO UPDATE SET session_count = session_count + 1
+    )");
+    prepare(m_fileTypeWatchQuery, R"(
+        INSERT INTO rollup_file_types (is_image, watch_ms) SELECT is_image, ? FROM file_stats WHERE id = ?
+        ON CONFLICT(is_image) DO UPDATE SET watch_ms = watch_ms + excluded.watch_ms
+    )");
+    prepare(m_fileTypeCountQuery, R"(
+        INSERT INTO rollup_file_types (is_image, file_count) VALUES (?, 1)
+        ON CONFLICT(is_image) DO UPDATE SET file_count = file_count + 1
+    )");
+    // Only files with watch time count, as in the directory views
+    prepare(m_directoryQuery, R"(
+        INSERT INTO rollup_directories (directory_id, watch_ms, file_count, play_count)
+        SELECT ?, COALESCE(SUM(total_watch_ms), 0), COUNT(*), COALESCE(SUM(play_count), 0)
+        FROM file_stats WHERE directory_id = ? AND total_watch_ms > 0
+        ON CONFLICT(directory_id) DO UPDATE SET
+            watch_ms = excluded.watch_ms, file_count = excluded.file_count, play_count = excluded.play_count
+    )");
+    prepare(m_directorySessionsQuery, R"(
+        INSERT INTO rollup_directories (directory_id, session_count) VALUES (?, ?)
+        ON CONFLICT(directory_id) DO UPDATE SET session_count = session_count + excluded.session_count
+    )");
+    prepare(m_fileSessionsQuery, "SELECT COUNT(*) FROM watch_sessions WHERE file_id = ?");
+    prepare(m_fileSkipQuery, "UPDATE file_stats SET skip_count = skip_count + 1 WHERE id = ?");
+    prepare(m_fileDurationQuery, "SELECT duration_ms FROM file_stats WHERE id = ?");
+    prepare(m_skipTypeQuery, R"(
+        INSERT INTO rollup_skip_types (skip_type, skip_count) VALUES (?, 1)
+        ON CONFLICT(skip_type) DO UPDATE SET skip_count = skip_count + 1
+    )");
+    prepare(m_loadHistogramQuery, "SELECT buckets FROM rollup_histograms WHERE file_id = ? AND kind = ?");
+    prepare(m_storeHistogramQuery, "INSERT OR REPLACE INTO rollup_histograms (file_id, kind, buckets) VALUES (?, ?, ?)");
+}
+
+void StatsRollups::release()
+{
+    m_hourQuery = QSqlQuery();
+    m_daySessionQuery = QSqlQuery();
+    m_daySkipQuery = QSqlQuery();
+    m_dayScreenshotQuery = QSqlQuery();
+    m_dayPauseQuery = QSqlQuery();
+    m_dayVolumeQuery = QSqlQuery();
+    m_dayZoomQuery = QSqlQuery();
+    m_sessionLengthQuery = QSqlQuery();
+    m_fileTypeWatchQuery = QSqlQuery();
+    m_fileTypeCountQuery = QSqlQuery();
+    m_directoryQuery = QSqlQuery();
+    m_directorySessionsQuery = QSqlQuery();
+    m_fileSessionsQuery = QSqlQuery();
+    m_fileSkipQuery = QSqlQuery();
+    m_fileDurationQuery = QSqlQuery();
+    m_skipTypeQuery = QSqlQuery();
+    m_loadHistogramQuery = QSqlQuery();
+    m_storeHistogramQuery = QSqlQuery();
+    m_dirtyDirectories.clear();
+    m_histograms.clear();
+    m_db = QSqlDatabase();
+}
+
+void StatsRollups::apply(const StatsRecord &record, qint64 fileId, qint64 directoryId)
+{
+    using Statement = StatsRecord::Statement;
+    const QVariantList &v = record.values;
+
+    switch (record.statement) {
+    case Statement::WatchSession: {
+        // Values: started_at, ended_at, duration_ms, cell_row, cell_col, hour_of_day, day_of_week
+        const qint64 durationMs = v.at(2).toLongLong();
+
+        m_hourQuery.addBindValue(v.at(5));
+        m_hourQuery.addBindValue(v.at(6));
+        m_hourQuery.addBindValue(durationMs);
+        m_hourQuery.exec();
+
+        m_daySessionQuery.addBindValue(v.at(0));
+        m_daySessionQuery.addBindValue(durationMs);
+        m_daySessionQuery.addBindValue(durationMs);
+        m_daySessionQuery.addBindValue(v.at(0));
+        m_daySessionQuery.addBindValue(v.at(1));
+        m_daySessionQuery.exec();
+
+        m_sessionLengthQuery.addBindValue(sessionLengthBucket(durationMs));
+        m_sessionLengthQuery.exec();
+
+        addDirectorySessions(directoryId, 1);
+        break;
+    }
+    case Statement::SessionProgress:
+    case Statement::SessionEnd:
+        // Watch time delta comes first
+        m_fileTypeWatchQuery.addBindValue(v.at(0));
+        m_fileTypeWatchQuery.addBindValue(fileId);
+        m_fileTypeWatchQuery.exec();
+        m_dirtyDirectories.insert(directoryId);
+        break;
+    case Statement::PlayCount:
+        m_dirtyDirectories.insert(directoryId);
+        break;
+    case Statement::SkipEvent: {
+        // Values: timestamp, from_position_ms, to_position_ms, skip_type
+        m_daySkipQuery.addBindValue(v.at(0));
+        m_daySkipQuery.exec();
+        m_skipTypeQuery.addBindValue(v.at(3));
+        m_skipTypeQuery.exec();
+        m_fileSkipQuery.addBindValue(fileId);
+        m_fileSkipQuery.exec();
+
+        qint64 durationMs = 0;
+        m_fileDurationQuery.addBindValue(fileId);
+        if (m_fileDurationQuery.exec() && m_fileDurationQuery.next()) {
+            durationMs = m_fileDurationQuery.value(0).toLongLong();
+        }
+        m_fileDurationQuery.finish();
+        addSkip(fileId, v.at(1).toLongLong(), durationMs);
+        break;
+    }
+    case Statement::PositionSample: {
+        // Values: position in percent of the duration
+        const int bucket = static_cast<int>(v.at(0).toDouble());
+        addToHistogram(fileId, Histogram::Position, bucket);
+        addToHistogram(RollupConstants::kAllFiles, Histogram::Position, bucket);
+        break;
+    }
+    case Statement::ScreenshotEvent:
+        m_dayScreenshotQuery.addBindValue(v.at(0));
+        m_dayScreenshotQuery.exec();
+        break;
+    case Statement::PauseEvent:
+        // Values: timestamp, position_ms, is_pause
+        m_dayPauseQuery.addBindValue(v.at(0));
+        m_dayPauseQuery.addBindValue(v.at(2).toBool() ? 1 : 0);
+        m_dayPauseQuery.exec();
+        break;
+    case Statement::VolumeEvent:
+        // Values: timestamp, old_volume, new_volume, is_mute
+        m_dayVolumeQuery.addBindValue(v.at(0));
+        m_dayVolumeQuery.addBindValue(v.at(3).toBool() ? 1 : 0);
+        m_dayVolumeQuery.exec();
+        break;
+    case Statement::ZoomEvent:
+        // Values: timestamp, zoom_level, pan_x, pan_y
+        m_dayZoomQuery.addBindValue(v.at(0));
+        m_dayZoomQuery.exec();
+        break;
+    default:
+        break;
+    }
+}
+
+void StatsRollups::addFile(bool isImage)
+{
+    m_fileTypeCountQuery.addBindValue(isImage ? 1 : 0);
+    m_fileTypeCountQuery.exec();
+}
+
+void StatsRollups::moveFile(qint64 fileId, qint64 fromDirectory, qint64 toDirectory)
+{
+    if (fromDirectory == toDirectory) {
+        return;
+    }
+
+    // Watch time and play counts follow from the recompute, sessions move explicitly
+    qint64 sessions = 0;
+    m_fileSessionsQuery.addBindValue(fileId);
+    if (m_fileSessionsQuery.exec() && m_fileSessionsQuery.next()) {
+        sessions = m_fileSessionsQuery.value(0).toLongLong();
+    }
+    m_fileSessionsQuery.finish();
+
+    if (sessions > 0) {
+        addDirectorySessions(fromDirectory, -sessions);
+        addDirectorySessions(toDirectory, sessions);
+    }
+    m_dirtyDirectories.insert(fromDirectory);
+    m_dirtyDirectories.insert(toDirectory);
+}
+
+void StatsRollups::addSkip(qint64 fileId, qint64 fromPositionMs, qint64 durationMs)
+{
+    // Without a duration there is no position to put it at
+    if (durationMs <= 0) {
+        return;
+    }
+    const int bucket = static_cast<int>(fromPositionMs * 100 / durationMs);
+    addToHistogram(fileId, Histogram::Skip, bucket);
+    addToHistogram(RollupConstants::kAllFiles, Histogram::Skip, bucket);
+}
+
+QVector<quint32>& StatsRollups::histogram(qint64 fileId, Histogram kind)
+{
+    const QPair<qint64, int> key(fileId, static_cast<int>(kind));
+    auto it = m_histograms.find(key);
+    if (it != m_histograms.end()) {
+        return it.value();
+    }
+
+    QByteArray blob;
+    m_loadHistogramQuery.addBindValue(fileId);
+    m_loadHistogramQuery.addBindValue(key.second);
+    if (m_loadHistogramQuery.exec() && m_loadHistogramQuery.next()) {
+        blob = m_loadHistogramQuery.value(0).toByteArray();
+    }
+    m_loadHistogramQuery.finish();
+    return m_histograms.insert(key, decodeHistogram(blob)).value();
+}
+
+void StatsRollups::addToHistogram(qint64 fileId, Histogram kind, int bucket)
+{
+    histogram(fileId, kind)[qBound(0, bucket, RollupConstants::kHistogramBuckets - 1)]++;
+}
+
+void StatsRollups::addDirectorySessions(qint64 directoryId, qint64 count)
+{
+    if (directoryId < 0) {
+        return;
+    }
+    m_directorySessionsQuery.addBindValue(directoryId);
+    m_directorySessionsQuery.addBindValue(count);
+    m_directorySessionsQuery.exec();
+}
+
+void StatsRollups::flush()
+{
+    for (auto it = m_histograms.cbegin(); it != m_histograms.cend(); ++it) {
+        m_storeHistogramQuery.addBindValue(it.key().first);
+        m_storeHistogramQuery.addBindValue(it.key().second);
+        m_storeHistogramQuery.addBindValue(encodeHistogram(it.value()));
+        if (!m_storeHistogramQuery.exec()) {
+            qWarning() << "Failed to store histogram:" << m_storeHistogramQuery.lastError().text();
+        }
+    }
+    m_histograms.clear();
+
+    for (qint64 directoryId : std::as_const(m_dirtyDirectories)) {
+        if (directoryId < 0) continue;
+        m_directoryQuery.addBindValue(directoryId);
+        m_directoryQuery.addBindValue(directoryId);
+        if (!m_directoryQuery.exec()) {
+            qWarning() << "Failed to update directory rollup:" << m_directoryQuery.lastError().text();
+        }
+    }
+    m_dirtyDirectories.clear();
+}
+
+void StatsRollups::clear()
+{
+    QSqlQuery query(m_db);
+    for (const char *table : kTotalsTables) {
+        query.exec(QString("DELETE FROM %1").arg(QLatin1String(table)));
+    }
+    for (const char *table : kHistogramTables) {
+        query.exec(QString("DELETE FROM %1").arg(QLatin1String(table)));
+    }
+    m_dirtyDirectories.clear();
+    m_histograms.clear();
+}
+
+void StatsRollups::rebuildIfEmpty()
+{
+    // Every tracked file is counted in rollup_file_types, so it is only
+    // empty next to a non-empty file_stats if the rollups are new
+    QSqlQuery query(m_db);
+    if (!query.exec(R"(
+            SELECT EXISTS (SELECT 1 FROM rollup_file_types), EXISTS (SELECT 1 FROM file_stats),
+                   EXISTS (SELECT 1 FROM rollup_histograms), EXISTS (SELECT 1 FROM skip_events),
+                   EXISTS (SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'position_samples')
+        )") || !query.next()) {
+        return;
+    }
+    const bool buildTotals = !query.value(0).toBool() && query.value(1).toBool();
+    const bool buildHistograms = !query.value(2).toBool() && query.value(3).toBool();
+    const bool foldSamples = query.value(4).toBool();
+    query.finish();
+    if (!buildTotals && !buildHistograms && !foldSamples) {
+        return;
+    }
+
+    m_db.transaction();
+    if (buildTotals) {
+        rebuild();
+    }
+    if (buildHistograms) {
+        rebuildHistograms();
+    }
+    if (foldSamples) {
+        foldPositionSamples();
+    }
+    flush();
+    if (!m_db.commit()) {
+        qWarning() << "Failed to build stats rollups:" << m_db.lastError().text();
+        m_db.rollback();
+        m_histograms.clear();
+        return;
+    }
+    qDebug() << "StatsRollups built from existing history";
+}
+
+void StatsRollups::rebuildHistograms()
+{
+    QSqlQuery query(m_db);
+    for (const char *table : kHistogramTables) {
+        query.exec(QString("DELETE FROM %1").arg(QLatin1String(table)));
+    }
+    m_histograms.clear();
+    query.exec(R"(
+        INSERT INTO rollup_skip_types (skip_type, skip_count)
+        SELECT skip_type, COUNT(*) FROM skip_events GROUP BY skip_type
+    )");
+
+    query.setForwardOnly(true);
+    if (query.exec(R"(
+            SELECT se.file_id, se.from_position_ms, fs.duration_ms
+            FROM skip_events se
+            JOIN file_stats fs ON se.file_id = fs.id
+        )")) {
+        while (query.next()) {
+            addSkip(query.value(0).toLongLong(), query.value(1).toLongLong(), query.value(2).toLongLong());
+        }
+    }
+}
+
+void StatsRollups::foldPositionSamples()
+{
+    // Legacy one-row-per-sample table, replaced by the position histograms
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (query.exec("SELECT file_id, position_pct FROM position_samples")) {
+        while (query.next()) {
+            const int bucket = query.value(1).toInt();
+            addToHistogram(query.value(0).toLongLong(), Histogram::Position, bucket);
+            addToHistogram(RollupConstants::kAllFiles, Histogram::Position, bucket);
+        }
+    }
+    query.finish();
+    query.exec("DROP TABLE position_samples");
+}
+
+void StatsRollups::compact(qint64 cutoffMs)
+{
+    QSqlQuery query(m_db);
+    int removed = 0;
+
+    m_db.transaction();
+
+    // Counts are rolled up as events arrive; durations only once they leave
+    query.prepare(R"(
+        INSERT INTO rollup_daily (day, pause_ms)
+        SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, SUM(pause_duration_ms)
+        FROM pause_events WHERE timestamp < ? AND pause_duration_ms > 0 GROUP BY d
+        ON CONFLICT(day) DO UPDATE SET pause_ms = pause_ms + excluded.pause_ms
+    )");
+    query.addBindValue(cutoffMs);
+    if (!query.exec()) {
+        qWarning() << "Failed to fold pause durations:" << query.lastError().text();
+        m_db.rollback();
+        return;
+    }
+
+    for (const char *table : kCompactedTables) {
+        query.prepare(QString("DELETE FROM %1 WHERE timestamp < ?").arg(QLatin1String(table)));
+        query.addBindValue(cutoffMs);
+        if (query.exec()) {
+            removed += query.numRowsAffected();
+        }
+    }
+    if (!m_db.commit()) {
+        qWarning() << "Failed to compact stats events:" << m_db.lastError().text();
+        m_db.rollback();
+        return;
+    }
+
+    if (removed > 0) {
+        qDebug() << "StatsRollups compacted" << removed << "raw events";
+    }
+}
+
+void StatsRollups::rebuild()
+{
+    QSqlQuery query(m_db);
+    for (const char *table : kTotalsTables) {
+        query.exec(QString("DELETE FROM %1").arg(QLatin1String(table)));
+    }
+    m_dirtyDirectories.clear();
+
+    query.exec(R"(
+        INSERT INTO rollup_hourly (hour_of_day, day_of_week, watch_ms, session_count)
+        SELECT hour_of_day, day_of_week, SUM(duration_ms), COUNT(*)
+        FROM watch_sessions GROUP BY hour_of_day, day_of_week
+    )");
+    query.exec(R"(
+        INSERT INTO rollup_daily (day, watch_ms, session_count, longest_session_ms, first_start, last_end)
+        SELECT date(started_at / 1000, 'unixepoch', 'localtime') AS d,
+               SUM(duration_ms), COUNT(*), MAX(duration_ms), MIN(started_at), MAX(ended_at)
+        FROM watch_sessions GROUP BY d
+    )");
+    query.exec(R"(
+        INSERT INTO rollup_daily (day, skip_count)
+        SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, COUNT(*)
+        FROM skip_events WHERE true GROUP BY d
+        ON CONFLICT(day) DO UPDATE SET skip_count = excluded.skip_count
+    )");
+    query.exec(R"(
+        INSERT INTO rollup_daily (day, screenshot_count)
+        SELECT date(timestamp / 1000, 'unixepoch', 'localtime') AS d, COUNT(*)
+        FROM screenshot_events WHERE true GROUP BY d
+        ON CONFLICT(day) DO UPDATE SET screenshot_count = excluded.screenshot_count
+    )");
+    fillDailyControlCounts(query);
+    query.exec(QString(R"(
+        INSERT INTO rollup_session_lengths (bucket_sec, session_count)
+        SELECT %1 AS bucket, COUNT(*) FROM watch_sessions GROUP BY bucket
+    )").arg(sessionBucketSql("duration_ms")));
+    query.exec(R"(
+        INSERT INTO rollup_file_types (is_image, watch_ms, file_count)
+        SELECT is_image, COALESCE(SUM(total_watch_ms), 0), COUNT(*) FROM file_stats GROUP BY is_image
+    )");
+    query.exec(R"(
+        INSERT INTO rollup_directories (directory_id, watch_ms, file_count, play_count, session_count)
+        SELECT fs.directory_id,
+               SUM(CASE WHEN fs.total_watch_ms > 0 THEN fs.total_watch_ms ELSE 0 END),
+               SUM(fs.total_watch_ms > 0),
+               SUM(CASE WHEN fs.total_watch_ms > 0 THEN fs.play_count ELSE 0 END),
+               COALESCE(SUM(ws.sessions), 0)
+        FROM file_stats fs
+        LEFT JOIN (SELECT file_id, COUNT(*) AS sessions FROM watch_sessions GROUP BY file_id) ws
+            ON ws.file_id = fs.id
+        WHERE fs.directory_id IS NOT NULL
+        GROUP BY fs.directory_id
+    )");
+}
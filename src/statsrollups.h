@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVector>
+#include <array>
+
+struct StatsRecord;
+
+namespace RollupConstants {
+    // Lower bounds in seconds: <30s, 30s-1m, 1-2m, 2-5m, 5-10m, 10-30m, 30m-1h, >1h
+    inline constexpr std::array<int, 8> kSessionLengthBuckets = {0, 30, 60, 120, 300, 600, 1800, 3600};
+
+    inline constexpr int kHistogramBuckets = 100;            // 1% of the duration each
+    inline constexpr qint64 kAllFiles = 0;                   // rollup_histograms.file_id of the wall-wide row
+    inline constexpr int kRawEventRetentionDays = 90;        // Older skip/pause/volume/zoom rows are compacted
+    inline constexpr int kCompactionIntervalMs = 60 * 60 * 1000;
+}
+
+// Aggregates over the raw stats tables, kept current by StatsWriterWorker in
+// the same transaction as the events they summarize. Analytics read these
+// instead of re-scanning watch_sessions and the event tables:
+//   rollup_hourly           hour of day x day of week
+//   rollup_daily            local calendar day (timeline, trends, totals;
+//                           pause, volume and zoom counts)
+//   rollup_directories      directories.id
+//   rollup_file_types       video / image
+//   rollup_session_lengths  RollupConstants::kSessionLengthBuckets
+//   rollup_skip_types       skip_events.skip_type
+//   rollup_histograms       per-file and wall-wide position/skip histograms
+// Histograms are kHistogramBuckets little-endian quint32 counters in one
+// BLOB; a batch updates them in memory and writes each touched row once.
+class StatsRollups
+{
+public:
+    enum class Histogram {
+        Position = 0,   // Sampled playback positions
+        Skip = 1        // Positions skipped away from
+    };
+
+    // Schema; called from StatsManager::createTables()
+    static bool createTables(QSqlQuery &query);
+
+    [[nodiscard]] static int sessionLengthBucket(qint64 durationMs);
+    [[nodiscard]] static QVector<quint32> decodeHistogram(const QByteArray &blob);
+
+    void prepare(const QSqlDatabase &db);
+    void release();
+
+    // Writer thread, inside the batch transaction
+    void apply(const StatsRecord &record, qint64 fileId, qint64 directoryId);
+    void addFile(bool isImage);
+    void moveFile(qint64 fileId, qint64 fromDirectory, qint64 toDirectory);
+    void flush();   // Writes histograms and recomputes directories touched by this batch
+    void clear();
+
+    // Fills the rollups from the raw tables if they predate them
+    void rebuildIfEmpty();
+
+    // Deletes raw events older than cutoffMs after folding what is not yet
+    // rolled up (pause durations); their rollups stay
+    void compact(qint64 cutoffMs);
+
+private:
+    void rebuild();
+    void rebuildHistograms();
+    void foldPositionSamples();
+    void addDirectorySessions(qint64 directoryId, qint64 count);
+    void addToHistogram(qint64 fileId, Histogram kind, int bucket);
+    void addSkip(qint64 fileId, qint64 fromPositionMs, qint64 durationMs);
+    [[nodiscard]] QVector<quint32>& histogram(qint64 fileId, Histogram kind);
+    [[nodiscard]] static QByteArray encodeHistogram(const QVector<quint32> &counts);
+
+    QSqlDatabase m_db;
+    QSqlQuery m_hourQuery;
+    QSqlQuery m_daySessionQuery;
+    QSqlQuery m_daySkipQuery;
+    QSqlQuery m_dayScreenshotQuery;
+    QSqlQuery m_dayPauseQuery;
+    QSqlQuery m_dayVolumeQuery;
+    QSqlQuery m_dayZoomQuery;
+    QSqlQuery m_sessionLengthQuery;
+    QSqlQuery m_fileTypeWatchQuery;
+    QSqlQuery m_fileTypeCountQuery;
+    QSqlQuery m_directoryQuery;
+    QSqlQuery m_directorySessionsQuery;
+    QSqlQuery m_fileSessionsQuery;
+    QSqlQuery m_fileSkipQuery;
+    QSqlQuery m_fileDurationQuery;
+    QSqlQuery m_skipTypeQuery;
+    QSqlQuery m_loadHistogramQuery;
+    QSqlQuery m_storeHistogramQuery;
+
+    QSet<qint64> m_dirtyDirectories;
+    QHash<QPair<qint64, int>, QVector<quint32>> m_histograms;   // Touched by this batch
+};
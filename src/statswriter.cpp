@@ -0,0 +1,516 @@
+#include "statswriter.h"
+#include <QSqlError>
+#include <QMetaObject>
+#include <QDateTime>
+#include <QDebug>
+#include <iterator>
+#include <utility>
+
+namespace {
+    const QString kConnectionName = QStringLiteral("stats_writer_connection");
+
+    constexpr int kNoFileId = -1;      // Statement does not reference file_stats
+    constexpr int kAppendFileId = -2;  // File id is the last bind value (WHERE id = ?)
+
+    struct StatementSpec {
+        const char *sql;   // nullptr: handled in code
+        int fileIdBind;    // Bind position of the resolved file id
+    };
+
+    // Same order as StatsRecord::Statement
+    constexpr StatementSpec kStatements[] = {
+        {"INSERT INTO skip_events (file_id, timestamp, from_position_ms, to_position_ms, skip_type) "
+         "VALUES (?, ?, ?, ?, ?)", 0},
+        {"INSERT INTO loop_events (file_id, timestamp, loop_enabled, loop_count) VALUES (?, ?, ?, ?)", 0},
+        {"UPDATE file_stats SET loop_toggle_count = loop_toggle_count + 1 WHERE id = ?", kAppendFileId},
+        {"INSERT INTO rename_history (old_path, new_path, timestamp) VALUES (?, ?, ?)", kNoFileId},
+        {"UPDATE file_stats SET file_path = ? WHERE file_path = ?", kNoFileId},
+        {"INSERT INTO pause_events (file_id, timestamp, position_ms, is_pause) VALUES (?, ?, ?, ?)", 0},
+        {"INSERT INTO volume_events (timestamp, old_volume, new_volume, is_mute) VALUES (?, ?, ?, ?)", kNoFileId},
+        {"INSERT INTO zoom_events (file_id, timestamp, zoom_level, pan_x, pan_y) VALUES (?, ?, ?, ?, ?)", 0},
+        {"INSERT INTO screenshot_events (file_id, timestamp, position_ms, screenshot_path) VALUES (?, ?, ?, ?)", 0},
+        {"INSERT INTO fullscreen_events (timestamp, is_fullscreen, is_tile_fullscreen, cell_row, cell_col) "
+         "VALUES (?, ?, ?, ?, ?)", kNoFileId},
+        {"INSERT INTO grid_events (timestamp, rows, cols, source_path, filter, is_start) VALUES (?, ?, ?, ?, ?, ?)",
+         kNoFileId},
+        {"INSERT INTO rotation_events (file_id, timestamp, rotation) VALUES (?, ?, ?)", 0},
+        {nullptr, 0},   // PositionSample: only feeds the position histograms
+        {"UPDATE file_stats SET play_count = play_count + 1, last_watched_at = ?, updated_at = ? WHERE id = ?",
+         kAppendFileId},
+        {"UPDATE file_stats SET total_watch_ms = total_watch_ms + ?, last_position_ms = ?, updated_at = ? "
+         "WHERE id = ?", kAppendFileId},
+        {"UPDATE file_stats SET total_watch_ms = total_watch_ms + ?, last_position_ms = ?, last_watched_at = ?, "
+         "updated_at = ? WHERE id = ?", kAppendFileId},
+        {"INSERT INTO watch_sessions (file_id, started_at, ended_at, duration_ms, cell_row, cell_col, "
+         "hour_of_day, day_of_week) VALUES (?, ?, ?, ?, ?, ?, ?, ?)", 0},
+        {"DELETE FROM favorites WHERE file_id = ?", 0},   // Toggle: insert when nothing was deleted
+        {nullptr, kNoFileId},
+    };
+    static_assert(std::size(kStatements) == static_cast<size_t>(StatsRecord::Statement::Count),
+                  "kStatements must cover every StatsRecord::Statement");
+
+    const StatementSpec& specFor(StatsRecord::Statement statement)
+    {
+        return kStatements[static_cast<int>(statement)];
+    }
+}
+
+// ============ StatsWriterWorker ============
+
+StatsWriterWorker::StatsWriterWorker(std::mutex *mutex, QVector<StatsRecord> *queue)
+    : QObject(nullptr)
+    , m_mutex(mutex)
+    , m_queue(queue)
+{
+}
+
+StatsWriterWorker::~StatsWriterWorker()
+{
+    close();
+}
+
+void StatsWriterWorker::open(const QString &dbPath)
+{
+    if (m_db.isOpen()) {
+        return;
+    }
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
+    m_db.setDatabaseName(dbPath);
+
+    if (!m_db.open()) {
+        qWarning() << "Failed to open stats writer database:" << m_db.lastError().text();
+        return;
+    }
+
+    // Commits are batched, so the ordering guarantee of NORMAL is enough
+    QSqlQuery pragma(m_db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+    pragma.exec("PRAGMA busy_timeout=5000");
+
+    m_statements.resize(static_cast<int>(StatsRecord::Statement::Count));
+    for (int i = 0; i < m_statements.size(); ++i) {
+        const StatementSpec &spec = kStatements[i];
+        if (!spec.sql) continue;
+        m_statements[i] = QSqlQuery(m_db);
+        if (!m_statements[i].prepare(QString::fromLatin1(spec.sql))) {
+            qWarning() << "Failed to prepare stats statement:" << m_statements[i].lastError().text();
+        }
+    }
+
+    m_selectFileQuery = QSqlQuery(m_db);
+    m_selectFileQuery.prepare("SELECT id FROM file_stats WHERE file_path = ?");
+    m_insertFileQuery = QSqlQuery(m_db);
+    m_insertFileQuery.prepare("INSERT INTO file_stats (file_path, duration_ms, is_image, directory_id) "
+                              "VALUES (?, ?, ?, ?)");
+    m_insertDirectoryQuery = QSqlQuery(m_db);
+    m_insertDirectoryQuery.prepare("INSERT INTO directories (path) VALUES (?)");
+    m_updateDirectoryQuery = QSqlQuery(m_db);
+    m_updateDirectoryQuery.prepare("UPDATE file_stats SET directory_id = ? WHERE id = ?");
+    m_insertFavoriteQuery = QSqlQuery(m_db);
+    m_insertFavoriteQuery.prepare("INSERT INTO favorites (file_id) VALUES (?)");
+    m_rollups.prepare(m_db);
+
+    m_commitTimer = new QTimer(this);
+    m_commitTimer->setSingleShot(true);
+    m_commitTimer->setInterval(StatsWriterConstants::kCommitIntervalMs);
+    connect(m_commitTimer, &QTimer::timeout, this, &StatsWriterWorker::commit);
+
+    warmCaches();
+    backfillDirectories();
+    m_rollups.rebuildIfEmpty();
+
+    m_compactTimer = new QTimer(this);
+    m_compactTimer->setInterval(RollupConstants::kCompactionIntervalMs);
+    connect(m_compactTimer, &QTimer::timeout, this, &StatsWriterWorker::compact);
+    m_compactTimer->start();
+    compact();
+}
+
+void StatsWriterWorker::close()
+{
+    if (!m_db.isValid()) {
+        return;
+    }
+
+    // Whatever is still queued goes in with the last transaction
+    commit();
+
+    if (m_commitTimer) {
+        m_commitTimer->stop();
+    }
+    if (m_compactTimer) {
+        m_compactTimer->stop();
+    }
+    m_statements.clear();
+    m_selectFileQuery = QSqlQuery();
+    m_insertFileQuery = QSqlQuery();
+    m_insertDirectoryQuery = QSqlQuery();
+    m_updateDirectoryQuery = QSqlQuery();
+    m_insertFavoriteQuery = QSqlQuery();
+    m_rollups.release();
+    m_fileIds.clear();
+    m_directoryIds.clear();
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(kConnectionName);
+}
+
+void StatsWriterWorker::scheduleCommit()
+{
+    if (m_commitTimer && !m_commitTimer->isActive()) {
+        m_commitTimer->start();
+    }
+}
+
+void StatsWriterWorker::commit()
+{
+    if (m_commitTimer) {
+        m_commitTimer->stop();
+    }
+
+    QVector<StatsRecord> batch;
+    {
+        std::lock_guard<std::mutex> lock(*m_mutex);
+        batch.swap(*m_queue);
+    }
+    if (batch.isEmpty() || !m_db.isOpen()) {
+        return;
+    }
+
+    QStringList paths;
+    m_db.transaction();
+    for (const StatsRecord &record : std::as_const(batch)) {
+        if (execute(record) && record.notify) {
+            paths.append(record.filePath);
+        }
+    }
+    m_rollups.flush();
+    if (!m_db.commit()) {
+        qWarning() << "Failed to commit stats batch:" << m_db.lastError().text();
+        m_db.rollback();
+        // Ids handed out inside the batch point at rows that are gone now;
+        // the directory cache must stay complete, so reload both
+        m_fileIds.clear();
+        m_directoryIds.clear();
+        warmCaches();
+        return;
+    }
+
+    if (!paths.isEmpty()) {
+        emit committed(paths);
+    }
+}
+
+void StatsWriterWorker::compact()
+{
+    // Queued records land first so their rollups are in before raw rows go
+    commit();
+    const qint64 cutoff = QDateTime::currentDateTime()
+                              .addDays(-RollupConstants::kRawEventRetentionDays).toMSecsSinceEpoch();
+    m_rollups.compact(cutoff);
+}
+
+QString StatsWriterWorker::directoryOf(const QString &filePath)
+{
+    return filePath.section('/', 0, -2);
+}
+
+void StatsWriterWorker::warmCaches()
+{
+    QSqlQuery query(m_db);
+    if (query.exec("SELECT id, path FROM directories")) {
+        while (query.next()) {
+            m_directoryIds.insert(query.value(1).toString(), query.value(0).toLongLong());
+        }
+    }
+
+    // Files being watched again are mostly the recent ones
+    query.prepare("SELECT id, file_path FROM file_stats ORDER BY last_watched_at DESC LIMIT ?");
+    query.addBindValue(StatsWriterConstants::kWarmFileIds);
+    if (query.exec()) {
+        while (query.next()) {
+            m_fileIds.insert(query.value(1).toString(), query.value(0).toLongLong());
+        }
+    }
+}
+
+void StatsWriterWorker::backfillDirectories()
+{
+    // Rows written before directories were interned
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT id, file_path FROM file_stats WHERE directory_id IS NULL")) {
+        return;
+    }
+
+    int updated = 0;
+    m_db.transaction();
+    while (query.next()) {
+        const qint64 dirId = directoryId(query.value(1).toString());
+        if (dirId < 0) continue;
+        m_updateDirectoryQuery.addBindValue(dirId);
+        m_updateDirectoryQuery.addBindValue(query.value(0).toLongLong());
+        m_updateDirectoryQuery.exec();
+        ++updated;
+    }
+    m_db.commit();
+
+    if (updated > 0) {
+        qDebug() << "StatsWriter assigned directories to" << updated << "files";
+    }
+}
+
+qint64 StatsWriterWorker::directoryId(const QString &filePath)
+{
+    const QString dir = directoryOf(filePath);
+    auto it = m_directoryIds.constFind(dir);
+    if (it != m_directoryIds.cend()) {
+        return it.value();
+    }
+
+    // The cache holds every row, so a miss is a new directory
+    m_insertDirectoryQuery.addBindValue(dir);
+    if (!m_insertDirectoryQuery.exec()) {
+        qWarning() << "Failed to create directories entry:" << m_insertDirectoryQuery.lastError().text();
+        return -1;
+    }
+    const qint64 id = m_insertDirectoryQuery.lastInsertId().toLongLong();
+    m_directoryIds.insert(dir, id);
+    return id;
+}
+
+qint64 StatsWriterWorker::fileId(const StatsRecord &record)
+{
+    auto it = m_fileIds.constFind(record.filePath);
+    if (it != m_fileIds.cend()) {
+        return it.value();
+    }
+
+    if (m_fileIds.size() >= StatsWriterConstants::kMaxCachedFileIds) {
+        m_fileIds.clear();
+    }
+
+    qint64 id = -1;
+    m_selectFileQuery.addBindValue(record.filePath);
+    if (m_selectFileQuery.exec() && m_selectFileQuery.next()) {
+        id = m_selectFileQuery.value(0).toLongLong();
+    }
+    m_selectFileQuery.finish();
+
+    if (id < 0) {
+        const qint64 dirId = directoryId(record.filePath);
+        m_insertFileQuery.addBindValue(record.filePath);
+        m_insertFileQuery.addBindValue(static_cast<qint64>(record.durationSec * 1000));
+        m_insertFileQuery.addBindValue(record.isImage ? 1 : 0);
+        m_insertFileQuery.addBindValue(dirId >= 0 ? QVariant(dirId) : QVariant());
+        if (!m_insertFileQuery.exec()) {
+            qWarning() << "Failed to create file_stats entry:" << m_insertFileQuery.lastError().text();
+            return -1;
+        }
+        id = m_insertFileQuery.lastInsertId().toLongLong();
+        m_rollups.addFile(record.isImage);
+    }
+
+    m_fileIds.insert(record.filePath, id);
+    return id;
+}
+
+void StatsWriterWorker::renameFile(const QString &oldPath, const QString &newPath)
+{
+    // The row keeps its id; only the cache key and the directory move
+    qint64 id = m_fileIds.take(oldPath);
+    if (id == 0) {
+        m_selectFileQuery.addBindValue(newPath);
+        if (m_selectFileQuery.exec() && m_selectFileQuery.next()) {
+            id = m_selectFileQuery.value(0).toLongLong();
+        }
+        m_selectFileQuery.finish();
+        if (id == 0) return;
+    }
+    m_fileIds.insert(newPath, id);
+
+    const qint64 dirId = directoryId(newPath);
+    if (dirId >= 0) {
+        m_updateDirectoryQuery.addBindValue(dirId);
+        m_updateDirectoryQuery.addBindValue(id);
+        m_updateDirectoryQuery.exec();
+        m_rollups.moveFile(id, m_directoryIds.value(directoryOf(oldPath), -1), dirId);
+    }
+}
+
+bool StatsWriterWorker::execute(const StatsRecord &record)
+{
+    if (record.statement == StatsRecord::Statement::ClearAll) {
+        clearAll();
+        return true;
+    }
+
+    const StatementSpec &spec = specFor(record.statement);
+    qint64 id = -1;
+    if (spec.fileIdBind != kNoFileId) {
+        if (record.filePath.isEmpty() || (id = fileId(record)) < 0) {
+            return false;
+        }
+    }
+
+    if (record.statement == StatsRecord::Statement::ToggleFavorite) {
+        toggleFavorite(id);
+        return true;
+    }
+
+    if (!spec.sql) {
+        m_rollups.apply(record, id, directoryId(record.filePath));
+        return true;
+    }
+
+    QSqlQuery &query = m_statements[static_cast<int>(record.statement)];
+    for (int i = 0; i < record.values.size(); ++i) {
+        if (i == spec.fileIdBind) {
+            query.addBindValue(id);
+        }
+        query.addBindValue(record.values.at(i));
+    }
+    if (spec.fileIdBind == kAppendFileId || spec.fileIdBind == record.values.size()) {
+        query.addBindValue(id);
+    }
+
+    if (!query.exec()) {
+        qWarning() << "Failed to write stats record:" << query.lastError().text();
+        return false;
+    }
+
+    if (record.statement == StatsRecord::Statement::RenameFile && query.numRowsAffected() > 0) {
+        renameFile(record.values.at(1).toString(), record.values.at(0).toString());
+    }
+    m_rollups.apply(record, id, id >= 0 ? directoryId(record.filePath) : -1);
+    return true;
+}
+
+void StatsWriterWorker::toggleFavorite(qint64 fileId)
+{
+    QSqlQuery &remove = m_statements[static_cast<int>(StatsRecord::Statement::ToggleFavorite)];
+    remove.addBindValue(fileId);
+    if (remove.exec() && remove.numRowsAffected() > 0) {
+        return;
+    }
+
+    m_insertFavoriteQuery.addBindValue(fileId);
+    m_insertFavoriteQuery.exec();
+}
+
+void StatsWriterWorker::clearAll()
+{
+    QSqlQuery query(m_db);
+    query.exec("DELETE FROM watch_sessions");
+    query.exec("DELETE FROM skip_events");
+    query.exec("DELETE FROM loop_events");
+    query.exec("DELETE FROM pause_events");
+    query.exec("DELETE FROM volume_events");
+    query.exec("DELETE FROM zoom_events");
+    query.exec("DELETE FROM screenshot_events");
+    query.exec("DELETE FROM fullscreen_events");
+    query.exec("DELETE FROM grid_events");
+    query.exec("DELETE FROM rotation_events");
+    query.exec("DELETE FROM rename_history");
+    query.exec("DELETE FROM favorites");
+    query.exec("DELETE FROM file_stats");
+    query.exec("DELETE FROM directories");
+    m_rollups.clear();
+    m_fileIds.clear();
+    m_directoryIds.clear();
+}
+
+// ============ StatsWriter ============
+
+StatsWriter::StatsWriter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+StatsWriter::~StatsWriter()
+{
+    stop();
+}
+
+void StatsWriter::start(const QString &dbPath)
+{
+    if (m_thread) {
+        return;
+    }
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName("StatsWriter");
+
+    m_worker = new StatsWriterWorker(&m_mutex, &m_queue);
+    m_worker->moveToThread(m_thread);
+    connect(m_worker, &StatsWriterWorker::committed, this, &StatsWriter::committed);
+
+    m_thread->start(QThread::LowPriority);
+
+    QMetaObject::invokeMethod(m_worker, [worker = m_worker, dbPath]() {
+        worker->open(dbPath);
+    }, Qt::QueuedConnection);
+}
+
+void StatsWriter::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    // close() commits the backlog on the writer thread before returning
+    QMetaObject::invokeMethod(m_worker, &StatsWriterWorker::close, Qt::BlockingQueuedConnection);
+    m_thread->quit();
+    m_thread->wait();
+
+    delete m_worker;
+    m_worker = nullptr;
+    delete m_thread;
+    m_thread = nullptr;
+
+    const quint64 dropped = droppedCount();
+    if (dropped > 0) {
+        qWarning() << "StatsWriter dropped" << dropped << "records on overflow";
+    }
+}
+
+bool StatsWriter::enqueue(StatsRecord record)
+{
+    if (!m_thread) {
+        return false;
+    }
+
+    qsizetype size = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= StatsWriterConstants::kMaxBacklog) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_queue.append(std::move(record));
+        size = m_queue.size();
+    }
+
+    // The first record of a batch arms the timer; a full batch commits at once
+    if (size == 1) {
+        QMetaObject::invokeMethod(m_worker, &StatsWriterWorker::scheduleCommit, Qt::QueuedConnection);
+    } else if (size == StatsWriterConstants::kCommitBatch) {
+        QMetaObject::invokeMethod(m_worker, &StatsWriterWorker::commit, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void StatsWriter::flush()
+{
+    if (!m_thread) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_worker, &StatsWriterWorker::commit, Qt::BlockingQueuedConnection);
+}
+
+int StatsWriter::pending() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<int>(m_queue.size());
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "statsrollups.h"
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QThread>
+#include <QTimer>
+#include <QVariantList>
+#include <QVector>
+#include <QHash>
+#include <atomic>
+#include <mutex>
+
+namespace StatsWriterConstants {
+    inline constexpr int kMaxBacklog = 8192;        // Queued records; further ones are dropped and counted
+    inline constexpr int kCommitBatch = 256;        // Records that force a commit without waiting
+    inline constexpr int kCommitIntervalMs = 500;   // Longest a record waits for its commit
+    inline constexpr int kWarmFileIds = 4096;       // Most recently watched files resolved at open
+    inline constexpr int kMaxCachedFileIds = 65536; // The path -> id cache starts over beyond this
+}
+
+// One write against the stats database. Records naming a file get its
+// file_stats id resolved on the writer thread and bound at the statement's
+// file id slot (see kStatements in statswriter.cpp).
+struct StatsRecord {
+    enum class Statement {
+        SkipEvent,
+        LoopEvent,
+        LoopToggleCount,
+        RenameHistory,
+        RenameFile,         // Values: new path, old path
+        PauseEvent,
+        VolumeEvent,
+        ZoomEvent,
+        ScreenshotEvent,
+        FullscreenEvent,
+        GridEvent,
+        RotationEvent,
+        PositionSample,     // Values: position in percent
+        PlayCount,
+        SessionProgress,
+        SessionEnd,
+        WatchSession,
+        ToggleFavorite,
+        ClearAll,
+        Count
+    };
+
+    Statement statement = Statement::SkipEvent;
+    QString filePath;          // Resolves the file id; also reported by committed()
+    double durationSec = 0.0;  // Only used if the file row has to be created
+    bool isImage = false;
+    bool notify = false;       // Report filePath in committed()
+    QVariantList values;       // Bind values without the file id
+};
+
+// Lives on the stats writer thread with its own SQLite connection. Drains
+// the StatsWriter queue in one transaction per batch. File and directory
+// ids are cached here, so steady-state events never look them up.
+class StatsWriterWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    StatsWriterWorker(std::mutex *mutex, QVector<StatsRecord> *queue);
+    ~StatsWriterWorker() override;
+
+    // Directory part of a path, as stored in the directories table
+    [[nodiscard]] static QString directoryOf(const QString &filePath);
+
+public slots:
+    void open(const QString &dbPath);
+    void close();
+    void scheduleCommit();   // Commit within kCommitIntervalMs
+    void commit();           // Commit everything queued now
+    void compact();          // Drop raw events past the retention window
+
+signals:
+    void committed(const QStringList &paths);
+
+private:
+    void warmCaches();
+    void backfillDirectories();
+    [[nodiscard]] qint64 fileId(const StatsRecord &record);
+    [[nodiscard]] qint64 directoryId(const QString &filePath);
+    bool execute(const StatsRecord &record);
+    void renameFile(const QString &oldPath, const QString &newPath);
+    void toggleFavorite(qint64 fileId);
+    void clearAll();
+
+    std::mutex *m_mutex = nullptr;
+    QVector<StatsRecord> *m_queue = nullptr;
+    QSqlDatabase m_db;
+    QVector<QSqlQuery> m_statements;   // Indexed by StatsRecord::Statement
+    QSqlQuery m_selectFileQuery;
+    QSqlQuery m_insertFileQuery;
+    QSqlQuery m_insertDirectoryQuery;
+    QSqlQuery m_updateDirectoryQuery;
+    QSqlQuery m_insertFavoriteQuery;
+    QTimer *m_commitTimer = nullptr;
+    QTimer *m_compactTimer = nullptr;
+    StatsRollups m_rollups;
+
+    // Lookups on the write path; only misses touch SQLite
+    QHash<QString, qint64> m_fileIds;       // file_stats.file_path -> id
+    QHash<QString, qint64> m_directoryIds;  // directories.path -> id, complete
+};
+
+// Asynchronous, group-committing writer for StatsManager. enqueue() never
+// touches SQLite; a dedicated thread commits by size or time, so a burst of
+// events from a whole grid costs one WAL commit instead of one per event.
+class StatsWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StatsWriter(QObject *parent = nullptr);
+    ~StatsWriter() override;
+
+    void start(const QString &dbPath);
+    void stop();    // Commits the backlog, then closes the connection
+
+    // GUI thread; false if the backlog is full and the record was dropped
+    bool enqueue(StatsRecord record);
+
+    // Blocks until everything queued so far is committed
+    void flush();
+
+    [[nodiscard]] bool isRunning() const noexcept { return m_thread != nullptr; }
+    [[nodiscard]] int pending() const;
+    [[nodiscard]] quint64 droppedCount() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+signals:
+    void committed(const QStringList &paths);
+
+private:
+    QThread *m_thread = nullptr;
+    StatsWriterWorker *m_worker = nullptr;
+
+    mutable std::mutex m_mutex;
+    QVector<StatsRecord> m_queue;   // Guarded by m_mutex
+    std::atomic<quint64> m_dropped{0};
+};
@@ -0,0 +1,153 @@
+#include "stillimagecache.h"
+#include "filescanner.h"
+#include <QImageReader>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // Decoded by mpv, which plays the animation
+    const QSet<QString> kAnimatedExtensions = {"gif", "webp", "avif"};
+}
+
+StillImageCache& StillImageCache::instance()
+{
+    static StillImageCache instance;
+    return instance;
+}
+
+StillImageCache::StillImageCache()
+    : QObject(nullptr)
+    , m_memory(StillConstants::kMemoryBudgetKb)
+{
+    m_pool.setMaxThreadCount(StillConstants::kWorkerThreads);
+}
+
+StillImageCache::~StillImageCache()
+{
+    shutdown();
+}
+
+void StillImageCache::shutdown()
+{
+    m_shuttingDown = true;
+    m_queue.clear();
+    m_pool.waitForDone();
+    m_running.clear();
+}
+
+bool StillImageCache::handles(const QString &path)
+{
+    static const QList<QByteArray> supported = QImageReader::supportedImageFormats();
+
+    const QString ext = QFileInfo(path).suffix().toLower();
+    return FileScanner::imageExtensions().contains(ext) && !kAnimatedExtensions.contains(ext)
+        && supported.contains(ext.toLatin1());
+}
+
+QSize StillImageCache::bucket(const QSize &target) noexcept
+{
+    auto roundUp = [](int value) {
+        const int step = StillConstants::kSizeBucket;
+        return std::max(step, (value + step - 1) / step * step);
+    };
+    return QSize(roundUp(target.width()), roundUp(target.height()));
+}
+
+QString StillImageCache::Job::cacheKey() const
+{
+    return QString("%1x%2:%3").arg(size.width()).arg(size.height()).arg(path);
+}
+
+QPixmap StillImageCache::pixmap(const QString &path, const QSize &target) const
+{
+    const QPixmap *cached = m_memory.object(Job{path, bucket(target)}.cacheKey());
+    return cached ? *cached : QPixmap();
+}
+
+void StillImageCache::setWanted(const QObject *owner, const QStringList &paths, const QSize &target)
+{
+    if (m_shuttingDown || !owner) {
+        return;
+    }
+
+    if (!m_queue.hasOwner(owner)) {
+        connect(owner, &QObject::destroyed, this, [this, owner]() { m_queue.release(owner); });
+    }
+
+    const QSize size = bucket(target);
+    QList<Job> jobs;
+    jobs.reserve(paths.size());
+    for (const QString &path : paths) {
+        if (!path.isEmpty()) {
+            jobs.append(Job{path, size});
+        }
+    }
+    m_queue.setWanted(owner, jobs, [this](const QString &key) {
+        return m_memory.contains(key) || m_running.contains(key) || m_failed.contains(key);
+    });
+
+    dispatch();
+}
+
+void StillImageCache::dispatch()
+{
+    while (!m_shuttingDown && m_running.size() < StillConstants::kWorkerThreads && !m_queue.isEmpty()) {
+        const Job job = m_queue.takeFirst();
+        m_running.insert(job.cacheKey());
+
+        m_pool.start([this, job]() {
+            const QImage image = decode(job);
+            QMetaObject::invokeMethod(this, [this, job, image]() {
+                onJobFinished(job, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void StillImageCache::onJobFinished(const Job &job, const QImage &image)
+{
+    const QString key = job.cacheKey();
+    m_running.remove(key);
+
+    if (image.isNull()) {
+        m_failed.insert(key);
+        m_failedPaths.insert(job.path);
+        qWarning() << "StillImageCache: cannot decode" << job.path << "- handing it to mpv";
+        emit failed(job.path);
+    } else {
+        // The upload happens here, once, instead of on every paint
+        auto *pixmap = new QPixmap(QPixmap::fromImage(image));
+        const qsizetype cost = std::max<qsizetype>(1, static_cast<qsizetype>(image.sizeInBytes() / 1024));
+        m_memory.insert(key, pixmap, cost);
+        emit ready(job.path);
+    }
+
+    dispatch();
+}
+
+QImage StillImageCache::decode(const Job &job)
+{
+    QImageReader reader(job.path);
+    reader.setAutoTransform(true);
+
+    // Scaled size is in stored orientation, before the EXIF rotation
+    QSize target = job.size;
+    if (reader.transformation() & QImageIOHandler::TransformationRotate90) {
+        target.transpose();
+    }
+    const QSize size = reader.size();
+    if (size.isValid() && (size.width() > target.width() || size.height() > target.height())) {
+        reader.setScaledSize(size.scaled(target, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return {};
+    }
+
+    // Formats QPainter draws without converting
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                         : QImage::Format_RGB32);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QPixmap>
+#include <QImage>
+#include <QCache>
+#include <QSet>
+#include <QList>
+#include <QThreadPool>
+#include "wantedqueue.h"
+
+namespace StillConstants {
+    inline constexpr int kWorkerThreads = 2;
+    inline constexpr int kMemoryBudgetKb = 256 * 1024;  // Decoded stills across the grid
+    inline constexpr int kPrefetchDepth = 3;             // Stills decoded ahead per cell, the current one included
+    inline constexpr int kSizeBucket = 256;              // Decode sizes round up to this, so similar tiles share
+    inline constexpr double kMaxZoomDecodeScale = 4.0;   // Zoomed stills decode at most this much above tile size
+}
+
+// Decoded still images for the cells' fast path (MpvWidget hands stills to
+// a StillView instead of decoding them through mpv). Files are decoded on a
+// small pool with Qt's image plugins, scaled while decoding to the tile size
+// (libjpeg's DCT scaling for JPEG), and kept as pixmaps in an LRU.
+//
+// Cells declare their current and upcoming stills with setWanted(); the
+// newest request goes first and files nobody wants are dropped from the queue.
+class StillImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    [[nodiscard]] static StillImageCache& instance();
+
+    void shutdown();
+
+    // Stills only: animated formats, and any Qt has no plugin for, stay on mpv
+    [[nodiscard]] static bool handles(const QString &path);
+
+    // Null until decoded; never blocks
+    [[nodiscard]] QPixmap pixmap(const QString &path, const QSize &target) const;
+
+    // Qt could not decode it at some size; such files go to mpv instead
+    [[nodiscard]] bool hasFailed(const QString &path) const { return m_failedPaths.contains(path); }
+
+    // Current still first, then the prefetch ring. Replaces what owner wanted
+    // before; released when owner is destroyed.
+    void setWanted(const QObject *owner, const QStringList &paths, const QSize &target);
+
+signals:
+    void ready(const QString &path);
+    void failed(const QString &path);
+
+private:
+    struct Job {
+        QString path;
+        QSize size;     // Bucketed target
+        [[nodiscard]] QString cacheKey() const;
+    };
+
+    StillImageCache();
+    ~StillImageCache() override;
+    StillImageCache(const StillImageCache&) = delete;
+    StillImageCache& operator=(const StillImageCache&) = delete;
+
+    [[nodiscard]] static QSize bucket(const QSize &target) noexcept;
+    void dispatch();
+    void onJobFinished(const Job &job, const QImage &image);
+
+    [[nodiscard]] static QImage decode(const Job &job);   // Runs on the pool
+
+    QThreadPool m_pool;
+    QCache<QString, QPixmap> m_memory;
+    WantedQueue<Job> m_queue;
+    QSet<QString> m_running;     // cacheKey
+    QSet<QString> m_failed;      // No retries within a session
+    QSet<QString> m_failedPaths;
+    bool m_shuttingDown = false;
+};
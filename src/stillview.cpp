@@ -0,0 +1,138 @@
+#include "stillview.h"
+#include "stillimagecache.h"
+#include <QPainter>
+#include <QResizeEvent>
+#include <QImageReader>
+#include <QTransform>
+#include <QThreadPool>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QPointer>
+#include <QApplication>
+#include <QMetaObject>
+#include <algorithm>
+#include <cmath>
+
+StillView::StillView(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_TransparentForMouseEvents);   // Clicks and wheel go to the cell
+    connect(&StillImageCache::instance(), &StillImageCache::ready, this, &StillView::onReady);
+    hide();
+}
+
+void StillView::showStill(const QString &path)
+{
+    if (path == m_path) return;
+
+    m_path = path;
+    m_pixmap = QPixmap();
+    if (m_path.isEmpty()) {
+        StillImageCache::instance().setWanted(this, {}, QSize());
+        hide();
+        return;
+    }
+    fetch();
+    show();
+    raise();
+}
+
+void StillView::setTransform(double zoom, double panX, double panY, int rotation)
+{
+    const bool sharper = std::max(0.0, zoom) != std::max(0.0, m_zoom);
+    m_zoom = zoom;
+    m_panX = panX;
+    m_panY = panY;
+    m_rotation = ((rotation % 360) + 360) % 360;
+    if (sharper && !m_path.isEmpty()) {
+        fetch();   // Zoomed in: decode closer to the source size
+    }
+    update();
+}
+
+QSize StillView::targetSize() const
+{
+    const double zoomScale = std::min(std::pow(2.0, std::max(0.0, m_zoom)), StillConstants::kMaxZoomDecodeScale);
+    QSize target = size() * devicePixelRatioF() * zoomScale;
+    if (m_rotation == 90 || m_rotation == 270) {
+        target.transpose();   // Fitted before rotating, as painted
+    }
+    return target;
+}
+
+void StillView::saveScreenshot(const QString &dir)
+{
+    if (m_path.isEmpty()) return;
+
+    // Like mpv's %f-%P, with the wall clock instead of a playback time
+    const QString file = QDir(dir).filePath(QString("%1-%2.png")
+        .arg(QFileInfo(m_path).fileName(), QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss")));
+    const QString source = m_path;
+    const int rotation = m_rotation;
+    QPointer<StillView> self(this);
+
+    // Full-size decode; too slow for the GUI thread on large photos
+    QThreadPool::globalInstance()->start([self, source, file, rotation]() {
+        QImageReader reader(source);
+        reader.setAutoTransform(true);
+        QImage image = reader.read();
+        if (!image.isNull() && rotation != 0) {
+            image = image.transformed(QTransform().rotate(rotation));
+        }
+        const bool saved = !image.isNull() && QDir().mkpath(QFileInfo(file).absolutePath()) && image.save(file, "PNG");
+        QMetaObject::invokeMethod(qApp, [self, file, saved]() {   // The view may be gone by now
+            if (self) emit self->screenshotSaved(saved ? file : QString());
+        }, Qt::QueuedConnection);
+    });
+}
+
+void StillView::fetch()
+{
+    // Usually prefetched by the cell's playlist window; otherwise this is the request
+    const QPixmap pixmap = StillImageCache::instance().pixmap(m_path, targetSize());
+    if (!pixmap.isNull()) {
+        m_pixmap = pixmap;
+        update();
+    } else {
+        StillImageCache::instance().setWanted(this, {m_path}, targetSize());
+    }
+}
+
+void StillView::onReady(const QString &path)
+{
+    if (path == m_path && isVisible()) {
+        fetch();
+    }
+}
+
+void StillView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (!m_path.isEmpty()) {
+        fetch();   // Another size bucket; the old pixmap is scaled until it arrives
+    }
+}
+
+void StillView::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    if (m_pixmap.isNull()) return;
+
+    // Decoded near the tile size, so this is at most a small rescale. As in
+    // mpv: rotate, fit, scale by 2^zoom, then pan in units of the fitted size.
+    const bool sideways = m_rotation == 90 || m_rotation == 270;
+    QSizeF rotated = m_pixmap.deviceIndependentSize();
+    if (sideways) rotated.transpose();
+    const QSizeF fitted = rotated.scaled(size(), Qt::KeepAspectRatio) * std::pow(2.0, m_zoom);
+    QSizeF drawn = fitted;
+    if (sideways) drawn.transpose();
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.translate(width() / 2.0 + m_panX * fitted.width(), height() / 2.0 + m_panY * fitted.height());
+    painter.rotate(m_rotation);
+    const QRectF target(QPointF(-drawn.width() / 2.0, -drawn.height() / 2.0), drawn);
+    painter.drawPixmap(target, m_pixmap, QRectF(m_pixmap.rect()));
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QWidget>
+#include <QPixmap>
+#include <QString>
+
+// Draws a cell's current still from the StillImageCache, letterboxed like
+// mpv would. Shown over the cell's MpvWidget while the fast path has a still
+// up; mpv meanwhile only holds the playlist timing. Zoom, pan and rotation
+// stay mpv properties and are mirrored here, so the cell's controls work
+// on stills unchanged.
+class StillView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StillView(QWidget *parent = nullptr);
+
+    void showStill(const QString &path);   // Empty hides the view
+    [[nodiscard]] const QString& path() const noexcept { return m_path; }
+
+    // mpv's video-zoom (log2), video-pan-x/y (in displayed widths) and video-rotate
+    void setTransform(double zoom, double panX, double panY, int rotation);
+
+    // Full-size, rotated copy of the still as PNG in dir; async. Emits
+    // screenshotSaved() with the file, or an empty path on failure.
+    void saveScreenshot(const QString &dir);
+
+signals:
+    void screenshotSaved(const QString &file);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void onReady(const QString &path);
+    void fetch();
+    [[nodiscard]] QSize targetSize() const;   // Device pixels
+
+    QString m_path;
+    QPixmap m_pixmap;
+    double m_zoom = 0.0;
+    double m_panX = 0.0;
+    double m_panY = 0.0;
+    int m_rotation = 0;
+};
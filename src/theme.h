@@ -377,26 +377,26 @@ inline QString accentButtonStyle() {
 
 inline QString listWidgetStyle() {
     return QString(R"(
-        QListWidget {
+        QListView {
             background: %1;
             border: 1px solid %2;
             border-radius: %3px;
             color: %4;
             outline: none;
         }
-        QListWidget::item {
+        QListView::item {
             padding: 10px 14px;
             border: none;
             border-radius: %5px;
             margin: 2px 4px;
         }
-        QListWidget::item:selected {
+        QListView::item:selected {
             background: qlineargradient(x1:0, y1:0, x2:1, y2:0,
                 stop:0 rgba(0, 212, 255, 0.3), stop:1 rgba(180, 0, 255, 0.2));
             color: %6;
             border-left: 3px solid %7;
         }
-        QListWidget::item:hover:!selected {
+        QListView::item:hover:!selected {
             background: %8;
         }
     )").arg(Colors::Surface, Colors::GlassBorder, QString::number(Radius::MD),
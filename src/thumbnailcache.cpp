@@ -0,0 +1,313 @@
+#include "thumbnailcache.h"
+#include "filescanner.h"
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QPainter>
+#include <QMetaObject>
+#include <QDebug>
+#include <mpv/client.h>
+#include <algorithm>
+
+namespace {
+    bool isImage(const QString &path)
+    {
+        return FileScanner::imageExtensions().contains(QFileInfo(path).suffix().toLower());
+    }
+
+    bool saveImage(const QImage &image, const QString &path)
+    {
+        QDir().mkpath(QFileInfo(path).path());
+
+        // Readers (including the dashboard) never see a half-written file
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        if (!image.save(&file, "JPG", ThumbnailConstants::kJpegQuality)) {
+            file.cancelWriting();
+            return false;
+        }
+        return file.commit();
+    }
+}
+
+// ============ ThumbnailCache ============
+
+ThumbnailCache& ThumbnailCache::instance()
+{
+    static ThumbnailCache instance;
+    return instance;
+}
+
+ThumbnailCache::ThumbnailCache()
+    : QObject(nullptr)
+    , m_memory(ThumbnailConstants::kMemoryBudgetKb)
+{
+    m_pool.setMaxThreadCount(ThumbnailConstants::kWorkerThreads);
+    m_pool.setThreadPriority(QThread::LowPriority);
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    shutdown();
+}
+
+void ThumbnailCache::shutdown()
+{
+    m_shuttingDown = true;
+    m_queue.clear();
+    for (const auto &flag : std::as_const(m_running)) {
+        flag->store(true);
+    }
+    m_pool.waitForDone();
+    m_running.clear();
+}
+
+QString ThumbnailCache::storeDirectory()
+{
+    // Generic location so the dashboard finds it without knowing Qt's app paths
+    QString cachePath = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    return cachePath + "/goobert/thumbnails";
+}
+
+QString ThumbnailCache::keyFor(const QString &path, qint64 size, qint64 mtimeMs)
+{
+    // dashboard/app.py derives the same key from os.stat()
+    const QByteArray identity = path.toUtf8() + '\n' + QByteArray::number(size) + '\n' + QByteArray::number(mtimeMs);
+    return QString::fromLatin1(QCryptographicHash::hash(identity, QCryptographicHash::Sha1).toHex());
+}
+
+QString ThumbnailCache::storePath(const QString &key, Kind kind)
+{
+    const char *suffix = kind == Kind::Sprite ? ".sprite.jpg" : ".jpg";
+    return QString("%1/%2/%3%4").arg(storeDirectory(), key.left(2), key, QLatin1String(suffix));
+}
+
+QString ThumbnailCache::Job::cacheKey() const
+{
+    return (kind == Kind::Sprite ? QStringLiteral("s:") : QStringLiteral("t:")) + path;
+}
+
+QPixmap ThumbnailCache::pixmap(const QString &path, Kind kind) const
+{
+    const QPixmap *cached = m_memory.object(Job{path, kind}.cacheKey());
+    return cached ? *cached : QPixmap();
+}
+
+void ThumbnailCache::setWanted(const QObject *owner, const QStringList &paths, Kind kind)
+{
+    if (m_shuttingDown || !owner) {
+        return;
+    }
+
+    if (!m_queue.hasOwner(owner)) {
+        connect(owner, &QObject::destroyed, this, [this, owner]() { m_queue.release(owner); });
+    }
+
+    QList<Job> jobs;
+    jobs.reserve(paths.size());
+    for (const QString &path : paths) {
+        if (!path.isEmpty()) {
+            jobs.append(Job{path, kind});
+        }
+    }
+    m_queue.setWanted(owner, jobs, [this](const QString &key) {
+        return m_memory.contains(key) || m_running.contains(key) || m_failed.contains(key);
+    });
+
+    // Scrolled past: stop decoding what is no longer on screen
+    for (auto it = m_running.cbegin(); it != m_running.cend(); ++it) {
+        if (!m_queue.isWanted(it.key())) {
+            it.value()->store(true);
+        }
+    }
+
+    dispatch();
+}
+
+void ThumbnailCache::dispatch()
+{
+    while (!m_shuttingDown && m_running.size() < ThumbnailConstants::kWorkerThreads && !m_queue.isEmpty()) {
+        const Job job = m_queue.takeFirst();
+        auto cancelled = std::make_shared<std::atomic_bool>(false);
+        m_running.insert(job.cacheKey(), cancelled);
+
+        m_pool.start([this, job, cancelled]() {
+            const QImage image = produce(job, *cancelled);
+            QMetaObject::invokeMethod(this, [this, job, image]() {
+                onJobFinished(job, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void ThumbnailCache::onJobFinished(const Job &job, const QImage &image)
+{
+    const QString key = job.cacheKey();
+    const bool cancelled = m_running.value(key) && m_running.value(key)->load();
+    m_running.remove(key);
+
+    if (!image.isNull()) {
+        // Cost in KiB, matching the budget
+        auto *pixmap = new QPixmap(QPixmap::fromImage(image));
+        const qsizetype cost = std::max<qsizetype>(1, static_cast<qsizetype>(image.sizeInBytes() / 1024));
+        m_memory.insert(key, pixmap, cost);
+        emit ready(job.path, job.kind);
+    } else if (!cancelled) {
+        m_failed.insert(key);
+    } else if (m_queue.isWanted(key)) {
+        // Cancelled, then scrolled back to before the worker noticed
+        m_queue.prepend(job);
+    }
+
+    dispatch();
+}
+
+QImage ThumbnailCache::produce(const Job &job, const std::atomic_bool &cancelled)
+{
+    const QFileInfo fi(job.path);
+    if (!fi.isFile()) {
+        return {};
+    }
+
+    const QString file = storePath(keyFor(job.path, fi.size(), fi.lastModified().toMSecsSinceEpoch()), job.kind);
+    QImage image;
+    if (image.load(file)) {
+        return image;
+    }
+
+    if (isImage(job.path)) {
+        // Stills have nothing to spread a sprite over
+        if (job.kind == Kind::Sprite) {
+            return {};
+        }
+        QImageReader reader(job.path);
+        reader.setAutoTransform(true);
+        const QSize size = reader.size();
+        if (size.isValid()) {
+            reader.setScaledSize(size.scaled(ThumbnailConstants::kThumbWidth, ThumbnailConstants::kThumbHeight * 4,
+                                             Qt::KeepAspectRatio));
+        }
+        image = reader.read();
+    } else if (job.kind == Kind::Sprite) {
+        image = composeSprite(job.path, cancelled);
+    } else {
+        const QByteArray start = QByteArray::number(ThumbnailConstants::kThumbPosition * 100.0, 'f', 1) + '%';
+        image = grabFrame(job.path, start, ThumbnailConstants::kThumbWidth, cancelled);
+    }
+
+    if (!image.isNull() && !saveImage(image, file)) {
+        qWarning() << "ThumbnailCache: failed to store" << file;
+    }
+    return image;
+}
+
+QImage ThumbnailCache::grabFrame(const QString &path, const QByteArray &start, int width,
+                                 const std::atomic_bool &cancelled)
+{
+    QTemporaryDir outDir;
+    if (!outDir.isValid()) {
+        return {};
+    }
+
+    mpv_handle *mpv = mpv_create();
+    if (!mpv) {
+        return {};
+    }
+
+    // One decoded frame, written by vo=image; hardware decode copies back
+    // to system memory since the frame leaves the GPU anyway
+    const QByteArray outPath = outDir.path().toUtf8();
+    const QByteArray scale = QString("scale=w=%1:h=-2").arg(width).toUtf8();
+    mpv_set_option_string(mpv, "config", "no");
+    mpv_set_option_string(mpv, "terminal", "no");
+    mpv_set_option_string(mpv, "msg-level", "all=no");
+    mpv_set_option_string(mpv, "load-scripts", "no");
+    mpv_set_option_string(mpv, "osc", "no");
+    mpv_set_option_string(mpv, "idle", "no");
+    mpv_set_option_string(mpv, "audio", "no");
+    mpv_set_option_string(mpv, "sub", "no");
+    mpv_set_option_string(mpv, "hwdec", "auto-copy-safe");
+    mpv_set_option_string(mpv, "hr-seek", "no");   // Nearest keyframe is good enough for a preview
+    mpv_set_option_string(mpv, "start", start.constData());
+    mpv_set_option_string(mpv, "frames", "1");
+    mpv_set_option_string(mpv, "vf", scale.constData());
+    mpv_set_option_string(mpv, "vo", "image");
+    mpv_set_option_string(mpv, "vo-image-format", "jpg");
+    mpv_set_option_string(mpv, "vo-image-outdir", outPath.constData());
+
+    bool ok = mpv_initialize(mpv) >= 0;
+    if (ok) {
+        const QByteArray file = path.toUtf8();
+        const char *cmd[] = {"loadfile", file.constData(), nullptr};
+        ok = mpv_command(mpv, cmd) >= 0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (ok) {
+        if (cancelled.load(std::memory_order_relaxed) || timer.elapsed() > ThumbnailConstants::kGrabTimeoutMs) {
+            ok = false;
+            break;
+        }
+        const mpv_event *event = mpv_wait_event(mpv, 0.1);
+        if (event->event_id == MPV_EVENT_END_FILE || event->event_id == MPV_EVENT_SHUTDOWN) {
+            break;
+        }
+    }
+    mpv_terminate_destroy(mpv);
+
+    if (!ok) {
+        return {};
+    }
+
+    const QStringList frames = QDir(outDir.path()).entryList({"*.jpg"}, QDir::Files, QDir::Name);
+    QImage image;
+    if (!frames.isEmpty()) {
+        image.load(outDir.filePath(frames.first()));
+    }
+    return image;
+}
+
+QImage ThumbnailCache::composeSprite(const QString &path, const std::atomic_bool &cancelled)
+{
+    using namespace ThumbnailConstants;
+    const int frames = kSpriteColumns * kSpriteRows;
+
+    QImage sprite(kSpriteColumns * kThumbWidth, kSpriteRows * kThumbHeight, QImage::Format_RGB32);
+    sprite.fill(Qt::black);
+    QPainter painter(&sprite);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    int grabbed = 0;
+    for (int i = 0; i < frames; ++i) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            return {};
+        }
+
+        // Centre of each equal slice, so neither the intro nor the credits dominate
+        const double percent = (i + 0.5) * 100.0 / frames;
+        const QImage frame = grabFrame(path, QByteArray::number(percent, 'f', 1) + '%', kThumbWidth, cancelled);
+        if (frame.isNull()) {
+            continue;
+        }
+
+        const QRect slot((i % kSpriteColumns) * kThumbWidth, (i / kSpriteColumns) * kThumbHeight, kThumbWidth, kThumbHeight);
+        const QSize fitted = frame.size().scaled(slot.size(), Qt::KeepAspectRatio);
+        const QRect target(slot.x() + (slot.width() - fitted.width()) / 2,
+                           slot.y() + (slot.height() - fitted.height()) / 2,
+                           fitted.width(), fitted.height());
+        painter.drawImage(target, frame);
+        ++grabbed;
+    }
+    painter.end();
+
+    return grabbed > 0 ? sprite : QImage();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QPixmap>
+#include <QImage>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include "wantedqueue.h"
+
+namespace ThumbnailConstants {
+    inline constexpr int kThumbWidth = 160;           // 16:9 tiles; height follows the source aspect
+    inline constexpr int kThumbHeight = 90;
+    inline constexpr double kThumbPosition = 0.33;    // Matches the skipper default, so it looks like the wall
+    inline constexpr int kSpriteColumns = 3;
+    inline constexpr int kSpriteRows = 2;
+    inline constexpr int kWorkerThreads = 2;          // Each one runs a short-lived mpv decode
+    inline constexpr int kMemoryBudgetKb = 48 * 1024; // In-memory LRU of decoded pixmaps
+    inline constexpr int kGrabTimeoutMs = 10000;      // Give up on files that never produce a frame
+    inline constexpr int kJpegQuality = 85;
+}
+
+// Thumbnails and preview sprites for file lists. Images are stored on disk
+// under a key derived from path, size and mtime (see keyFor(), mirrored by
+// the dashboard), and decoded ones are kept in an in-memory LRU.
+//
+// Views declare what they currently show with setWanted(); the newest
+// request goes first, and work nobody wants any more is dropped or cancelled.
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Kind {
+        Thumbnail,
+        Sprite     // kSpriteColumns x kSpriteRows frames spread over the file
+    };
+
+    [[nodiscard]] static ThumbnailCache& instance();
+
+    void shutdown();
+
+    // Null until generated; never blocks
+    [[nodiscard]] QPixmap pixmap(const QString &path, Kind kind = Kind::Thumbnail) const;
+
+    // Replaces everything `owner` wanted before. Released when owner is destroyed.
+    void setWanted(const QObject *owner, const QStringList &paths, Kind kind = Kind::Thumbnail);
+
+    [[nodiscard]] static QString storeDirectory();
+    [[nodiscard]] static QString keyFor(const QString &path, qint64 size, qint64 mtimeMs);
+    [[nodiscard]] static QString storePath(const QString &key, Kind kind);
+
+signals:
+    void ready(const QString &path, ThumbnailCache::Kind kind);
+
+private:
+    struct Job {
+        QString path;
+        Kind kind = Kind::Thumbnail;
+        [[nodiscard]] QString cacheKey() const;
+    };
+
+    ThumbnailCache();
+    ~ThumbnailCache() override;
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    void dispatch();
+    void onJobFinished(const Job &job, const QImage &image);
+
+    // Run on the pool
+    [[nodiscard]] static QImage produce(const Job &job, const std::atomic_bool &cancelled);
+    [[nodiscard]] static QImage grabFrame(const QString &path, const QByteArray &start, int width,
+                                          const std::atomic_bool &cancelled);
+    [[nodiscard]] static QImage composeSprite(const QString &path, const std::atomic_bool &cancelled);
+
+    QThreadPool m_pool;
+    QCache<QString, QPixmap> m_memory;
+    WantedQueue<Job> m_queue;
+    QHash<QString, std::shared_ptr<std::atomic_bool>> m_running; // cacheKey -> cancel flag
+    QSet<QString> m_failed;                                      // No retries within a session
+    bool m_shuttingDown = false;
+};
@@ -54,7 +54,7 @@ void ToolBar::setupUi()
     // Grid config
     addWidget(new QLabel("Grid"));
     m_colsSpin = new QSpinBox();
-    m_colsSpin->setRange(1, 10);
+    m_colsSpin->setRange(1, ToolBarConstants::kMaxGridSize);
     m_colsSpin->setValue(cfg.defaultCols());
     m_colsSpin->setFixedWidth(42);
     m_colsSpin->setStyleSheet(inputStyle);
@@ -63,7 +63,7 @@ void ToolBar::setupUi()
     addWidget(new QLabel("x"));
 
     m_rowsSpin = new QSpinBox();
-    m_rowsSpin->setRange(1, 10);
+    m_rowsSpin->setRange(1, ToolBarConstants::kMaxGridSize);
     m_rowsSpin->setValue(cfg.defaultRows());
     m_rowsSpin->setFixedWidth(42);
     m_rowsSpin->setStyleSheet(inputStyle);
@@ -77,6 +77,7 @@ void ToolBar::setupUi()
     m_sourceEdit->setFixedWidth(200);
     m_sourceEdit->setStyleSheet(inputStyle);
     m_sourceEdit->setText(cfg.defaultMediaPath());
+    m_sourceEdit->setToolTip("Separate multiple sources with ;");
     addWidget(m_sourceEdit);
 
     auto *browseBtn = new QPushButton("..");
@@ -92,6 +93,7 @@ void ToolBar::setupUi()
     m_filterEdit = new QLineEdit();
     m_filterEdit->setFixedWidth(100);
     m_filterEdit->setPlaceholderText("AND");
+    m_filterEdit->setToolTip("Terms are AND-ed; -term excludes, \"quoted phrase\" matches spaces");
     m_filterEdit->setStyleSheet(inputStyle);
     addWidget(m_filterEdit);
 
@@ -234,3 +236,15 @@ int ToolBar::cols() const { return m_colsSpin->value(); }
 QString ToolBar::sourceDir() const { return m_sourceEdit->text(); }
 QString ToolBar::filter() const { return m_filterEdit->text().trimmed(); }
 void ToolBar::setSourceDir(const QString &dir) { m_sourceEdit->setText(dir); }
+void ToolBar::setGridSize(int rows, int cols) { m_rowsSpin->setValue(rows); m_colsSpin->setValue(cols); }
+
+QStringList ToolBar::sourceDirs() const
+{
+    QStringList dirs;
+    for (const QString &dir : m_sourceEdit->text().split(';', Qt::SkipEmptyParts)) {
+        if (QString trimmed = dir.trimmed(); !trimmed.isEmpty()) {
+            dirs.append(trimmed);
+        }
+    }
+    return dirs;
+}
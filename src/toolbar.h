@@ -7,6 +7,10 @@
 #include <QSpinBox>
 #include <QLineEdit>
 
+namespace ToolBarConstants {
+    inline constexpr int kMaxGridSize = 10;   // Rows and columns; also the limit of --grid
+}
+
 class ToolBar : public QToolBar
 {
     Q_OBJECT
@@ -22,8 +26,10 @@ public:
     [[nodiscard]] int rows() const;
     [[nodiscard]] int cols() const;
     [[nodiscard]] QString sourceDir() const;
+    [[nodiscard]] QStringList sourceDirs() const;  // ';'-separated roots
     [[nodiscard]] QString filter() const;
     void setSourceDir(const QString &dir);
+    void setGridSize(int rows, int cols);   // Clamped to 1..kMaxGridSize
 
 signals:
     void startClicked();
@@ -0,0 +1,225 @@
+#include "wallrenderer.h"
+#include "mpvwidget.h"
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QResizeEvent>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+WallRenderer::WallRenderer(QWidget *parent)
+    : QOpenGLWidget(parent)
+{
+    setUpdateBehavior(QOpenGLWidget::NoPartialUpdate);
+    setAutoFillBackground(false);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_TransparentForMouseEvents);  // Cells on top handle input
+    connect(this, &QOpenGLWidget::frameSwapped, this, &WallRenderer::onFrameSwapped);
+
+    if (parent) {
+        parent->installEventFilter(this);
+        setGeometry(parent->rect());
+    }
+    lower();
+}
+
+WallRenderer::~WallRenderer()
+{
+    // Render contexts must be freed with our GL context current and before
+    // the mpv handles go away; players notice through their QPointer
+    makeCurrent();
+    for (auto &tile : m_tiles) {
+        destroyContext(*tile);
+    }
+    doneCurrent();
+    m_tiles.clear();
+}
+
+void WallRenderer::addTile(MpvWidget *player, QWidget *area)
+{
+    if (!player || !player->handle()) return;
+
+    auto tile = std::make_unique<Tile>();
+    tile->wall = this;
+    tile->player = player;
+    tile->area = area;
+
+    // Before initializeGL the context is created there
+    if (context()) {
+        makeCurrent();
+        createContext(*tile);
+        doneCurrent();
+    }
+
+    m_tiles.push_back(std::move(tile));
+    update();
+}
+
+void WallRenderer::removeTile(MpvWidget *player)
+{
+    auto it = std::find_if(m_tiles.begin(), m_tiles.end(), [player](const auto &tile) {
+        return tile->player == player;
+    });
+    if (it == m_tiles.end()) return;
+
+    makeCurrent();
+    destroyContext(**it);
+    doneCurrent();
+    m_tiles.erase(it);
+    update();
+}
+
+void WallRenderer::initializeGL()
+{
+    for (auto &tile : m_tiles) {
+        createContext(*tile);
+    }
+}
+
+void WallRenderer::createContext(Tile &tile)
+{
+    if (tile.ctx) return;
+
+    mpv_opengl_init_params gl_init_params{
+        .get_proc_address = getGlProcAddress,
+    };
+
+    mpv_render_param params[]{
+        {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_OPENGL)},
+        {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, &gl_init_params},
+        {MPV_RENDER_PARAM_INVALID, nullptr}
+    };
+
+    int err = mpv_render_context_create(&tile.ctx, tile.player->handle(), params);
+    if (err < 0) {
+        qWarning() << "WallRenderer: mpv_render_context_create failed:" << mpv_error_string(err);
+        tile.ctx = nullptr;
+        return;
+    }
+
+    mpv_render_context_set_update_callback(tile.ctx, onUpdate, &tile);
+    tile.pending = true;
+}
+
+void WallRenderer::destroyContext(Tile &tile)
+{
+    // After free mpv guarantees the update callback is no longer called
+    if (tile.ctx) {
+        mpv_render_context_free(tile.ctx);
+        tile.ctx = nullptr;
+        FrameScheduler::instance().cancel(&tile);
+    }
+    tile.fbo.reset();
+}
+
+QRect WallRenderer::tileRect(const Tile &tile) const
+{
+    if (!tile.area) return QRect();
+
+    const QRect logical(tile.area->mapTo(parentWidget(), QPoint(0, 0)) - pos(), tile.area->size());
+    const qreal dpr = devicePixelRatioF();
+    return QRect(qRound(logical.x() * dpr), qRound(logical.y() * dpr),
+                 qRound(logical.width() * dpr), qRound(logical.height() * dpr));
+}
+
+void WallRenderer::paintGL()
+{
+    auto *f = QOpenGLContext::currentContext()->extraFunctions();
+    const qreal dpr = devicePixelRatioF();
+    const int surfaceW = qRound(width() * dpr);
+    const int surfaceH = qRound(height() * dpr);
+    const GLuint target = defaultFramebufferObject();
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, target);
+    f->glViewport(0, 0, surfaceW, surfaceH);
+    f->glClearColor(0.f, 0.f, 0.f, 1.f);
+    f->glClear(GL_COLOR_BUFFER_BIT);
+
+    for (auto &tile : m_tiles) {
+        if (!tile->ctx || !tile->area || !tile->area->isVisible()) continue;
+
+        const QRect rect = tileRect(*tile);
+        if (rect.isEmpty()) continue;
+
+        bool newFrame = false;
+        bool render = false;
+        if (!tile->fbo || tile->fbo->size() != rect.size()) {
+            tile->fbo = std::make_unique<QOpenGLFramebufferObject>(rect.size());
+            render = true;
+        }
+        if (tile->pending) {
+            tile->pending = false;
+            newFrame = (mpv_render_context_update(tile->ctx) & MPV_RENDER_UPDATE_FRAME) != 0;
+            render |= newFrame;
+        }
+
+        if (render) {
+            mpv_opengl_fbo fbo{
+                .fbo = static_cast<int>(tile->fbo->handle()),
+                .w = rect.width(),
+                .h = rect.height(),
+            };
+            int flip_y = 1;  // Same orientation as MpvWidget, so the blit is a straight copy
+            mpv_render_param params[]{
+                {MPV_RENDER_PARAM_OPENGL_FBO, &fbo},
+                {MPV_RENDER_PARAM_FLIP_Y, &flip_y},
+                {MPV_RENDER_PARAM_INVALID, nullptr}
+            };
+            QElapsedTimer timer;
+            timer.start();
+            mpv_render_context_render(tile->ctx, params);
+            tile->player->recordRenderTime(timer.nsecsElapsed(), newFrame);
+            tile->rendered = true;
+        }
+
+        // GL's origin is bottom-left
+        const int y = surfaceH - rect.y() - rect.height();
+        f->glBindFramebuffer(GL_READ_FRAMEBUFFER, tile->fbo->handle());
+        f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        f->glBlitFramebuffer(0, 0, rect.width(), rect.height(),
+                             rect.x(), y, rect.x() + rect.width(), y + rect.height(),
+                             GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    f->glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+bool WallRenderer::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == parentWidget() && event->type() == QEvent::Resize) {
+        setGeometry(parentWidget()->rect());
+        lower();
+    }
+    return QOpenGLWidget::eventFilter(watched, event);
+}
+
+void WallRenderer::Tile::onFrameDue()
+{
+    pending = true;
+    wall->update();  // Every due tile lands in the same paint
+}
+
+void WallRenderer::onFrameSwapped()
+{
+    for (auto &tile : m_tiles) {
+        if (tile->rendered && tile->ctx) {
+            mpv_render_context_report_swap(tile->ctx);
+        }
+        tile->rendered = false;
+    }
+}
+
+void WallRenderer::onUpdate(void *ctx)
+{
+    // mpv's render thread; the scheduler defers the work to the next refresh
+    FrameScheduler::instance().requestFrame(static_cast<Tile*>(ctx));
+}
+
+void *WallRenderer::getGlProcAddress(void *ctx, const char *name)
+{
+    Q_UNUSED(ctx);
+    QOpenGLContext *glctx = QOpenGLContext::currentContext();
+    if (!glctx)
+        return nullptr;
+    return reinterpret_cast<void*>(glctx->getProcAddress(QByteArray(name)));
+}
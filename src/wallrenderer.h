@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QOpenGLWidget>
+#include <QOpenGLFramebufferObject>
+#include <QPointer>
+#include <memory>
+#include <vector>
+#include <mpv/client.h>
+#include <mpv/render_gl.h>
+#include "framescheduler.h"
+
+class MpvWidget;
+
+// One GL surface for the whole video wall. Attached MpvWidgets create their
+// mpv render context here instead of in their own QOpenGLWidget; each tile
+// renders into a tile-sized FBO that is blitted into the tile's rect, and Qt
+// composites a single widget instead of one per cell.
+//
+// The renderer sits underneath the grid cells (which stay transparent) and
+// tracks its parent's size. Tile fullscreen detaches the cell again so it
+// can use its own MpvWidget surface with the OSC.
+class WallRenderer : public QOpenGLWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WallRenderer(QWidget *parent);
+    ~WallRenderer() override;
+
+    // area is the widget whose rect the tile fills, in any descendant of our parent
+    void addTile(MpvWidget *player, QWidget *area);
+    void removeTile(MpvWidget *player);
+    [[nodiscard]] int tileCount() const noexcept { return static_cast<int>(m_tiles.size()); }
+
+protected:
+    void initializeGL() override;
+    void paintGL() override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    struct Tile : FrameClient {
+        WallRenderer *wall = nullptr;
+        MpvWidget *player = nullptr;
+        QPointer<QWidget> area;
+        mpv_render_context *ctx = nullptr;
+        std::unique_ptr<QOpenGLFramebufferObject> fbo;
+        bool pending = false;            // mpv signalled an update since the last paint
+        bool rendered = false;           // Rendered in the last paint; owes a swap report
+
+        void onFrameDue() override;
+    };
+
+    void onFrameSwapped();
+
+    void createContext(Tile &tile);
+    void destroyContext(Tile &tile);
+    [[nodiscard]] QRect tileRect(const Tile &tile) const;  // Device pixels, top-left origin
+
+    static void onUpdate(void *ctx);
+    static void *getGlProcAddress(void *ctx, const char *name);
+
+    std::vector<std::unique_ptr<Tile>> m_tiles;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QSet>
+#include <utility>
+
+// Work queue of the background caches that decode for views (ThumbnailCache,
+// StillImageCache). Every owner declares the jobs it wants right now; the
+// newest declaration goes to the front in its own order, and jobs no owner
+// wants any more leave the queue. Job needs a cacheKey().
+template <typename Job>
+class WantedQueue
+{
+public:
+    // Replaces what owner wanted before. skip(key) filters jobs that need no
+    // work (cached, running or failed); queued jobs were filtered already.
+    template <typename Skip>
+    void setWanted(const QObject *owner, const QList<Job> &jobs, Skip skip)
+    {
+        forget(m_wanted.value(owner));
+        m_wanted.insert(owner, jobs);
+        for (const Job &job : jobs) {
+            ++m_wantedKeys[job.cacheKey()];
+        }
+
+        QList<Job> front;
+        QSet<QString> queued;
+        for (const Job &job : jobs) {
+            const QString key = job.cacheKey();
+            if (queued.contains(key) || skip(key)) continue;
+            queued.insert(key);
+            front.append(job);
+        }
+        for (const Job &job : std::as_const(m_queue)) {
+            const QString key = job.cacheKey();
+            if (!queued.contains(key) && isWanted(key)) {
+                queued.insert(key);
+                front.append(job);
+            }
+        }
+        m_queue = std::move(front);
+    }
+
+    void release(const QObject *owner)
+    {
+        forget(m_wanted.take(owner));
+        m_queue.removeIf([this](const Job &job) { return !isWanted(job.cacheKey()); });
+    }
+
+    [[nodiscard]] bool hasOwner(const QObject *owner) const { return m_wanted.contains(owner); }
+    [[nodiscard]] bool isWanted(const QString &key) const { return m_wantedKeys.contains(key); }
+
+    [[nodiscard]] bool isEmpty() const noexcept { return m_queue.isEmpty(); }
+    [[nodiscard]] Job takeFirst() { return m_queue.takeFirst(); }
+    void prepend(const Job &job) { m_queue.prepend(job); }
+    void clear() { m_queue.clear(); }
+
+private:
+    void forget(const QList<Job> &jobs)
+    {
+        for (const Job &job : jobs) {
+            const auto it = m_wantedKeys.find(job.cacheKey());
+            if (it != m_wantedKeys.end() && --it.value() <= 0) {
+                m_wantedKeys.erase(it);
+            }
+        }
+    }
+
+    QHash<const QObject*, QList<Job>> m_wanted;
+    QHash<QString, int> m_wantedKeys;   // cacheKey -> owners wanting it
+    QList<Job> m_queue;                 // Front is next
+};